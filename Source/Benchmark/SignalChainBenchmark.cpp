@@ -0,0 +1,842 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2016 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "SignalChainBenchmark.h"
+#include "../AccessClass.h"
+#include "../Processors/PluginManager/PluginManager.h"
+#include "../Processors/ProcessorGraph/ProcessorGraph.h"
+#include "../Processors/RecordNode/RecordNode.h"
+#include "../Processors/RecordNode/RecordEngine.h"
+#include "../Processors/ClosedLoop/ClosedLoopLane.h"
+#include "../Processors/Serial/ofSerial.h"
+#include "../CoreServices.h"
+
+#include <stdio.h>
+
+#if JUCE_LINUX || JUCE_MAC
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <unistd.h>
+#endif
+
+#define BENCHMARK_NODE_ID 100
+#define SPIKE_INTERVAL_MS 50
+#define SPIKE_LENGTH 32
+
+/** Biphasic spike shape (in microvolts) used by the BenchmarkSource. */
+static const float spikeTemplate[SPIKE_LENGTH] =
+{
+    0.0f, -5.0f, -15.0f, -40.0f, -90.0f, -160.0f, -220.0f, -240.0f,
+    -200.0f, -130.0f, -60.0f, 0.0f, 40.0f, 65.0f, 75.0f, 72.0f,
+    64.0f, 54.0f, 44.0f, 35.0f, 27.0f, 20.0f, 14.0f, 10.0f,
+    6.0f, 4.0f, 2.0f, 1.0f, 0.5f, 0.2f, 0.1f, 0.0f
+};
+
+BenchmarkSource::BenchmarkSource(int numChannels_, float sampleRate_)
+    : GenericProcessor("Benchmark Source"), numChannels(numChannels_), sampleRate(sampleRate_),
+      samplesPerBlock(0), timestamp(0), ttlState(0), random(12345)
+{
+    phase.calloc(numChannels);
+    samplesToNextSpike.calloc(numChannels);
+    spikeSampleIndex.calloc(numChannels);
+
+    const int spikeInterval = int(sampleRate * SPIKE_INTERVAL_MS / 1000.0f);
+
+    for (int i = 0; i < numChannels; i++)
+    {
+        phase[i] = random.nextDouble() * double_Pi * 2.0;
+        samplesToNextSpike[i] = random.nextInt(spikeInterval) + 1;
+        spikeSampleIndex[i] = -1;
+    }
+}
+
+BenchmarkSource::~BenchmarkSource()
+{
+}
+
+float BenchmarkSource::getDefaultSampleRate()
+{
+    return sampleRate;
+}
+
+int BenchmarkSource::getNumHeadstageOutputs()
+{
+    return numChannels;
+}
+
+int BenchmarkSource::getNumEventChannels()
+{
+    return 1;
+}
+
+float BenchmarkSource::getBitVolts(Channel* chan)
+{
+    return 0.195f;
+}
+
+void BenchmarkSource::setSamplesPerBlock(int nSamples)
+{
+    samplesPerBlock = nSamples;
+}
+
+void BenchmarkSource::process(AudioSampleBuffer& buffer, MidiBuffer& events)
+{
+    events.clear();
+    buffer.clear();
+
+    const int nSamples = jmin(samplesPerBlock, buffer.getNumSamples());
+    const int nChans = jmin(numChannels, buffer.getNumChannels());
+    const double phaseIncrement = double_Pi * 2.0 * 8.0 / sampleRate; // 8 Hz theta-like LFP
+    const int spikeInterval = int(sampleRate * SPIKE_INTERVAL_MS / 1000.0f);
+
+    for (int chan = 0; chan < nChans; chan++)
+    {
+        float* data = buffer.getWritePointer(chan);
+        double p = phase[chan];
+
+        for (int i = 0; i < nSamples; i++)
+        {
+            float sample = 150.0f * (float) std::sin(p) + 10.0f * (random.nextFloat() - 0.5f);
+
+            if (spikeSampleIndex[chan] >= 0)
+            {
+                sample += spikeTemplate[spikeSampleIndex[chan]++];
+
+                if (spikeSampleIndex[chan] >= SPIKE_LENGTH)
+                    spikeSampleIndex[chan] = -1;
+            }
+            else if (--samplesToNextSpike[chan] <= 0)
+            {
+                spikeSampleIndex[chan] = 0;
+                samplesToNextSpike[chan] = spikeInterval;
+            }
+
+            data[i] = sample;
+            p += phaseIncrement;
+        }
+
+        phase[chan] = std::fmod(p, double_Pi * 2.0);
+    }
+
+    setNumSamples(events, nSamples);
+    setTimestamp(events, timestamp);
+
+    // toggle the TTL line once per second
+    const int64 samplesPerSecond = int64(sampleRate);
+    const int64 nextToggle = ((timestamp / samplesPerSecond) + 1) * samplesPerSecond;
+
+    if (nextToggle < timestamp + nSamples)
+    {
+        ttlState = 1 - ttlState;
+        int64 ts = nextToggle;
+
+        addEvent(events,              // MidiBuffer
+                 TTL,                 // eventType
+                 int(nextToggle - timestamp), // sampleNum
+                 ttlState,            // eventID
+                 0,                   // eventChannel
+                 8,
+                 (uint8*) &ts);
+    }
+
+    timestamp += nSamples;
+}
+
+/////////////////////////////////////////////////////////////////////////
+
+SignalChainBenchmark::SignalChainBenchmark(const StringArray& parameters)
+{
+    channelCounts = parseList(parameters, "channels", "32,384,1024");
+    blockSizes = parseList(parameters, "block-sizes", "1024");
+    sampleRates = parseList(parameters, "sample-rates", "30000");
+
+    numBlocks = getOption(parameters, "blocks", "2000").getIntValue();
+    numWarmupBlocks = getOption(parameters, "warmup", "50").getIntValue();
+    benchmarkRecording = !parameters.contains("--no-record", true);
+    carMode = getOption(parameters, "car-mode", "mean");
+    streamFormat = getOption(parameters, "stream-format", "float32");
+    streamCompression = parameters.contains("--stream-lz4", true);
+
+    numClosedLoopTriggers = getOption(parameters, "closed-loop-latency", "0").getIntValue();
+
+    if (parameters.contains("--closed-loop-latency", true))
+        numClosedLoopTriggers = 1000;
+
+    processorNames.addTokens(getOption(parameters, "processors",
+                                       "Bandpass Filter,Common Avg Ref,Channel Map,"
+                                       "Spike Detector,Spike Sorter,Phase Detector"), ",", "\"");
+    processorNames.trim();
+    processorNames.removeEmptyStrings();
+
+    recordingDirectory = File::getSpecialLocation(File::tempDirectory).getChildFile("open-ephys-benchmark");
+}
+
+SignalChainBenchmark::~SignalChainBenchmark()
+{
+}
+
+String SignalChainBenchmark::getOption(const StringArray& parameters, const String& option, const String& defaultValue)
+{
+    const String prefix = "--" + option + "=";
+
+    for (int i = 0; i < parameters.size(); i++)
+    {
+        // arguments containing spaces arrive quoted as a whole
+        const String parameter = parameters[i].unquoted();
+
+        if (parameter.startsWithIgnoreCase(prefix))
+            return parameter.substring(prefix.length()).unquoted();
+    }
+
+    return defaultValue;
+}
+
+Array<int> SignalChainBenchmark::parseList(const StringArray& parameters, const String& option, const String& defaultValue)
+{
+    StringArray tokens;
+    tokens.addTokens(getOption(parameters, option, defaultValue), ",", String::empty);
+
+    Array<int> values;
+
+    for (int i = 0; i < tokens.size(); i++)
+    {
+        const int v = tokens[i].getIntValue();
+
+        if (v > 0)
+            values.add(v);
+    }
+
+    return values;
+}
+
+int SignalChainBenchmark::run()
+{
+    if (numClosedLoopTriggers > 0)
+        return runClosedLoopLatency();
+
+    std::cout << std::endl << "Open Ephys signal chain benchmark" << std::endl;
+    std::cout << "  " << numBlocks << " blocks per configuration, " << numWarmupBlocks << " warm-up blocks" << std::endl;
+
+    int numFailed = 0;
+
+    for (int c = 0; c < channelCounts.size(); c++)
+    {
+        for (int b = 0; b < blockSizes.size(); b++)
+        {
+            for (int s = 0; s < sampleRates.size(); s++)
+            {
+                numFailed += runConfiguration(channelCounts[c], blockSizes[b], float(sampleRates[s]));
+            }
+        }
+    }
+
+    if (recordingDirectory.isDirectory())
+        recordingDirectory.deleteRecursively();
+
+    return numFailed;
+}
+
+GenericProcessor* SignalChainBenchmark::createProcessor(const String& processorName)
+{
+    PluginManager* pm = AccessClass::getPluginManager();
+
+    for (int i = 0; i < pm->getNumProcessors(); i++)
+    {
+        if (processorName.equalsIgnoreCase(pm->getPluginName(Plugin::ProcessorPlugin, i)))
+        {
+            Plugin::ProcessorInfo info = pm->getProcessorInfo(i);
+
+            if (info.creator == nullptr)
+                return nullptr;
+
+            GenericProcessor* proc = info.creator();
+            proc->setPluginData(Plugin::ProcessorPlugin, i);
+            return proc;
+        }
+    }
+
+    return nullptr;
+}
+
+XmlElement* SignalChainBenchmark::createDefaultSettings(const String& processorName, int numChannels)
+{
+    // Settings use the same layout as settings.xml, so they go through the
+    // processors' own loading code.
+
+    const int numTetrodes = numChannels / 4;
+
+    if (processorName.equalsIgnoreCase("Spike Detector"))
+    {
+        XmlElement* xml = new XmlElement("PROCESSOR");
+
+        for (int e = 0; e < numTetrodes; e++)
+        {
+            XmlElement* electrode = xml->createNewChildElement("ELECTRODE");
+            electrode->setAttribute("name", "Tetrode " + String(e + 1));
+            electrode->setAttribute("numChannels", 4);
+            electrode->setAttribute("electrodeID", e + 1);
+
+            for (int ch = 0; ch < 4; ch++)
+            {
+                XmlElement* subchannel = electrode->createNewChildElement("SUBCHANNEL");
+                subchannel->setAttribute("ch", e * 4 + ch);
+                subchannel->setAttribute("thresh", 50.0);
+                subchannel->setAttribute("isActive", true);
+            }
+        }
+
+        return xml;
+    }
+    else if (processorName.equalsIgnoreCase("Spike Sorter"))
+    {
+        XmlElement* xml = new XmlElement("PROCESSOR");
+        XmlElement* sorter = xml->createNewChildElement("SpikeSorter");
+        sorter->setAttribute("activeElectrode", -1);
+        sorter->setAttribute("numPreSamples", 8);
+        sorter->setAttribute("numPostSamples", 32);
+        sorter->setAttribute("autoDACassignment", false);
+        sorter->setAttribute("syncThresholds", false);
+        sorter->setAttribute("uniqueID", numTetrodes);
+        sorter->setAttribute("flipSignal", false);
+
+        for (int e = 0; e < numTetrodes; e++)
+        {
+            XmlElement* electrode = sorter->createNewChildElement("ELECTRODE");
+            electrode->setAttribute("name", "Tetrode " + String(e + 1));
+            electrode->setAttribute("numChannels", 4);
+            electrode->setAttribute("electrodeID", e + 1);
+            electrode->setAttribute("advancerID", -1);
+            electrode->setAttribute("depthOffsetMM", 0.0);
+
+            for (int ch = 0; ch < 4; ch++)
+            {
+                XmlElement* subchannel = electrode->createNewChildElement("SUBCHANNEL");
+                subchannel->setAttribute("ch", e * 4 + ch);
+                subchannel->setAttribute("thresh", 50.0);
+                subchannel->setAttribute("isActive", true);
+            }
+        }
+
+        return xml;
+    }
+    else if (processorName.equalsIgnoreCase("Phase Detector"))
+    {
+        XmlElement* xml = new XmlElement("PROCESSOR");
+        XmlElement* editorXml = xml->createNewChildElement("EDITOR");
+        XmlElement* detector = editorXml->createNewChildElement("DETECTOR");
+        detector->setAttribute("PHASE", 1);
+        detector->setAttribute("INPUT", 0);
+        detector->setAttribute("GATE", -1);
+        detector->setAttribute("OUTPUT", 0);
+        return xml;
+    }
+    else if (processorName.equalsIgnoreCase("Common Avg Ref"))
+    {
+        XmlElement* xml = new XmlElement("PROCESSOR");
+        XmlElement* car = xml->createNewChildElement("CAR");
+        car->setAttribute("gain", 100.0);
+        car->setAttribute("mode", carMode);
+
+        // one reference group per 64-channel shank, at most 16 groups
+        const int groupSize = jmax(64, (numChannels + 15) / 16);
+
+        for (int first = 0; first < numChannels; first += groupSize)
+        {
+            String channelList;
+
+            for (int ch = first; ch < jmin(numChannels, first + groupSize); ch++)
+                channelList << ch << " ";
+
+            XmlElement* group = car->createNewChildElement("GROUP");
+            group->setAttribute("referenceChannels", channelList.trim());
+            group->setAttribute("affectedChannels", channelList.trim());
+        }
+        return xml;
+    }
+    else if (processorName.equalsIgnoreCase("Stream Output"))
+    {
+        // the processor's own subscriber receives the stream over the
+        // loopback interface and reports the throughput on disable()
+        XmlElement* xml = new XmlElement("PROCESSOR");
+        XmlElement* stream = xml->createNewChildElement("STREAMOUTPUT");
+        stream->setAttribute("port", 5558);
+        stream->setAttribute("format", streamFormat);
+        stream->setAttribute("lz4", streamCompression);
+        stream->setAttribute("loopback", true);
+        return xml;
+    }
+
+    return nullptr;
+}
+
+void SignalChainBenchmark::processBlocks(Array<GenericProcessor*>& chain, OwnedArray<Timings>& timings,
+                                         int numChannels, int blockSize, int nBlocks, bool recordTimings)
+{
+    AudioSampleBuffer buffer(numChannels, blockSize);
+    MidiBuffer events;
+
+    for (int block = 0; block < nBlocks; block++)
+    {
+        for (int p = 0; p < chain.size(); p++)
+        {
+            AudioProcessor* processor = chain[p];
+
+            const int64 start = Time::getHighResolutionTicks();
+            processor->processBlock(buffer, events);
+            const int64 end = Time::getHighResolutionTicks();
+
+            if (recordTimings)
+            {
+                Timings* t = timings[p];
+                t->blockMicros.add(Time::highResolutionTicksToSeconds(end - start) * 1.0e6);
+                t->channelSamples += int64(numChannels) * blockSize;
+            }
+        }
+    }
+}
+
+void SignalChainBenchmark::printTimings(const OwnedArray<Timings>& timings, int blockSize, float sampleRate)
+{
+    const double budgetMicros = double(blockSize) / sampleRate * 1.0e6;
+
+    printf("  %-24s %10s %10s %10s %10s %14s %9s\n",
+           "processor", "p50 (us)", "p90 (us)", "p99 (us)", "max (us)", "Msamples/s", "budget %");
+
+    for (int i = 0; i < timings.size(); i++)
+    {
+        const Timings* t = timings[i];
+
+        if (t->blockMicros.size() == 0)
+            continue;
+
+        Array<double> sorted(t->blockMicros);
+        DefaultElementComparator<double> sorter;
+        sorted.sort(sorter);
+
+        const int n = sorted.size();
+        double total = 0;
+
+        for (int k = 0; k < n; k++)
+            total += sorted[k];
+
+        const double mean = total / n;
+        const double samplesPerSecond = total > 0 ? double(t->channelSamples) / (total * 1.0e-6) : 0;
+
+        printf("  %-24s %10.1f %10.1f %10.1f %10.1f %14.2f %8.2f%%\n",
+               t->name.toRawUTF8(),
+               sorted[int(0.50 * (n - 1))],
+               sorted[int(0.90 * (n - 1))],
+               sorted[int(0.99 * (n - 1))],
+               sorted[n - 1],
+               samplesPerSecond / 1.0e6,
+               100.0 * mean / budgetMicros);
+    }
+
+    fflush(stdout);
+}
+
+int SignalChainBenchmark::runConfiguration(int numChannels, int blockSize, float sampleRate)
+{
+    std::cout << std::endl << "=== " << numChannels << " channels, " << blockSize << " samples/block, "
+              << sampleRate << " Hz ===" << std::endl;
+
+    int numFailed = 0;
+
+    OwnedArray<GenericProcessor> chain;
+    BenchmarkSource* source = new BenchmarkSource(numChannels, sampleRate);
+    source->setSamplesPerBlock(blockSize);
+    chain.add(source);
+
+    for (int i = 0; i < processorNames.size(); i++)
+    {
+        GenericProcessor* proc = createProcessor(processorNames[i]);
+
+        if (proc == nullptr)
+        {
+            std::cout << "  Processor not found: " << processorNames[i] << std::endl;
+            numFailed++;
+            continue;
+        }
+
+        chain.add(proc);
+    }
+
+    // wire up the chain the same way the EditorViewport and ProcessorGraph do
+    for (int i = 0; i < chain.size(); i++)
+    {
+        GenericProcessor* proc = chain[i];
+        proc->setNodeId(BENCHMARK_NODE_ID + i);
+        proc->createEditor();
+
+        if (i > 0)
+        {
+            proc->setSourceNode(chain[i - 1]);
+            chain[i - 1]->setDestNode(proc);
+        }
+        else
+        {
+            proc->setAllChannelsToRecord();
+        }
+    }
+
+    // loadFromXml() updates each processor's settings from its source, so
+    // this has to run in chain order
+    OwnedArray<XmlElement> settings;
+
+    for (int i = 0; i < chain.size(); i++)
+    {
+        GenericProcessor* proc = chain[i];
+        proc->parametersAsXml = createDefaultSettings(proc->getName(), numChannels);
+        settings.add(proc->parametersAsXml);
+        proc->loadFromXml();
+        proc->prepareToPlay(sampleRate, blockSize);
+    }
+
+    RecordNode* recordNode = AccessClass::getProcessorGraph()->getRecordNode();
+    recordNode->resetConnections();
+
+    for (int i = 0; i < chain.size(); i++)
+    {
+        chain[i]->enableEditor();
+        chain[i]->enable();
+    }
+
+    Array<GenericProcessor*> processors;
+    processors.addArray(chain);
+
+    OwnedArray<Timings> timings;
+
+    for (int i = 0; i < processors.size(); i++)
+    {
+        Timings* t = new Timings();
+        t->name = processors[i]->getName();
+        t->channelSamples = 0;
+        timings.add(t);
+    }
+
+    processBlocks(processors, timings, numChannels, blockSize, numWarmupBlocks, false);
+    processBlocks(processors, timings, numChannels, blockSize, numBlocks, true);
+    printTimings(timings, blockSize, sampleRate);
+
+    if (benchmarkRecording)
+    {
+        for (int i = 0; i < chain.size(); i++)
+            chain[i]->disable();
+
+        OwnedArray<RecordEngineManager> managers;
+
+        for (int i = 0; i < RecordEngineManager::getNumOfBuiltInEngines(); i++)
+            managers.add(RecordEngineManager::createBuiltInEngineManager(i));
+
+        PluginManager* pm = AccessClass::getPluginManager();
+
+        for (int i = 0; i < pm->getNumRecordEngines(); i++)
+        {
+            Plugin::RecordEngineInfo info = pm->getRecordEngineInfo(i);
+
+            if (info.creator != nullptr)
+                managers.add(info.creator());
+        }
+
+        for (int i = 0; i < managers.size(); i++)
+            runRecordEngine(managers[i], chain, numChannels, blockSize, sampleRate);
+
+        recordNode->clearRecordEngines();
+        recordNode->resetConnections();
+    }
+    else
+    {
+        for (int i = 0; i < chain.size(); i++)
+            chain[i]->disable();
+    }
+
+    for (int i = 0; i < chain.size(); i++)
+        chain[i]->disableEditor();
+
+    recordNode->resetConnections();
+
+    return numFailed;
+}
+
+void SignalChainBenchmark::runRecordEngine(RecordEngineManager* manager,
+                                           OwnedArray<GenericProcessor>& chain,
+                                           int numChannels, int blockSize, float sampleRate)
+{
+    std::cout << std::endl << "  RecordNode with " << manager->getName() << " engine:" << std::endl;
+
+    RecordNode* recordNode = AccessClass::getProcessorGraph()->getRecordNode();
+
+    RecordEngine* engine = manager->instantiateEngine();
+    engine->registerManager(manager);
+
+    recordNode->clearRecordEngines();
+    recordNode->registerRecordEngine(engine);
+    recordNode->resetConnections();
+
+    GenericProcessor* last = chain.getLast();
+    recordNode->registerProcessor(last);
+
+    for (int chan = 0; chan < last->getNumOutputs(); chan++)
+        recordNode->addInputChannel(last, chan);
+
+    recordNode->addInputChannel(last, AccessClass::getProcessorGraph()->midiChannelIndex);
+
+    for (int i = 0; i < chain.size(); i++)
+        chain[i]->enable();
+
+    recordNode->enable();
+    recordNode->setDataDirectory(recordingDirectory);
+    recordNode->newDirectoryNeeded = true;
+
+    if (!recordingDirectory.isDirectory())
+        recordingDirectory.createDirectory();
+
+    for (int i = 0; i < chain.size(); i++)
+        chain[i]->setRecording(true);
+
+    recordNode->setParameter(1, 0.0f); // start recording
+
+    Array<GenericProcessor*> processors;
+    processors.addArray(chain);
+    processors.add(recordNode);
+
+    OwnedArray<Timings> timings;
+
+    for (int i = 0; i < processors.size(); i++)
+    {
+        Timings* t = new Timings();
+        t->name = processors[i]->getName();
+        t->channelSamples = 0;
+        timings.add(t);
+    }
+
+    processBlocks(processors, timings, numChannels, blockSize, numWarmupBlocks, false);
+    processBlocks(processors, timings, numChannels, blockSize, numBlocks, true);
+
+    const int64 start = Time::getHighResolutionTicks();
+    recordNode->setParameter(0, 0.0f); // stop recording, waits for the record thread to flush
+    const double flushMillis = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start) * 1000.0;
+
+    for (int i = 0; i < chain.size(); i++)
+    {
+        chain[i]->setRecording(false);
+        chain[i]->disable();
+    }
+
+    recordNode->disable();
+
+    // only the record node is interesting here; the rest of the chain was reported above
+    timings.removeRange(0, chain.size());
+    printTimings(timings, blockSize, sampleRate);
+    std::cout << "  record thread flush: " << String(flushMillis, 1) << " ms" << std::endl;
+}
+
+#if JUCE_LINUX || JUCE_MAC
+
+/** Stands in for an output device on the closed-loop lane: writes a
+    Firmata-style digital message to a serial port for every trigger. */
+class PtyTriggerWriter : public ClosedLoopLane::Listener
+{
+public:
+    PtyTriggerWriter(ofSerial& serial_) : serial(serial_) { }
+
+    void closedLoopTriggerReceived(const ClosedLoopTrigger& trigger)
+    {
+        unsigned char message[3] = { 0x90, (unsigned char) (trigger.state ? 1 : 0), 0x00 };
+        serial.writeBytes(message, 3);
+    }
+
+private:
+    ofSerial& serial;
+};
+
+/** Reads the master side of the pseudo-terminal and timestamps every
+    complete message as it arrives. */
+class PtyTriggerReader : public Thread
+{
+public:
+    PtyTriggerReader(int fd_, int maxMessages_)
+        : Thread("Closed-loop latency reader"), fd(fd_), maxMessages(maxMessages_), bytesInMessage(0)
+    {
+        arrivalTicks.calloc(maxMessages);
+    }
+
+    void run()
+    {
+        unsigned char buffer[256];
+
+        while (!threadShouldExit() && numReceived.get() < maxMessages)
+        {
+            struct pollfd pfd;
+            pfd.fd = fd;
+            pfd.events = POLLIN;
+
+            // time out now and then to check threadShouldExit()
+            if (poll(&pfd, 1, 50) <= 0)
+                continue;
+
+            const int numBytes = (int) read(fd, buffer, sizeof(buffer));
+            const int64 now = Time::getHighResolutionTicks();
+
+            for (int i = 0; i < numBytes && numReceived.get() < maxMessages; i++)
+            {
+                if (++bytesInMessage == 3)
+                {
+                    bytesInMessage = 0;
+                    arrivalTicks[numReceived.get()] = now;
+                    ++numReceived;
+                }
+            }
+        }
+    }
+
+    int getNumReceived() const
+    {
+        return numReceived.get();
+    }
+
+    int64 getArrivalTicks(int index) const
+    {
+        return arrivalTicks[index];
+    }
+
+private:
+    int fd;
+    int maxMessages;
+    int bytesInMessage;
+
+    HeapBlock<int64> arrivalTicks;
+    Atomic<int> numReceived;
+};
+
+#endif
+
+int SignalChainBenchmark::runClosedLoopLatency()
+{
+    std::cout << std::endl << "=== closed-loop latency, " << numClosedLoopTriggers
+              << " triggers through a pseudo-terminal ===" << std::endl;
+
+#if JUCE_LINUX || JUCE_MAC
+
+    const int master = posix_openpt(O_RDWR | O_NOCTTY);
+
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0)
+    {
+        std::cout << "  Could not open a pseudo-terminal." << std::endl;
+
+        if (master >= 0)
+            close(master);
+
+        return 1;
+    }
+
+    ofSerial serial;
+
+    if (!serial.setup(ptsname(master), 115200))
+    {
+        std::cout << "  Could not open " << ptsname(master) << std::endl;
+        close(master);
+        return 1;
+    }
+
+    ClosedLoopLane* lane = CoreServices::getClosedLoopLane();
+
+    PtyTriggerWriter writer(serial);
+    PtyTriggerReader reader(master, numClosedLoopTriggers);
+
+    HeapBlock<int64> publishTicks;
+    publishTicks.calloc(numClosedLoopTriggers);
+
+    reader.startThread();
+    lane->resetStatistics();
+    lane->addListener(&writer);
+
+    int numSent = 0;
+
+    for (; numSent < numClosedLoopTriggers; numSent++)
+    {
+        // a detector would publish from the audio thread; this thread is
+        // the lane's only producer while the benchmark runs
+        publishTicks[numSent] = Time::getHighResolutionTicks();
+        lane->publish(BENCHMARK_NODE_ID, GenericProcessor::TTL, 0, (numSent + 1) % 2, numSent);
+
+        // wait for each message to arrive so that triggers never queue up
+        const uint32 deadline = Time::getMillisecondCounter() + 1000;
+
+        while (reader.getNumReceived() <= numSent && Time::getMillisecondCounter() < deadline)
+            Thread::yield();
+
+        if (reader.getNumReceived() <= numSent)
+        {
+            std::cout << "  Trigger " << numSent << " never arrived." << std::endl;
+            break;
+        }
+
+        Thread::sleep(1);
+    }
+
+    lane->removeListener(&writer);
+    reader.stopThread(1000);
+
+    serial.close();
+    close(master);
+
+    Array<double> latencies;
+
+    for (int i = 0; i < reader.getNumReceived() && i < numSent; i++)
+        latencies.add(Time::highResolutionTicksToSeconds(reader.getArrivalTicks(i) - publishTicks[i]) * 1.0e6);
+
+    if (latencies.size() == 0)
+        return 1;
+
+    DefaultElementComparator<double> sorter;
+    latencies.sort(sorter);
+
+    const int n = latencies.size();
+
+    printf("  %-24s %10s %10s %10s %10s\n", "path", "p50 (us)", "p90 (us)", "p99 (us)", "max (us)");
+    printf("  %-24s %10.1f %10.1f %10.1f %10.1f\n", "publish to pty",
+           latencies[int(0.50 * (n - 1))],
+           latencies[int(0.90 * (n - 1))],
+           latencies[int(0.99 * (n - 1))],
+           latencies[n - 1]);
+    printf("  lane dispatch: mean %.1f us, max %.1f us, %d dropped\n",
+           lane->getMeanDispatchLatency(), lane->getMaxDispatchLatency(), lane->getNumDropped());
+
+    for (int b = 0; b < blockSizes.size(); b++)
+        for (int s = 0; s < sampleRates.size(); s++)
+            printf("  for comparison, one %d-sample block at %d Hz lasts %.1f us\n",
+                   blockSizes[b], sampleRates[s], double(blockSizes[b]) / sampleRates[s] * 1.0e6);
+
+    fflush(stdout);
+
+    return numSent == numClosedLoopTriggers ? 0 : 1;
+
+#else
+
+    std::cout << "  Pseudo-terminals are not available on this platform." << std::endl;
+    return 1;
+
+#endif
+}
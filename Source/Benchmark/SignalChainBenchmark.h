@@ -0,0 +1,188 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2016 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef __SIGNALCHAINBENCHMARK_H_5D1C2A7E__
+#define __SIGNALCHAINBENCHMARK_H_5D1C2A7E__
+
+#include "../../JuceLibraryCode/JuceHeader.h"
+#include "../Processors/GenericProcessor/GenericProcessor.h"
+
+class RecordEngineManager;
+
+/**
+
+  Synthetic data source used by the SignalChainBenchmark.
+
+  Produces LFP-like oscillations, white noise and periodic biphasic spikes
+  on every channel, plus a TTL that toggles once per second, at an arbitrary
+  channel count and sample rate. Timestamps and buffer sizes are sent through
+  the event buffer exactly as a SourceNode would.
+
+  @see SignalChainBenchmark
+
+*/
+
+class BenchmarkSource : public GenericProcessor
+{
+public:
+    BenchmarkSource(int numChannels, float sampleRate);
+    ~BenchmarkSource();
+
+    void process(AudioSampleBuffer& buffer, MidiBuffer& events);
+
+    bool isSource()
+    {
+        return true;
+    }
+    bool generatesTimestamps()
+    {
+        return true;
+    }
+
+    float getDefaultSampleRate();
+    int getNumHeadstageOutputs();
+    int getNumEventChannels();
+    float getBitVolts(Channel* chan);
+
+    /** Sets the number of valid samples generated per block. */
+    void setSamplesPerBlock(int nSamples);
+
+private:
+    int numChannels;
+    float sampleRate;
+    int samplesPerBlock;
+
+    int64 timestamp;
+    int ttlState;
+
+    Random random;
+
+    /** Per-channel oscillator phase and spike countdown. */
+    HeapBlock<double> phase;
+    HeapBlock<int> samplesToNextSpike;
+    HeapBlock<int> spikeSampleIndex;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BenchmarkSource);
+};
+
+/**
+
+  Headless benchmark for the signal chain.
+
+  Launched with "open-ephys --benchmark". Builds a linear chain of processors
+  (loaded through the PluginManager) behind a BenchmarkSource, runs it for
+  a fixed number of blocks for every combination of channel count, block
+  size and sample rate, and prints per-block latency percentiles and
+  throughput for every processor. Optionally runs the RecordNode with every
+  available RecordEngine at the end of the chain.
+
+  Options (all optional):
+
+    --channels=32,384,1024
+    --block-sizes=1024
+    --sample-rates=30000
+    --blocks=2000
+    --warmup=50
+    --processors="Bandpass Filter,Common Avg Ref,..."
+    --car-mode=mean|median
+    --stream-format=float32|int16
+    --stream-lz4
+    --no-record
+
+  Adding "Stream Output" to the processors streams the data over ZeroMQ to a
+  subscriber in the same process, which prints the sustained throughput (e.g.
+  --processors="Stream Output" --channels=1024 --sample-rates=30000).
+
+  With --closed-loop-latency[=N] it instead publishes N (default 1000) triggers
+  on the ClosedLoopLane, to a listener that writes them to a pseudo-terminal
+  standing in for a serial output device, and prints the time from publishing
+  a trigger to its bytes arriving on the other end of the terminal.
+
+  @see BenchmarkSource, ProcessorGraph
+
+*/
+
+class SignalChainBenchmark
+{
+public:
+    SignalChainBenchmark(const StringArray& commandLineParameters);
+    ~SignalChainBenchmark();
+
+    /** Runs every configuration and prints the results. Returns the number of
+        processors that could not be created. */
+    int run();
+
+private:
+
+    struct Timings
+    {
+        String name;
+        Array<double> blockMicros;
+        int64 channelSamples;
+    };
+
+    /** Runs one channel count / block size / sample rate combination. */
+    int runConfiguration(int numChannels, int blockSize, float sampleRate);
+
+    /** Measures trigger latency through the ClosedLoopLane to a pseudo-terminal. */
+    int runClosedLoopLatency();
+
+    /** Runs the chain through the RecordNode using a single engine. */
+    void runRecordEngine(RecordEngineManager* manager,
+                         OwnedArray<GenericProcessor>& chain,
+                         int numChannels, int blockSize, float sampleRate);
+
+    /** Creates a plugin processor from its name, or nullptr if it doesn't exist. */
+    GenericProcessor* createProcessor(const String& processorName);
+
+    /** Provides default settings so that each processor does real work. */
+    XmlElement* createDefaultSettings(const String& processorName, int numChannels);
+
+    /** Runs numBlocks blocks through the chain, timing every processor. */
+    void processBlocks(Array<GenericProcessor*>& chain, OwnedArray<Timings>& timings,
+                       int numChannels, int blockSize, int numBlocks, bool recordTimings);
+
+    void printTimings(const OwnedArray<Timings>& timings, int blockSize, float sampleRate);
+
+    static Array<int> parseList(const StringArray& parameters, const String& option, const String& defaultValue);
+    static String getOption(const StringArray& parameters, const String& option, const String& defaultValue);
+
+    Array<int> channelCounts;
+    Array<int> blockSizes;
+    Array<int> sampleRates;
+    StringArray processorNames;
+    String carMode;
+    String streamFormat;
+    bool streamCompression;
+    int numClosedLoopTriggers;
+
+    int numBlocks;
+    int numWarmupBlocks;
+    bool benchmarkRecording;
+
+    File recordingDirectory;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SignalChainBenchmark);
+};
+
+#endif  // __SIGNALCHAINBENCHMARK_H_5D1C2A7E__
@@ -87,6 +87,11 @@ int64 getSoftwareTimestamp()
 	return getMessageCenter()->getTimestamp(true);
 }
 
+int64 getSoftwareTimestampForTicks(int64 ticks)
+{
+	return getMessageCenter()->getSoftwareTimestampForTicks(ticks);
+}
+
 void setRecordingDirectory(String dir)
 {
     getControlPanel()->setRecordingDirectory(dir);
@@ -144,6 +149,11 @@ void writeSpike(SpikeObject& spike, int electrodeIndex)
     getProcessorGraph()->getRecordNode()->writeSpike(spike, electrodeIndex);
 }
 
+void writeSpike(const SpikeRecord& spike, int electrodeIndex)
+{
+    getProcessorGraph()->getRecordNode()->writeSpike(spike, electrodeIndex);
+}
+
 void registerSpikeSource(GenericProcessor* processor)
 {
     getProcessorGraph()->getRecordNode()->registerSpikeSource(processor);
@@ -155,6 +165,11 @@ int addSpikeElectrode(SpikeRecordInfo* elec)
 }
 };
 
+ClosedLoopLane* getClosedLoopLane()
+{
+    return getProcessorGraph()->getClosedLoopLane();
+}
+
 const char* getApplicationResource(const char* name, int& size)
 {
 	return BinaryData::getNamedResource(name, size);
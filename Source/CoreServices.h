@@ -29,8 +29,10 @@
 
 class GenericEditor;
 struct SpikeObject;
+struct SpikeRecord;
 class GenericProcessor;
 struct SpikeRecordInfo;
+class ClosedLoopLane;
 
 namespace CoreServices
 {
@@ -66,6 +68,10 @@ PLUGIN_API int64 getGlobalTimestamp();
 /** Gets the software timestamp based on a high resolution timer aligned to the start of each processing block */
 PLUGIN_API int64 getSoftwareTimestamp();
 
+/** Converts a Time::getHighResolutionTicks() value taken during acquisition to the
+software timestamp clock, e.g. for data that arrived between processing blocks */
+PLUGIN_API int64 getSoftwareTimestampForTicks(int64 ticks);
+
 /** Set new recording directory */
 PLUGIN_API void setRecordingDirectory(String dir);
 
@@ -99,10 +105,14 @@ PLUGIN_API int getExperimentNumber();
 /* Spike related methods. See record engine documentation */
 
 PLUGIN_API void writeSpike(SpikeObject& spike, int electrodeIndex);
+PLUGIN_API void writeSpike(const SpikeRecord& spike, int electrodeIndex);
 PLUGIN_API void registerSpikeSource(GenericProcessor* processor);
 PLUGIN_API int addSpikeElectrode(SpikeRecordInfo* elec);
 };
 
+/** Gets the lane used to pass triggers from detectors straight to output devices */
+PLUGIN_API ClosedLoopLane* getClosedLoopLane();
+
 PLUGIN_API const char* getApplicationResource(const char* name, int& size);
     
 /** Gets the default directory for user-initiated file saving/loading */
@@ -27,6 +27,7 @@
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "MainWindow.h"
 #include "UI/LookAndFeel/CustomLookAndFeel.h"
+#include "Benchmark/SignalChainBenchmark.h"
 
 #include <stdio.h>
 #include <fstream>
@@ -85,6 +86,19 @@ public:
         customLookAndFeel = new CustomLookAndFeel();
         LookAndFeel::setDefaultLookAndFeel(customLookAndFeel);
 
+        if (parameters.contains("--benchmark", true))
+        {
+            // build the processor graph and load plugins without showing anything,
+            // run the benchmark, then exit
+            mainWindow = new MainWindow(true);
+
+            SignalChainBenchmark benchmark(parameters);
+            setApplicationReturnValue(benchmark.run());
+
+            quit();
+            return;
+        }
+
         mainWindow = new MainWindow();
 
 
@@ -37,10 +37,11 @@ static inline File getSavedStateDirectory() {
 #endif
 }
 
-	MainWindow::MainWindow()
+	MainWindow::MainWindow(bool isHeadless_)
 : DocumentWindow(JUCEApplication::getInstance()->getApplicationName(),
 		Colour(Colours::black),
-		DocumentWindow::allButtons)
+		DocumentWindow::allButtons),
+	isHeadless(isHeadless_)
 {
 
 	setResizable(true,      // isResizable
@@ -72,6 +73,9 @@ static inline File getSavedStateDirectory() {
 
 	addKeyListener(commandManager.getKeyMappings());
 
+	if (isHeadless)
+		return;
+
 	loadWindowBounds();
 	setUsingNativeTitleBar(true);
 	Component::addToDesktop(getDesktopWindowStyleFlags());  // prevents the maximize
@@ -100,14 +104,18 @@ MainWindow::~MainWindow()
 		processorGraph->disableProcessors();
 	}
 
-	saveWindowBounds();
+	if (!isHeadless)
+		saveWindowBounds();
 
 	audioComponent->disconnectProcessorGraph();
 	UIComponent* ui = (UIComponent*) getContentComponent();
 	ui->disableDataViewport();
 
-	File file = getSavedStateDirectory().getChildFile("lastConfig.xml");
-	ui->getEditorViewport()->saveState(file);
+	if (!isHeadless)
+	{
+		File file = getSavedStateDirectory().getChildFile("lastConfig.xml");
+		ui->getEditorViewport()->saveState(file);
+	}
 
 	setMenuBar(0);
 
@@ -45,8 +45,11 @@ class MainWindow   : public DocumentWindow
 public:
 
     /** Initializes the MainWindow, creates the AudioComponent, ProcessorGraph,
-        and UIComponent, and sets the window boundaries. */
-    MainWindow();
+        and UIComponent, and sets the window boundaries.
+
+        A headless MainWindow is never placed on the desktop and doesn't load or
+        save any window or signal chain state (used by the benchmark mode). */
+    MainWindow(bool isHeadless = false);
 
     /** Destroys the AudioComponent, ProcessorGraph, and UIComponent, and saves the window boundaries. */
     ~MainWindow();
@@ -62,6 +65,9 @@ public:
     /** Determines whether the last used configuration reloads upon startup. */
     bool shouldReloadOnStartup;
 
+    /** True if the window was created without being shown. */
+    const bool isHeadless;
+
 private:
 
     /** Saves the MainWindow's boundaries into the file "windowState.xml", located in the directory
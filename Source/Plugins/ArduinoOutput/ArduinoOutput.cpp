@@ -27,12 +27,16 @@
 #include <stdio.h>
 
 ArduinoOutput::ArduinoOutput()
-	: GenericProcessor("Arduino Output"), outputChannel(13), inputChannel(-1), state(true), acquisitionIsActive(false), deviceSelected(false)
+	: GenericProcessor("Arduino Output"), outputChannel(13), inputChannel(-1), state(true), useClosedLoopLane(false), acquisitionIsActive(false), deviceSelected(false)
 {
+    dispatcher = new OutputDispatcher("Arduino", this);
 }
 
 ArduinoOutput::~ArduinoOutput()
 {
+    // stop sending before disconnecting
+    dispatcher = nullptr;
+
 	if (arduino.isInitialized())
 		arduino.disconnect();
 }
@@ -51,6 +55,10 @@ void ArduinoOutput::setDevice(String devName)
 
         Time timer;
 
+        // don't talk to the old device while reconnecting
+        dispatcher->waitUntilSent(500);
+        dispatcher->resetDeviceState();
+
         arduino.connect(devName.toStdString());
 
         if (arduino.isArduinoReady())
@@ -116,31 +124,58 @@ void ArduinoOutput::handleEvent(int eventType, MidiMessage& event, int sampleNum
             }
         }
 
-        if (state)
+        // triggers already arrived through the closed-loop lane
+        if (!useClosedLoopLane)
+            handleTrigger(eventChannel, eventId);
+
+        //ArduinoOutputEditor* ed = (ArduinoOutputEditor*) getEditor();
+        //ed->receivedEvent();
+    }
+
+}
+
+void ArduinoOutput::closedLoopTriggerReceived(const ClosedLoopTrigger& trigger)
+{
+    if (trigger.eventType == TTL)
+        handleTrigger(trigger.channel, trigger.state);
+}
+
+void ArduinoOutput::handleTrigger(int eventChannel, int eventId)
+{
+    if (state)
+    {
+        if (inputChannel == -1 || eventChannel == inputChannel)
         {
-            if (inputChannel == -1 || eventChannel == inputChannel)
+            if (eventId == 0)
             {
-                if (eventId == 0)
-                {
-                    arduino.sendDigital(outputChannel, ARD_LOW);
-                }
-                else
-                {
-                    arduino.sendDigital(outputChannel, ARD_HIGH);
-                }
+                dispatcher->queueCommand(outputChannel, ARD_LOW);
+            }
+            else
+            {
+                dispatcher->queueCommand(outputChannel, ARD_HIGH);
             }
         }
-
-        //ArduinoOutputEditor* ed = (ArduinoOutputEditor*) getEditor();
-        //ed->receivedEvent();
     }
+}
+
+bool ArduinoOutput::sendOutputCommand(const OutputCommand& command)
+{
+    if (!arduino.isInitialized())
+        return false;
 
+    arduino.sendDigital(command.target, command.value);
+    return true;
+}
+
+OutputDispatcher* ArduinoOutput::getOutputDispatcher()
+{
+    return dispatcher;
 }
 
 void ArduinoOutput::setParameter(int parameterIndex, float newValue)
 {
     // make sure current output channel is off:
-    arduino.sendDigital(outputChannel, ARD_LOW);
+    dispatcher->queueCommand(outputChannel, ARD_LOW);
 
     if (parameterIndex == 0)
     {
@@ -155,6 +190,9 @@ void ArduinoOutput::setParameter(int parameterIndex, float newValue)
             state = true;
         else
             state = false;
+    } else if (parameterIndex == 3)
+    {
+        useClosedLoopLane = (newValue > 0);
     }
 }
 
@@ -173,15 +211,37 @@ void ArduinoOutput::setGateChannel(int chan)
     setParameter(2, chan-1);
 }
 
+void ArduinoOutput::setUseClosedLoopLane(bool use)
+{
+    if (!acquisitionIsActive)
+        setParameter(3, use ? 1.0f : 0.0f);
+    else
+        CoreServices::sendStatusMessage("Cannot change trigger source while acquisition is active.");
+}
+
+bool ArduinoOutput::getUseClosedLoopLane()
+{
+    return useClosedLoopLane;
+}
+
 bool ArduinoOutput::enable()
 {
     acquisitionIsActive = true;
-	return deviceSelected;
+
+    dispatcher->resetStatistics();
+
+    if (useClosedLoopLane && deviceSelected)
+        CoreServices::getClosedLoopLane()->addListener(this);
+
+    return deviceSelected;
 }
 
 bool ArduinoOutput::disable()
 {
-    arduino.sendDigital(outputChannel, ARD_LOW);
+    CoreServices::getClosedLoopLane()->removeListener(this);
+
+    dispatcher->queueCommand(outputChannel, ARD_LOW);
+    dispatcher->waitUntilSent(500);
     acquisitionIsActive = false;
 	return true;
 }
@@ -26,6 +26,7 @@
 
 #include <SerialLib.h>
 #include <ProcessorHeaders.h>
+#include <ClosedLoopLib.h>
 #include "serial/ofArduino.h"
 
 
@@ -38,11 +39,16 @@
 
 	Based on Open Frameworks ofArduino class.
 
+	Pin changes are sent by an OutputDispatcher on its own thread, so a slow
+	serial port never holds up the signal chain.
+
 	@see GenericProcessor
 
 */
 
-class ArduinoOutput : public GenericProcessor
+class ArduinoOutput : public GenericProcessor,
+                      public ClosedLoopLane::Listener,
+                      public OutputDispatcher::Device
 {
 public:
 
@@ -59,6 +65,15 @@ public:
     /** Convenient interface for responding to incoming events. */
     void handleEvent(int eventType, MidiMessage& event, int sampleNum);
 
+    /** Fires the output as soon as a detector publishes a trigger, when the
+    closed-loop lane is in use. Called on the lane thread. */
+    void closedLoopTriggerReceived(const ClosedLoopTrigger& trigger);
+
+    /** Writes a pin on the Arduino. Called on the dispatcher thread. */
+    bool sendOutputCommand(const OutputCommand& command);
+
+    OutputDispatcher* getOutputDispatcher();
+
     /** Called immediately prior to the start of data acquisition. */
     bool enable();
 
@@ -79,16 +94,28 @@ public:
     void setGateChannel(int);
     void setDevice(String deviceString);
 
+    /** When enabled, triggers are taken from the closed-loop lane instead of
+    the event buffer; gate events still arrive through the event buffer. */
+    void setUseClosedLoopLane(bool);
+    bool getUseClosedLoopLane();
+
     int outputChannel;
     int inputChannel;
     int gateChannel;
 
 private:
 
+    /** Sets the output according to a TTL on the given channel, if the gate is open. */
+    void handleTrigger(int eventChannel, int eventId);
+
     /** An open-frameworks Arduino object. */
     ofArduino arduino;
 
+    /** Sends pin changes to the Arduino; destroyed before it. */
+    ScopedPointer<OutputDispatcher> dispatcher;
+
     bool state;
+    bool useClosedLoopLane;
     bool acquisitionIsActive;
     bool deviceSelected;
 
@@ -96,6 +96,18 @@ ArduinoOutputEditor::ArduinoOutputEditor(GenericProcessor* parentNode, bool useD
     gateChannelSelector->setSelectedId(1, dontSendNotification);
     addAndMakeVisible(gateChannelSelector);
 
+    closedLoopButton = new UtilityButton("FAST", Font("Small Text", 10, Font::plain));
+    closedLoopButton->setRadius(3.0f);
+    closedLoopButton->setBounds(75,30,45,20);
+    closedLoopButton->addListener(this);
+    closedLoopButton->setClickingTogglesState(true);
+    closedLoopButton->setTooltip("Take triggers from the closed-loop lane, firing as soon as a detector publishes them");
+    addAndMakeVisible(closedLoopButton);
+
+    dispatcherMonitor = new OutputDispatcherMonitor(arduino->getOutputDispatcher());
+    dispatcherMonitor->setBounds(75,55,70,24);
+    addAndMakeVisible(dispatcherMonitor);
+
 }
 
 ArduinoOutputEditor::~ArduinoOutputEditor()
@@ -127,6 +139,15 @@ void ArduinoOutputEditor::comboBoxChanged(ComboBox* comboBoxThatHasChanged)
     }
 }
 
+void ArduinoOutputEditor::buttonEvent(Button* button)
+{
+    if (button == closedLoopButton)
+    {
+        arduino->setUseClosedLoopLane(button->getToggleState());
+        button->setToggleState(arduino->getUseClosedLoopLane(), dontSendNotification);
+    }
+}
+
 void ArduinoOutputEditor::timerCallback()
 {
 
@@ -52,6 +52,7 @@ public:
     ImageIcon* icon;
 
     void comboBoxChanged(ComboBox* comboBoxThatHasChanged);
+    void buttonEvent(Button* button);
 
     ArduinoOutput* arduino;
 
@@ -60,6 +61,8 @@ public:
 private:
 
    // ScopedPointer<UtilityButton> triggerButton;
+    ScopedPointer<UtilityButton> closedLoopButton;
+    ScopedPointer<OutputDispatcherMonitor> dispatcherMonitor;
     ScopedPointer<ComboBox> inputChannelSelector;
     ScopedPointer<ComboBox> outputChannelSelector;
     ScopedPointer<ComboBox> gateChannelSelector;
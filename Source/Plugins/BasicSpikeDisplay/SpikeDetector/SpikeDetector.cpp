@@ -22,13 +22,21 @@
 */
 
 #include <stdio.h>
+#include <algorithm>
 #include "SpikeDetector.h"
 
+// number of samples per block used for the MAD noise estimate
+#define NOISE_ESTIMATE_SAMPLES 256
+
+// time constant of the running noise estimate, in seconds
+#define NOISE_TIME_CONSTANT 2.0f
+
 SpikeDetector::SpikeDetector()
     : GenericProcessor("Spike Detector"),
       overflowBuffer(2,100), dataBuffer(nullptr),
-      overflowBufferSize(100), currentElectrode(-1),
-      uniqueID(0)
+      overflowBufferSize(100), contextChannels(0), contextSamples(0),
+      numOverflowChannels(0), thresholdType(FIXED_THRESHOLD), thresholdMultiplier(4.0f),
+      currentElectrode(-1), uniqueID(0)
 {
     //// the standard form:
     electrodeTypes.add("single electrode");
@@ -62,8 +70,7 @@ SpikeDetector::SpikeDetector()
         electrodeCounter.add(0);
     }
 
-    //spikeBuffer = new uint8_t[MAX_SPIKE_BUFFER_LEN]; // MAX_SPIKE_BUFFER_LEN defined in SpikeObject.h
-	spikeBuffer.malloc(MAX_SPIKE_BUFFER_LEN);
+    noiseScratch.malloc(NOISE_ESTIMATE_SAMPLES);
 
 }
 
@@ -83,7 +90,13 @@ void SpikeDetector::updateSettings()
 {
 
     if (getNumInputs() > 0)
+    {
         overflowBuffer.setSize(getNumInputs(), overflowBufferSize);
+        overflowBuffer.clear();
+    }
+
+    numOverflowChannels = overflowBuffer.getNumChannels();
+    overflowChannelUpdated.calloc(numOverflowChannels);
 
     for (int i = 0; i < electrodes.size(); i++)
     {
@@ -146,6 +159,7 @@ bool SpikeDetector::addElectrode(int nChans, int electrodeID)
     newElectrode->thresholds.malloc(nChans);
     newElectrode->isActive.malloc(nChans);
     newElectrode->channels.malloc(nChans);
+    newElectrode->noiseLevels.malloc(nChans);
     newElectrode->isMonitored = false;
 
     for (int i = 0; i < nChans; i++)
@@ -194,6 +208,9 @@ StringArray SpikeDetector::getElectrodeNames()
 void SpikeDetector::resetElectrode(SimpleElectrode* e)
 {
     e->lastBufferIndex = 0;
+
+    for (int i = 0; i < e->numChannels; i++)
+        *(e->noiseLevels+i) = -1.0f;
 }
 
 bool SpikeDetector::removeElectrode(int index)
@@ -291,6 +308,26 @@ double SpikeDetector::getChannelThreshold(int electrodeNum, int channelNum)
     return *(electrodes[electrodeNum]->thresholds+channelNum);
 }
 
+void SpikeDetector::setThresholdType(ThresholdType type)
+{
+    thresholdType = type;
+}
+
+SpikeDetector::ThresholdType SpikeDetector::getThresholdType()
+{
+    return thresholdType;
+}
+
+void SpikeDetector::setThresholdMultiplier(float multiplier)
+{
+    thresholdMultiplier = multiplier;
+}
+
+float SpikeDetector::getThresholdMultiplier()
+{
+    return thresholdMultiplier;
+}
+
 void SpikeDetector::setParameter(int parameterIndex, float newValue)
 {
     //editor->updateParameterButtons(parameterIndex);
@@ -314,11 +351,13 @@ bool SpikeDetector::enable()
 
     sampleRateForElectrode = (uint16_t) getSampleRate();
 
+    allocateContext();
+    overflowBuffer.clear();
 
-    useOverflowBuffer.clear();
-
-    for (int i = 0; i < electrodes.size(); i++)
-        useOverflowBuffer.add(false);
+    for (int n = 0; n < electrodes.size(); n++)
+    {
+        resetElectrode(electrodes[n]);
+    }
 
     return true;
 }
@@ -334,93 +373,39 @@ bool SpikeDetector::disable()
     return true;
 }
 
-void SpikeDetector::addSpikeEvent(SpikeObject* s, MidiBuffer& eventBuffer, int peakIndex)
-{
-
-    // std::cout << "Adding spike event for index " << peakIndex << std::endl;
-
-    s->eventType = SPIKE_EVENT_CODE;
-
-    int numBytes = packSpike(s,                        // SpikeObject
-                             spikeBuffer,              // uint8_t*
-                             MAX_SPIKE_BUFFER_LEN);    // int
-
-    if (numBytes > 0)
-        eventBuffer.addEvent(spikeBuffer, numBytes, peakIndex);
-
-    //std::cout << "Adding spike" << std::endl;
-}
-
-void SpikeDetector::addWaveformToSpikeObject(SpikeObject* s,
-                                             int& peakIndex,
-                                             int& electrodeNumber,
-                                             int& currentChannel)
+void SpikeDetector::allocateContext()
 {
-    int spikeLength = electrodes[electrodeNumber]->prePeakSamples +
-                      + electrodes[electrodeNumber]->postPeakSamples;
-
-//    uint8_t     eventType;
-//    int64_t    timestamp;
-//    int64_t    timestamp_software;
-//    uint16_t    source; // used internally, the index of the electrode in the electrode array
-//    uint16_t    nChannels;
-//    uint16_t    nSamples;
-//    uint16_t    sortedId;   // sorted unit ID (or 0 if unsorted)
-//    uint16_t    electrodeID; // unique electrode ID (regardless electrode position in the array)
-//    uint16_t    channel; // the channel in which threshold crossing was detected (index in channel array, not absolute channel number).
-//    uint8_t     color[3];
-//    float       pcProj[2];
-//    uint16_t    samplingFrequencyHz;
-//    uint16_t    data[MAX_NUMBER_OF_SPIKE_CHANNELS* MAX_NUMBER_OF_SPIKE_CHANNEL_SAMPLES];
-//    float       gain[MAX_NUMBER_OF_SPIKE_CHANNELS];
-//    uint16_t    threshold[MAX_NUMBER_OF_SPIKE_CHANNELS];
-    
-    s->timestamp = getTimestamp(currentChannel) + peakIndex;
-
-    s->nSamples = spikeLength;
+    int maxChannels = 1;
+    int maxPostPeakSamples = 0;
+    int maxContextSamples = 0;
 
-    int chan = *(electrodes[electrodeNumber]->channels+currentChannel);
-
-    s->gain[currentChannel] = (int)(1.0f / channels[chan]->bitVolts)*1000;
-    s->threshold[currentChannel] = (int) *(electrodes[electrodeNumber]->thresholds+currentChannel); // / channels[chan]->bitVolts * 1000;
-
-    // cycle through buffer
-
-    if (isChannelActive(electrodeNumber, currentChannel))
+    for (int i = 0; i < electrodes.size(); i++)
     {
-
-        for (int sample = 0; sample < spikeLength; sample++)
-        {
-
-            // warning -- be careful of bitvolts conversion
-            s->data[currentIndex] = uint16(getNextSample(*(electrodes[electrodeNumber]->channels+currentChannel)) / channels[chan]->bitVolts + 32768);
-
-            currentIndex++;
-            sampleIndex++;
-
-            //std::cout << currentIndex << std::endl;
-
-        }
+        maxChannels = jmax(maxChannels, electrodes[i]->numChannels);
+        maxPostPeakSamples = jmax(maxPostPeakSamples, electrodes[i]->postPeakSamples);
+        maxContextSamples = jmax(maxContextSamples,
+                                 electrodes[i]->prePeakSamples + 2*electrodes[i]->postPeakSamples + 2);
     }
-    else
-    {
-        for (int sample = 0; sample < spikeLength; sample++)
-        {
-
-            // insert a blank spike if the
-            s->data[currentIndex] = 0;
-            currentIndex++;
-            sampleIndex++;
 
-            //std::cout << currentIndex << std::endl;
+    // crossings are only searched while the whole context after them is in
+    // the buffer, so the overflow has to hold twice that
+    const int requiredOverflow = jmax(100, 2 * (2*maxPostPeakSamples + 2));
 
-        }
+    if (requiredOverflow != overflowBufferSize)
+    {
+        overflowBufferSize = requiredOverflow;
+        overflowBuffer.setSize(jmax(1, getNumInputs()), overflowBufferSize);
     }
 
+    if (maxChannels > contextChannels || maxContextSamples > contextSamples)
+    {
+        contextChannels = jmax(contextChannels, maxChannels);
+        contextSamples = jmax(contextSamples, maxContextSamples);
 
-    sampleIndex -= spikeLength; // reset sample index
-
-
+        contextBuffer.malloc(contextChannels * contextSamples);
+        channelThresholds.malloc(contextChannels);
+        nextCrossing.malloc(contextChannels);
+    }
 }
 
 void SpikeDetector::handleEvent(int eventType, MidiMessage& event, int sampleNum)
@@ -446,236 +431,336 @@ void SpikeDetector::process(AudioSampleBuffer& buffer,
 
     checkForEvents(events); // need to find any timestamp events before extracting spikes
 
-    //std::cout << dataBuffer.getMagnitude(0,nSamples) << std::endl;
+    // the spikes sent in the previous block have been handled by now
+    spikePool.clear();
+
+    float* thresholds = channelThresholds;
 
     for (int i = 0; i < electrodes.size(); i++)
     {
 
-        //  std::cout << "ELECTRODE " << i << std::endl;
-
         electrode = electrodes[i];
 
-        // refresh buffer index for this electrode
-        sampleIndex = electrode->lastBufferIndex - 1; // subtract 1 to account for
-        // increment at start of getNextSample()
+        const int numChannels = electrode->numChannels;
+        const int prePeakSamples = electrode->prePeakSamples;
+        const int postPeakSamples = electrode->postPeakSamples;
+        const int spikeLength = prePeakSamples + postPeakSamples;
+
+        // electrodes changed since acquisition started may not fit the buffers
+        if (numChannels > contextChannels
+            || prePeakSamples + 2*postPeakSamples + 2 > contextSamples
+            || 2*postPeakSamples + 2 > overflowBufferSize/2)
+            continue;
 
         int nSamples = getNumSamples(*electrode->channels);
 
-        // cycle through samples
-        while (samplesAvailable(nSamples))
+        // leave enough samples at the end of the buffer to find the peak and
+        // waveform; crossings after this are found in the next buffer
+        const int scanEnd = nSamples - overflowBufferSize/2 + 1;
+
+        // next sample to check, relative to the start of this buffer
+        int sampleIndex = jmax(electrode->lastBufferIndex, -overflowBufferSize);
+
+        for (int chan = 0; chan < numChannels; chan++)
+        {
+            if (thresholdType != FIXED_THRESHOLD && *(electrode->isActive+chan))
+            {
+                updateNoiseLevel(electrode, chan, nSamples);
+                thresholds[chan] = thresholdMultiplier * *(electrode->noiseLevels+chan);
+            }
+            else
+            {
+                thresholds[chan] = (float) *(electrode->thresholds+chan);
+            }
+
+            nextCrossing[chan] = sampleIndex - 1; // not searched yet
+        }
+
+        while (sampleIndex < scanEnd)
         {
+            // find the earliest crossing on any channel; crossings found on a channel
+            // are kept until the electrode has advanced past them
+            int triggerIndex = scanEnd;
+            int triggerChannel = -1;
 
-            sampleIndex++;
-            // cycle through channels
-            for (int chan = 0; chan < electrode->numChannels; chan++)
+            for (int chan = 0; chan < numChannels; chan++)
             {
-                // std::cout << "  channel " << chan << std::endl;
-                if (*(electrode->isActive+chan))
+                if (!*(electrode->isActive+chan))
+                    continue;
+
+                if (nextCrossing[chan] < sampleIndex)
+                    nextCrossing[chan] = findThresholdCrossing(*(electrode->channels+chan),
+                                                               sampleIndex, scanEnd, thresholds[chan]);
+
+                if (nextCrossing[chan] < triggerIndex)
                 {
-                    int currentChannel = *(electrode->channels+chan);
+                    triggerIndex = nextCrossing[chan];
+                    triggerChannel = chan;
+                }
+            }
 
-                    if (-getNextSample(currentChannel) > *(electrode->thresholds+chan)) // trigger spike
-                    {
-                        //std::cout << "Spike detected on electrode " << i << std::endl;
-                        // find the peak
-                        int peakIndex = sampleIndex;
-
-                        while (-getCurrentSample(currentChannel) <
-                               -getNextSample(currentChannel) &&
-                               sampleIndex < peakIndex + electrode->postPeakSamples)
-                        {
-                            sampleIndex++;
-                        }
-
-                        peakIndex = sampleIndex;
-                        sampleIndex -= (electrode->prePeakSamples+1);
-                        
-//                        uint8_t     eventType;
-//                        int64_t    timestamp;
-//                        int64_t    timestamp_software;
-//                        uint16_t    source; // used internally, the index of the electrode in the electrode array
-//                        uint16_t    nChannels;
-//                        uint16_t    nSamples;
-//                        uint16_t    sortedId;   // sorted unit ID (or 0 if unsorted)
-//                        uint16_t    electrodeID; // unique electrode ID (regardless electrode position in the array)
-//                        uint16_t    channel; // the channel in which threshold crossing was detected (index in channel array, not absolute channel number).
-//                        uint8_t     color[3];
-//                        float       pcProj[2];
-//                        uint16_t    samplingFrequencyHz;
-//                        uint16_t    data[MAX_NUMBER_OF_SPIKE_CHANNELS* MAX_NUMBER_OF_SPIKE_CHANNEL_SAMPLES];
-//                        float       gain[MAX_NUMBER_OF_SPIKE_CHANNELS];
-//                        uint16_t    threshold[MAX_NUMBER_OF_SPIKE_CHANNELS];
-
-                        SpikeObject newSpike;
-                        newSpike.timestamp = 0; //getTimestamp(currentChannel) + peakIndex;
-                        newSpike.timestamp_software = -1;
-                        newSpike.source = i;
-                        newSpike.nChannels = electrode->numChannels;
-                        newSpike.sortedId = 0;
-                        newSpike.electrodeID = electrode->electrodeID;
-                        newSpike.channel = 0;
-                        newSpike.samplingFrequencyHz = sampleRateForElectrode;
-
-                        currentIndex = 0;
-
-                        // package spikes;
-                        for (int channel = 0; channel < electrode->numChannels; channel++)
-                        {
-
-                            addWaveformToSpikeObject(&newSpike,
-                                                     peakIndex,
-                                                     i,
-                                                     channel);
-
-                            // if (*(electrode->isActive+currentChannel))
-                            // {
-
-                            //     createSpikeEvent(peakIndex,       // peak index
-                            //                      i,               // electrodeNumber
-                            //                      currentChannel,  // channel number
-                            //                      events);         // event buffer
-
-
-                            // } // end if channel is active
-
-                        }
-
-                        //for (int xxx = 0; xxx < 1000; xxx++) // overload with spikes for testing purposes
-                        addSpikeEvent(&newSpike, events, peakIndex);
-
-                        // advance the sample index
-                        sampleIndex = peakIndex + electrode->postPeakSamples;
-
-                        break; // quit spike "for" loop
-                    } // end spike trigger
-
-                } // end if channel is active
-            } // end cycle through channels on electrode
+            if (triggerChannel < 0)
+            {
+                sampleIndex = scanEnd;
+                break;
+            }
 
-        } // end cycle through samples
+            // gather the samples around the crossing for every channel
+            const int contextStart = triggerIndex - prePeakSamples - 1;
+            const int contextLength = prePeakSamples + 2*postPeakSamples + 2;
 
-        electrode->lastBufferIndex = sampleIndex - nSamples; // should be negative
+            for (int chan = 0; chan < numChannels; chan++)
+            {
+                copySampleContext(*(electrode->channels+chan), contextStart, contextLength,
+                                  nSamples, contextBuffer + chan*contextLength);
+            }
 
-        //jassert(electrode->lastBufferIndex < 0);
+            // find the peak
+            const float* context = contextBuffer + triggerChannel*contextLength;
+            int peakIndex = triggerIndex;
 
-        if (nSamples > overflowBufferSize)
-        {
+            while (-context[peakIndex - 1 - contextStart] < -context[peakIndex - contextStart] &&
+                   peakIndex < triggerIndex + postPeakSamples)
+            {
+                peakIndex++;
+            }
+
+            SpikeRecord* newSpike = spikePool.allocate(numChannels, spikeLength);
 
-            for (int j = 0; j < electrode->numChannels; j++)
+            if (newSpike == nullptr) // the pool is full for this block
             {
+                sampleIndex = peakIndex + postPeakSamples + 1;
+                continue;
+            }
 
-                overflowBuffer.copyFrom(*electrode->channels+j, 0,
-                                        buffer, *electrode->channels+j,
-                                        nSamples-overflowBufferSize,
-                                        overflowBufferSize);
-                
+            newSpike->eventType = SPIKE_EVENT_CODE;
+            newSpike->timestamp = getTimestamp(*electrode->channels) + peakIndex;
+            newSpike->timestamp_software = -1;
+            newSpike->source = i;
+            newSpike->sortedId = 0;
+            newSpike->electrodeID = electrode->electrodeID;
+            newSpike->channel = 0;
+            newSpike->samplingFrequencyHz = sampleRateForElectrode;
+            newSpike->color[0] = newSpike->color[1] = newSpike->color[2] = 0;
+            newSpike->pcProj[0] = newSpike->pcProj[1] = 0;
+
+            // fill in the waveforms
+            const int waveformStart = peakIndex - prePeakSamples - 1 - contextStart;
+
+            for (int chan = 0; chan < numChannels; chan++)
+            {
+                const Channel* ch = channels[*(electrode->channels+chan)];
+                uint16* data = newSpike->getData() + chan*spikeLength;
+
+                newSpike->getGains()[chan] = (int)(1.0f / ch->bitVolts)*1000;
+                newSpike->getThresholds()[chan] = (int) thresholds[chan];
+
+                if (*(electrode->isActive+chan))
+                {
+                    // warning -- be careful of bitvolts conversion
+                    const float* waveform = contextBuffer + chan*contextLength + waveformStart;
+                    const float scale = 1.0f / ch->bitVolts;
+
+                    for (int sample = 0; sample < spikeLength; sample++)
+                        data[sample] = uint16(waveform[sample] * scale + 32768);
+                }
+                else
+                {
+                    // insert a blank spike
+                    memset(data, 0, spikeLength * sizeof(uint16));
+                }
             }
 
-            useOverflowBuffer.set(i, true);
+            spikePool.addSpikeEvent(newSpike, events, peakIndex);
 
-        }
-        else
-        {
-            useOverflowBuffer.set(i, false);
-        }
+            // advance the sample index
+            sampleIndex = peakIndex + postPeakSamples + 1;
+
+        } // end cycle through samples
+
+        electrode->lastBufferIndex = sampleIndex - nSamples; // should be negative
 
     } // end cycle through electrodes
 
     // copy end of this buffer into the overflow buffer
+    updateOverflowBuffer();
 
-    //std::cout << "Copying buffer" << std::endl;
-    // std::cout << "nSamples: " << nSamples;
-    //std::cout << "overflowBufferSize:" << overflowBufferSize;
+}
 
-    //std::cout << "sourceStartSample = " << nSamples-overflowBufferSize << std::endl;
-    // std::cout << "numSamples = " << overflowBufferSize << std::endl;
-    // std::cout << "buffer size = " << buffer.getNumSamples() << std::endl;
+int SpikeDetector::findThresholdCrossing(int chan, int startIndex, int endIndex, float threshold)
+{
+    const float level = -threshold;
+    int index = startIndex;
 
-    
+    // end of the previous buffer
+    if (index < 0)
+    {
+        const float* overflow = overflowBuffer.getReadPointer(chan);
 
+        for (; index < jmin(endIndex, 0); index++)
+        {
+            if (index >= -overflowBufferSize && overflow[overflowBufferSize + index] < level)
+                return index;
+        }
+    }
 
+    const float* data = dataBuffer->getReadPointer(chan);
+    const int bufferEnd = jmin(endIndex, dataBuffer->getNumSamples());
 
-}
+    // test 16 samples at a time without branching, which the compiler turns
+    // into SIMD comparisons; only the first block with a crossing is searched
+    while (index + 16 <= bufferEnd)
+    {
+        int anyCrossing = 0;
 
-float SpikeDetector::getNextSample(int& chan)
-{
+        for (int k = 0; k < 16; k++)
+            anyCrossing |= (data[index + k] < level);
 
+        if (anyCrossing)
+            break;
 
+        index += 16;
+    }
 
-    //if (useOverflowBuffer)
-    //{
-    if (sampleIndex < 0)
+    for (; index < bufferEnd; index++)
     {
-        // std::cout << "  sample index " << sampleIndex << "from overflowBuffer" << std::endl;
-        int ind = overflowBufferSize + sampleIndex;
+        if (data[index] < level)
+            return index;
+    }
 
-        if (ind < overflowBuffer.getNumSamples())
-            return *overflowBuffer.getWritePointer(chan, ind);
-        else
-            return 0;
+    return endIndex;
+}
+
+void SpikeDetector::copySampleContext(int chan, int firstIndex, int numSamples, int nSamples, float* dest)
+{
+    const int lastIndex = firstIndex + numSamples;
+    const int bufferEnd = jmin(nSamples, dataBuffer->getNumSamples());
+
+    int index = firstIndex;
 
+    if (index < -overflowBufferSize)
+    {
+        const int n = jmin(lastIndex, -overflowBufferSize) - index;
+        FloatVectorOperations::clear(dest, n);
+        dest += n;
+        index += n;
     }
-    else
+
+    if (index < 0 && index < lastIndex)
     {
-        //  useOverflowBuffer = false;
-        // std::cout << "  sample index " << sampleIndex << "from regular buffer" << std::endl;
+        const int n = jmin(lastIndex, 0) - index;
+        FloatVectorOperations::copy(dest, overflowBuffer.getReadPointer(chan, overflowBufferSize + index), n);
+        dest += n;
+        index += n;
+    }
 
-        if (sampleIndex < dataBuffer->getNumSamples())
-            return *dataBuffer->getWritePointer(chan, sampleIndex);
-        else
-            return 0;
+    if (index < bufferEnd && index < lastIndex)
+    {
+        const int n = jmin(lastIndex, bufferEnd) - index;
+        FloatVectorOperations::copy(dest, dataBuffer->getReadPointer(chan, index), n);
+        dest += n;
+        index += n;
     }
-    //} else {
-    //    std::cout << "  sample index " << sampleIndex << "from regular buffer" << std::endl;
-    //     return *dataBuffer.getWritePointer(chan, sampleIndex);
-    //}
 
+    if (index < lastIndex)
+        FloatVectorOperations::clear(dest, lastIndex - index);
 }
 
-float SpikeDetector::getCurrentSample(int& chan)
+void SpikeDetector::updateNoiseLevel(SimpleElectrode* e, int channelIndex, int nSamples)
 {
+    const int n = jmin(nSamples, dataBuffer->getNumSamples());
 
-    // if (useOverflowBuffer)
-    // {
-    //     return *overflowBuffer.getWritePointer(chan, overflowBufferSize + sampleIndex - 1);
-    // } else {
-    //     return *dataBuffer.getWritePointer(chan, sampleIndex - 1);
-    // }
+    if (n <= 0)
+        return;
 
-    if (sampleIndex < 1)
+    const float* data = dataBuffer->getReadPointer(*(e->channels+channelIndex));
+    float noise;
+
+    if (thresholdType == RMS_THRESHOLD)
     {
-        //std::cout << "  sample index " << sampleIndex << "from overflowBuffer" << std::endl;
-        return *overflowBuffer.getWritePointer(chan, overflowBufferSize + sampleIndex - 1);
+        float sumOfSquares = 0.0f;
+
+        for (int i = 0; i < n; i++)
+            sumOfSquares += data[i] * data[i];
+
+        noise = std::sqrt(sumOfSquares / n);
     }
     else
     {
-        //  useOverflowBuffer = false;
-        // std::cout << "  sample index " << sampleIndex << "from regular buffer" << std::endl;
-        return *dataBuffer->getWritePointer(chan, sampleIndex - 1);
-    }
-    //} else {
+        // median(|x|) / 0.6745 estimates the standard deviation without being
+        // pulled up by the spikes themselves
+        const int stride = jmax(1, n / NOISE_ESTIMATE_SAMPLES);
+        int numValues = 0;
 
-}
+        for (int i = 0; i < n && numValues < NOISE_ESTIMATE_SAMPLES; i += stride)
+            noiseScratch[numValues++] = std::abs(data[i]);
 
+        std::nth_element(noiseScratch.getData(), noiseScratch + numValues/2, noiseScratch + numValues);
 
-bool SpikeDetector::samplesAvailable(int nSamples)
-{
+        noise = noiseScratch[numValues/2] / 0.6745f;
+    }
 
-    if (sampleIndex > nSamples - overflowBufferSize/2)
+    float& level = *(e->noiseLevels+channelIndex);
+
+    if (level < 0)
     {
-        return false;
+        level = noise;
     }
     else
     {
-        return true;
+        const float alpha = 1.0f - std::exp(-float(n) / (NOISE_TIME_CONSTANT * jmax(1.0f, float(sampleRateForElectrode))));
+        level += alpha * (noise - level);
     }
+}
+
+void SpikeDetector::updateOverflowBuffer()
+{
+    for (int ch = 0; ch < numOverflowChannels; ch++)
+        overflowChannelUpdated[ch] = false;
 
+    for (int i = 0; i < electrodes.size(); i++)
+    {
+        SimpleElectrode* electrode = electrodes[i];
+
+        for (int j = 0; j < electrode->numChannels; j++)
+        {
+            const int chan = *(electrode->channels+j);
+
+            if (chan < 0 || chan >= numOverflowChannels || chan >= dataBuffer->getNumChannels()
+                || overflowChannelUpdated[chan])
+                continue;
+
+            overflowChannelUpdated[chan] = true;
+
+            const int nSamples = jmin(getNumSamples(chan), dataBuffer->getNumSamples());
+
+            if (nSamples >= overflowBufferSize)
+            {
+                overflowBuffer.copyFrom(chan, 0,
+                                        *dataBuffer, chan,
+                                        nSamples-overflowBufferSize,
+                                        overflowBufferSize);
+            }
+            else if (nSamples > 0)
+            {
+                // short buffer: shift the older samples down and append the new ones
+                float* overflow = overflowBuffer.getWritePointer(chan);
+
+                memmove(overflow, overflow + nSamples, (overflowBufferSize - nSamples) * sizeof(float));
+                memcpy(overflow + overflowBufferSize - nSamples, dataBuffer->getReadPointer(chan), nSamples * sizeof(float));
+            }
+        }
+    }
 }
 
 
 void SpikeDetector::saveCustomParametersToXml(XmlElement* parentElement)
 {
 
+    XmlElement* thresholdNode = parentElement->createNewChildElement("THRESHOLDS");
+    thresholdNode->setAttribute("type", (int) thresholdType);
+    thresholdNode->setAttribute("multiplier", thresholdMultiplier);
+
     for (int i = 0; i < electrodes.size(); i++)
     {
         XmlElement* electrodeNode = parentElement->createNewChildElement("ELECTRODE");
@@ -712,7 +797,12 @@ void SpikeDetector::loadCustomParametersFromXml()
 
         forEachXmlChildElement(*parametersAsXml, xmlNode)
         {
-            if (xmlNode->hasTagName("ELECTRODE"))
+            if (xmlNode->hasTagName("THRESHOLDS"))
+            {
+                setThresholdType((ThresholdType) jlimit(0, 2, xmlNode->getIntAttribute("type", FIXED_THRESHOLD)));
+                setThresholdMultiplier((float) xmlNode->getDoubleAttribute("multiplier", 4.0));
+            }
+            else if (xmlNode->hasTagName("ELECTRODE"))
             {
 
                 electrodeIndex++;
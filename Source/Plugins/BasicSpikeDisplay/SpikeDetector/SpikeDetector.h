@@ -45,6 +45,10 @@ struct SimpleElectrode
     HeapBlock<double> thresholds;
     HeapBlock<bool> isActive;
 
+    /** Running noise estimate of every channel, used by the adaptive thresholds
+        (negative until the first block has been seen). */
+    HeapBlock<float> noiseLevels;
+
 };
 
 class SpikeDetectorEditor;
@@ -53,6 +57,13 @@ class SpikeDetectorEditor;
 
   Detects spikes in a continuous signal and outputs events containing the spike data.
 
+  Each channel is scanned a whole block at a time for threshold crossings. Peaks and
+  waveforms are only resolved at the crossings, from a small contiguous copy of the
+  samples around them that spans the previous block where needed.
+
+  Thresholds are either fixed, or a multiple of a running RMS or median absolute
+  deviation (MAD) noise estimate that is updated once per block.
+
   @see GenericProcessor, SpikeDetectorEditor
 
 */
@@ -151,6 +162,21 @@ public:
 
     double getChannelThreshold(int electrodeNum, int channelNum);
 
+    enum ThresholdType
+    {
+        FIXED_THRESHOLD = 0,
+        RMS_THRESHOLD,
+        MAD_THRESHOLD
+    };
+
+    /** Selects fixed or adaptive thresholds for all electrodes. */
+    void setThresholdType(ThresholdType type);
+    ThresholdType getThresholdType();
+
+    /** Sets the number of noise standard deviations used by the adaptive thresholds. */
+    void setThresholdMultiplier(float multiplier);
+    float getThresholdMultiplier();
+
     void saveCustomParametersToXml(XmlElement* parentElement);
     void loadCustomParametersFromXml();
 
@@ -162,22 +188,52 @@ private:
 
     int overflowBufferSize;
 
-    int sampleIndex;
-
     Array<int> electrodeCounter;
 
-    float getNextSample(int& chan);
-    float getCurrentSample(int& chan);
-    bool samplesAvailable(int nSamples);
+    /** Returns the first sample index in [startIndex, endIndex) at which the
+        channel goes below -threshold, or endIndex if it doesn't. Negative
+        indices refer to the end of the previous buffer. */
+    int findThresholdCrossing(int chan, int startIndex, int endIndex, float threshold);
+
+    /** Copies numSamples samples of a channel, starting at firstIndex, into dest.
+        Negative indices are read from the overflow buffer and samples that
+        aren't available are set to zero. */
+    void copySampleContext(int chan, int firstIndex, int numSamples, int nSamples, float* dest);
 
-    Array<bool> useOverflowBuffer;
+    /** Updates the noise estimate of one channel of an electrode from the current buffer. */
+    void updateNoiseLevel(SimpleElectrode* e, int channelIndex, int nSamples);
+
+    /** Keeps the last overflowBufferSize samples of every channel used by an electrode. */
+    void updateOverflowBuffer();
+
+    /** Sizes the context and overflow buffers for the largest electrode. */
+    void allocateContext();
+
+    /** Contiguous samples around a threshold crossing, for every channel of an electrode. */
+    HeapBlock<float> contextBuffer;
+    int contextChannels;
+    int contextSamples;
+
+    /** Per-channel thresholds and pending crossings of the current electrode. */
+    HeapBlock<float> channelThresholds;
+    HeapBlock<int> nextCrossing;
+
+    /** Scratch space for the MAD noise estimate. */
+    HeapBlock<float> noiseScratch;
+
+    /** Marks the channels already copied to the overflow buffer in this block. */
+    HeapBlock<bool> overflowChannelUpdated;
+    int numOverflowChannels;
+
+    ThresholdType thresholdType;
+    float thresholdMultiplier;
 
     int currentElectrode;
     int currentChannelIndex;
-    int currentIndex;
 
-   // uint8_t* spikeBuffer;///[256];
-	HeapBlock<uint8_t> spikeBuffer;
+    /** Holds the spikes detected in the current block; downstream processors
+        read them in place through their SPIKE events. */
+    SpikePool spikePool;
     int64 timestamp;
 
     OwnedArray<SimpleElectrode> electrodes;
@@ -190,12 +246,6 @@ private:
 
     void handleEvent(int eventType, MidiMessage& event, int sampleNum);
 
-    void addSpikeEvent(SpikeObject* s, MidiBuffer& eventBuffer, int peakIndex);
-    void addWaveformToSpikeObject(SpikeObject* s,
-                                  int& peakIndex,
-                                  int& electrodeNumber,
-                                  int& currentChannel);
-
     void resetElectrode(SimpleElectrode*);
     
     uint16_t sampleRateForElectrode;
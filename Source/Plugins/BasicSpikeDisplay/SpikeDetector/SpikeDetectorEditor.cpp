@@ -63,6 +63,18 @@ SpikeDetectorEditor::SpikeDetectorEditor(GenericProcessor* parentNode, bool useD
     electrodeList->setBounds(15,75,115,20);
     addAndMakeVisible(electrodeList);
 
+    thresholdTypeSelector = new ComboBox("Threshold Type");
+    thresholdTypeSelector->addItem("Fixed", SpikeDetector::FIXED_THRESHOLD + 1);
+    thresholdTypeSelector->addItem("RMS", SpikeDetector::RMS_THRESHOLD + 1);
+    thresholdTypeSelector->addItem("MAD", SpikeDetector::MAD_THRESHOLD + 1);
+    thresholdTypeSelector->setEditableText(false);
+    thresholdTypeSelector->setJustificationType(Justification::centredLeft);
+    thresholdTypeSelector->setTooltip("Fixed thresholds, or a multiple of the RMS or MAD noise level of each channel");
+    thresholdTypeSelector->addListener(this);
+    thresholdTypeSelector->setBounds(135,75,60,20);
+    thresholdTypeSelector->setSelectedId(SpikeDetector::FIXED_THRESHOLD + 1, dontSendNotification);
+    addAndMakeVisible(thresholdTypeSelector);
+
     numElectrodes = new Label("Number of Electrodes","1");
     numElectrodes->setEditable(true);
     numElectrodes->addListener(this);
@@ -507,6 +519,13 @@ void SpikeDetectorEditor::labelTextChanged(Label* label)
 void SpikeDetectorEditor::comboBoxChanged(ComboBox* comboBox)
 {
 
+    if (comboBox == thresholdTypeSelector)
+    {
+        SpikeDetector* processor = (SpikeDetector*) getProcessor();
+        processor->setThresholdType((SpikeDetector::ThresholdType) (comboBox->getSelectedId() - 1));
+        return;
+    }
+
     if (comboBox == electrodeList)
     {
         int ID = comboBox->getSelectedId();
@@ -543,6 +562,9 @@ void SpikeDetectorEditor::comboBoxChanged(ComboBox* comboBox)
 
 void SpikeDetectorEditor::checkSettings()
 {
+    SpikeDetector* processor = (SpikeDetector*) getProcessor();
+    thresholdTypeSelector->setSelectedId(processor->getThresholdType() + 1, dontSendNotification);
+
     electrodeList->setSelectedId(0);
     drawElectrodeButtons(0);
 
@@ -72,6 +72,7 @@ private:
 
     ComboBox* electrodeTypes;
     ComboBox* electrodeList;
+    ComboBox* thresholdTypeSelector;
     Label* numElectrodes;
     Label* thresholdLabel;
     TriangleButton* upButton;
@@ -153,7 +153,7 @@ void SpikeDisplayCanvas::refresh()
 void SpikeDisplayCanvas::processSpikeEvents()
 {
 
-    processor->setParameter(2, 0.0f); // request redraw
+    processor->transferSpikesToPlots();
 
 }
 
@@ -28,7 +28,7 @@
 
 
 SpikeDisplayNode::SpikeDisplayNode()
-    : GenericProcessor("Spike Viewer"), displayBufferSize(5),  redrawRequested(false),
+    : GenericProcessor("Spike Viewer"), displayBufferSize(32),
 	isRecording(false)
 {
 
@@ -61,17 +61,18 @@ void SpikeDisplayNode::updateSettings()
         if (type == ELECTRODE_CHANNEL)
         {
 
-            Electrode elec;
-			elec.numChannels = static_cast<SpikeChannel*>(eventChannels[i]->extraData.get())->numChannels;
+            Electrode* elec = new Electrode();
+			elec->numChannels = static_cast<SpikeChannel*>(eventChannels[i]->extraData.get())->numChannels;
 
-            elec.name = eventChannels[i]->getName();
-            elec.currentSpikeIndex = 0;
-            elec.mostRecentSpikes.ensureStorageAllocated(displayBufferSize);
+            elec->name = eventChannels[i]->getName();
+            elec->spikeRing = new SpikeRing(displayBufferSize);
+            elec->spikePlot = nullptr;
+            elec->recordIndex = -1;
 
-            for (int j = 0; j < elec.numChannels; j++)
+            for (int j = 0; j < elec->numChannels; j++)
             {
-                elec.displayThresholds.add(0);
-                elec.detectorThresholds.add(0);
+                elec->displayThresholds.add(0);
+                elec->detectorThresholds.add(0);
             }
 
             electrodes.add(elec);
@@ -94,7 +95,7 @@ bool SpikeDisplayNode::enable()
 	CoreServices::RecordNode::registerSpikeSource(this);
 	for (int i = 0; i < electrodes.size(); i ++)
 	{
-		Electrode& elec = electrodes.getReference(i);
+		Electrode& elec = *electrodes[i];
 		SpikeRecordInfo *recElec = new SpikeRecordInfo();
 		recElec->name = elec.name;
 		recElec->numChannels = elec.numChannels;
@@ -110,6 +111,13 @@ bool SpikeDisplayNode::enable()
 bool SpikeDisplayNode::disable()
 {
     std::cout << "SpikeDisplayNode disabled!" << std::endl;
+
+    for (int i = 0; i < electrodes.size(); i++)
+    {
+        if (electrodes[i]->spikeRing->getNumDropped() > 0)
+            std::cout << electrodes[i]->name << ": " << electrodes[i]->spikeRing->getNumDropped()
+                      << " spikes were not displayed" << std::endl;
+    }
     SpikeDisplayEditor* editor = (SpikeDisplayEditor*) getEditor();
     editor->disable();
     return true;
@@ -119,7 +127,7 @@ int SpikeDisplayNode::getNumberOfChannelsForElectrode(int i)
 {
     if (i > -1 && i < electrodes.size())
     {
-        return electrodes[i].numChannels;
+        return electrodes[i]->numChannels;
     }
     else
     {
@@ -132,7 +140,7 @@ String SpikeDisplayNode::getNameForElectrode(int i)
 
     if (i > -1 && i < electrodes.size())
     {
-        return electrodes[i].name;
+        return electrodes[i]->name;
     }
     else
     {
@@ -142,7 +150,7 @@ String SpikeDisplayNode::getNameForElectrode(int i)
 
 void SpikeDisplayNode::addSpikePlotForElectrode(SpikePlot* sp, int i)
 {
-    Electrode& e = electrodes.getReference(i);
+    Electrode& e = *electrodes[i];
     e.spikePlot = sp;
 
 }
@@ -151,7 +159,7 @@ void SpikeDisplayNode::removeSpikePlots()
 {
     for (int i = 0; i < getNumElectrodes(); i++)
     {
-        Electrode& e = electrodes.getReference(i);
+        Electrode& e = *electrodes[i];
         e.spikePlot = nullptr;
     }
 }
@@ -188,11 +196,6 @@ void SpikeDisplayNode::setParameter(int param, float val)
         isRecording = true;
 
     }
-    else if (param == 2)   // redraw
-    {
-        redrawRequested = true;
-
-    }
 
 }
 
@@ -203,36 +206,44 @@ void SpikeDisplayNode::process(AudioSampleBuffer& buffer, MidiBuffer& events)
 
     checkForEvents(events); // automatically calls 'handleEvent
 
-    if (redrawRequested)
+}
+
+void SpikeDisplayNode::transferSpikesToPlots()
+{
+    for (int i = 0; i < getNumElectrodes(); i++)
     {
-        // update incoming thresholds
-        for (int i = 0; i < getNumElectrodes(); i++)
-        {
 
-            Electrode& e = electrodes.getReference(i);
+        Electrode& e = *electrodes[i];
 
-            // update thresholds
-            for (int j = 0; j < e.numChannels; j++)
-            {
-                e.displayThresholds.set(j,
-                                        e.spikePlot->getDisplayThresholdForChannel(j));
+        if (e.spikePlot == nullptr)
+            continue;
 
-                e.spikePlot->setDetectorThresholdForChannel(j, e.detectorThresholds[j]);
-            }
+        // update thresholds; the arrays are never resized while acquiring,
+        // so the audio thread only ever sees a stale value
+        for (int j = 0; j < e.numChannels; j++)
+        {
+            e.displayThresholds.set(j,
+                                    e.spikePlot->getDisplayThresholdForChannel(j));
 
-            // transfer buffered spikes to spike plot
-            for (int j = 0; j < e.currentSpikeIndex; j++)
-            {
-                //std::cout << "Transferring spikes." << std::endl;
-                e.spikePlot->processSpikeObject(e.mostRecentSpikes[j]);
-                e.currentSpikeIndex = 0;
-            }
+            e.spikePlot->setDetectorThresholdForChannel(j, e.detectorThresholds[j]);
+        }
 
+        // transfer buffered spikes to spike plot
+        while (const SpikeObject* s = e.spikeRing->peek())
+        {
+            e.spikePlot->processSpikeObject(*s);
+            e.spikeRing->release();
         }
 
-        redrawRequested = false;
     }
+}
 
+int SpikeDisplayNode::getNumDroppedSpikes(int i)
+{
+    if (i > -1 && i < electrodes.size())
+        return electrodes[i]->spikeRing->getNumDropped();
+
+    return 0;
 }
 
 void SpikeDisplayNode::handleEvent(int eventType, MidiMessage& event, int samplePosition)
@@ -249,6 +260,10 @@ void SpikeDisplayNode::handleEvent(int eventType, MidiMessage& event, int sample
         if (bufferSize > 0)
         {
 
+            // spikes from this process are read in place; the display only
+            // keeps as many channels and samples as a SpikeObject holds
+            const SpikeRecord* record = SpikePool::getSpike(dataptr, bufferSize);
+
             SpikeObject newSpike;
 
             bool isValid = unpackSpike(&newSpike, dataptr, bufferSize);
@@ -257,13 +272,16 @@ void SpikeDisplayNode::handleEvent(int eventType, MidiMessage& event, int sample
             {
                 int electrodeNum = newSpike.source;
 
-                Electrode& e = electrodes.getReference(electrodeNum);
+                if (electrodeNum >= electrodes.size())
+                    return;
+
+                Electrode& e = *electrodes[electrodeNum];
                 // std::cout << electrodeNum << std::endl;
 
                 bool aboveThreshold = false;
 
                 // update threshold / check threshold
-                for (int i = 0; i < e.numChannels; i++)
+                for (int i = 0; i < jmin(e.numChannels, int(newSpike.nChannels)); i++)
                 {
                     e.detectorThresholds.set(i, float(newSpike.threshold[i])); // / float(newSpike.gain[i]));
 
@@ -273,18 +291,17 @@ void SpikeDisplayNode::handleEvent(int eventType, MidiMessage& event, int sample
                 if (aboveThreshold)
                 {
 
-                    // add to buffer
-                    if (e.currentSpikeIndex < displayBufferSize)
-                    {
-                        //  std::cout << "Adding spike " << e.currentSpikeIndex + 1 << std::endl;
-                        e.mostRecentSpikes.set(e.currentSpikeIndex, newSpike);
-                        e.currentSpikeIndex++;
-                    }
+                    // add to display buffer
+                    if (e.spikePlot != nullptr)
+                        e.spikeRing->push(newSpike);
 
                     // save spike
                     if (isRecording)
                     {
-						CoreServices::RecordNode::writeSpike(newSpike,e.recordIndex);
+						if (record != nullptr)
+							CoreServices::RecordNode::writeSpike(*record,e.recordIndex);
+						else
+							CoreServices::RecordNode::writeSpike(newSpike,e.recordIndex);
                     }
                 }
 
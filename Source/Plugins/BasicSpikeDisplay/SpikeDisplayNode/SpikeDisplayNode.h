@@ -34,7 +34,8 @@ class SpikePlot;
 /**
 
  Takes in MidiEvents and extracts SpikeObjects from the MidiEvent buffers.
- Those Events are then held in a queue until they are pulled by the SpikeDisplayCanvas.
+ Those Events are then held in a lock-free SpikeRing per electrode until they are
+ pulled by the SpikeDisplayCanvas.
 
   @see GenericProcessor, SpikeDisplayEditor, SpikeDisplayCanvas
 
@@ -75,6 +76,14 @@ public:
     void addSpikePlotForElectrode(SpikePlot* sp, int i);
     void removeSpikePlots();
 
+    /** Exchanges thresholds with the spike plots and hands them the spikes
+        received since the last call. Called from the message thread. */
+    void transferSpikesToPlots();
+
+    /** Returns the number of spikes that were not displayed for an electrode
+        because the canvas fell behind. */
+    int getNumDroppedSpikes(int i);
+
     bool checkThreshold(int, float, SpikeObject&);
 
 private:
@@ -88,8 +97,7 @@ private:
         Array<float> displayThresholds;
         Array<float> detectorThresholds;
 
-        Array<SpikeObject> mostRecentSpikes;
-        int currentSpikeIndex;
+        ScopedPointer<SpikeRing> spikeRing;
 
         SpikePlot* spikePlot;
 
@@ -97,10 +105,9 @@ private:
 
     };
 
-    Array<Electrode> electrodes;
+    OwnedArray<Electrode> electrodes;
 
     int displayBufferSize;
-    bool redrawRequested;
 
     // members for recording
     bool isRecording;
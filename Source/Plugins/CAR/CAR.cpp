@@ -22,6 +22,7 @@
 */
 
 #include <stdio.h>
+#include <algorithm>
 
 #include "CAR.h"
 #include "CAREditor.h"
@@ -29,13 +30,19 @@
 
 CAR::CAR()
     : GenericProcessor ("Common Avg Ref") //, threshold(200.0), state(true)
+    , m_referenceMode         (MEAN_REFERENCE)
+    , m_activeConfiguration   (nullptr)
+    , m_configurationInUse    (nullptr)
 {
-    m_avgBuffer = AudioSampleBuffer (1, 10000); // 1-dimensional buffer to hold the avg
+    m_referenceGroups.add (new ReferenceGroup());
+
+    publishConfiguration();
 }
 
 
 CAR::~CAR()
 {
+    delete m_activeConfiguration.exchange (nullptr);
 }
 
 
@@ -61,78 +68,364 @@ void CAR::setGainLevel (float newGain)
 
 void CAR::process (AudioSampleBuffer& buffer, MidiBuffer& events)
 {
-    const int numSamples            = buffer.getNumSamples();
-    const int numReferenceChannels  = m_referenceChannels.size();
-    const int numAffectedChannels   = m_affectedChannels.size();
+    // Announce the configuration we are about to use. If it was swapped in between,
+    // the message thread may already have retired it, so try again with the new one.
+    Configuration* config = m_activeConfiguration.load();
 
-    // There are no sense to do any processing if either number of reference or affected channels is zero.
-    if (! numReferenceChannels
-        || ! numAffectedChannels)
+    for (;;)
     {
-        return;
-    }
+        m_configurationInUse.store (config);
 
-    m_avgBuffer.clear();
+        Configuration* latest = m_activeConfiguration.load();
 
-    for (int i = 0; i < numReferenceChannels; ++i)
-    {
-        m_avgBuffer.addFrom (0,                         // destChannel
-                             0,                         // destStartSample
-                             buffer,                    // source
-                             m_referenceChannels[i],    // sourceChannel
-                             0,                         // sourceStartSample
-                             numSamples,                // numSamples
-                             1.0f);                     // gain to apply
+        if (latest == config)
+            break;
+
+        config = latest;
     }
 
-    m_avgBuffer.applyGain (1.0f / float (numReferenceChannels));
+    const int numSamples = buffer.getNumSamples();
 
     m_gainLevel.updateTarget();
     const float gain = -1.0f * m_gainLevel.getNextValue() / 100.f;
 
-    for (int i = 0; i < numAffectedChannels; ++i)
+    config->prepare (buffer);
+
+    // Process the buffer in tiles of samples across all channels, so that every
+    // channel of the tile is still in cache when the reference is subtracted.
+    // All references of a tile are computed before any channel is modified,
+    // which keeps the result independent of the order of overlapping groups.
+    for (int startSample = 0; startSample < numSamples; startSample += CAR_TILE_SIZE)
+    {
+        const int tileSize = jmin (CAR_TILE_SIZE, numSamples - startSample);
+
+        for (int group = 0; group < config->numGroups; ++group)
+        {
+            if (config->numValidReferences[group] > 0 && config->numValidAffected[group] > 0)
+                config->computeReference (group, startSample, tileSize, config->referenceTiles + group * CAR_TILE_SIZE);
+        }
+
+        for (int group = 0; group < config->numGroups; ++group)
+        {
+            // There are no sense to do any processing if either number of reference or affected channels is zero.
+            if (! config->numValidReferences[group]
+                || ! config->numValidAffected[group])
+            {
+                continue;
+            }
+
+            const float* reference = config->referenceTiles + group * CAR_TILE_SIZE;
+            float* const* affected = config->affectedPointers + config->affectedOffsets[group];
+
+            for (int i = 0; i < config->numValidAffected[group]; ++i)
+                FloatVectorOperations::addWithMultiply (affected[i] + startSample, reference, gain, tileSize);
+        }
+    }
+
+    m_configurationInUse.store (nullptr);
+}
+
+
+// ============================================================================
+
+CAR::Configuration::Configuration (const OwnedArray<ReferenceGroup>& groups, ReferenceMode referenceMode)
+    : mode      (referenceMode)
+    , numGroups (groups.size())
+{
+    referenceOffsets.calloc (numGroups + 1);
+    affectedOffsets.calloc  (numGroups + 1);
+
+    int maxReferenceChannels = 1;
+
+    for (int group = 0; group < numGroups; ++group)
     {
-        buffer.addFrom (m_affectedChannels[i],  // destChannel
-                        0,                      // destStartSample
-                        m_avgBuffer,            // source
-                        0,                      // sourceChannel
-                        0,                      // sourceStartSample
-                        numSamples,             // numSamples
-                        gain);                  // gain to apply
+        referenceOffsets[group] = referenceChannels.size();
+        affectedOffsets[group]  = affectedChannels.size();
+
+        referenceChannels.addArray (groups[group]->referenceChannels);
+        affectedChannels.addArray  (groups[group]->affectedChannels);
+
+        maxReferenceChannels = jmax (maxReferenceChannels, groups[group]->referenceChannels.size());
     }
+
+    referenceOffsets[numGroups] = referenceChannels.size();
+    affectedOffsets[numGroups]  = affectedChannels.size();
+
+    referencePointers.calloc  (jmax (1, referenceChannels.size()));
+    affectedPointers.calloc   (jmax (1, affectedChannels.size()));
+    numValidReferences.calloc (jmax (1, numGroups));
+    numValidAffected.calloc   (jmax (1, numGroups));
+    referenceTiles.calloc     (jmax (1, numGroups) * CAR_TILE_SIZE);
+    medianScratch.calloc      (maxReferenceChannels);
+}
+
+
+void CAR::Configuration::prepare (AudioSampleBuffer& buffer)
+{
+    const int numChannels = buffer.getNumChannels();
+
+    for (int group = 0; group < numGroups; ++group)
+    {
+        int numReferences = 0;
+
+        for (int i = referenceOffsets[group]; i < referenceOffsets[group + 1]; ++i)
+        {
+            const int channel = referenceChannels.getUnchecked (i);
+
+            if (channel >= 0 && channel < numChannels)
+                referencePointers[referenceOffsets[group] + numReferences++] = buffer.getReadPointer (channel);
+        }
+
+        int numAffected = 0;
+
+        for (int i = affectedOffsets[group]; i < affectedOffsets[group + 1]; ++i)
+        {
+            const int channel = affectedChannels.getUnchecked (i);
+
+            if (channel >= 0 && channel < numChannels)
+                affectedPointers[affectedOffsets[group] + numAffected++] = buffer.getWritePointer (channel);
+        }
+
+        numValidReferences[group] = numReferences;
+        numValidAffected[group]   = numAffected;
+    }
+}
+
+
+void CAR::Configuration::computeReference (int group, int startSample, int numSamples, float* reference)
+{
+    const float* const* references = referencePointers + referenceOffsets[group];
+    const int numReferences = numValidReferences[group];
+
+    if (mode == MEAN_REFERENCE)
+    {
+        FloatVectorOperations::copy (reference, references[0] + startSample, numSamples);
+
+        for (int i = 1; i < numReferences; ++i)
+            FloatVectorOperations::add (reference, references[i] + startSample, numSamples);
+
+        FloatVectorOperations::multiply (reference, 1.0f / float (numReferences), numSamples);
+    }
+    else
+    {
+        const int middle = numReferences / 2;
+
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            for (int i = 0; i < numReferences; ++i)
+                medianScratch[i] = references[i][startSample + sample];
+
+            std::nth_element (medianScratch.getData(), medianScratch + middle, medianScratch + numReferences);
+
+            float median = medianScratch[middle];
+
+            // For an even number of channels, average the two middle values. After
+            // nth_element the lower one is the largest value of the lower half.
+            if ((numReferences & 1) == 0)
+                median = 0.5f * (median + *std::max_element (medianScratch.getData(), medianScratch + middle));
+
+            reference[sample] = median;
+        }
+    }
+}
+
+
+// ============================================================================
+
+void CAR::publishConfiguration()
+{
+    Configuration* oldConfiguration = m_activeConfiguration.exchange (new Configuration (m_referenceGroups, m_referenceMode));
+
+    if (oldConfiguration != nullptr)
+        m_retiredConfigurations.add (oldConfiguration);
+
+    releaseRetiredConfigurations();
+}
+
+
+void CAR::releaseRetiredConfigurations()
+{
+    Configuration* inUse = m_configurationInUse.load();
+
+    for (int i = m_retiredConfigurations.size(); --i >= 0;)
+    {
+        if (m_retiredConfigurations[i] != inUse)
+            m_retiredConfigurations.remove (i);
+    }
+}
+
+
+Array<int> CAR::getReferenceChannels (int group) const
+{
+    if (! isPositiveAndBelow (group, m_referenceGroups.size()))
+        return Array<int>();
+
+    return m_referenceGroups[group]->referenceChannels;
 }
 
 
-void CAR::setReferenceChannels (const Array<int>& newReferenceChannels)
+Array<int> CAR::getAffectedChannels (int group) const
 {
-    const ScopedLock myScopedLock (objectLock);
+    if (! isPositiveAndBelow (group, m_referenceGroups.size()))
+        return Array<int>();
 
-    m_referenceChannels = Array<int> (newReferenceChannels);
+    return m_referenceGroups[group]->affectedChannels;
 }
 
 
-void CAR::setAffectedChannels (const Array<int>& newAffectedChannels)
+void CAR::setReferenceChannels (const Array<int>& newReferenceChannels, int group)
 {
-    const ScopedLock myScopedLock (objectLock);
+    if (! isPositiveAndBelow (group, CAR_MAX_REFERENCE_GROUPS))
+        return;
+
+    while (m_referenceGroups.size() <= group)
+        m_referenceGroups.add (new ReferenceGroup());
+
+    m_referenceGroups[group]->referenceChannels = newReferenceChannels;
+
+    publishConfiguration();
+}
+
+
+void CAR::setAffectedChannels (const Array<int>& newAffectedChannels, int group)
+{
+    if (! isPositiveAndBelow (group, CAR_MAX_REFERENCE_GROUPS))
+        return;
 
-    m_affectedChannels = Array<int> (newAffectedChannels);
+    while (m_referenceGroups.size() <= group)
+        m_referenceGroups.add (new ReferenceGroup());
+
+    m_referenceGroups[group]->affectedChannels = newAffectedChannels;
+
+    publishConfiguration();
 }
 
 
-void CAR::setReferenceChannelState (int channel, bool newState)
+void CAR::setReferenceChannelState (int channel, bool newState, int group)
 {
+    Array<int> channels = getReferenceChannels (group);
+
     if (! newState)
-        m_referenceChannels.removeFirstMatchingValue (channel);
+        channels.removeFirstMatchingValue (channel);
     else
-        m_referenceChannels.addIfNotAlreadyThere (channel);
+        channels.addIfNotAlreadyThere (channel);
+
+    setReferenceChannels (channels, group);
 }
 
 
-void CAR::setAffectedChannelState (int channel, bool newState)
+void CAR::setAffectedChannelState (int channel, bool newState, int group)
 {
+    Array<int> channels = getAffectedChannels (group);
+
     if (! newState)
-        m_affectedChannels.removeFirstMatchingValue (channel);
+        channels.removeFirstMatchingValue (channel);
     else
-        m_affectedChannels.add (channel);
+        channels.addIfNotAlreadyThere (channel);
+
+    setAffectedChannels (channels, group);
 }
 
+
+int CAR::getNumReferenceGroups() const
+{
+    return m_referenceGroups.size();
+}
+
+
+void CAR::setNumReferenceGroups (int numGroups)
+{
+    m_referenceGroups.clear();
+
+    for (int i = 0; i < jlimit (1, CAR_MAX_REFERENCE_GROUPS, numGroups); ++i)
+        m_referenceGroups.add (new ReferenceGroup());
+
+    publishConfiguration();
+}
+
+
+CAR::ReferenceMode CAR::getReferenceMode() const
+{
+    return m_referenceMode;
+}
+
+
+void CAR::setReferenceMode (ReferenceMode newMode)
+{
+    m_referenceMode = newMode;
+
+    publishConfiguration();
+}
+
+
+static String channelListToString (const Array<int>& channels)
+{
+    String list;
+
+    for (int i = 0; i < channels.size(); ++i)
+        list << channels[i] << " ";
+
+    return list.trimEnd();
+}
+
+
+static Array<int> channelListFromString (const String& list)
+{
+    StringArray tokens;
+    tokens.addTokens (list, " ", String::empty);
+
+    Array<int> channels;
+
+    for (int i = 0; i < tokens.size(); ++i)
+        channels.add (tokens[i].getIntValue());
+
+    return channels;
+}
+
+
+void CAR::saveCustomParametersToXml (XmlElement* parentElement)
+{
+    XmlElement* carXml = parentElement->createNewChildElement ("CAR");
+
+    carXml->setAttribute ("gain", getGainLevel());
+    carXml->setAttribute ("mode", m_referenceMode == MEDIAN_REFERENCE ? "median" : "mean");
+
+    for (int group = 0; group < m_referenceGroups.size(); ++group)
+    {
+        XmlElement* groupXml = carXml->createNewChildElement ("GROUP");
+
+        groupXml->setAttribute ("referenceChannels", channelListToString (m_referenceGroups[group]->referenceChannels));
+        groupXml->setAttribute ("affectedChannels",  channelListToString (m_referenceGroups[group]->affectedChannels));
+    }
+}
+
+
+void CAR::loadCustomParametersFromXml()
+{
+    if (parametersAsXml == nullptr)
+        return;
+
+    forEachXmlChildElementWithTagName (*parametersAsXml, carXml, "CAR")
+    {
+        setGainLevel ((float) carXml->getDoubleAttribute ("gain", 100.0));
+
+        m_referenceMode = carXml->getStringAttribute ("mode", "mean") == "median" ? MEDIAN_REFERENCE : MEAN_REFERENCE;
+
+        m_referenceGroups.clear();
+
+        forEachXmlChildElementWithTagName (*carXml, groupXml, "GROUP")
+        {
+            if (m_referenceGroups.size() == CAR_MAX_REFERENCE_GROUPS)
+                break;
+
+            ReferenceGroup* group = m_referenceGroups.add (new ReferenceGroup());
+            group->referenceChannels = channelListFromString (groupXml->getStringAttribute ("referenceChannels"));
+            group->affectedChannels  = channelListFromString (groupXml->getStringAttribute ("affectedChannels"));
+        }
+
+        if (m_referenceGroups.size() == 0)
+            m_referenceGroups.add (new ReferenceGroup());
+
+        publishConfiguration();
+    }
+}
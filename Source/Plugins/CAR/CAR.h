@@ -30,12 +30,19 @@
 #endif
 
 #include <ProcessorHeaders.h>
+#include <atomic>
 
 /**
 
     This is a simple filter that subtracts the average of all other channels from 
     each channel. The gain parameter allows you to subtract a percentage of the total avg.
 
+    Channels can be split into several independent reference groups (e.g. one per
+    shank of a multi-shank probe), and the reference can be either the mean or the
+    median of the group's reference channels. The buffer is processed in tiles of
+    CAR_TILE_SIZE samples across all channels, so that the reference channels are
+    still in cache when they are subtracted from the affected channels.
+
     See Ludwig et al. 2009 Using a common average reference to improve cortical
     neuron recordings from microelectrode arrays. J. Neurophys, 2009 for a detailed
     discussion
@@ -43,6 +50,9 @@
 
 */
 
+#define CAR_TILE_SIZE            64
+#define CAR_MAX_REFERENCE_GROUPS 16
+
 class CAR : public GenericProcessor
 {
 public:
@@ -81,35 +91,106 @@ public:
     /** Creates the CAREditor. */
     AudioProcessorEditor* createEditor() override;
 
-    Array<int> getReferenceChannels() const     { return m_referenceChannels; }
-    Array<int> getAffectedChannels()  const     { return m_affectedChannels; }
+    enum ReferenceMode
+    {
+        MEAN_REFERENCE = 0,
+        MEDIAN_REFERENCE
+    };
+
+    /** All of the functions below must be called from the message thread.
+        The group index defaults to the first group. */
+    Array<int> getReferenceChannels (int group = 0) const;
+    Array<int> getAffectedChannels  (int group = 0) const;
+
+    void setReferenceChannels (const Array<int>& newReferenceChannels, int group = 0);
+    void setAffectedChannels  (const Array<int>& newAffectedChannels,  int group = 0);
+
+    void setReferenceChannelState (int channel, bool newState, int group = 0);
+    void setAffectedChannelState  (int channel, bool newState, int group = 0);
+
+    int getNumReferenceGroups() const;
 
-    void setReferenceChannels (const Array<int>& newReferenceChannels);
-    void setAffectedChannels  (const Array<int>& newAffectedChannels);
+    /** Removes every reference group and adds numGroups empty ones. */
+    void setNumReferenceGroups (int numGroups);
 
-    void setReferenceChannelState (int channel, bool newState);
-    void setAffectedChannelState  (int channel, bool newState);
+    ReferenceMode getReferenceMode() const;
+    void setReferenceMode (ReferenceMode newMode);
+
+    /** Saves gain, referencing mode and every reference group. */
+    void saveCustomParametersToXml (XmlElement* parentElement) override;
+
+    /** Restores gain, referencing mode and every reference group. */
+    void loadCustomParametersFromXml() override;
 
 
 private:
-    LinearSmoothedValueAtomic<float> m_gainLevel;
+    struct ReferenceGroup
+    {
+        /** Channels which will be used to calculate the reference signal. */
+        Array<int> referenceChannels;
 
-    AudioSampleBuffer m_avgBuffer;
+        /** Channels that will have the reference signal subtracted. */
+        Array<int> affectedChannels;
+    };
 
-    /** We should add this for safety to prevent any app crashes or invalid data processing.
-        Since we use m_referenceChannels and m_affectedChannels arrays in the process() function,
-        which works in audioThread, we may stumble upon the situation when we start changing
-        either reference or affected channels by copying array and in the middle of copying process
-        we will be interrupted by audioThread. So it most probably will lead to app crash or
-        processing incorrect channels.
-    */
-    CriticalSection objectLock;
+    /** Immutable copy of the reference groups that is used by the audio thread,
+        together with the scratch memory needed to process a buffer with it. */
+    struct Configuration
+    {
+        Configuration (const OwnedArray<ReferenceGroup>& groups, ReferenceMode mode);
+
+        /** Resolves the channel pointers of every group for this buffer,
+            ignoring channels that the buffer doesn't have. */
+        void prepare (AudioSampleBuffer& buffer);
+
+        /** Computes the reference of one group for numSamples samples. */
+        void computeReference (int group, int startSample, int numSamples, float* reference);
 
-    /** Array of channels which will be used to calculate mean signal. */
-    Array<int> m_referenceChannels;
+        const ReferenceMode mode;
+        const int numGroups;
 
-    /** Array of channels that will be affected by adding/substracting of mean signal of reference channels */
-    Array<int> m_affectedChannels;
+        Array<int> referenceChannels;
+        Array<int> affectedChannels;
+
+        /** Offsets of every group into the flattened channel lists. There are
+            numGroups + 1 entries so that the last one marks the end. */
+        HeapBlock<int> referenceOffsets;
+        HeapBlock<int> affectedOffsets;
+
+        HeapBlock<const float*> referencePointers;
+        HeapBlock<float*>       affectedPointers;
+        HeapBlock<int>          numValidReferences;
+        HeapBlock<int>          numValidAffected;
+
+        /** One tile of reference signal per group. */
+        HeapBlock<float> referenceTiles;
+
+        /** Gather buffer for the median. */
+        HeapBlock<float> medianScratch;
+
+        JUCE_DECLARE_NON_COPYABLE (Configuration);
+    };
+
+    /** Builds a new Configuration from m_referenceGroups and hands it to the audio thread. */
+    void publishConfiguration();
+
+    /** Deletes retired configurations that the audio thread can no longer be using. */
+    void releaseRetiredConfigurations();
+
+    LinearSmoothedValueAtomic<float> m_gainLevel;
+
+    /** Message thread copy of the reference groups. */
+    OwnedArray<ReferenceGroup> m_referenceGroups;
+    ReferenceMode m_referenceMode;
+
+    /** The configuration is swapped with a single atomic exchange, so the audio thread
+        never waits for the message thread. While processing, the audio thread announces
+        the configuration it is using in m_configurationInUse; configurations replaced
+        in the meantime are kept in m_retiredConfigurations until it's safe to delete them.
+    */
+    std::atomic<Configuration*> m_activeConfiguration;
+    std::atomic<Configuration*> m_configurationInUse;
+    OwnedArray<Configuration>   m_retiredConfigurations;
 
     // ==================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CAR);
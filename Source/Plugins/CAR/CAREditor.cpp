@@ -34,6 +34,7 @@ static const Colour COLOUR_ACCENT  (Colour::fromRGB (3, 169, 244));
 CAREditor::CAREditor (GenericProcessor* parentProcessor, bool useDefaultParameterEditors)
     : GenericEditor (parentProcessor, useDefaultParameterEditors)
     , m_currentChannelsView          (REFERENCE_CHANNELS)
+    , m_currentGroup                 (0)
     , m_channelSelectorButtonManager (new LinearButtonGroupManager)
     , m_gainSlider                   (new ParameterSlider (0.0, 100.0, 100.0, Font("Default", 13.f, Font::plain)))
 {
@@ -67,6 +68,21 @@ CAREditor::CAREditor (GenericProcessor* parentProcessor, bool useDefaultParamete
     m_gainSlider->addListener (this);
     addAndMakeVisible (m_gainSlider);
 
+    m_groupSelector = new ComboBox ("Reference group");
+    for (int i = 0; i < CAR_MAX_REFERENCE_GROUPS; ++i)
+        m_groupSelector->addItem ("Group " + String (i + 1), i + 1);
+    m_groupSelector->setSelectedId (1, dontSendNotification);
+    m_groupSelector->setTooltip ("Channels of each group are referenced only to that group (e.g. one group per shank)");
+    m_groupSelector->addListener (this);
+    addAndMakeVisible (m_groupSelector);
+
+    m_modeSelector = new ComboBox ("Reference mode");
+    m_modeSelector->addItem ("Mean",   CAR::MEAN_REFERENCE + 1);
+    m_modeSelector->addItem ("Median", CAR::MEDIAN_REFERENCE + 1);
+    m_modeSelector->setSelectedId (CAR::MEAN_REFERENCE + 1, dontSendNotification);
+    m_modeSelector->addListener (this);
+    addAndMakeVisible (m_modeSelector);
+
     channelSelector->paramButtonsToggledByDefault (false);
 
     setDesiredWidth (280);
@@ -94,7 +110,9 @@ void CAREditor::paint (Graphics& g)
 
 void CAREditor::resized()
 {
-    m_channelSelectorButtonManager->setBounds (110, 50, 150, 36);
+    m_channelSelectorButtonManager->setBounds (110, 35, 150, 36);
+    m_groupSelector->setBounds (110, 80, 80, 20);
+    m_modeSelector->setBounds  (195, 80, 65, 20);
 
     m_gainSlider->setBounds (15, 30, 80, 80);
 
@@ -109,16 +127,14 @@ void CAREditor::buttonClicked (Button* buttonThatWasClicked)
     // "Reference channels" button clicked
     if (buttonName.startsWith ("reference"))
     {
-        channelSelector->setActiveChannels (static_cast<CAR*> (getProcessor())->getReferenceChannels());
-
         m_currentChannelsView = REFERENCE_CHANNELS;
+        updateChannelSelector();
     }
     // "Affected channels" button clicked
     else if (buttonName.startsWith ("affected"))
     {
-        channelSelector->setActiveChannels (static_cast<CAR*> (getProcessor())->getAffectedChannels());
-
         m_currentChannelsView = AFFECTED_CHANNELS;
+        updateChannelSelector();
     }
 
     GenericEditor::buttonClicked (buttonThatWasClicked);
@@ -130,12 +146,49 @@ void CAREditor::channelChanged (int channel, bool newState)
     auto processor = static_cast<CAR*> (getProcessor());
     if (m_currentChannelsView == REFERENCE_CHANNELS)
     {
-        processor->setReferenceChannelState (channel, newState);
+        processor->setReferenceChannelState (channel, newState, m_currentGroup);
     }
     else
     {
-        processor->setAffectedChannelState (channel, newState);
+        processor->setAffectedChannelState (channel, newState, m_currentGroup);
+    }
+}
+
+
+void CAREditor::comboBoxChanged (ComboBox* comboBoxThatHasChanged)
+{
+    auto processor = static_cast<CAR*> (getProcessor());
+
+    if (comboBoxThatHasChanged == m_groupSelector)
+    {
+        m_currentGroup = m_groupSelector->getSelectedId() - 1;
+        updateChannelSelector();
     }
+    else if (comboBoxThatHasChanged == m_modeSelector)
+    {
+        processor->setReferenceMode ((CAR::ReferenceMode) (m_modeSelector->getSelectedId() - 1));
+    }
+}
+
+
+void CAREditor::updateSettings()
+{
+    auto processor = static_cast<CAR*> (getProcessor());
+
+    m_modeSelector->setSelectedId (processor->getReferenceMode() + 1, dontSendNotification);
+
+    updateChannelSelector();
+}
+
+
+void CAREditor::updateChannelSelector()
+{
+    auto processor = static_cast<CAR*> (getProcessor());
+
+    if (m_currentChannelsView == REFERENCE_CHANNELS)
+        channelSelector->setActiveChannels (processor->getReferenceChannels (m_currentGroup));
+    else
+        channelSelector->setActiveChannels (processor->getAffectedChannels (m_currentGroup));
 }
 
 
@@ -35,6 +35,7 @@ class ParameterSlider;
    @see CAR
 */
 class CAREditor : public GenericEditor
+                , public ComboBox::Listener
 {
 public:
     CAREditor (GenericProcessor* parentProcessor, bool useDefaultParameterEditors);
@@ -48,11 +49,16 @@ public:
     // ==========================================================
     void buttonClicked (Button* buttonThatWasClicked) override;
 
+    // ComboBox::Listener methods
+    // ==========================================================
+    void comboBoxChanged (ComboBox* comboBoxThatHasChanged) override;
+
     // GenericEditor methods
     // =========================================================
     /** This methods is called when any sliders that we are listen for change their values */
     void sliderEvent (Slider* sliderWhichValueHasChanged) override;
     void channelChanged (int channel, bool newState) override;
+    void updateSettings() override;
 
 
 private:
@@ -62,10 +68,16 @@ private:
         AFFECTED_CHANNELS
     };
 
+    /** Shows the channels of the current view and group in the channel selector. */
+    void updateChannelSelector();
+
     ChannelsType m_currentChannelsView;
+    int m_currentGroup;
 
     ScopedPointer<LinearButtonGroupManager> m_channelSelectorButtonManager;
     ScopedPointer<ParameterSlider>          m_gainSlider;
+    ScopedPointer<ComboBox>                 m_groupSelector;
+    ScopedPointer<ComboBox>                 m_modeSelector;
 
     // LookAndFeel
     SharedResourcePointer<MaterialButtonLookAndFeel> m_materialButtonLookAndFeel;
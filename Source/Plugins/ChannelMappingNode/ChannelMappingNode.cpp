@@ -28,7 +28,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 
 ChannelMappingNode::ChannelMappingNode()
-    : GenericProcessor("Channel Map"), channelBuffer(1,10000)
+    : GenericProcessor("Channel Map"), mappingChanged(true), numMappedChannels(0),
+      mappingIsIdentity(true), channelBuffer(1,10000)
 {
     referenceArray.resize(1024); // make room for 1024 channels
     channelArray.resize(1024);
@@ -67,6 +68,17 @@ void ChannelMappingNode::updateSettings()
     if (getNumInputs() > 0)
         channelBuffer.setSize(getNumInputs(), 10000);
 
+    // size the plan for the current channel count so that rebuilding it
+    // from the audio thread never allocates
+    const int numChannels = jmax(1, getNumInputs());
+    sourceChannels.resize(numChannels);
+    sourceReferences.resize(numChannels);
+    sourceSlots.resize(numChannels);
+    referenceSlots.resize(numChannels);
+    savedChannels.resize(numChannels);
+    channelSlots.resize(numChannels);
+    mappingChanged = true;
+
 	if (editorIsConfigured)
 	{
 	    OwnedArray<Channel> oldChannels;
@@ -120,51 +132,120 @@ void ChannelMappingNode::setParameter(int parameterIndex, float newValue)
         channelArray.set(currentChannel, (int) newValue);
     }
 
+    mappingChanged = true;
 }
 
-void ChannelMappingNode::process(AudioSampleBuffer& buffer,
-                                 MidiBuffer& midiMessages)
+void ChannelMappingNode::updateMappingPlan(int numChannels)
 {
-    int j=0;
-    int i=0;
-    int realChan;
+    const int maxOutputs = jmin(settings.numOutputs, numChannels, sourceChannels.size());
 
-    // use copy constructor to set the data to refer to
-    channelBuffer = buffer;
+    numMappedChannels = 0;
+    mappingIsIdentity = true;
 
-   // buffer.clear();
-
-    while (j < settings.numOutputs)
+    for (int i = 0; numMappedChannels < maxOutputs && i < channelArray.size(); i++)
     {
-        realChan = channelArray[i];
-        if ((realChan < channelBuffer.getNumChannels()) && (enabledChannelArray[realChan]))
+        const int realChan = channelArray[i];
+
+        if ((realChan < numChannels) && (enabledChannelArray[realChan]))
         {
-            // copy it back into the buffer according to the channel mapping
-            buffer.copyFrom(j, // destChannel
-                           0, // destStartSample
-                           channelBuffer.getReadPointer(realChan), // source
-                           getNumSamples(j), // numSamples
-                           1.0f // gain to apply to source (positive for original signal)
-                          );
-
-            // now do the referencing
+            int referenceChan = -1;
+
             if ((referenceArray[realChan] > -1) && (referenceChannels[referenceArray[realChan]] > -1)
-                && (referenceChannels[referenceArray[realChan]] < channelBuffer.getNumChannels()))
+                && (referenceChannels[referenceArray[realChan]] < numChannels)
+                && (referenceChannels[referenceArray[realChan]] < channels.size()))
             {
-                buffer.addFrom(j, // destChannel
-                               0, // destStartSample
-                               channelBuffer, // source
-							   channels[referenceChannels[referenceArray[realChan]]]->index-1, // sourceChannel
-                               0, // sourceStartSample
-                               getNumSamples(j), // numSamples
-                               -1.0f // gain to apply to source (negative for reference)
-                              );
+                referenceChan = channels[referenceChannels[referenceArray[realChan]]]->index-1;
+
+                if (referenceChan < 0 || referenceChan >= numChannels)
+                    referenceChan = -1;
             }
-            j++;
+
+            if (realChan != numMappedChannels || referenceChan > -1)
+                mappingIsIdentity = false;
+
+            sourceChannels.set(numMappedChannels, realChan);
+            sourceReferences.set(numMappedChannels, referenceChan);
+            numMappedChannels++;
         }
-        i++;
+    }
 
+    // Output j is written in place at step j, so an input channel read at step j
+    // has already been overwritten if it is a lower output that was modified.
+    // Only those channels are saved before the mapping is applied.
+    int numSaved = 0;
+
+    for (int ch = 0; ch < channelSlots.size(); ch++)
+        channelSlots.set(ch, -1);
+
+    for (int j = 0; j < numMappedChannels; j++)
+    {
+        for (int k = 0; k < 2; k++)
+        {
+            const int chan = (k == 0) ? sourceChannels[j] : sourceReferences[j];
+            int slot = -1;
+
+            if (chan > -1 && chan < j
+                && (sourceChannels[chan] != chan || sourceReferences[chan] > -1))
+            {
+                slot = channelSlots[chan];
+
+                if (slot < 0)
+                {
+                    slot = numSaved++;
+                    channelSlots.set(chan, slot);
+                    savedChannels.set(slot, chan);
+                }
+            }
+
+            if (k == 0)
+                sourceSlots.set(j, slot);
+            else
+                referenceSlots.set(j, slot);
+        }
     }
 
+    for (int slot = numSaved; slot < savedChannels.size(); slot++)
+        savedChannels.set(slot, -1);
 }
 
+void ChannelMappingNode::process(AudioSampleBuffer& buffer,
+                                 MidiBuffer& midiMessages)
+{
+    if (mappingChanged.exchange(false))
+        updateMappingPlan(buffer.getNumChannels());
+
+    if (mappingIsIdentity)
+        return;
+
+    const int maxSamples = jmin(buffer.getNumSamples(), channelBuffer.getNumSamples());
+
+    // save the channels that are overwritten before they are read
+    for (int slot = 0; slot < savedChannels.size() && savedChannels[slot] > -1; slot++)
+    {
+        channelBuffer.copyFrom(slot, 0, buffer, savedChannels[slot], 0, maxSamples);
+    }
+
+    for (int j = 0; j < numMappedChannels; j++)
+    {
+        const int nSamples = jmin(getNumSamples(j), maxSamples);
+
+        float* dest = buffer.getWritePointer(j);
+        const float* source = (sourceSlots[j] > -1) ? channelBuffer.getReadPointer(sourceSlots[j])
+                                                     : buffer.getReadPointer(sourceChannels[j]);
+
+        if (sourceReferences[j] > -1)
+        {
+            const float* reference = (referenceSlots[j] > -1) ? channelBuffer.getReadPointer(referenceSlots[j])
+                                                               : buffer.getReadPointer(sourceReferences[j]);
+
+            // gather and reference in a single pass; element-wise, so it is safe
+            // when dest is also the source or the reference
+            for (int n = 0; n < nSamples; n++)
+                dest[n] = source[n] - reference[n];
+        }
+        else if (dest != source)
+        {
+            FloatVectorOperations::copy(dest, source, nSamples);
+        }
+    }
+}
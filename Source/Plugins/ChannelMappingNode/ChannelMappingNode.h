@@ -26,6 +26,7 @@
 
 
 #include <ProcessorHeaders.h>
+#include <atomic>
 
 
 /**
@@ -35,6 +36,10 @@
   Allows the user to select a subset of channels, remap their order, and reference them against
   any other channel.
 
+  The mapping is applied in place. Only the input channels that would be overwritten before
+  they are read are saved to a scratch buffer, unchanged channels are not touched at all, and
+  referencing is fused with the gather so every output channel is written exactly once.
+
   @see GenericProcessor
 
 */
@@ -61,6 +66,10 @@ public:
 
 private:
 
+    /** Rebuilds the per-output source/reference lists and the set of input
+        channels that need to be saved before the mapping is applied. */
+    void updateMappingPlan(int numChannels);
+
     Array<int> referenceArray;
     Array<int> referenceChannels;
     Array<int> channelArray;
@@ -68,6 +77,25 @@ private:
 
     bool editorIsConfigured;
 
+    /** Set whenever the mapping changes; the plan is rebuilt at the start of the next block. */
+    std::atomic<bool> mappingChanged;
+
+    /** Input channel (and reference channel, or -1) of every output channel. */
+    Array<int> sourceChannels;
+    Array<int> sourceReferences;
+
+    /** Scratch buffer slot holding the source/reference of every output channel,
+        or -1 if it can be read straight from the buffer. */
+    Array<int> sourceSlots;
+    Array<int> referenceSlots;
+
+    /** Input channel saved in every scratch buffer slot, and the reverse lookup. */
+    Array<int> savedChannels;
+    Array<int> channelSlots;
+
+    int numMappedChannels;
+    bool mappingIsIdentity;
+
     AudioSampleBuffer channelBuffer;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ChannelMappingNode);
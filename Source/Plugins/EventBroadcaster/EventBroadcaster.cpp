@@ -10,6 +10,7 @@
 
 #include "EventBroadcaster.h"
 #include "EventBroadcasterEditor.h"
+#include <SpikeLib.h>
 
 std::shared_ptr<void> EventBroadcaster::getZMQContext() {
     // Note: C++11 guarantees that initialization of static local variables occurs exactly once, even
@@ -96,6 +97,7 @@ bool EventBroadcaster::isSink()
 void EventBroadcaster::handleEvent(int eventType, MidiMessage& event, int samplePosition)
 {
     const uint8_t* buffer = event.getRawData();
+    int numBytes = event.getRawDataSize();
     uint8_t type = buffer[0];
     int64_t timestamp;
     
@@ -108,9 +110,23 @@ void EventBroadcaster::handleEvent(int eventType, MidiMessage& event, int sample
             break;
         }
             
-        case SPIKE:
+        case SPIKE: {
+            // spikes from this process are handles into their source's pool;
+            // subscribers get the packed spike
+            if (const SpikeRecord* record = SpikePool::getSpike(buffer, numBytes))
+            {
+                numBytes = getPackedSpikeSize(record->nChannels, record->nSamples);
+
+                if (packedSpike.size() < size_t(numBytes))
+                    packedSpike.resize(numBytes);
+
+                packSpike(record, packedSpike.data(), numBytes);
+                buffer = packedSpike.data();
+            }
+
             std::copy_n(buffer + 1, sizeof(timestamp), reinterpret_cast<uint8_t *>(&timestamp));
             break;
+        }
             
         default:
             // Don't broadcast other event types
@@ -122,7 +138,7 @@ void EventBroadcaster::handleEvent(int eventType, MidiMessage& event, int sample
 #ifdef ZEROMQ
     if (-1 == zmq_send(zmqSocket.get(), &type, sizeof(type), ZMQ_SNDMORE) ||
         -1 == zmq_send(zmqSocket.get(), &timestampSeconds, sizeof(timestampSeconds), ZMQ_SNDMORE) ||
-        -1 == zmq_send(zmqSocket.get(), buffer + 1, event.getRawDataSize() - 1, 0) /* Omit event type */)
+        -1 == zmq_send(zmqSocket.get(), buffer + 1, numBytes - 1, 0) /* Omit event type */)
     {
         std::cout << "Failed to send message: " << zmq_strerror(zmq_errno()) << std::endl;
     }
@@ -24,6 +24,7 @@
 
 #endif
 #include <memory>
+#include <vector>
 
 class EventBroadcaster : public GenericProcessor
 {
@@ -52,6 +53,9 @@ private:
     
     float currentSampleRate;
 
+    /** Packed copy of the last spike, reused between events. */
+    std::vector<uint8_t> packedSpike;
+
 };
 
 
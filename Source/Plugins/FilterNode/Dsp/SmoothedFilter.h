@@ -47,6 +47,11 @@ namespace Dsp
 /*
  * Implements smooth modulation of time-varying filter parameters
  *
+ * Rather than redesigning the filter for every sample of a transition,
+ * the filter is only designed at keyframes spaced KeyframeInterval
+ * samples apart; in between, the coefficients are interpolated
+ * linearly from one keyframe design to the next.
+ *
  */
 template <class DesignClass,
          int Channels,
@@ -59,9 +64,15 @@ class SmoothedFilterDesign
 public:
     typedef FilterDesign <DesignClass, Channels, StateType> filter_type_t;
 
+    enum
+    {
+        KeyframeInterval = 32
+    };
+
     SmoothedFilterDesign(int transitionSamples)
         : m_transitionSamples(transitionSamples)
         , m_remainingSamples(-1)  // first time flag
+        , m_keyframeSamples(0)
     {
     }
 
@@ -80,18 +91,25 @@ public:
 
         if (remainingSamples > 0)
         {
-            // interpolate parameters for each sample
-            const double t = 1. / m_remainingSamples;
-            double dp[maxParameters];
-            for (int i = 0; i < DesignClass::NumParams; ++i)
-                dp[i] = (this->getParams()[i] - m_transitionParams[i]) * t;
-
             for (int n = 0; n < remainingSamples; ++n)
             {
-                for (int i = DesignClass::NumParams; --i >=0;)
-                    m_transitionParams[i] += dp[i];
+                if (m_keyframeSamples == 0)
+                {
+                    // design the next keyframe, interpolating parameters
+                    // linearly over the rest of the transition
+                    m_keyframeSamples = std::min(int(KeyframeInterval), m_remainingSamples);
+                    const double t = double(m_keyframeSamples) / m_remainingSamples;
+                    for (int i = DesignClass::NumParams; --i >= 0;)
+                        m_transitionParams[i] += (this->getParams()[i] - m_transitionParams[i]) * t;
+
+                    m_keyframeFilter.setParams(m_transitionParams);
+                }
 
-                m_transitionFilter.setParams(m_transitionParams);
+                // step the coefficients towards the keyframe, which they
+                // reach exactly on its last sample
+                m_transitionFilter.interpolateTowards(m_keyframeFilter, 1. / m_keyframeSamples);
+                --m_keyframeSamples;
+                --m_remainingSamples;
 
                 for (int i = numChannels; --i >= 0;)
                 {
@@ -100,8 +118,6 @@ public:
                 }
             }
 
-            m_remainingSamples -= remainingSamples;
-
             if (m_remainingSamples == 0)
                 m_transitionParams = this->getParams();
         }
@@ -132,24 +148,29 @@ protected:
     {
         if (m_remainingSamples >= 0)
         {
+            // start the new transition from wherever the current one is
             m_remainingSamples = m_transitionSamples;
+            m_keyframeSamples = 0;
         }
         else
         {
             // first time
             m_remainingSamples = 0;
             m_transitionParams = parameters;
+            m_transitionFilter.setParams(parameters);
         }
 
         filter_type_t::doSetParams(parameters);
     }
 
 protected:
-    Params m_transitionParams;
+    Params m_transitionParams;     // parameters of the latest keyframe
     DesignClass m_transitionFilter;
+    DesignClass m_keyframeFilter;
     int m_transitionSamples;
 
     int m_remainingSamples;        // remaining transition samples
+    int m_keyframeSamples;         // samples left until the next keyframe
 };
 
 }
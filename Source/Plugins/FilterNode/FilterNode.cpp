@@ -126,24 +126,25 @@ AudioProcessorEditor* FilterNode::createEditor()
 
 void FilterNode::updateSettings()
 {
-    //int id = nodeId;
     int numInputs = getNumInputs();
-    int numfilt = filters.size();
-    if (numInputs < 1024 && numInputs != numfilt)
+
+    // channels that are still there keep their filters, settings and state;
+    // only the difference in channel count is added or removed
+    if (filters.size() > numInputs)
     {
-        // SO fixed this. I think values were never restored correctly because you cleared lowCuts.
-        Array<double> oldlowCuts, oldhighCuts;
-        oldlowCuts = lowCuts;
-        oldhighCuts = highCuts;
+        int numRemoved = filters.size() - numInputs;
 
-        filters.clear();
-        lowCuts.clear();
-        highCuts.clear();
-        shouldFilterChannel.clear();
+        filters.removeLast(numRemoved);
+        filterSampleRates.removeLast(numRemoved);
+        shouldFilterChannel.removeLast(numRemoved);
+        lowCuts.removeLast(lowCuts.size() - numInputs);
+        highCuts.removeLast(highCuts.size() - numInputs);
+    }
 
-        for (int n = 0; n < getNumInputs(); n++)
+    for (int n = 0; n < numInputs; n++)
+    {
+        if (n >= filters.size())
         {
-
             // std::cout << "Creating filter number " << n << std::endl;
 
             filters.add(new Dsp::SmoothedFilterDesign
@@ -153,35 +154,20 @@ void FilterNode::updateSettings()
                         Dsp::DirectFormII>						// realization
                         (1));
 
-
-            //Parameter& p1 =  parameters.getReference(0);
-            //p1.setValue(600.0f, n);
-            //Parameter& p2 =  parameters.getReference(1);
-            //p2.setValue(6000.0f, n);
-
-            // restore defaults
-
+            filterSampleRates.add(0.0f);
             shouldFilterChannel.add(true);
 
-            float lc, hc;
-
-            if (oldlowCuts.size() > n)
-            {
-                lc = oldlowCuts[n];
-                hc = oldhighCuts[n];
-            }
-            else
+            // restore defaults
+            if (lowCuts.size() <= n)
             {
-                lc = defaultLowCut;
-                hc = defaultHighCut;
+                lowCuts.add(defaultLowCut);
+                highCuts.add(defaultHighCut);
             }
-
-            lowCuts.add(lc);
-            highCuts.add(hc);
-
-            setFilterParameters(lc, hc, n);
         }
 
+        // only redesign filters whose input rate changed
+        if (n < channels.size() && channels[n]->sampleRate != filterSampleRates[n])
+            setFilterParameters(lowCuts[n], highCuts[n], n);
     }
 
     setApplyOnADC(applyOnADC);
@@ -214,7 +200,10 @@ void FilterNode::setFilterParameters(double lowCut, double highCut, int chan)
     params[3] = highCut - lowCut; // bandwidth
 
     if (filters.size() > chan)
+    {
         filters[chan]->setParams(params);
+        filterSampleRates.set(chan, channels[chan]->sampleRate);
+    }
 
 }
 
@@ -70,6 +70,8 @@ private:
 
     Array<double> lowCuts, highCuts;
     OwnedArray<Dsp::Filter> filters;
+    /** The sample rate each filter was designed for. */
+    Array<float> filterSampleRates;
     Array<bool> shouldFilterChannel;
 
     bool applyOnADC;
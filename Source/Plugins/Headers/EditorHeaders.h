@@ -32,6 +32,7 @@ which should use VisualizerEditorHeaders.
 #include "../../Processors/Editors/ImageIcon.h"
 #include "../../Processors/Editors/ElectrodeButtons.h"
 #include "../../Processors/Editors/ChannelSelector.h"
+#include "../../Processors/Editors/OutputDispatcherMonitor.h"
 
 
 
@@ -27,3 +27,4 @@ representing, packing, unpacking and processing spike objects.
 */
 
 #include "../../Processors/Visualization/SpikeObject.h"
+#include "../../Processors/Visualization/SpikeRing.h"
@@ -170,6 +170,11 @@ void KWIKFileSource::fillRecordInfo()
 void KWIKFileSource::updateActiveRecord()
 {
     samplePos=0;
+
+    channelBitVolts.clearQuick();
+    for (int i=0; i < getActiveNumChannels(); i++)
+        channelBitVolts.add(getChannelInfo(i).bitVolts);
+
     try
     {
         String path = "/recordings/" + String(availableDataSets[activeRecord]) + "/data";
@@ -239,14 +244,18 @@ int KWIKFileSource::readData(int16* buffer, int nSamples)
 
 void KWIKFileSource::processChannelData(int16* inBuffer, float* outBuffer, int channel, int64 numSamples)
 {
-    int n = getActiveNumChannels();
-    float bitVolts = getChannelInfo(channel).bitVolts;
-
-    for (int i=0; i < numSamples; i++)
-    {
-        *(outBuffer+i) = *(inBuffer+(n*i)+channel) * bitVolts;
-    }
+    SampleConversion::int16ToFloat(inBuffer + channel, getActiveNumChannels(), outBuffer,
+                                   getChannelInfo(channel).bitVolts, int(numSamples));
+}
 
+void KWIKFileSource::processData(int16* inBuffer, float* const* outBuffers, int numChannels, int64 numSamples)
+{
+    // the data set is stored interleaved, one row per sample
+    if (numChannels == channelBitVolts.size())
+        SampleConversion::deinterleaveInt16ToFloat(inBuffer, outBuffers, channelBitVolts.getRawDataPointer(),
+                                                   numChannels, int(numSamples));
+    else
+        FileSource::processData(inBuffer, outBuffers, numChannels, numSamples);
 }
 
 bool KWIKFileSource::isReady()
@@ -49,6 +49,8 @@ public:
 
     void processChannelData(int16* inBuffer, float* outBuffer, int channel, int64 numSamples) override;
 
+    void processData(int16* inBuffer, float* const* outBuffers, int numChannels, int64 numSamples) override;
+
 	bool isReady() override;
 
 private:
@@ -59,6 +61,8 @@ private:
     void updateActiveRecord() override;
     int64 samplePos;
     Array<int> availableDataSets;
+    /** bitVolts of each channel of the active record */
+    Array<float> channelBitVolts;
 	bool skipRecordEngineCheck;
 };
 
@@ -900,13 +900,15 @@ KWXFile::KWXFile(String basename) : HDF5FileBase()
 {
     initFile(basename);
     numElectrodes=0;
-    transformVector.malloc(MAX_TRANSFORM_SIZE);
+    transformSize = MAX_TRANSFORM_SIZE;
+    transformVector.malloc(transformSize);
 }
 
 KWXFile::KWXFile() : HDF5FileBase()
 {
     numElectrodes=0;
-    transformVector.malloc(MAX_TRANSFORM_SIZE);
+    transformSize = MAX_TRANSFORM_SIZE;
+    transformVector.malloc(transformSize);
 }
 
 KWXFile::~KWXFile()
@@ -1004,6 +1006,14 @@ void KWXFile::writeSpike(int groupIndex, int nSamples, const uint16* data, uint6
         return;
     }
     int nChans= channelArray[groupIndex];
+
+    // large electrode groups can need more room than the default
+    if (nChans*nSamples > transformSize)
+    {
+        transformSize = nChans*nSamples;
+        transformVector.malloc(transformSize);
+    }
+
     int16* dst=transformVector;
 
     //Given the way we store spike data, we need to transpose it to store in
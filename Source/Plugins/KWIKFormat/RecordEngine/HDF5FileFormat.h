@@ -206,6 +206,7 @@ private:
     Array<int> channelArray;
     int numElectrodes;
 	HeapBlock<int16> transformVector;
+    int transformSize;
     //int16* transformVector;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(KWXFile);
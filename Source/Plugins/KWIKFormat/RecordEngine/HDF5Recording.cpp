@@ -30,7 +30,6 @@
 HDF5Recording::HDF5Recording() : processorIndex(-1), bufferSize(MAX_BUFFER_SIZE), hasAcquired(false)
 {
     //timestamp = 0;
-    scaledBuffer.malloc(MAX_BUFFER_SIZE);
     intBuffer.malloc(MAX_BUFFER_SIZE);
 }
 
@@ -66,7 +65,6 @@ void HDF5Recording::registerProcessor(const GenericProcessor* proc)
 
 void HDF5Recording::resetChannels()
 {
-	scaledBuffer.malloc(MAX_BUFFER_SIZE);
 	intBuffer.malloc(MAX_BUFFER_SIZE);
 	bufferSize = MAX_BUFFER_SIZE;
     processorIndex = -1;
@@ -186,7 +184,6 @@ void HDF5Recording::closeFiles()
 	recordedChanToKWDChan.clear();
 	channelTimestampArray.clear();
 	channelLeftOverSamples.clear();
-	scaledBuffer.malloc(MAX_BUFFER_SIZE);
 	intBuffer.malloc(MAX_BUFFER_SIZE);
 	bufferSize = MAX_BUFFER_SIZE;
 }
@@ -197,13 +194,11 @@ void HDF5Recording::writeData(int writeChannel, int realChannel, const float* bu
 	{
 		std::cerr << "Write buffer overrun, resizing to" << size << std::endl;
 		bufferSize = size;
-		scaledBuffer.malloc(size);
 		intBuffer.malloc(size);
 	}
-	double multFactor = 1 / (float(0x7fff) * getChannel(realChannel)->bitVolts);
 	int index = processorMap[getChannel(realChannel)->recordIndex];
-	FloatVectorOperations::copyWithMultiply(scaledBuffer.getData(), buffer, multFactor, size);
-	AudioDataConverters::convertFloatToInt16LE(scaledBuffer.getData(), intBuffer.getData(), size);
+	addClippedSamples(writeChannel, SampleConversion::floatToInt16LE(buffer, intBuffer.getData(),
+	                                                                 1.0f / getChannel(realChannel)->bitVolts, size));
 	fileArray[index]->writeRowData(intBuffer.getData(), size, recordedChanToKWDChan[writeChannel]);
 
 	int sampleOffset = channelLeftOverSamples[writeChannel];
@@ -245,20 +240,33 @@ void HDF5Recording::endChannelBlock(bool lastBlock)
 
 void HDF5Recording::writeEvent(int eventType, const MidiMessage& event, int64 timestamp)
 {
-    const uint8* dataptr = event.getRawData();
+    writeRawEvent(eventType, event.getRawData(), event.getRawDataSize(), timestamp);
+}
+
+void HDF5Recording::writeRawEvent(int eventType, const uint8* dataptr, int numBytes, int64 timestamp)
+{
+    if (numBytes < 6)
+        return;
+
     if (eventType == GenericProcessor::TTL)
         eventFile->writeEvent(0,*(dataptr+2),*(dataptr+1),(void*)(dataptr+3),timestamp);
     else if (eventType == GenericProcessor::MESSAGE)
         eventFile->writeEvent(1,*(dataptr+2),*(dataptr+1),(void*)(dataptr+6),timestamp);
 }
 
+void HDF5Recording::writeMessage(const uint8* data, int numBytes, int64 timestamp)
+{
+    if (numBytes >= 6)
+        eventFile->writeEvent(1,*(data+2),*(data+1),(void*)(data+6),timestamp);
+}
+
 void HDF5Recording::addSpikeElectrode(int index, const SpikeRecordInfo* elec)
 {
     spikesFile->addChannelGroup(elec->numChannels);
 }
-void HDF5Recording::writeSpike(int electrodeIndex, const SpikeObject& spike, int64 /*timestamp*/)
+void HDF5Recording::writeSpike(int electrodeIndex, const SpikeRecord& spike, int64 /*timestamp*/)
 {
-    spikesFile->writeSpike(electrodeIndex,spike.nSamples,spike.data,spike.timestamp);
+    spikesFile->writeSpike(electrodeIndex,spike.nSamples,spike.getData(),spike.timestamp);
 }
 
 void HDF5Recording::startAcquisition()
@@ -37,9 +37,11 @@ public:
 	void closeFiles() override;
 	void writeData(int writeChannel, int realChannel, const float* buffer, int size) override;
 	void writeEvent(int eventType, const MidiMessage& event, int64 timestamp) override;
+	void writeRawEvent(int eventType, const uint8* data, int numBytes, int64 timestamp) override;
+	void writeMessage(const uint8* data, int numBytes, int64 timestamp) override;
 	void addChannel(int index, const Channel* chan) override;
 	void addSpikeElectrode(int index,const  SpikeRecordInfo* elec) override;
-	void writeSpike(int electrodeIndex, const SpikeObject& spike, int64 timestamp) override;
+	void writeSpike(int electrodeIndex, const SpikeRecord& spike, int64 timestamp) override;
 	void registerProcessor(const GenericProcessor* processor) override;
 	void resetChannels() override;
 	void startAcquisition() override;
@@ -61,10 +63,8 @@ private:
     OwnedArray<HDF5RecordingInfo> infoArray;
     ScopedPointer<KWEFile> eventFile;
     ScopedPointer<KWXFile> spikesFile;
-	HeapBlock<float> scaledBuffer;
 	HeapBlock<int16> intBuffer;
 	int bufferSize;
-    //float* scaledBuffer;
     //int16* intBuffer;
 
     bool hasAcquired;
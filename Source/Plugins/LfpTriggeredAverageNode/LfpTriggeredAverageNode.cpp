@@ -269,7 +269,7 @@ void LfpTriggeredAverageNode::process(AudioSampleBuffer& buffer, MidiBuffer& eve
     // 1. place any new samples into the displayBuffer
     //std::cout << "Display node sample count: " << nSamples << std::endl; ///buffer.getNumSamples() << std::endl;
 
-    int nSamples = 100;
+    int nSamples = getNumValidSamples();
 
     totalSamples = nSamples; //nSamples;
     displayBufferIndexEvents = displayBufferIndex;
@@ -27,6 +27,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 
 const int MAX_MESSAGE_LENGTH = 64000;
+const int MESSAGE_QUEUE_SIZE = 256;
+
+// requests answered in one go before checking for a wake-up again
+const int MAX_REQUESTS_PER_BATCH = 64;
 
 
 #ifdef WIN32
@@ -144,35 +148,41 @@ StringTS::~StringTS()
 }
 
 /*********************************************/
-void* NetworkEvents::zmqcontext = nullptr;
+
+std::shared_ptr<void> NetworkEvents::getZMQContext()
+{
+    // one context for the library, as in the EventBroadcaster; it outlives
+    // every socket, so stopping the thread no longer means destroying it
+#ifdef ZEROMQ
+    static const std::shared_ptr<void> ctx(zmq_ctx_new(), zmq_ctx_destroy);
+#else
+    static const std::shared_ptr<void> ctx;
+#endif
+    return ctx;
+}
 
 NetworkEvents::NetworkEvents()
-    : GenericProcessor("Network Events"), Thread("NetworkThread"), threshold(200.0), bufferZone(5.0f), state(false)
+    : GenericProcessor("Network Events"), Thread("NetworkThread"),
+      zmqContext(getZMQContext()), wakeSender(nullptr), wakeReceiver(nullptr),
+      threshold(200.0), bufferZone(5.0f), state(false),
+      messageFifo(MESSAGE_QUEUE_SIZE)
 
 {
-    createZmqContext();
+    messageSlots.calloc(MESSAGE_QUEUE_SIZE);
+
     firstTime = true;
-    responder = nullptr;
     urlport = 5556;
     threadRunning = false;
     opensocket();
 
     sendSampleCount = false; // disable updating the continuous buffer sample counts,
     // since this processor only sends events
-    shutdown = false;
 }
 
 void NetworkEvents::setNewListeningPort(int port)
 {
-    // first, close existing thread.
+    // closesocket() returns once the thread has quit
     closesocket();
-    // allow some time for thread to quit
-#ifdef WIN32
-    Sleep(300);
-#else
-    usleep(300 * 1000);
-#endif
-
 
     urlport = port;
     opensocket();
@@ -180,7 +190,6 @@ void NetworkEvents::setNewListeningPort(int port)
 
 NetworkEvents::~NetworkEvents()
 {
-    shutdown = true;
     closesocket();
 }
 
@@ -189,20 +198,36 @@ bool NetworkEvents::closesocket()
 
     std::cout << "Disabling network node" << std::endl;
 
+    signalThreadShouldExit();
+
 #ifdef ZEROMQ
-    if (threadRunning)
-    {
-        zmq_close(responder);
-        zmq_ctx_destroy(zmqcontext); // this will cause the thread to exit
-        zmqcontext = nullptr;
+    // interrupts the thread's zmq_poll()
+    if (wakeSender != nullptr)
+        zmq_send(wakeSender, "", 0, ZMQ_DONTWAIT);
+#endif
 
-        if (!shutdown)
-            createZmqContext();// and this will take care that processor graph doesn't attempt to delete the context again
-    }
+    stopThread(2000);
+
+#ifdef ZEROMQ
+    if (wakeSender != nullptr)
+        zmq_close(wakeSender);
+
+    if (wakeReceiver != nullptr)
+        zmq_close(wakeReceiver);
 #endif
+
+    wakeSender = nullptr;
+    wakeReceiver = nullptr;
+    threadRunning = false;
+
     return true;
 }
 
+int NetworkEvents::getNumDroppedMessages() const
+{
+    return numDroppedMessages.get();
+}
+
 int NetworkEvents::getNumEventChannels()
 {
     return 1;
@@ -411,7 +436,23 @@ String NetworkEvents::handleSpecialMessages(StringTS msg)
 	StringArray inputs = StringArray::fromTokens(s, " ");
 	String cmd = String(inputs[0]);
 
-	const MessageManagerLock mmLock;
+	/** Plain event messages don't need the message thread */
+	static const char* const commands[] = { "StartAcquisition", "StopAcquisition", "StartRecord", "StopRecord",
+		"IsAcquiring", "IsRecording", "GetRecordingPath", "GetRecordingNumber", "GetExperimentNumber" };
+
+	bool isCommand = false;
+
+	for (int i = 0; i < numElementsInArray(commands); i++)
+		isCommand = isCommand || cmd.equalsIgnoreCase(commands[i]);
+
+	if (!isCommand)
+		return String("NotHandled");
+
+	/** Gives up if the network thread is asked to stop while waiting for the lock */
+	const MessageManagerLock mmLock(this);
+
+	if (!mmLock.lockWasGained())
+		return String("NotHandled");
 	if (cmd.compareIgnoreCase("StartAcquisition") == 0)
 	{
 		if (!CoreServices::getAcquisitionStatus())
@@ -521,23 +562,47 @@ void NetworkEvents::process(AudioSampleBuffer& buffer,
     checkForEvents(events);
     //simulateDesignAndTrials(events);
 
-    //std::cout << *buffer.getSampleData(0, 0) << std::endl;
-    lock.enter();
-    while (!networkMessagesQueue.empty())
+    // everything that arrived since the last block goes out together
+    const int numReady = messageFifo.getNumReady();
+
+    if (numReady > 0)
     {
-        StringTS msg = networkMessagesQueue.front();
-        postTimestamppedStringToMidiBuffer(msg, events);
-        CoreServices::sendStatusMessage(("Network event received: " + msg.getString()).toRawUTF8());
-        //			 getUIComponent()->getLogWindow()->addLineToLog(msg);
-        networkMessagesQueue.pop();
+        int start1, size1, start2, size2;
+        messageFifo.prepareToRead(numReady, start1, size1, start2, size2);
+
+        for (int i = 0; i < size1 + size2; i++)
+        {
+            MessageSlot& slot = messageSlots[i < size1 ? start1 + i : start2 + i - size1];
+
+            // the terminating zero is part of the event
+            addEvent(events,
+                     (uint8) MESSAGE,
+                     0,
+                     1,
+                     0,
+                     (uint8) (slot.length + 1),
+                     slot.data);
+        }
+
+        messageFifo.finishedRead(size1 + size2);
     }
-    lock.exit();
 
 }
 
 
 void NetworkEvents::opensocket()
 {
+#ifdef ZEROMQ
+    // inproc endpoints have to be bound before anything connects to them
+    const String wakeAddress = "inproc://network-events-" + String::toHexString((pointer_sized_int) this);
+
+    wakeReceiver = zmq_socket(zmqContext.get(), ZMQ_PAIR);
+    zmq_bind(wakeReceiver, wakeAddress.toRawUTF8());
+
+    wakeSender = zmq_socket(zmqContext.get(), ZMQ_PAIR);
+    zmq_connect(wakeSender, wakeAddress.toRawUTF8());
+#endif
+
     startThread();
 }
 
@@ -545,61 +610,165 @@ void NetworkEvents::run()
 {
 
 #ifdef ZEROMQ
-    responder = zmq_socket(zmqcontext, ZMQ_REP);
+    void* router = zmq_socket(zmqContext.get(), ZMQ_ROUTER);
     String url= String("tcp://*:")+String(urlport);
-    int rc = zmq_bind(responder, url.toRawUTF8());
+    int rc = zmq_bind(router, url.toRawUTF8());
 
     if (rc != 0)
     {
         // failed to open socket?
         std::cout << "Failed to open socket: " << zmq_strerror(zmq_errno()) << std::endl;
+        zmq_close(router);
         return;
     }
 
+    // replies to clients that went away are discarded on close
+    const int linger = 0;
+    zmq_setsockopt(router, ZMQ_LINGER, &linger, sizeof(linger));
+
     threadRunning = true;
-    unsigned char* buffer = new unsigned char[MAX_MESSAGE_LENGTH];
-    int result=-1;
+    HeapBlock<unsigned char> buffer(MAX_MESSAGE_LENGTH);
+
+    zmq_pollitem_t items[2];
+    items[0].socket = router;
+    items[0].fd = 0;
+    items[0].events = ZMQ_POLLIN;
+    items[1].socket = wakeReceiver;
+    items[1].fd = 0;
+    items[1].events = ZMQ_POLLIN;
 
-    while (threadRunning)
+    while (!threadShouldExit())
     {
+        items[0].revents = 0;
+        items[1].revents = 0;
 
-        result = zmq_recv(responder, buffer, MAX_MESSAGE_LENGTH-1, 0);  // blocking
+        // sleeps until a request arrives or closesocket() wakes us up
+        if (zmq_poll(items, 2, -1) < 0)
+        {
+            if (zmq_errno() == ETERM)
+                break;
 
-        juce::int64 timestamp_software = timer.getHighResolutionTicks();
+            continue;
+        }
 
-        if (result < 0) // will only happen when responder dies.
+        if (items[1].revents & ZMQ_POLLIN)
             break;
 
-        StringTS Msg(buffer, result, timestamp_software);
-        if (result > 0)
-        {
-            lock.enter();
-            networkMessagesQueue.push(Msg);
-            lock.exit();
-
-            //std::cout << "Received message!" << std::endl;
-            // handle special messages
-            String response = handleSpecialMessages(Msg);
+        // answer everything that is waiting before polling again
+        int numRequests = 0;
+        String request;
 
-            zmq_send(responder, response.getCharPointer(), response.length(), 0);
-        }
-        else
-        {
-            String zeroMessageError = "Recieved Zero Message?!?!?";
-            //std::cout << "Received Zero Message!" << std::endl;
+        while (numRequests < MAX_REQUESTS_PER_BATCH && handleRequest(router, buffer, request))
+            numRequests++;
 
-            zmq_send(responder, zeroMessageError.getCharPointer(), zeroMessageError.length(), 0);
-        }
+        if (numRequests == 1)
+            CoreServices::sendStatusMessage("Network event received: " + request);
+        else if (numRequests > 1)
+            CoreServices::sendStatusMessage(String(numRequests) + " network events received, last: " + request);
     }
 
-
-    zmq_close(responder);
-    delete[] buffer;
+    zmq_close(router);
     threadRunning = false;
     return;
 #endif
 }
 
+bool NetworkEvents::handleRequest(void* router, unsigned char* buffer, String& request)
+{
+#ifdef ZEROMQ
+    zmq_msg_t identity;
+    zmq_msg_init(&identity);
+
+    // the ROUTER prefixes every request with the client's identity
+    if (zmq_msg_recv(&identity, router, ZMQ_DONTWAIT) < 0)
+    {
+        zmq_msg_close(&identity);
+        return false;
+    }
+
+    juce::int64 timestamp_software = timer.getHighResolutionTicks();
+
+    // REQ clients send an empty delimiter before the request, DEALER clients
+    // usually don't; the reply uses the same envelope
+    bool delimited = false;
+    bool firstPart = true;
+    int result = -1;
+
+    for (;;)
+    {
+        int more = 0;
+        size_t moreSize = sizeof(more);
+        zmq_getsockopt(router, ZMQ_RCVMORE, &more, &moreSize);
+
+        if (!more)
+            break;
+
+        // only the first part after the envelope is the request
+        const int n = zmq_recv(router, buffer, result < 0 ? MAX_MESSAGE_LENGTH - 1 : 0, 0);
+
+        if (n < 0)
+            break;
+
+        if (firstPart && n == 0)
+            delimited = true;
+        else if (result < 0)
+            result = jmin(n, MAX_MESSAGE_LENGTH - 1);
+
+        firstPart = false;
+    }
+
+    String response;
+
+    if (result > 0)
+    {
+        StringTS Msg(buffer, result, timestamp_software);
+
+        if (!queueMessage(buffer, result, timestamp_software))
+            ++numDroppedMessages;
+
+        // handle special messages
+        response = handleSpecialMessages(Msg);
+        request = Msg.getString();
+    }
+    else
+    {
+        response = "Recieved Zero Message?!?!?";
+    }
+
+    zmq_msg_send(&identity, router, ZMQ_SNDMORE);
+    zmq_msg_close(&identity);
+
+    if (delimited)
+        zmq_send(router, "", 0, ZMQ_SNDMORE);
+
+    zmq_send(router, response.toRawUTF8(), response.getNumBytesAsUTF8(), ZMQ_DONTWAIT);
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool NetworkEvents::queueMessage(const unsigned char* buffer, int length, int64 timestamp)
+{
+    int start1, size1, start2, size2;
+    messageFifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    if (size1 == 0)
+        return false;
+
+    MessageSlot& slot = messageSlots[start1];
+
+    slot.timestamp = timestamp;
+    slot.length = jmin(length, int(sizeof(slot.data)) - 1);
+    memcpy(slot.data, buffer, slot.length);
+    slot.data[slot.length] = 0;
+
+    messageFifo.finishedWrite(1);
+
+    return true;
+}
+
 
 
 
@@ -662,14 +831,6 @@ void NetworkEvents::loadCustomParametersFromXml()
     }
 }
 
-void NetworkEvents::createZmqContext()
-{
-#ifdef ZEROMQ
-    if (zmqcontext == nullptr)
-        zmqcontext = zmq_ctx_new(); //<-- this is only available in version 3+
-#endif
-}
-
 StringPairArray NetworkEvents::parseNetworkMessage(String msg)
 {
 	StringArray splitted;
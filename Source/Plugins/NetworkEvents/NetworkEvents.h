@@ -40,12 +40,21 @@
 #include <ProcessorHeaders.h>
 
 #include <list>
+#include <memory>
 #include <queue>
 
 /**
 
  Sends incoming TCP/IP messages from 0MQ to the events buffer
 
+ The network thread serves any number of clients on a ROUTER socket, so REQ
+ clients get the usual one-reply-per-request behaviour while DEALER clients
+ can keep several requests in flight. It sleeps in zmq_poll() until a request
+ or a wake-up from closesocket() arrives, answers every request that is
+ waiting, and copies them into preallocated slots of a lock-free queue. The
+ audio thread adds everything that has arrived to the event buffer once per
+ block, without taking any lock.
+
   @see GenericProcessor
 
 */
@@ -105,6 +114,10 @@ public:
     void postTimestamppedStringToMidiBuffer(StringTS s, MidiBuffer& events);
     void setNewListeningPort(int port);
 
+    /** Returns the number of messages that didn't fit in the queue to the
+        event buffer (they were still answered). */
+    int getNumDroppedMessages() const;
+
     void saveCustomParametersToXml(XmlElement* parentElement);
     void loadCustomParametersFromXml();
 
@@ -113,23 +126,44 @@ public:
     bool threadRunning ;
 private:
     void handleEvent(int eventType, MidiMessage& event, int samplePos);
-    void createZmqContext();
+
+    static std::shared_ptr<void> getZMQContext();
+
+    /** Receives one request from the ROUTER socket and answers it. Returns
+        false if there was none waiting. */
+    bool handleRequest(void* router, unsigned char* buffer, String& request);
+
+    /** Copies a message into the queue to the audio thread. Network thread only. */
+    bool queueMessage(const unsigned char* buffer, int length, int64 timestamp);
+
+    /** Slot in the queue to the audio thread. Messages travel in MESSAGE
+        events, whose size is limited to 255 bytes including the terminator. */
+    struct MessageSlot
+    {
+        int64 timestamp;
+        int length;
+        uint8 data[255];
+    };
 
 	//* Split network message into name/value pairs (name1=val1 name2=val2 etc) */
 	StringPairArray parseNetworkMessage(String msg);
 
     StringTS createStringTS(String S, int64 t);
 
-    static void* zmqcontext;
-    void* responder;
+    const std::shared_ptr<void> zmqContext;
+
+    /** Connected pair of sockets used to wake the network thread. */
+    void* wakeSender;
+    void* wakeReceiver;
     float threshold;
     float bufferZone;
     bool state;
-    bool shutdown;
     Time timer;
-    std::queue<StringTS> networkMessagesQueue;
 
-    CriticalSection lock;
+    AbstractFifo messageFifo;
+    HeapBlock<MessageSlot> messageSlots;
+    Atomic<int> numDroppedMessages;
+
     std::queue<StringTS> simulation;
     int64 simulationStartTime;
     bool firstTime ;
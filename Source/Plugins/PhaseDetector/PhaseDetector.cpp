@@ -24,10 +24,12 @@
 #include <stdio.h>
 #include "PhaseDetector.h"
 #include "PhaseDetectorEditor.h"
+#include <ClosedLoopLib.h>
 
 PhaseDetector::PhaseDetector()
     : GenericProcessor("Phase Detector"), activeModule(-1),
-      risingPos(false), risingNeg(false), fallingPos(false), fallingNeg(false)
+      risingPos(false), risingNeg(false), fallingPos(false), fallingNeg(false),
+      closedLoopLane(nullptr)
 
 {
 
@@ -131,9 +133,22 @@ void PhaseDetector::updateSettings()
 
 bool PhaseDetector::enable()
 {
+    closedLoopLane = CoreServices::getClosedLoopLane();
+
     return true;
 }
 
+void PhaseDetector::addTrigger(MidiBuffer& events, const DetectorModule& module, int sampleNum, int state)
+{
+    addEvent(events, TTL, sampleNum, state, module.outputChan);
+
+    // let output devices listening on the closed-loop lane fire right away,
+    // rather than when the event reaches them through the signal chain
+    if (closedLoopLane != nullptr)
+        closedLoopLane->publish(nodeId, TTL, module.outputChan, state,
+                                getTimestamp(module.inputChan) + sampleNum);
+}
+
 void PhaseDetector::handleEvent(int eventType, MidiMessage& event, int sampleNum)
 {
     // MOVED GATING TO PULSE PAL OUTPUT!
@@ -191,7 +206,7 @@ void PhaseDetector::process(AudioSampleBuffer& buffer,
 
                     if (module.type == PEAK)
                     {
-                        addEvent(events, TTL, i, 1, module.outputChan);
+                        addTrigger(events, module, i, 1);
                         module.samplesSinceTrigger = 0;
                         module.wasTriggered = true;
                     }
@@ -204,7 +219,7 @@ void PhaseDetector::process(AudioSampleBuffer& buffer,
 
                     if (module.type == FALLING_ZERO)
                     {
-                        addEvent(events, TTL, i, 1, module.outputChan);
+                        addTrigger(events, module, i, 1);
                         module.samplesSinceTrigger = 0;
                         module.wasTriggered = true;
                     }
@@ -217,7 +232,7 @@ void PhaseDetector::process(AudioSampleBuffer& buffer,
 
                     if (module.type == TROUGH)
                     {
-                        addEvent(events, TTL, i, 1, module.outputChan);
+                        addTrigger(events, module, i, 1);
                         module.samplesSinceTrigger = 0;
                         module.wasTriggered = true;
                     }
@@ -230,7 +245,7 @@ void PhaseDetector::process(AudioSampleBuffer& buffer,
 
                     if (module.type == RISING_ZERO)
                     {
-                        addEvent(events, TTL, i, 1, module.outputChan);
+                        addTrigger(events, module, i, 1);
                         module.samplesSinceTrigger = 0;
                         module.wasTriggered = true;
                     }
@@ -245,7 +260,7 @@ void PhaseDetector::process(AudioSampleBuffer& buffer,
                 {
                     if (module.samplesSinceTrigger > 1000)
                     {
-                        addEvent(events, TTL, i, 0, module.outputChan);
+                        addTrigger(events, module, i, 0);
                         module.wasTriggered = false;
                     }
                     else
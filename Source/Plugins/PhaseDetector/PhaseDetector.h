@@ -29,6 +29,8 @@
 
 #define NUM_INTERVALS 5
 
+class ClosedLoopLane;
+
 /**
 
   Uses peaks to estimate the phase of a continuous signal.
@@ -94,8 +96,13 @@ private:
 
     void handleEvent(int eventType, MidiMessage& event, int sampleNum);
 
+    /** Adds a TTL event for a module and publishes it on the closed-loop lane. */
+    void addTrigger(MidiBuffer& events, const DetectorModule& module, int sampleNum, int state);
+
     bool risingPos, risingNeg, fallingPos, fallingNeg;
 
+    ClosedLoopLane* closedLoopLane;
+
     void estimateFrequency();
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PhaseDetector);
@@ -28,13 +28,15 @@
 
 
 PulsePalOutput::PulsePalOutput()
-    : GenericProcessor("Pulse Pal"), channelToChange(0)
+    : GenericProcessor("Pulse Pal"), channelToChange(0), useClosedLoopLane(false), acquisitionIsActive(false)
 {
 
     pulsePal.initialize();
 
     pulsePal.updateDisplay("GUI Connected","Click for menu");
 
+    dispatcher = new OutputDispatcher("Pulse Pal", this);
+
     for (int i = 0; i < 4; i++)
     {
         channelTtlTrigger.add(-1);
@@ -46,6 +48,8 @@ PulsePalOutput::PulsePalOutput()
 
 PulsePalOutput::~PulsePalOutput()
 {
+    // stop sending before the display update
+    dispatcher = nullptr;
 
     pulsePal.updateDisplay("PULSE PAL v1.0","Click for menu");
 }
@@ -70,9 +74,10 @@ void PulsePalOutput::handleEvent(int eventType, MidiMessage& event, int sampleNu
 
         for (int i = 0; i < channelTtlTrigger.size(); i++)
         {
-            if (eventId == 1 && eventChannel == channelTtlTrigger[i] && channelState[i])
+            // triggers already arrived through the closed-loop lane
+            if (!useClosedLoopLane && eventId == 1 && eventChannel == channelTtlTrigger[i] && channelState[i])
             {
-                pulsePal.triggerChannel(i+1);
+                triggerChannel(i+1);
             }
 
             if (eventChannel == channelTtlGate[i])
@@ -88,6 +93,71 @@ void PulsePalOutput::handleEvent(int eventType, MidiMessage& event, int sampleNu
 
 }
 
+void PulsePalOutput::closedLoopTriggerReceived(const ClosedLoopTrigger& trigger)
+{
+    if (trigger.eventType != TTL || trigger.state != 1)
+        return;
+
+    for (int i = 0; i < channelTtlTrigger.size(); i++)
+    {
+        if (trigger.channel == channelTtlTrigger[i] && channelState[i])
+        {
+            triggerChannel(i+1);
+        }
+    }
+}
+
+void PulsePalOutput::triggerChannel(int chan)
+{
+    // triggers are never redundant
+    dispatcher->queueCommand(chan, 1, false);
+}
+
+bool PulsePalOutput::sendOutputCommand(const OutputCommand& command)
+{
+    pulsePal.triggerChannel(command.target);
+    return true;
+}
+
+OutputDispatcher* PulsePalOutput::getOutputDispatcher()
+{
+    return dispatcher;
+}
+
+bool PulsePalOutput::enable()
+{
+    acquisitionIsActive = true;
+
+    dispatcher->resetStatistics();
+
+    if (useClosedLoopLane)
+        CoreServices::getClosedLoopLane()->addListener(this);
+
+    return true;
+}
+
+bool PulsePalOutput::disable()
+{
+    CoreServices::getClosedLoopLane()->removeListener(this);
+
+    acquisitionIsActive = false;
+
+    return true;
+}
+
+void PulsePalOutput::setUseClosedLoopLane(bool use)
+{
+    if (!acquisitionIsActive)
+        setParameter(3, use ? 1.0f : 0.0f);
+    else
+        CoreServices::sendStatusMessage("Cannot change trigger source while acquisition is active.");
+}
+
+bool PulsePalOutput::getUseClosedLoopLane()
+{
+    return useClosedLoopLane;
+}
+
 void PulsePalOutput::setParameter(int parameterIndex, float newValue)
 {
     editor->updateParameterButtons(parameterIndex);
@@ -113,6 +183,9 @@ void PulsePalOutput::setParameter(int parameterIndex, float newValue)
                 channelState.set(channelToChange, false);
             }
 
+            break;
+        case 3:
+            useClosedLoopLane = (newValue > 0);
             break;
         default:
             std::cout << "Unrecognized parameter index." << std::endl;
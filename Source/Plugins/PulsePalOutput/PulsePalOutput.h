@@ -25,6 +25,7 @@
 #define __PULSEPALOUTPUT_H_A8BF66D6__
 
 #include <ProcessorHeaders.h>
+#include <ClosedLoopLib.h>
 #include "PulsePalOutputEditor.h"
 #include "serial/PulsePal.h"
 
@@ -33,11 +34,16 @@
   Allows the signal chain to send outputs to the Pulse Pal
   from Lucid Biosystems (www.lucidbiosystems.com)
 
+  Triggers are sent by an OutputDispatcher on its own thread, so a slow
+  serial port never holds up the signal chain.
+
   @see GenericProcessor, PulsePalOutputEditor, PulsePal
 
 */
 
-class PulsePalOutput : public GenericProcessor
+class PulsePalOutput : public GenericProcessor,
+                       public ClosedLoopLane::Listener,
+                       public OutputDispatcher::Device
 
 {
 public:
@@ -50,6 +56,26 @@ public:
 
     void handleEvent(int eventType, MidiMessage& event, int sampleNum);
 
+    /** Triggers the Pulse Pal as soon as a detector publishes a trigger, when
+    the closed-loop lane is in use. Called on the lane thread. */
+    void closedLoopTriggerReceived(const ClosedLoopTrigger& trigger);
+
+    /** Triggers a Pulse Pal channel. Called on the dispatcher thread. */
+    bool sendOutputCommand(const OutputCommand& command);
+
+    /** Queues a trigger for a Pulse Pal channel (1-4). */
+    void triggerChannel(int chan);
+
+    OutputDispatcher* getOutputDispatcher();
+
+    bool enable();
+    bool disable();
+
+    /** When enabled, triggers are taken from the closed-loop lane instead of
+    the event buffer; gate events still arrive through the event buffer. */
+    void setUseClosedLoopLane(bool);
+    bool getUseClosedLoopLane();
+
     AudioProcessorEditor* createEditor();
 
     bool isSink()
@@ -65,8 +91,14 @@ private:
 
     int channelToChange;
 
+    bool useClosedLoopLane;
+    bool acquisitionIsActive;
+
     PulsePal pulsePal;
 
+    /** Sends triggers to the Pulse Pal; destroyed before it. */
+    ScopedPointer<OutputDispatcher> dispatcher;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PulsePalOutput);
 
 };
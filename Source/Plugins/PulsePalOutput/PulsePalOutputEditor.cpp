@@ -32,7 +32,7 @@ PulsePalOutputEditor::PulsePalOutputEditor(GenericProcessor* parentNode, PulsePa
 
 {
 
-    desiredWidth = 315;
+    desiredWidth = 370;
 
     for (int i = 1; i < 5; i++)
     {
@@ -46,6 +46,18 @@ PulsePalOutputEditor::PulsePalOutputEditor(GenericProcessor* parentNode, PulsePa
 
     }
 
+    closedLoopButton = new UtilityButton("FAST", Font("Small Text", 10, Font::plain));
+    closedLoopButton->setRadius(3.0f);
+    closedLoopButton->setBounds(315,30,45,20);
+    closedLoopButton->addListener(this);
+    closedLoopButton->setClickingTogglesState(true);
+    closedLoopButton->setTooltip("Take triggers from the closed-loop lane, firing as soon as a detector publishes them");
+    addAndMakeVisible(closedLoopButton);
+
+    dispatcherMonitor = new OutputDispatcherMonitor(((PulsePalOutput*) getProcessor())->getOutputDispatcher());
+    dispatcherMonitor->setBounds(315,55,55,24);
+    addAndMakeVisible(dispatcherMonitor);
+
 
 }
 
@@ -59,6 +71,7 @@ void PulsePalOutputEditor::saveCustomParameters(XmlElement* xml)
 {
 
     xml->setAttribute("Type", "PulsePalOutputEditor");
+    xml->setAttribute("ClosedLoop", closedLoopButton->getToggleState());
 
     for (int i = 0; i < 4; i++)
     {
@@ -74,6 +87,8 @@ void PulsePalOutputEditor::saveCustomParameters(XmlElement* xml)
 void PulsePalOutputEditor::loadCustomParameters(XmlElement* xml)
 {
 
+    closedLoopButton->setToggleState(xml->getBoolAttribute("ClosedLoop", false), sendNotification);
+
     forEachXmlChildElement(*xml, xmlNode)
     {
         if (xmlNode->hasTagName("OUTPUTCHANNEL"))
@@ -88,6 +103,17 @@ void PulsePalOutputEditor::loadCustomParameters(XmlElement* xml)
     }
 }
 
+void PulsePalOutputEditor::buttonEvent(Button* button)
+{
+    if (button == closedLoopButton)
+    {
+        PulsePalOutput* processor = (PulsePalOutput*) getProcessor();
+
+        processor->setUseClosedLoopLane(button->getToggleState());
+        button->setToggleState(processor->getUseClosedLoopLane(), dontSendNotification);
+    }
+}
+
 
 //-----------------------------------------------
 
@@ -150,7 +176,7 @@ void ChannelTriggerInterface::paint(Graphics& g)
 
 void ChannelTriggerInterface::buttonClicked(Button* button)
 {
-    pulsePal->triggerChannel(channelNumber);
+    processor->triggerChannel(channelNumber);
 }
 
 void ChannelTriggerInterface::comboBoxChanged(ComboBox* comboBoxThatHasChanged)
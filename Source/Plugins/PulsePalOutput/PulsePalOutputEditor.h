@@ -53,9 +53,14 @@ private:
 
     PulsePal* pulsePal;
 
+    ScopedPointer<UtilityButton> closedLoopButton;
+    ScopedPointer<OutputDispatcherMonitor> dispatcherMonitor;
+
     void saveCustomParameters(XmlElement* xml);
     void loadCustomParameters(XmlElement* xml);
 
+    void buttonEvent(Button* button);
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PulsePalOutputEditor);
 
 };
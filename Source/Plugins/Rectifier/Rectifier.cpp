@@ -59,16 +59,12 @@ void Rectifier::setParameter(int parameterIndex, float newValue)
 void Rectifier::process(AudioSampleBuffer& buffer,
                         MidiBuffer& events)
 {
-    int nChannels = buffer.getNumChannels();
-    
-    for (int ch = 0; ch < nChannels ; ch++)
+    forEachValidRange(buffer, [] (int, float* bufPtr, int nSamples)
     {
-        int nSamples = buffer.getNumSamples();
-        float* bufPtr = buffer.getWritePointer(ch);
         for (int n = 0; n < nSamples; n++)
         {
             *(bufPtr + n) = fabsf(*(bufPtr + n));
         }
-    }
+    });
     
 }
@@ -0,0 +1,235 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2016 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "PolyphaseResampler.h"
+
+// half-length of the filter, in zero crossings of the sinc
+#define FILTER_ZERO_CROSSINGS 16
+// fraction of the lower Nyquist frequency that is passed
+#define FILTER_PASSBAND 0.9
+// Kaiser window shape; about 80 dB of stopband attenuation
+#define FILTER_KAISER_BETA 8.0
+
+namespace
+{
+    // zeroth-order modified Bessel function of the first kind
+    double besselI0(double x)
+    {
+        double sum = 1.0;
+        double term = 1.0;
+
+        for (int k = 1; k < 50; k++)
+        {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+
+            if (term < sum * 1e-12)
+                break;
+        }
+
+        return sum;
+    }
+}
+
+PolyphaseResampler::PolyphaseResampler()
+    : up(1), down(1), numChannels(0), tapsPerPhase(1),
+      frameCapacity(0), numFrames(0), position(0), phase(0), numDropped(0)
+{
+}
+
+void PolyphaseResampler::getRatio(double inputRate, double outputRate, int maxFactor, int& up, int& down)
+{
+    up = down = 1;
+
+    if (inputRate <= 0 || outputRate <= 0)
+        return;
+
+    // most rates are whole numbers of Hz, and then the ratio is exact
+    const int64 inputHz = int64(inputRate + 0.5);
+    const int64 outputHz = int64(outputRate + 0.5);
+
+    if (std::abs(inputRate - double(inputHz)) < 1e-6 && std::abs(outputRate - double(outputHz)) < 1e-6)
+    {
+        int64 a = inputHz, b = outputHz;
+
+        while (b != 0)
+        {
+            const int64 t = a % b;
+            a = b;
+            b = t;
+        }
+
+        if (outputHz / a <= maxFactor && inputHz / a <= maxFactor)
+        {
+            up = int(outputHz / a);
+            down = int(inputHz / a);
+            return;
+        }
+    }
+
+    // otherwise take the best continued-fraction approximation that fits
+    const double target = outputRate / inputRate;
+    double x = target;
+    int64 p0 = 0, q0 = 1, p1 = 1, q1 = 0;
+
+    for (int i = 0; i < 64; i++)
+    {
+        const int64 a = int64(std::floor(x));
+        const int64 p2 = a * p1 + p0;
+        const int64 q2 = a * q1 + q0;
+
+        if (p2 > maxFactor || q2 > maxFactor)
+            break;
+
+        p0 = p1; q0 = q1;
+        p1 = p2; q1 = q2;
+
+        if (x - double(a) < 1e-12 || std::abs(double(p1) / double(q1) - target) < 1e-12)
+            break;
+
+        x = 1.0 / (x - double(a));
+    }
+
+    up = int(jmax<int64>(1, p1));
+    down = int(jmax<int64>(1, q1));
+}
+
+void PolyphaseResampler::prepare(int up_, int down_, int numChannels_, int maxInputSamples)
+{
+    up = jmax(1, up_);
+    down = jmax(1, down_);
+    numChannels = jmax(1, numChannels_);
+
+    // prototype low-pass filter at the upsampled rate, cut off below the lower
+    // of the two Nyquist frequencies
+    const int factor = jmax(up, down);
+    const int numTaps = 2 * FILTER_ZERO_CROSSINGS * factor + 1;
+    const double cutoff = FILTER_PASSBAND * 0.5 / factor; // cycles per upsampled sample
+    const double centre = (numTaps - 1) / 2.0;
+    const double windowScale = 1.0 / besselI0(FILTER_KAISER_BETA);
+
+    tapsPerPhase = (numTaps + up - 1) / up;
+    coefficients.calloc(size_t(tapsPerPhase) * up);
+
+    for (int n = 0; n < numTaps; n++)
+    {
+        const double t = n - centre;
+        const double sinc = (t == 0) ? 2.0 * cutoff
+                                     : std::sin(2.0 * double_Pi * cutoff * t) / (double_Pi * t);
+        const double r = t / centre;
+        const double window = besselI0(FILTER_KAISER_BETA * std::sqrt(jmax(0.0, 1.0 - r * r))) * windowScale;
+
+        // tap n of the prototype belongs to phase n % up; the gain of up makes
+        // up for the zeros the upsampling inserts
+        coefficients[(n % up) * tapsPerPhase + n / up] = float(sinc * window * up);
+    }
+
+    // room for the history, a block of input and a backlog of as much again
+    frameCapacity = tapsPerPhase - 1 + 2 * jmax(1, maxInputSamples);
+    frames.malloc(size_t(frameCapacity) * numChannels);
+    accumulator.malloc(numChannels);
+
+    reset();
+}
+
+void PolyphaseResampler::reset()
+{
+    numFrames = tapsPerPhase - 1;
+    position = numFrames;
+    phase = 0;
+    numDropped = 0;
+
+    if (frames != nullptr)
+        FloatVectorOperations::clear(frames, numFrames * numChannels);
+}
+
+double PolyphaseResampler::getDelay() const
+{
+    const int numTaps = 2 * FILTER_ZERO_CROSSINGS * jmax(up, down) + 1;
+
+    return (numTaps - 1) / (2.0 * down);
+}
+
+int PolyphaseResampler::process(AudioSampleBuffer& buffer, int numInputSamples, int maxOutputSamples)
+{
+    const int nChannels = jmin(numChannels, buffer.getNumChannels());
+
+    if (numFrames + numInputSamples > frameCapacity)
+    {
+        numDropped += numFrames + numInputSamples - frameCapacity;
+        numInputSamples = frameCapacity - numFrames;
+    }
+
+    // interleave the new input after what's left from the last block
+    for (int chan = 0; chan < nChannels; chan++)
+    {
+        const float* src = buffer.getReadPointer(chan);
+        float* dest = frames + size_t(numFrames) * numChannels + chan;
+
+        for (int n = 0; n < numInputSamples; n++)
+            dest[n * numChannels] = src[n];
+    }
+
+    numFrames += numInputSamples;
+
+    int numOutputSamples = 0;
+
+    while (position < numFrames && numOutputSamples < maxOutputSamples)
+    {
+        const float* h = coefficients + phase * tapsPerPhase;
+        const float* x = frames + size_t(position) * numChannels;
+
+        // one tap at a time across all channels
+        FloatVectorOperations::copyWithMultiply(accumulator, x, h[0], numChannels);
+
+        for (int k = 1; k < tapsPerPhase; k++)
+        {
+            if (h[k] != 0.0f)
+                FloatVectorOperations::addWithMultiply(accumulator, x - k * numChannels, h[k], numChannels);
+        }
+
+        for (int chan = 0; chan < nChannels; chan++)
+            buffer.getWritePointer(chan)[numOutputSamples] = accumulator[chan];
+
+        numOutputSamples++;
+
+        phase += down;
+        position += phase / up;
+        phase %= up;
+    }
+
+    // keep the frames the next output still needs; when downsampling the
+    // next position may lie beyond the input we have so far
+    const int firstNeeded = jmin(position - (tapsPerPhase - 1), numFrames);
+
+    if (firstNeeded > 0)
+    {
+        memmove(frames, frames + size_t(firstNeeded) * numChannels,
+                sizeof(float) * size_t(numFrames - firstNeeded) * numChannels);
+
+        numFrames -= firstNeeded;
+        position -= firstNeeded;
+    }
+
+    return numOutputSamples;
+}
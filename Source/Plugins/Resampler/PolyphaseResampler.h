@@ -0,0 +1,106 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2016 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef POLYPHASERESAMPLER_H_INCLUDED
+#define POLYPHASERESAMPLER_H_INCLUDED
+
+#include "../../../JuceLibraryCode/JuceHeader.h"
+
+/**
+
+  Converts blocks of multichannel data between two sample rates whose ratio
+  is an exact fraction up / down.
+
+  Conceptually the input is upsampled by inserting up - 1 zeros after every
+  sample, low-pass filtered with a Kaiser-windowed sinc and decimated by down;
+  the polyphase form only evaluates the filter taps that land on real input
+  samples for the outputs that are kept. The position within the input, in
+  steps of 1 / up of a sample, is carried over from one block to the next, so
+  splitting the data into blocks doesn't change the result.
+
+  Samples are stored interleaved (one frame of every channel after another),
+  so each filter tap is applied to all channels at once with a single vector
+  operation.
+
+  @see Resampler
+
+*/
+
+class PolyphaseResampler
+{
+public:
+    PolyphaseResampler();
+
+    /** Finds the closest fraction up / down to outputRate / inputRate with
+        neither term above maxFactor. */
+    static void getRatio(double inputRate, double outputRate, int maxFactor, int& up, int& down);
+
+    /** Designs the filter and allocates the history for the given ratio.
+        Not real-time safe. */
+    void prepare(int up, int down, int numChannels, int maxInputSamples);
+
+    /** Forgets all past input. */
+    void reset();
+
+    /** Reads numInputSamples from each of the first numChannels channels of
+        the buffer and writes up to maxOutputSamples resampled samples back
+        into it, starting at sample 0. Returns the number of samples written.
+        Input that can't be turned into output yet is kept for the next call. */
+    int process(AudioSampleBuffer& buffer, int numInputSamples, int maxOutputSamples);
+
+    /** Delay of the filter, in output samples. */
+    double getDelay() const;
+
+    int getUpFactor() const     { return up; }
+    int getDownFactor() const   { return down; }
+
+    /** Returns the number of input samples that were discarded because more
+        input arrived than could be turned into output. */
+    int getNumDropped() const   { return numDropped; }
+
+private:
+    int up;
+    int down;
+    int numChannels;
+    int tapsPerPhase;
+
+    /** One row of tapsPerPhase coefficients per phase; tap 0 applies to the
+        newest input sample. */
+    HeapBlock<float> coefficients;
+
+    /** Interleaved input, including tapsPerPhase - 1 frames of history. */
+    HeapBlock<float> frames;
+    int frameCapacity;
+    int numFrames;
+
+    /** Newest input frame used by the next output, and its filter phase. */
+    int position;
+    int phase;
+
+    HeapBlock<float> accumulator;
+    int numDropped;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PolyphaseResampler);
+};
+
+#endif  // POLYPHASERESAMPLER_H_INCLUDED
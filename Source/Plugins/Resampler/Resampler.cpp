@@ -0,0 +1,178 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2016 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "Resampler.h"
+#include "ResamplerEditor.h"
+
+// largest block the graph hands to a processor
+#define MAX_BLOCK_SAMPLES 4096
+
+Resampler::Resampler()
+    : GenericProcessor("Resampler"),
+      targetSampleRate(2500.0f),
+      inputSampleRate(0.0f),
+      upFactor(1),
+      downFactor(1),
+      inputSourceNodeId(-1),
+      outputTimestamp(0),
+      firstBlock(true)
+{
+}
+
+Resampler::~Resampler()
+{
+}
+
+AudioProcessorEditor* Resampler::createEditor()
+{
+    editor = new ResamplerEditor(this, true);
+    return editor;
+}
+
+void Resampler::updateSettings()
+{
+    inputSampleRate = channels.size() > 0 ? channels[0]->sampleRate : settings.sampleRate;
+    inputSourceNodeId = channels.size() > 0 ? channels[0]->sourceNodeId : -1;
+
+    PolyphaseResampler::getRatio(inputSampleRate, targetSampleRate, maxFactor, upFactor, downFactor);
+
+    const float outputSampleRate = inputSampleRate * upFactor / downFactor;
+
+    bool severalSources = false;
+
+    // from here on the channels are a stream of their own, with this
+    // processor's sample counts and timestamps
+    for (int i = 0; i < channels.size(); i++)
+    {
+        if (channels[i]->sourceNodeId != inputSourceNodeId)
+            severalSources = true;
+
+        channels[i]->sampleRate = outputSampleRate;
+        channels[i]->sourceNodeId = nodeId;
+    }
+
+    if (severalSources)
+        std::cout << "Resampler: input channels come from more than one source; "
+                  << "all of them will be resampled with the sample counts of the first." << std::endl;
+
+    settings.sampleRate = outputSampleRate;
+
+    std::cout << "Resampler: " << inputSampleRate << " Hz -> " << outputSampleRate
+              << " Hz (x " << upFactor << " / " << downFactor << ")" << std::endl;
+}
+
+bool Resampler::enable()
+{
+    resampler.prepare(upFactor, downFactor, channels.size(), MAX_BLOCK_SAMPLES);
+
+    firstBlock = true;
+    outputTimestamp = 0;
+
+    return true;
+}
+
+bool Resampler::disable()
+{
+    if (resampler.getNumDropped() > 0)
+        std::cout << "Resampler: " << resampler.getNumDropped()
+                  << " input samples dropped because the output couldn't keep up." << std::endl;
+
+    return true;
+}
+
+void Resampler::process(AudioSampleBuffer& buffer, MidiBuffer& events)
+{
+    std::map<uint8, int>::const_iterator count = numSamples.find(uint8(inputSourceNodeId));
+    const int nSamples = (count != numSamples.end()) ? jmin(count->second, buffer.getNumSamples()) : 0;
+
+    if (firstBlock && nSamples > 0)
+    {
+        // output sample j stands for input sample (j + delay) * down / up, so
+        // the stream's timestamps continue those of its source
+        std::map<uint8, int64>::const_iterator ts = timestamps.find(uint8(inputSourceNodeId));
+        const int64 inputTimestamp = (ts != timestamps.end()) ? ts->second : 0;
+
+        outputTimestamp = int64(std::floor(double(inputTimestamp) * upFactor / downFactor
+                                           - resampler.getDelay() + 0.5));
+        firstBlock = false;
+    }
+
+    int nOutput = 0;
+
+    if (channels.size() > 0)
+        nOutput = resampler.process(buffer, nSamples, buffer.getNumSamples());
+
+    setNumSamples(events, nOutput);
+    setTimestamp(events, outputTimestamp);
+
+    outputTimestamp += nOutput;
+}
+
+void Resampler::setTargetSampleRate(float rate)
+{
+    if (rate <= 0)
+        return;
+
+    targetSampleRate = rate;
+}
+
+float Resampler::getTargetSampleRate() const
+{
+    return targetSampleRate;
+}
+
+float Resampler::getInputSampleRate() const
+{
+    return inputSampleRate;
+}
+
+int Resampler::getUpFactor() const
+{
+    return upFactor;
+}
+
+int Resampler::getDownFactor() const
+{
+    return downFactor;
+}
+
+void Resampler::saveCustomParametersToXml(XmlElement* parentElement)
+{
+    XmlElement* mainNode = parentElement->createNewChildElement("RESAMPLER");
+    mainNode->setAttribute("targetSampleRate", targetSampleRate);
+}
+
+void Resampler::loadCustomParametersFromXml()
+{
+    if (parametersAsXml)
+    {
+        forEachXmlChildElement(*parametersAsXml, mainNode)
+        {
+            if (mainNode->hasTagName("RESAMPLER"))
+                setTargetSampleRate(float(mainNode->getDoubleAttribute("targetSampleRate", targetSampleRate)));
+        }
+    }
+
+    if (editor != nullptr)
+        static_cast<ResamplerEditor*>(getEditor())->updateSettings();
+}
@@ -0,0 +1,116 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2016 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef RESAMPLER_H_INCLUDED
+#define RESAMPLER_H_INCLUDED
+
+#include <ProcessorHeaders.h>
+#include "PolyphaseResampler.h"
+
+/**
+
+  Changes the sample rate of continuous data, e.g. to bring 30 kHz probe
+  data down to an LFP rate early in the signal chain so that everything
+  after it has less to do.
+
+  The ratio between the input and output rates is an exact fraction (see
+  PolyphaseResampler). Downstream, the resampled channels are a stream of
+  their own: their Channel::sampleRate is the new rate and their source is
+  this processor, which sends its own sample counts and timestamps (in
+  samples at the new rate, corrected for the filter delay). Processors that
+  look these up per channel, such as the RecordNode and the LFP Viewer, can
+  therefore mix resampled and original channels.
+
+  All input channels are expected to come from one source.
+
+  @see PolyphaseResampler, GenericProcessor
+
+*/
+
+class Resampler : public GenericProcessor
+{
+public:
+    Resampler();
+    ~Resampler();
+
+    AudioProcessorEditor* createEditor() override;
+
+    bool hasEditor() const override
+    {
+        return true;
+    }
+
+    /** The resampled channels get their sample counts and timestamps from here. */
+    bool generatesTimestamps() override
+    {
+        return true;
+    }
+
+    /** The output has a different number of samples than the input. */
+    bool processesWholeBuffer() override
+    {
+        return true;
+    }
+
+    void updateSettings() override;
+
+    bool enable() override;
+    bool disable() override;
+
+    void process(AudioSampleBuffer& buffer, MidiBuffer& events) override;
+
+    /** Sets the requested output rate; the actual rate is the nearest one
+        that is an exact fraction of the input rate (getSampleRate()). */
+    void setTargetSampleRate(float rate);
+    float getTargetSampleRate() const;
+
+    /** Returns the sample rate of the incoming data. */
+    float getInputSampleRate() const;
+
+    int getUpFactor() const;
+    int getDownFactor() const;
+
+    void saveCustomParametersToXml(XmlElement* parentElement) override;
+    void loadCustomParametersFromXml() override;
+
+private:
+    /** Largest up or down factor, which bounds the filter length. */
+    static const int maxFactor = 1024;
+
+    float targetSampleRate;
+    float inputSampleRate;
+    int upFactor;
+    int downFactor;
+
+    /** Node that supplies the sample counts and timestamps of the input. */
+    int inputSourceNodeId;
+
+    PolyphaseResampler resampler;
+
+    int64 outputTimestamp;
+    bool firstBlock;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Resampler);
+};
+
+#endif  // RESAMPLER_H_INCLUDED
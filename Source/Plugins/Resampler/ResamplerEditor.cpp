@@ -0,0 +1,98 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2016 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "ResamplerEditor.h"
+#include "Resampler.h"
+
+ResamplerEditor::ResamplerEditor(GenericProcessor* parentNode, bool useDefaultParameterEditors)
+    : GenericEditor(parentNode, useDefaultParameterEditors)
+{
+    desiredWidth = 180;
+
+    processor = (Resampler*) parentNode;
+
+    rateLabel = new Label("Rate", "Rate (Hz):");
+    rateLabel->setBounds(5,30,70,20);
+    rateLabel->setFont(Font("Small Text", 12, Font::plain));
+    addAndMakeVisible(rateLabel);
+
+    rateValue = new Label("Rate value", String::empty);
+    rateValue->setBounds(75,32,70,18);
+    rateValue->setFont(Font("Default", 13, Font::plain));
+    rateValue->setColour(Label::textColourId, Colours::white);
+    rateValue->setColour(Label::backgroundColourId, Colours::grey);
+    rateValue->setEditable(true);
+    rateValue->setTooltip("Output sample rate; rounded to an exact fraction of the input rate");
+    rateValue->addListener(this);
+    addAndMakeVisible(rateValue);
+
+    ratioLabel = new Label("Ratio", String::empty);
+    ratioLabel->setBounds(5,60,170,20);
+    ratioLabel->setFont(Font("Small Text", 11, Font::plain));
+    ratioLabel->setColour(Label::textColourId, Colours::darkgrey);
+    addAndMakeVisible(ratioLabel);
+
+    updateSettings();
+}
+
+void ResamplerEditor::updateSettings()
+{
+    rateValue->setText(String(processor->getTargetSampleRate(), 0), dontSendNotification);
+
+    String text;
+
+    if (processor->getInputSampleRate() > 0)
+    {
+        text << String(processor->getSampleRate(), 1) << " Hz (x " << processor->getUpFactor()
+             << " / " << processor->getDownFactor() << ")";
+    }
+
+    ratioLabel->setText(text, dontSendNotification);
+}
+
+void ResamplerEditor::labelTextChanged(Label* label)
+{
+    if (label == rateValue)
+    {
+        processor->setTargetSampleRate(label->getText().getFloatValue());
+
+        // downstream processors need to know the new rate
+        CoreServices::updateSignalChain(this);
+    }
+
+    updateSettings();
+}
+
+void ResamplerEditor::startAcquisition()
+{
+    GenericEditor::startAcquisition();
+
+    rateValue->setEditable(false);
+}
+
+void ResamplerEditor::stopAcquisition()
+{
+    GenericEditor::stopAcquisition();
+
+    rateValue->setEditable(true);
+}
@@ -0,0 +1,64 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2016 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef RESAMPLEREDITOR_H_INCLUDED
+#define RESAMPLEREDITOR_H_INCLUDED
+
+#include <EditorHeaders.h>
+
+class Resampler;
+
+/**
+
+  User interface for the Resampler: the requested output rate, and the
+  rate and ratio actually used.
+
+  @see Resampler
+
+*/
+
+class ResamplerEditor : public GenericEditor,
+                        public Label::Listener
+{
+public:
+    ResamplerEditor(GenericProcessor* parentNode, bool useDefaultParameterEditors);
+
+    void labelTextChanged(Label* label) override;
+
+    void startAcquisition() override;
+    void stopAcquisition() override;
+
+    /** Shows the processor's current settings, e.g. after loading them. */
+    void updateSettings();
+
+private:
+    Resampler* processor;
+
+    ScopedPointer<Label> rateLabel;
+    ScopedPointer<Label> rateValue;
+    ScopedPointer<Label> ratioLabel;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ResamplerEditor);
+};
+
+#endif  // RESAMPLEREDITOR_H_INCLUDED
@@ -28,12 +28,16 @@
 const int SerialInput::BAUDRATES[12] = {300, 1200, 2400, 4800, 9600, 14400, 19200, 28800, 38400, 57600, 115200, 230400};
 
 SerialInput::SerialInput()
-    : GenericProcessor("Serial Port"), baudrate(0)
+    : GenericProcessor("Serial Port"), Thread("Serial Port reader"),
+      messageFifo(SERIAL_QUEUE_SIZE), frameSize(0), frameTicks(0),
+      framingMode(RAW_FRAMING), framingValue(10), lastBlockTicks(0), baudrate(0)
 {
+    messages.calloc(SERIAL_QUEUE_SIZE);
 }
 
 SerialInput::~SerialInput()
 {
+    stopThread(1000);
     serial.close();
 }
 
@@ -67,6 +71,20 @@ void SerialInput::setBaudrate(int baudrate)
     this->baudrate = baudrate;
 }
 
+void SerialInput::setFraming(FramingMode mode, int value)
+{
+    // only changed while the reader thread is stopped
+    if (isThreadRunning())
+        return;
+
+    framingMode = mode;
+
+    if (mode == LENGTH_FRAMING)
+        framingValue = jlimit(1, SERIAL_MESSAGE_MAX_BYTES, value);
+    else
+        framingValue = jlimit(0, 255, value);
+}
+
 
 bool SerialInput::isReady()
 {
@@ -83,49 +101,155 @@ bool SerialInput::isReady()
     return true;
 }
 
+bool SerialInput::enable()
+{
+    messageFifo.reset();
+    numDroppedMessages = 0;
+    frameSize = 0;
+
+    lastBlockTicks = Time::getHighResolutionTicks();
+
+    startThread(8);
+
+    return true;
+}
+
 bool SerialInput::disable()
 {
+    stopThread(1000);
     serial.close();
+
+    if (numDroppedMessages.get() > 0)
+        std::cout << "SerialInput: dropped " << numDroppedMessages.get() << " messages." << std::endl;
+
     return true;
 }
 
-
-void SerialInput::process(AudioSampleBuffer&, MidiBuffer& events)
+void SerialInput::run()
 {
-    int bytesAvailable = serial.available();
+    uint8 buffer[4096];
 
-    if (bytesAvailable == OF_SERIAL_ERROR)
+    while (!threadShouldExit())
     {
-        // ToDo: Properly warn about problem here!
-        AlertWindow::showMessageBoxAsync(AlertWindow::WarningIcon, "SerialInput device access error!", "Could not access serial device.");
-        return;
+        // time out now and then to check threadShouldExit()
+        if (!serial.waitForData(50))
+            continue;
+
+        const int64 arrivalTicks = Time::getHighResolutionTicks();
+        const int bytesRead = serial.readBytes(buffer, sizeof(buffer));
+
+        if (bytesRead > 0)
+        {
+            frameBytes(buffer, bytesRead, arrivalTicks);
+        }
+        else if (bytesRead == OF_SERIAL_ERROR || bytesRead == 0)
+        {
+            // a failed read, or nothing to read although the port said there
+            // was, means the device has gone away
+            std::cout << "SerialInput: could not read from " << device << ", stopping." << std::endl;
+            return;
+        }
     }
+}
 
-    if (bytesAvailable > 0)
+void SerialInput::frameBytes(const uint8* data, int numBytes, int64 arrivalTicks)
+{
+    if (framingMode == RAW_FRAMING)
     {
+        for (int i = 0; i < numBytes; i += SERIAL_MESSAGE_MAX_BYTES)
+            pushMessage(data + i, jmin(SERIAL_MESSAGE_MAX_BYTES, numBytes - i), arrivalTicks);
 
-        unsigned char buffer[10000];
-        int bytesRead = serial.readBytes(buffer, bytesAvailable);
+        return;
+    }
 
-        if (bytesRead > 0)
+    for (int i = 0; i < numBytes; i++)
+    {
+        // a message is timestamped with the arrival of its first byte
+        if (frameSize == 0)
+            frameTicks = arrivalTicks;
+
+        if (framingMode == DELIMITER_FRAMING && data[i] == framingValue)
         {
-            addEvent(events,    // MidiBuffer
-                     BINARY_MSG,    // eventType
-                     0,         // sampleNum
-                     nodeId,    // eventID
-                     0,         // eventChannel
-                     bytesRead, // numBytes
-                     buffer);   // data
+            pushMessage(frame, frameSize, frameTicks);
+            frameSize = 0;
+            continue;
         }
-        else if (bytesRead < 0)
+
+        frame[frameSize++] = data[i];
+
+        // in delimiter mode, overly long messages are split
+        if ((framingMode == LENGTH_FRAMING && frameSize == framingValue)
+            || frameSize == SERIAL_MESSAGE_MAX_BYTES)
         {
-            // ToDo: Properly warn about problem here!
-            AlertWindow::showMessageBoxAsync(AlertWindow::WarningIcon, "SerialInput device read error!", "Could not read serial input, even though data should be available.");
-            return;
+            pushMessage(frame, frameSize, frameTicks);
+            frameSize = 0;
         }
     }
 }
 
+void SerialInput::pushMessage(const uint8* data, int numBytes, int64 arrivalTicks)
+{
+    if (numBytes == 0)
+        return;
+
+    int start1, size1, start2, size2;
+    messageFifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    if (size1 == 0)
+    {
+        ++numDroppedMessages;
+        return;
+    }
+
+    SerialMessage& message = messages[start1];
+    message.arrivalTicks = arrivalTicks;
+    message.numBytes = numBytes;
+    memcpy(message.data, data, numBytes);
+
+    messageFifo.finishedWrite(1);
+}
+
+void SerialInput::process(AudioSampleBuffer& buffer, MidiBuffer& events)
+{
+    const int64 now = Time::getHighResolutionTicks();
+    const int64 blockTicks = now - lastBlockTicks;
+    const int numSamples = jmax(1, buffer.getNumSamples());
+
+    lastBlockTicks = now;
+
+    int start1, size1, start2, size2;
+    messageFifo.prepareToRead(messageFifo.getNumReady(), start1, size1, start2, size2);
+
+    for (int i = 0; i < size1 + size2; i++)
+    {
+        const SerialMessage& message = messages[i < size1 ? start1 + i : start2 + i - size1];
+
+        // the message, followed by its arrival time on the software clock
+        uint8 payload[SERIAL_MESSAGE_MAX_BYTES + sizeof(int64)];
+        const int64 arrivalTimestamp = CoreServices::getSoftwareTimestampForTicks(message.arrivalTicks);
+
+        memcpy(payload, message.data, message.numBytes);
+        memcpy(payload + message.numBytes, &arrivalTimestamp, sizeof(int64));
+
+        // the block covers the time since the previous one, so place the message
+        // at the sample matching its arrival; older messages go at the start
+        int sampleNum = numSamples - 1;
+
+        if (blockTicks > 0)
+            sampleNum -= int((now - message.arrivalTicks) * numSamples / blockTicks);
+
+        addEvent(events,    // MidiBuffer
+                 BINARY_MSG,    // eventType
+                 jlimit(0, numSamples - 1, sampleNum), // sampleNum
+                 nodeId,    // eventID
+                 0,         // eventChannel
+                 message.numBytes + sizeof(int64), // numBytes
+                 payload);  // data
+    }
+
+    messageFifo.finishedRead(size1 + size2);
+}
+
 AudioProcessorEditor* SerialInput::createEditor()
 {
     editor = new SerialInputEditor(this);
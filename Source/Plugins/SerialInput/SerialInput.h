@@ -33,15 +33,31 @@
 #include "SerialInputEditor.h"
 #include <SerialLib.h>
 
+// event payloads are at most 255 bytes, and end with the 8-byte arrival time
+#define SERIAL_MESSAGE_MAX_BYTES (255 - 8)
+#define SERIAL_QUEUE_SIZE 256
+
 /**
 
  This source processor allows you to pipe binary serial data input straight to the event cue/buffer.
 
+ The port is read on a separate thread, which waits for incoming data, timestamps it as
+ soon as it arrives and splits it into messages (see FramingMode). The messages are handed
+ to process() through a lock-free queue, so the audio thread never touches the port, and
+ each one is placed in the event buffer at the sample corresponding to its arrival time.
+
+ That sample is only an estimate, interpolated within the current block. Each BINARY_MSG
+ therefore carries the exact arrival time too: the message bytes are followed by an int64
+ (in the machine's byte order) holding the software timestamp of the arrival, i.e. the
+ high-resolution ticks since the start of acquisition, as in the MessageCenter's
+ "Software time" message.
+
  @see SerialInputEditor
 
  */
 
-class SerialInput : public GenericProcessor
+class SerialInput : public GenericProcessor,
+    private Thread
 
 {
 public:
@@ -74,6 +90,21 @@ public:
         return true;
     }
 
+    /** How the incoming byte stream is split into messages. */
+    enum FramingMode
+    {
+        RAW_FRAMING = 0,        // everything read at once is one message
+        DELIMITER_FRAMING = 1,  // messages end with a delimiter byte, which is removed
+        LENGTH_FRAMING = 2      // messages have a fixed number of bytes
+    };
+
+    /** Sets the framing mode. The value is the delimiter byte or the message length,
+     depending on the mode. Messages are never longer than SERIAL_MESSAGE_MAX_BYTES. */
+    void setFraming(FramingMode mode, int value);
+
+    /** Starts the reader thread. */
+    bool enable();
+
     /**
      This should only be run by the ProcessorGraph, before acquisition will be started.
 
@@ -86,7 +117,7 @@ public:
     /**
      Called immediately after the end of data acquisition by the ProcessorGraph.
 
-     It closes the open port serial port.
+     It stops the reader thread and closes the open serial port.
      */
     bool disable();
 
@@ -100,7 +131,7 @@ public:
 
      The process method is called every time a new data buffer is available.
 
-     Adds all the new serial data that is available to the event data buffer.
+     Adds all the messages received since the last block to the event data buffer.
      */
     void process(AudioSampleBuffer& buffer, MidiBuffer& events);
 
@@ -111,6 +142,38 @@ public:
 
 private:
 
+    /** Reads, timestamps and frames the incoming data. */
+    void run();
+
+    /** Splits newly read bytes into messages. Reader thread only. */
+    void frameBytes(const uint8* data, int numBytes, int64 arrivalTicks);
+
+    /** Queues a complete message for process(). Reader thread only. */
+    void pushMessage(const uint8* data, int numBytes, int64 arrivalTicks);
+
+    struct SerialMessage
+    {
+        int64 arrivalTicks;
+        int numBytes;
+        uint8 data[SERIAL_MESSAGE_MAX_BYTES];
+    };
+
+    // Messages on their way from the reader thread to process()
+    AbstractFifo messageFifo;
+    HeapBlock<SerialMessage> messages;
+    Atomic<int> numDroppedMessages;
+
+    // The message currently being assembled by the reader thread
+    uint8 frame[SERIAL_MESSAGE_MAX_BYTES];
+    int frameSize;
+    int64 frameTicks;
+
+    FramingMode framingMode;
+    int framingValue;
+
+    // Time at which the previous block was processed
+    int64 lastBlockTicks;
+
     // The current serial connection
     ofSerial serial;
 
@@ -65,6 +65,28 @@ SerialInputEditor::SerialInputEditor(SerialInput* parentNode)
     refreshButton->addListener(this);
 
     addAndMakeVisible(refreshButton);
+
+    // Add framing mode and value
+    framingList = new ComboBox();
+    framingList->setBounds(10,90,80,25);
+    framingList->addListener(this);
+    framingList->addItem("Raw", SerialInput::RAW_FRAMING + 1);
+    framingList->addItem("Delimiter", SerialInput::DELIMITER_FRAMING + 1);
+    framingList->addItem("Length", SerialInput::LENGTH_FRAMING + 1);
+    framingList->setSelectedId(SerialInput::RAW_FRAMING + 1, dontSendNotification);
+    framingList->setTooltip("Split the data into messages as it is read, at a delimiter byte, or every N bytes");
+
+    addAndMakeVisible(framingList);
+
+    framingValue = new Label("Framing value", "10");
+    framingValue->setBounds(95,90,65,25);
+    framingValue->setFont(Font("Small Text", 13, Font::plain));
+    framingValue->setEditable(true);
+    framingValue->setColour(Label::backgroundColourId, Colours::lightgrey);
+    framingValue->setTooltip("Delimiter byte (e.g. 10 for newline) or message length");
+    framingValue->addListener(this);
+
+    addAndMakeVisible(framingValue);
 }
 
 void SerialInputEditor::startAcquisition()
@@ -73,6 +95,8 @@ void SerialInputEditor::startAcquisition()
     deviceList->setEnabled(false);
     baudrateList->setEnabled(false);
     refreshButton->setEnabled(false);
+    framingList->setEnabled(false);
+    framingValue->setEditable(false);
     GenericEditor::startAcquisition();
 }
 
@@ -82,6 +106,8 @@ void SerialInputEditor::stopAcquisition()
     deviceList->setEnabled(true);
     baudrateList->setEnabled(true);
     refreshButton->setEnabled(true);
+    framingList->setEnabled(true);
+    framingValue->setEditable(true);
     GenericEditor::stopAcquisition();
 }
 
@@ -104,6 +130,22 @@ void SerialInputEditor::comboBoxChanged(ComboBox* comboBox)
     {
         node->setBaudrate(comboBox->getSelectedId());
     }
+    else if (comboBox == framingList)
+    {
+        updateFraming();
+    }
+}
+
+void SerialInputEditor::labelTextChanged(Label* label)
+{
+    updateFraming();
+}
+
+void SerialInputEditor::updateFraming()
+{
+    const SerialInput::FramingMode mode = (SerialInput::FramingMode) (framingList->getSelectedId() - 1);
+
+    node->setFraming(mode, framingValue->getText().getIntValue());
 }
 
 void SerialInputEditor::saveEditorParameters(XmlElement* xmlNode)
@@ -112,6 +154,8 @@ void SerialInputEditor::saveEditorParameters(XmlElement* xmlNode)
 
     parameters->setAttribute("device", deviceList->getText().toStdString());
     parameters->setAttribute("baudrate", baudrateList->getSelectedId());
+    parameters->setAttribute("framing", framingList->getSelectedId() - 1);
+    parameters->setAttribute("framingValue", framingValue->getText().getIntValue());
 }
 
 void SerialInputEditor::loadEditorParameters(XmlElement* xmlNode)
@@ -122,6 +166,8 @@ void SerialInputEditor::loadEditorParameters(XmlElement* xmlNode)
         {
             deviceList->setText(subNode->getStringAttribute("device", ""));
             baudrateList->setSelectedId(subNode->getIntAttribute("baudrate"));
+            framingValue->setText(String(subNode->getIntAttribute("framingValue", 10)), dontSendNotification);
+            framingList->setSelectedId(subNode->getIntAttribute("framing", SerialInput::RAW_FRAMING) + 1, sendNotificationSync);
         }
     }
 }
@@ -32,7 +32,7 @@
 
 class SerialInput;
 
-class SerialInputEditor : public GenericEditor, public ComboBox::Listener
+class SerialInputEditor : public GenericEditor, public ComboBox::Listener, public Label::Listener
 {
 
 public:
@@ -45,6 +45,9 @@ public:
     /** Combobox listener callback, callewd when a combobox is changed. */
     void comboBoxChanged(ComboBox* box);
 
+    /** Label listener callback, called when the framing value is edited. */
+    void labelTextChanged(Label* label);
+
     /** Called by processor graph in beginning of the acqusition, disables editor completly. */
     void startAcquisition();
 
@@ -67,6 +70,13 @@ private:
     // List of all available baudrates.
     ScopedPointer<ComboBox> baudrateList;
 
+    // How the data is split into messages, and the delimiter or length
+    ScopedPointer<ComboBox> framingList;
+    ScopedPointer<Label> framingValue;
+
+    // Pushes the framing settings to the parent node
+    void updateFraming();
+
     // Parent node
     SerialInput* node;
 
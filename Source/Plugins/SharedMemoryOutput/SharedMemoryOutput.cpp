@@ -0,0 +1,380 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2016 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "SharedMemoryOutput.h"
+#include "SharedMemoryOutputEditor.h"
+
+#include <stddef.h>
+
+#if JUCE_LINUX || JUCE_MAC
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// the ring always holds at least this many samples per channel, so that a
+// single block can never wrap onto itself
+#define MIN_CAPACITY 16384
+
+namespace
+{
+    // readers use a sequence lock to get a consistent view of the fields that
+    // change during acquisition (see oe_shm_position())
+
+    void beginUpdate(oe_shm_header* header)
+    {
+        __atomic_store_n(&header->sequence, header->sequence + 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+    }
+
+    void endUpdate(oe_shm_header* header)
+    {
+        __atomic_store_n(&header->sequence, header->sequence + 1, __ATOMIC_RELEASE);
+    }
+
+    template <typename Field, typename Value>
+    void storeField(Field* field, Value value)
+    {
+        __atomic_store_n(field, Field(value), __ATOMIC_RELAXED);
+    }
+}
+
+SharedMemoryOutput::SharedMemoryOutput()
+    : GenericProcessor("Shared Memory Output"),
+      segmentName("/open-ephys"),
+      sampleFormat(FLOAT_FORMAT),
+      bufferLength(2.0f),
+      header(nullptr),
+      data(nullptr),
+      segmentSize(0)
+{
+}
+
+SharedMemoryOutput::~SharedMemoryOutput()
+{
+    closeSegment();
+}
+
+AudioProcessorEditor* SharedMemoryOutput::createEditor()
+{
+    editor = new SharedMemoryOutputEditor(this, true);
+    return editor;
+}
+
+bool SharedMemoryOutput::isSink()
+{
+    return true;
+}
+
+void SharedMemoryOutput::setSegmentName(const String& name)
+{
+    segmentName = name.trim();
+
+    // POSIX shared-memory names start with a single slash
+    if (!segmentName.startsWithChar('/'))
+        segmentName = "/" + segmentName;
+}
+
+String SharedMemoryOutput::getSegmentName() const
+{
+    return segmentName;
+}
+
+void SharedMemoryOutput::setChannelList(const String& list)
+{
+    channelList = list.trim();
+}
+
+String SharedMemoryOutput::getChannelList() const
+{
+    return channelList;
+}
+
+void SharedMemoryOutput::setSampleFormat(SampleFormat format)
+{
+    sampleFormat = format;
+}
+
+SharedMemoryOutput::SampleFormat SharedMemoryOutput::getSampleFormat() const
+{
+    return sampleFormat;
+}
+
+void SharedMemoryOutput::setBufferLength(float seconds)
+{
+    bufferLength = jlimit(0.1f, 60.0f, seconds);
+}
+
+float SharedMemoryOutput::getBufferLength() const
+{
+    return bufferLength;
+}
+
+size_t SharedMemoryOutput::getSegmentSize() const
+{
+    return segmentSize;
+}
+
+Array<int> SharedMemoryOutput::getSelectedChannels()
+{
+    Array<int> selected = Channel::parseChannelList(channelList, getNumInputs());
+
+    selected.removeRange(OE_SHM_MAX_CHANNELS, selected.size());
+
+    return selected;
+}
+
+bool SharedMemoryOutput::enable()
+{
+#if JUCE_LINUX || JUCE_MAC
+    const Array<int> selected = getSelectedChannels();
+
+    if (selected.size() == 0)
+    {
+        CoreServices::sendStatusMessage("Shared Memory Output: no channels selected");
+        return false;
+    }
+
+    const uint32 capacity = uint32(nextPowerOfTwo(jmax(MIN_CAPACITY, int(getSampleRate() * bufferLength))));
+
+    if (!openSegment(selected, capacity))
+    {
+        CoreServices::sendStatusMessage("Shared Memory Output: could not create " + segmentName);
+        return false;
+    }
+
+    beginUpdate(header);
+    storeField(&header->state, uint32(OE_SHM_RUNNING));
+    storeField(&header->generation, header->generation + 1);
+    storeField(&header->max_block, uint32(0));
+    storeField(&header->write_index, uint64(0));
+    storeField(&header->timestamp, int64(getTimestamp(channelMap[0])));
+    endUpdate(header);
+
+    return true;
+#else
+    CoreServices::sendStatusMessage("Shared Memory Output is not available on this platform");
+    return false;
+#endif
+}
+
+bool SharedMemoryOutput::disable()
+{
+    if (header != nullptr)
+    {
+        // leave the segment in place so readers can drain the ring
+        beginUpdate(header);
+        storeField(&header->state, uint32(OE_SHM_STOPPED));
+        endUpdate(header);
+    }
+
+    return true;
+}
+
+bool SharedMemoryOutput::openSegment(const Array<int>& selected, uint32 capacity)
+{
+#if JUCE_LINUX || JUCE_MAC
+    HeapBlock<oe_shm_header> layout(1, true);
+
+    layout->magic = OE_SHM_MAGIC;
+    layout->version = OE_SHM_VERSION;
+    layout->header_size = OE_SHM_DATA_OFFSET;
+    layout->format = uint32(sampleFormat);
+    layout->num_channels = uint32(selected.size());
+    layout->capacity = capacity;
+    layout->sample_rate = getSampleRate();
+
+    for (int i = 0; i < selected.size(); i++)
+    {
+        const float bitVolts = channels[selected[i]]->bitVolts;
+
+        layout->channel_map[i] = uint32(selected[i]);
+        layout->bit_volts[i] = (sampleFormat == INT16_FORMAT && bitVolts > 0) ? bitVolts : 1.0f;
+    }
+
+    // the fields before the sequence number never change while a segment is open
+    const size_t staticSize = offsetof(oe_shm_header, sequence);
+
+    if (header != nullptr
+        && openSegmentName == segmentName
+        && memcmp(header, layout.getData(), staticSize) == 0)
+    {
+        return true;
+    }
+
+    closeSegment();
+
+    const size_t size = OE_SHM_SEGMENT_SIZE(layout->format, layout->num_channels, capacity);
+
+    // a segment left behind by a crashed instance would have the wrong layout
+    shm_unlink(segmentName.toRawUTF8());
+
+    const int fd = shm_open(segmentName.toRawUTF8(), O_CREAT | O_EXCL | O_RDWR, 0644);
+
+    if (fd < 0)
+        return false;
+
+    void* address = MAP_FAILED;
+
+    if (ftruncate(fd, off_t(size)) == 0)
+        address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    close(fd);
+
+    if (address == MAP_FAILED)
+    {
+        shm_unlink(segmentName.toRawUTF8());
+        return false;
+    }
+
+    // touch every page now rather than on the audio thread
+    memset(address, 0, size);
+
+    header = static_cast<oe_shm_header*>(address);
+    data = static_cast<uint8*>(address) + OE_SHM_DATA_OFFSET;
+    segmentSize = size;
+    openSegmentName = segmentName;
+
+    // readers check the magic number last, so publish it after everything else
+    memcpy(&header->version, &layout->version, staticSize - offsetof(oe_shm_header, version));
+    __atomic_store_n(&header->magic, uint32(OE_SHM_MAGIC), __ATOMIC_RELEASE);
+
+    channelMap = selected;
+
+    std::cout << "Shared Memory Output: " << segmentName << ", " << selected.size() << " channels, "
+              << capacity << " samples per channel (" << (size >> 20) << " MB)" << std::endl;
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+void SharedMemoryOutput::closeSegment()
+{
+#if JUCE_LINUX || JUCE_MAC
+    if (header == nullptr)
+        return;
+
+    // tells attached readers to reopen the segment
+    beginUpdate(header);
+    storeField(&header->state, uint32(OE_SHM_CLOSED));
+    endUpdate(header);
+
+    munmap(header, segmentSize);
+    shm_unlink(openSegmentName.toRawUTF8());
+
+    header = nullptr;
+    data = nullptr;
+    segmentSize = 0;
+    channelMap.clear();
+#endif
+}
+
+void SharedMemoryOutput::process(AudioSampleBuffer& buffer, MidiBuffer& events)
+{
+    if (header == nullptr || channelMap.size() == 0)
+        return;
+
+    // all published channels are expected to come from the same source
+    const int numSamples = getNumSamples(channelMap.getUnchecked(0));
+
+    if (numSamples > 0)
+        writeBlock(numSamples, getTimestamp(channelMap.getUnchecked(0)), buffer);
+}
+
+void SharedMemoryOutput::writeBlock(int numSamples, int64 timestamp, const AudioSampleBuffer& buffer)
+{
+    const uint32 capacity = header->capacity;
+    const uint32 mask = capacity - 1;
+    const uint64 first = header->write_index;
+    const uint32 count = uint32(jmin(numSamples, int(capacity / 2)));
+
+    // readers must know how far ahead of write_index the rings may be
+    // changing before we write there
+    if (count > header->max_block)
+    {
+        beginUpdate(header);
+        storeField(&header->max_block, count);
+        endUpdate(header);
+    }
+
+    const uint32 start = uint32(first & mask);
+    const uint32 run = jmin(count, capacity - start);
+
+    for (int c = 0; c < channelMap.size(); c++)
+    {
+        const float* source = buffer.getReadPointer(channelMap.getUnchecked(c));
+
+        if (sampleFormat == FLOAT_FORMAT)
+        {
+            float* ring = reinterpret_cast<float*>(data) + size_t(c) * capacity;
+
+            memcpy(ring + start, source, run * sizeof(float));
+            memcpy(ring, source + run, (count - run) * sizeof(float));
+        }
+        else
+        {
+            int16* ring = reinterpret_cast<int16*>(data) + size_t(c) * capacity;
+            const float scale = 1.0f / header->bit_volts[c];
+
+            for (uint32 i = 0; i < count; i++)
+                ring[(first + i) & mask] = int16(jlimit(-32768, 32767, roundToInt(source[i] * scale)));
+        }
+    }
+
+    beginUpdate(header);
+    storeField(&header->write_index, first + count);
+    storeField(&header->timestamp, timestamp + int64(count));
+    endUpdate(header);
+}
+
+void SharedMemoryOutput::saveCustomParametersToXml(XmlElement* parentElement)
+{
+    XmlElement* mainNode = parentElement->createNewChildElement("SHAREDMEMORYOUTPUT");
+    mainNode->setAttribute("name", segmentName);
+    mainNode->setAttribute("channels", channelList);
+    mainNode->setAttribute("format", sampleFormat == INT16_FORMAT ? "int16" : "float32");
+    mainNode->setAttribute("bufferLength", bufferLength);
+}
+
+void SharedMemoryOutput::loadCustomParametersFromXml()
+{
+    if (parametersAsXml)
+    {
+        forEachXmlChildElement(*parametersAsXml, mainNode)
+        {
+            if (mainNode->hasTagName("SHAREDMEMORYOUTPUT"))
+            {
+                setSegmentName(mainNode->getStringAttribute("name", segmentName));
+                setChannelList(mainNode->getStringAttribute("channels"));
+                setSampleFormat(mainNode->getStringAttribute("format") == "int16" ? INT16_FORMAT : FLOAT_FORMAT);
+                setBufferLength(float(mainNode->getDoubleAttribute("bufferLength", bufferLength)));
+            }
+        }
+    }
+
+    if (editor != nullptr)
+        static_cast<SharedMemoryOutputEditor*>(getEditor())->updateSettings();
+}
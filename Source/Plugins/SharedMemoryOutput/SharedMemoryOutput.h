@@ -0,0 +1,116 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2016 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef SHAREDMEMORYOUTPUT_H_INCLUDED
+#define SHAREDMEMORYOUTPUT_H_INCLUDED
+
+#include <ProcessorHeaders.h>
+#include "client/oe_shm.h"
+
+/**
+
+  Publishes continuous data in a shared-memory ring buffer, so that other
+  processes on the same machine can read it without any copies through the
+  GUI (see client/oe_shm.h for the layout and a C client library).
+
+  The segment is created when acquisition starts and keeps its name until
+  the processor is deleted, so readers can stay attached across runs; it is
+  only recreated (and readers told to reopen it) when the channel set, the
+  format or the ring length changes.
+
+  Only available on Linux and Mac OS X (POSIX shared memory).
+
+  @see SharedMemoryOutputEditor
+
+*/
+
+class SharedMemoryOutput : public GenericProcessor
+{
+public:
+    enum SampleFormat
+    {
+        FLOAT_FORMAT = OE_SHM_FLOAT32,
+        INT16_FORMAT = OE_SHM_INT16
+    };
+
+    SharedMemoryOutput();
+    ~SharedMemoryOutput();
+
+    AudioProcessorEditor* createEditor() override;
+
+    bool isSink() override;
+
+    bool enable() override;
+    bool disable() override;
+
+    void process(AudioSampleBuffer& buffer, MidiBuffer& events) override;
+
+    /** Name of the segment, e.g. "/open-ephys". Applied when acquisition starts. */
+    void setSegmentName(const String& name);
+    String getSegmentName() const;
+
+    /** Channels to publish, as 1-based numbers and ranges, e.g. "1-32,40".
+        An empty string publishes every input channel. */
+    void setChannelList(const String& list);
+    String getChannelList() const;
+
+    void setSampleFormat(SampleFormat format);
+    SampleFormat getSampleFormat() const;
+
+    /** Length of the ring; rounded up to a power of two samples. */
+    void setBufferLength(float seconds);
+    float getBufferLength() const;
+
+    /** Returns the size of the current segment in bytes, or 0 if there is none. */
+    size_t getSegmentSize() const;
+
+    void saveCustomParametersToXml(XmlElement* parentElement) override;
+    void loadCustomParametersFromXml() override;
+
+private:
+    /** Parses channelList against the current inputs. */
+    Array<int> getSelectedChannels();
+
+    /** Maps a segment with the given layout, reusing the current one if it matches. */
+    bool openSegment(const Array<int>& selected, uint32 capacity);
+    void closeSegment();
+
+    void writeBlock(int numSamples, int64 timestamp, const AudioSampleBuffer& buffer);
+
+    String segmentName;
+    String openSegmentName;
+    String channelList;
+    SampleFormat sampleFormat;
+    float bufferLength;
+
+    oe_shm_header* header;
+    uint8* data;
+    size_t segmentSize;
+
+    /** Input channel of each ring, copied from the header for the audio thread. */
+    Array<int> channelMap;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SharedMemoryOutput);
+};
+
+#endif  // SHAREDMEMORYOUTPUT_H_INCLUDED
@@ -0,0 +1,145 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2016 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "SharedMemoryOutputEditor.h"
+#include "SharedMemoryOutput.h"
+
+SharedMemoryOutputEditor::SharedMemoryOutputEditor(GenericProcessor* parentNode, bool useDefaultParameterEditors)
+    : GenericEditor(parentNode, useDefaultParameterEditors)
+{
+    desiredWidth = 180;
+
+    processor = (SharedMemoryOutput*) parentNode;
+
+    nameLabel = new Label("Name", "Name:");
+    nameLabel->setBounds(5,28,60,20);
+    nameLabel->setFont(Font("Small Text", 12, Font::plain));
+    addAndMakeVisible(nameLabel);
+
+    nameValue = createEditableLabel("Name value", 65,30,105);
+    nameValue->setTooltip("Name of the POSIX shared-memory segment");
+
+    channelsLabel = new Label("Channels", "Channels:");
+    channelsLabel->setBounds(5,53,60,20);
+    channelsLabel->setFont(Font("Small Text", 12, Font::plain));
+    addAndMakeVisible(channelsLabel);
+
+    channelsValue = createEditableLabel("Channels value", 65,55,105);
+    channelsValue->setTooltip("Channels to publish, e.g. 1-32,40 (empty for all)");
+
+    formatSelector = new ComboBox("Format");
+    formatSelector->setBounds(10,80,80,20);
+    formatSelector->addItem("float32", SharedMemoryOutput::FLOAT_FORMAT + 1);
+    formatSelector->addItem("int16", SharedMemoryOutput::INT16_FORMAT + 1);
+    formatSelector->addListener(this);
+    addAndMakeVisible(formatSelector);
+
+    lengthValue = createEditableLabel("Length value", 100,81,40);
+    lengthValue->setTooltip("Length of the ring buffer, in seconds");
+
+    lengthLabel = new Label("Length", "s");
+    lengthLabel->setBounds(140,80,30,20);
+    lengthLabel->setFont(Font("Small Text", 12, Font::plain));
+    addAndMakeVisible(lengthLabel);
+
+    sizeLabel = new Label("Size", String::empty);
+    sizeLabel->setBounds(5,105,170,20);
+    sizeLabel->setFont(Font("Small Text", 11, Font::plain));
+    sizeLabel->setColour(Label::textColourId, Colours::darkgrey);
+    addAndMakeVisible(sizeLabel);
+
+    updateSettings();
+}
+
+Label* SharedMemoryOutputEditor::createEditableLabel(const String& name, int x, int y, int width)
+{
+    Label* label = new Label(name, String::empty);
+    label->setBounds(x,y,width,18);
+    label->setFont(Font("Default", 13, Font::plain));
+    label->setColour(Label::textColourId, Colours::white);
+    label->setColour(Label::backgroundColourId, Colours::grey);
+    label->setEditable(true);
+    label->addListener(this);
+    addAndMakeVisible(label);
+
+    return label;
+}
+
+void SharedMemoryOutputEditor::updateSettings()
+{
+    nameValue->setText(processor->getSegmentName(), dontSendNotification);
+    channelsValue->setText(processor->getChannelList(), dontSendNotification);
+    formatSelector->setSelectedId(processor->getSampleFormat() + 1, dontSendNotification);
+    lengthValue->setText(String(processor->getBufferLength(), 1), dontSendNotification);
+}
+
+void SharedMemoryOutputEditor::labelTextChanged(Label* label)
+{
+    if (label == nameValue)
+    {
+        processor->setSegmentName(label->getText());
+    }
+    else if (label == channelsValue)
+    {
+        processor->setChannelList(label->getText());
+    }
+    else if (label == lengthValue)
+    {
+        processor->setBufferLength(label->getText().getFloatValue());
+    }
+
+    updateSettings();
+}
+
+void SharedMemoryOutputEditor::comboBoxChanged(ComboBox* comboBox)
+{
+    if (comboBox == formatSelector)
+        processor->setSampleFormat(SharedMemoryOutput::SampleFormat(formatSelector->getSelectedId() - 1));
+}
+
+void SharedMemoryOutputEditor::startAcquisition()
+{
+    GenericEditor::startAcquisition();
+
+    nameValue->setEditable(false);
+    channelsValue->setEditable(false);
+    lengthValue->setEditable(false);
+    formatSelector->setEnabled(false);
+
+    const size_t size = processor->getSegmentSize();
+
+    if (size > 0)
+        sizeLabel->setText(String(double(size) / (1 << 20), 1) + " MB shared", dontSendNotification);
+    else
+        sizeLabel->setText("Not publishing", dontSendNotification);
+}
+
+void SharedMemoryOutputEditor::stopAcquisition()
+{
+    GenericEditor::stopAcquisition();
+
+    nameValue->setEditable(true);
+    channelsValue->setEditable(true);
+    lengthValue->setEditable(true);
+    formatSelector->setEnabled(true);
+}
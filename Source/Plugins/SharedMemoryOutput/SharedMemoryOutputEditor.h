@@ -0,0 +1,73 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2016 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef SHAREDMEMORYOUTPUTEDITOR_H_INCLUDED
+#define SHAREDMEMORYOUTPUTEDITOR_H_INCLUDED
+
+#include <EditorHeaders.h>
+
+class SharedMemoryOutput;
+
+/**
+
+  User interface for the SharedMemoryOutput processor: segment name,
+  channel list, sample format and ring length.
+
+  @see SharedMemoryOutput
+
+*/
+
+class SharedMemoryOutputEditor : public GenericEditor,
+                                 public Label::Listener,
+                                 public ComboBox::Listener
+{
+public:
+    SharedMemoryOutputEditor(GenericProcessor* parentNode, bool useDefaultParameterEditors);
+
+    void labelTextChanged(Label* label) override;
+    void comboBoxChanged(ComboBox* comboBox) override;
+
+    void startAcquisition() override;
+    void stopAcquisition() override;
+
+    /** Shows the processor's current settings, e.g. after loading them. */
+    void updateSettings();
+
+private:
+    Label* createEditableLabel(const String& name, int x, int y, int width);
+
+    SharedMemoryOutput* processor;
+
+    ScopedPointer<Label> nameLabel;
+    ScopedPointer<Label> nameValue;
+    ScopedPointer<Label> channelsLabel;
+    ScopedPointer<Label> channelsValue;
+    ScopedPointer<ComboBox> formatSelector;
+    ScopedPointer<Label> lengthValue;
+    ScopedPointer<Label> lengthLabel;
+    ScopedPointer<Label> sizeLabel;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SharedMemoryOutputEditor);
+};
+
+#endif  // SHAREDMEMORYOUTPUTEDITOR_H_INCLUDED
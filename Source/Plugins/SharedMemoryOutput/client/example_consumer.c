@@ -0,0 +1,146 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2016 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/*
+  Example consumer for the Shared Memory Output processor: prints, once a
+  second, how many samples arrived, how many were lost and the RMS of every
+  channel.
+
+      cc -O2 -o example_consumer example_consumer.c oe_shm.c -lrt -lm
+      ./example_consumer /open-ephys
+*/
+
+#include "oe_shm.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define MAX_SAMPLES 4096
+
+static void sleep_ms(long ms)
+{
+    struct timespec t;
+
+    t.tv_sec = ms / 1000;
+    t.tv_nsec = (ms % 1000) * 1000000L;
+    nanosleep(&t, NULL);
+}
+
+static double now(void)
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1.0e-9;
+}
+
+/* Reads from an open segment until the GUI closes it. */
+static void consume(oe_shm_reader* reader, const char* name)
+{
+    float* samples;
+    double* sumOfSquares;
+    double lastReport;
+    uint64_t received = 0, lost = 0;
+    const uint32_t numChannels = reader->header->num_channels;
+    uint32_t c;
+
+    printf("%s: %u channels at %.1f Hz, %s, %u samples per channel\n",
+           name, numChannels, reader->header->sample_rate,
+           reader->header->format == OE_SHM_INT16 ? "int16" : "float32",
+           reader->header->capacity);
+
+    samples = malloc(sizeof(float) * MAX_SAMPLES * (numChannels > 0 ? numChannels : 1));
+    sumOfSquares = calloc(numChannels > 0 ? numChannels : 1, sizeof(double));
+    lastReport = now();
+
+    for (;;)
+    {
+        int64_t timestamp;
+        uint64_t skipped;
+        long n = oe_shm_read(reader, samples, MAX_SAMPLES, &timestamp, &skipped);
+
+        if (n < 0)
+            break;
+
+        lost += skipped;
+        received += (uint64_t) n;
+
+        for (c = 0; c < numChannels; c++)
+        {
+            const float* channel = samples + (size_t) c * MAX_SAMPLES;
+            long i;
+
+            for (i = 0; i < n; i++)
+                sumOfSquares[c] += channel[i] * channel[i];
+        }
+
+        if (now() - lastReport >= 1.0)
+        {
+            printf("%llu samples, %llu lost, last timestamp %lld\n",
+                   (unsigned long long) received, (unsigned long long) lost,
+                   (long long) (timestamp + n));
+
+            for (c = 0; c < numChannels; c++)
+            {
+                printf("  ch %u: %.2f RMS\n", reader->header->channel_map[c] + 1,
+                       received > 0 ? sqrt(sumOfSquares[c] / received) : 0.0);
+                sumOfSquares[c] = 0;
+            }
+
+            received = 0;
+            lost = 0;
+            lastReport = now();
+        }
+
+        if (n < MAX_SAMPLES)
+            sleep_ms(5);
+    }
+
+    free(samples);
+    free(sumOfSquares);
+}
+
+int main(int argc, char** argv)
+{
+    const char* name = argc > 1 ? argv[1] : "/open-ephys";
+    oe_shm_reader reader;
+
+    for (;;)
+    {
+        if (oe_shm_open(&reader, name) != 0)
+        {
+            fprintf(stderr, "Waiting for %s...\n", name);
+            sleep_ms(1000);
+            continue;
+        }
+
+        consume(&reader, name);
+
+        printf("%s was closed, reopening\n", name);
+        oe_shm_close(&reader);
+    }
+
+    return 0;
+}
@@ -0,0 +1,257 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2016 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "oe_shm.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define LOAD(p)     __atomic_load_n((p), __ATOMIC_RELAXED)
+#define ACQUIRE(p)  __atomic_load_n((p), __ATOMIC_ACQUIRE)
+
+int oe_shm_open(oe_shm_reader* reader, const char* name)
+{
+    struct stat st;
+    void* address;
+    const oe_shm_header* header;
+    int fd;
+
+    memset(reader, 0, sizeof(*reader));
+
+    fd = shm_open(name, O_RDONLY, 0);
+
+    if (fd < 0)
+        return -1;
+
+    if (fstat(fd, &st) != 0 || (size_t) st.st_size < OE_SHM_DATA_OFFSET)
+    {
+        close(fd);
+        errno = EINVAL;
+        return -1;
+    }
+
+    address = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (address == MAP_FAILED)
+        return -1;
+
+    header = (const oe_shm_header*) address;
+
+    if (ACQUIRE(&header->magic) != OE_SHM_MAGIC
+        || header->version != OE_SHM_VERSION
+        || header->num_channels > OE_SHM_MAX_CHANNELS
+        || (size_t) st.st_size < OE_SHM_SEGMENT_SIZE(header->format, header->num_channels, header->capacity))
+    {
+        munmap(address, (size_t) st.st_size);
+        errno = EINVAL;
+        return -1;
+    }
+
+    reader->header = header;
+    reader->data = (const uint8_t*) address + header->header_size;
+    reader->size = (size_t) st.st_size;
+
+    oe_shm_position(reader, &reader->read_index, NULL, &reader->generation);
+
+    return 0;
+}
+
+void oe_shm_close(oe_shm_reader* reader)
+{
+    if (reader->header != NULL)
+        munmap((void*) reader->header, reader->size);
+
+    memset(reader, 0, sizeof(*reader));
+}
+
+uint32_t oe_shm_position(const oe_shm_reader* reader,
+                         uint64_t* write_index,
+                         int64_t* timestamp,
+                         uint32_t* generation)
+{
+    const oe_shm_header* h = reader->header;
+    uint32_t sequence, state, gen;
+    uint64_t index;
+    int64_t ts;
+
+    for (;;)
+    {
+        sequence = ACQUIRE(&h->sequence);
+
+        if (sequence & 1)
+        {
+            /* the writer is in the middle of an update */
+            sched_yield();
+            continue;
+        }
+
+        state = LOAD(&h->state);
+        gen = LOAD(&h->generation);
+        index = LOAD(&h->write_index);
+        ts = LOAD(&h->timestamp);
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+        if (LOAD(&h->sequence) == sequence)
+            break;
+    }
+
+    if (write_index != NULL)
+        *write_index = index;
+
+    if (timestamp != NULL)
+        *timestamp = ts;
+
+    if (generation != NULL)
+        *generation = gen;
+
+    return state;
+}
+
+const float* oe_shm_float_ring(const oe_shm_reader* reader, int channel)
+{
+    const oe_shm_header* h = reader->header;
+
+    if (h->format != OE_SHM_FLOAT32 || channel < 0 || (uint32_t) channel >= h->num_channels)
+        return NULL;
+
+    return (const float*) reader->data + (size_t) channel * h->capacity;
+}
+
+const int16_t* oe_shm_int16_ring(const oe_shm_reader* reader, int channel)
+{
+    const oe_shm_header* h = reader->header;
+
+    if (h->format != OE_SHM_INT16 || channel < 0 || (uint32_t) channel >= h->num_channels)
+        return NULL;
+
+    return (const int16_t*) reader->data + (size_t) channel * h->capacity;
+}
+
+int oe_shm_intact(const oe_shm_reader* reader, uint64_t first_index)
+{
+    const oe_shm_header* h = reader->header;
+    uint64_t index;
+    uint32_t generation;
+
+    /* order the caller's reads of the rings before re-reading the position */
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+    oe_shm_position(reader, &index, NULL, &generation);
+
+    if (generation != reader->generation)
+        return 0;
+
+    /* the writer may already be filling the block after write_index */
+    return index + LOAD(&h->max_block) <= first_index + h->capacity;
+}
+
+static void copy_channel(const oe_shm_reader* reader, int channel, uint64_t first, size_t count, float* out)
+{
+    const oe_shm_header* h = reader->header;
+    const uint32_t mask = h->capacity - 1;
+    size_t i;
+
+    if (h->format == OE_SHM_INT16)
+    {
+        const int16_t* ring = oe_shm_int16_ring(reader, channel);
+        const float scale = h->bit_volts[channel];
+
+        for (i = 0; i < count; i++)
+            out[i] = ring[(first + i) & mask] * scale;
+    }
+    else
+    {
+        const float* ring = oe_shm_float_ring(reader, channel);
+        const size_t start = (size_t) (first & mask);
+        const size_t run = count < h->capacity - start ? count : h->capacity - start;
+
+        memcpy(out, ring + start, run * sizeof(float));
+        memcpy(out + run, ring, (count - run) * sizeof(float));
+    }
+}
+
+long oe_shm_read(oe_shm_reader* reader,
+                 float* out,
+                 size_t max_samples,
+                 int64_t* first_timestamp,
+                 uint64_t* lost)
+{
+    const oe_shm_header* h = reader->header;
+    uint64_t index, oldest, skipped = 0;
+    uint32_t generation, block, c;
+    int64_t ts;
+    size_t count;
+
+    for (;;)
+    {
+        if (oe_shm_position(reader, &index, &ts, &generation) == OE_SHM_CLOSED)
+            return -1;
+
+        if (generation != reader->generation)
+        {
+            /* acquisition was restarted */
+            reader->generation = generation;
+            reader->read_index = 0;
+        }
+
+        /* skip whatever the writer may already have overwritten */
+        block = LOAD(&h->max_block);
+        oldest = index + block > h->capacity ? index + block - h->capacity : 0;
+
+        if (reader->read_index < oldest)
+        {
+            skipped += oldest - reader->read_index;
+            reader->read_index = oldest;
+        }
+
+        count = (size_t) (index - reader->read_index);
+
+        if (count > max_samples)
+            count = max_samples;
+
+        for (c = 0; c < h->num_channels; c++)
+            copy_channel(reader, (int) c, reader->read_index, count, out + (size_t) c * max_samples);
+
+        if (oe_shm_intact(reader, reader->read_index))
+            break;
+
+        /* the writer overtook us while copying; try again from further ahead */
+    }
+
+    if (first_timestamp != NULL)
+        *first_timestamp = ts - (int64_t) (index - reader->read_index);
+
+    if (lost != NULL)
+        *lost = skipped;
+
+    reader->read_index += count;
+
+    return (long) count;
+}
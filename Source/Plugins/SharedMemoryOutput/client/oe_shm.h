@@ -0,0 +1,164 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2016 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/*
+  Layout of the shared-memory segment written by the Shared Memory Output
+  processor, and a small C client for reading it.
+
+  The segment starts with an oe_shm_header, followed at header_size bytes by
+  one ring per channel (planar): channel c occupies capacity samples starting
+  at header_size + c * capacity * sample size. Sample i of the stream, counted
+  from the start of acquisition, is stored at ring position i & (capacity - 1).
+
+  The writer copies each block into the rings first and then advances
+  write_index, so every sample below write_index is complete. A reader that
+  falls more than capacity - max_block samples behind loses data;
+  oe_shm_read() detects this, and zero-copy readers can check with
+  oe_shm_intact() after using the samples.
+
+  Timestamps are contiguous within a generation: sample i has the timestamp
+  timestamp - (write_index - i).
+
+  The segment is created by the GUI and can be mapped read-only by any number
+  of readers:
+
+      oe_shm_reader reader;
+
+      if (oe_shm_open(&reader, "/open-ephys") == 0)
+      {
+          ...
+          oe_shm_close(&reader);
+      }
+
+  Build the client with any C99 compiler (link with -lrt on Linux).
+*/
+
+#ifndef OE_SHM_H_INCLUDED
+#define OE_SHM_H_INCLUDED
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define OE_SHM_MAGIC        0x4d48534fu   /* "OSHM" */
+#define OE_SHM_VERSION      1
+#define OE_SHM_MAX_CHANNELS 1024
+
+/* Sample formats */
+#define OE_SHM_FLOAT32      0   /* microvolts (or the input channel's own unit) */
+#define OE_SHM_INT16        1   /* multiply by bit_volts to get back to floats */
+
+/* Writer states */
+#define OE_SHM_STOPPED      0
+#define OE_SHM_RUNNING      1
+#define OE_SHM_CLOSED       2   /* segment was replaced or removed; reopen it */
+
+typedef struct oe_shm_header
+{
+    /* Written once, before magic is set. */
+    uint32_t magic;
+    uint32_t version;
+    uint32_t header_size;       /* byte offset of the first channel's ring */
+    uint32_t format;            /* OE_SHM_FLOAT32 or OE_SHM_INT16 */
+    uint32_t num_channels;
+    uint32_t capacity;          /* samples per channel ring, a power of two */
+    double   sample_rate;
+    uint32_t channel_map[OE_SHM_MAX_CHANNELS];  /* 0-based input channel of each ring */
+    float    bit_volts[OE_SHM_MAX_CHANNELS];    /* scale of each int16 ring, 1 for float */
+
+    /* Updated by the writer after every block. Read with oe_shm_position(). */
+    uint32_t sequence;          /* odd while the fields below are being changed */
+    uint32_t state;             /* OE_SHM_STOPPED, OE_SHM_RUNNING or OE_SHM_CLOSED */
+    uint32_t generation;        /* incremented every time acquisition starts */
+    uint32_t max_block;         /* largest block written so far, in samples */
+    uint64_t write_index;       /* samples per channel written since acquisition started */
+    int64_t  timestamp;         /* timestamp of sample write_index, i.e. one past the last one */
+} oe_shm_header;
+
+/* Size in bytes of one sample of the given format */
+#define OE_SHM_SAMPLE_SIZE(format) ((format) == OE_SHM_INT16 ? 2u : 4u)
+
+/* Offset of the sample data, rounded up so every ring starts on a cache line */
+#define OE_SHM_DATA_OFFSET ((uint32_t) ((sizeof(oe_shm_header) + 63) & ~(size_t) 63))
+
+/* Total size of a segment */
+#define OE_SHM_SEGMENT_SIZE(format, numChannels, capacity) \
+    ((size_t) OE_SHM_DATA_OFFSET + (size_t) (numChannels) * (capacity) * OE_SHM_SAMPLE_SIZE(format))
+
+/* ------------------------------------------------------------------ */
+
+typedef struct oe_shm_reader
+{
+    const oe_shm_header* header;
+    const uint8_t* data;
+    size_t size;
+
+    /* next sample returned by oe_shm_read() */
+    uint64_t read_index;
+    uint32_t generation;
+} oe_shm_reader;
+
+/* Maps an existing segment read-only. Returns 0 on success, or -1 (with
+   errno set) if the segment doesn't exist or isn't an Open Ephys segment.
+   Reading starts at the newest sample. */
+int oe_shm_open(oe_shm_reader* reader, const char* name);
+
+void oe_shm_close(oe_shm_reader* reader);
+
+/* Takes a consistent snapshot of the writer's position. Any output pointer
+   may be NULL. Returns the writer state. */
+uint32_t oe_shm_position(const oe_shm_reader* reader,
+                         uint64_t* write_index,
+                         int64_t* timestamp,
+                         uint32_t* generation);
+
+/* Zero-copy access to a channel's ring: sample i of the stream is at
+   [i & (capacity - 1)]. Returns NULL if the format doesn't match. */
+const float*   oe_shm_float_ring(const oe_shm_reader* reader, int channel);
+const int16_t* oe_shm_int16_ring(const oe_shm_reader* reader, int channel);
+
+/* Returns 1 if samples from first_index onwards haven't been overwritten,
+   i.e. data read from the rings since first_index is valid. Call it after
+   using the samples. */
+int oe_shm_intact(const oe_shm_reader* reader, uint64_t first_index);
+
+/* Copies up to max_samples new samples of every channel into out, one run
+   of max_samples floats per channel, converting int16 data back to floats.
+   Returns the number of samples copied per channel, or -1 if the segment
+   was closed and has to be reopened. first_timestamp receives the timestamp
+   of the first copied sample and lost the number of samples that were
+   overwritten before they could be read (both may be NULL). */
+long oe_shm_read(oe_shm_reader* reader,
+                 float* out,
+                 size_t max_samples,
+                 int64_t* first_timestamp,
+                 uint64_t* lost);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* OE_SHM_H_INCLUDED */
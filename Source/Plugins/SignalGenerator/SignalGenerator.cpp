@@ -187,7 +187,11 @@ void SignalGenerator::process(AudioSampleBuffer& buffer,
                               MidiBuffer& midiMessages)
 {
 
-    int nSamps = int((float) buffer.getNumSamples() * sampleRateRatio);
+    // the block is allocated at the audio device's size, so at higher sample
+    // rates only part of the needed samples fit in it
+    int nSamps = jmin(int((float) buffer.getNumSamples() * sampleRateRatio), buffer.getNumSamples());
+
+    setNumSamples(midiMessages, nSamps);
 
     for (int i = 0; i < nSamps; ++i)
     {
@@ -0,0 +1,137 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2016 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "SimulatedHeadstageEditor.h"
+#include "SimulatedHeadstageThread.h"
+
+namespace
+{
+    const int channelCounts[] = { 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+    const int sampleRates[] = { 1000, 2000, 5000, 10000, 20000, 25000, 30000, 40000 };
+}
+
+SimulatedHeadstageEditor::SimulatedHeadstageEditor(GenericProcessor* parentNode,
+                                                   SimulatedHeadstageThread* t,
+                                                   bool useDefaultParameterEditors)
+    : GenericEditor(parentNode, useDefaultParameterEditors), thread(t)
+{
+    desiredWidth = 170;
+
+    const char* names[] = { "Channels", "Rate (Hz)", "Pacing" };
+
+    for (int i = 0; i < 3; i++)
+    {
+        Label* label = new Label(names[i], names[i]);
+        label->setBounds(5, 30 + 30 * i, 65, 20);
+        label->setFont(Font("Small Text", 12, Font::plain));
+        label->setColour(Label::textColourId, Colours::darkgrey);
+        addAndMakeVisible(label);
+        labels.add(label);
+    }
+
+    channelSelector = new ComboBox("Channels");
+    channelSelector->setBounds(70, 30, 90, 20);
+
+    for (int i = 0; i < numElementsInArray(channelCounts); i++)
+        channelSelector->addItem(String(channelCounts[i]), i + 1);
+
+    channelSelector->setSelectedId(2, dontSendNotification);
+    channelSelector->addListener(this);
+    addAndMakeVisible(channelSelector);
+
+    rateSelector = new ComboBox("Rate");
+    rateSelector->setBounds(70, 60, 90, 20);
+
+    for (int i = 0; i < numElementsInArray(sampleRates); i++)
+        rateSelector->addItem(String(sampleRates[i]), i + 1);
+
+    rateSelector->setSelectedId(7, dontSendNotification);
+    rateSelector->addListener(this);
+    addAndMakeVisible(rateSelector);
+
+    pacingSelector = new ComboBox("Pacing");
+    pacingSelector->setBounds(70, 90, 90, 20);
+    pacingSelector->addItem("Real time", 1);
+    pacingSelector->addItem("Free running", 2);
+    pacingSelector->setSelectedId(1, dontSendNotification);
+    pacingSelector->setTooltip("Real time paces the data to the wall clock; free running produces it as fast as the signal chain takes it");
+    pacingSelector->addListener(this);
+    addAndMakeVisible(pacingSelector);
+}
+
+SimulatedHeadstageEditor::~SimulatedHeadstageEditor()
+{
+}
+
+void SimulatedHeadstageEditor::comboBoxChanged(ComboBox* comboBox)
+{
+    if (acquisitionIsActive)
+        return;
+
+    if (comboBox == channelSelector)
+    {
+        thread->setNumChannels(channelCounts[comboBox->getSelectedId() - 1]);
+        CoreServices::updateSignalChain(this);
+    }
+    else if (comboBox == rateSelector)
+    {
+        thread->setSampleRate(float(sampleRates[comboBox->getSelectedId() - 1]));
+        CoreServices::updateSignalChain(this);
+    }
+    else if (comboBox == pacingSelector)
+    {
+        thread->setRealTime(comboBox->getSelectedId() == 1);
+    }
+}
+
+void SimulatedHeadstageEditor::startAcquisition()
+{
+    GenericEditor::startAcquisition();
+
+    channelSelector->setEnabled(false);
+    rateSelector->setEnabled(false);
+    pacingSelector->setEnabled(false);
+}
+
+void SimulatedHeadstageEditor::stopAcquisition()
+{
+    GenericEditor::stopAcquisition();
+
+    channelSelector->setEnabled(true);
+    rateSelector->setEnabled(true);
+    pacingSelector->setEnabled(true);
+}
+
+void SimulatedHeadstageEditor::saveCustomParameters(XmlElement* xml)
+{
+    xml->setAttribute("NumChannels", channelSelector->getSelectedId());
+    xml->setAttribute("SampleRate", rateSelector->getSelectedId());
+    xml->setAttribute("Pacing", pacingSelector->getSelectedId());
+}
+
+void SimulatedHeadstageEditor::loadCustomParameters(XmlElement* xml)
+{
+    channelSelector->setSelectedId(xml->getIntAttribute("NumChannels", channelSelector->getSelectedId()), sendNotificationSync);
+    rateSelector->setSelectedId(xml->getIntAttribute("SampleRate", rateSelector->getSelectedId()), sendNotificationSync);
+    pacingSelector->setSelectedId(xml->getIntAttribute("Pacing", pacingSelector->getSelectedId()), sendNotificationSync);
+}
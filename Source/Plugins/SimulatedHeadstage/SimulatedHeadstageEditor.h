@@ -0,0 +1,67 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2016 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef SIMULATEDHEADSTAGEEDITOR_H_INCLUDED
+#define SIMULATEDHEADSTAGEEDITOR_H_INCLUDED
+
+#include <EditorHeaders.h>
+
+class SimulatedHeadstageThread;
+
+/**
+
+  User interface for the simulated headstage: channel count, sample rate
+  and pacing.
+
+  @see SimulatedHeadstageThread
+
+*/
+
+class SimulatedHeadstageEditor : public GenericEditor,
+                                 public ComboBox::Listener
+{
+public:
+    SimulatedHeadstageEditor(GenericProcessor* parentNode, SimulatedHeadstageThread* thread, bool useDefaultParameterEditors);
+    ~SimulatedHeadstageEditor();
+
+    void comboBoxChanged(ComboBox* comboBox) override;
+
+    void startAcquisition() override;
+    void stopAcquisition() override;
+
+    void saveCustomParameters(XmlElement* xml) override;
+    void loadCustomParameters(XmlElement* xml) override;
+
+private:
+    SimulatedHeadstageThread* thread;
+
+    ScopedPointer<ComboBox> channelSelector;
+    ScopedPointer<ComboBox> rateSelector;
+    ScopedPointer<ComboBox> pacingSelector;
+
+    OwnedArray<Label> labels;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SimulatedHeadstageEditor);
+};
+
+#endif  // SIMULATEDHEADSTAGEEDITOR_H_INCLUDED
@@ -0,0 +1,413 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2016 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "SimulatedHeadstageThread.h"
+#include "SimulatedHeadstageEditor.h"
+
+#include <SpikeLib.h>
+
+#define RANDOM_SEED 20160101
+#define MAX_BLOCK_SAMPLES 512
+#define DATA_BUFFER_SAMPLES 4096
+#define NOISE_TABLE_SIZE (1 << 18)
+#define NUM_EVENT_CHANNELS 8
+
+// all amplitudes in microvolts, as the Rhythm thread delivers them
+#define BIT_VOLTS 0.195f
+#define NOISE_RMS 8.0f
+#define SPIKE_DURATION 0.003
+#define REFRACTORY_PERIOD 0.002
+#define TRIAL_RATE 0.5f
+
+namespace
+{
+    const int numLfpSources = 3;
+    const double lfpFrequencies[numLfpSources] = { 8.0, 20.0, 40.0 };
+    const float lfpAmplitudes[numLfpSources] = { 150.0f, 40.0f, 25.0f };
+
+    // share of a unit's amplitude seen on the channels around its own
+    const int spikeSpread = 2;
+    const float spreadWeights[2 * spikeSpread + 1] = { 0.2f, 0.5f, 1.0f, 0.5f, 0.2f };
+}
+
+SimulatedHeadstageThread::SimulatedHeadstageThread(SourceNode* sn)
+    : DataThread(sn),
+      numChannels(64),
+      sampleRate(30000.0f),
+      realTime(true),
+      random(RANDOM_SEED),
+      nextTrial(0), trialEnd(0), syncEnd(0),
+      startTicks(0), numSamplesGenerated(0)
+{
+    dataBuffer = new DataBuffer(numChannels, DATA_BUFFER_SAMPLES);
+
+    // Box-Muller; the table is built once and shared by all settings
+    noiseTable.malloc(NOISE_TABLE_SIZE + MAX_BLOCK_SAMPLES);
+
+    for (int i = 0; i < NOISE_TABLE_SIZE; i += 2)
+    {
+        const double r = std::sqrt(-2.0 * std::log(1.0 - random.nextDouble()));
+        const double theta = 2.0 * double_Pi * random.nextDouble();
+
+        noiseTable[i] = float(r * std::cos(theta));
+        noiseTable[i + 1] = float(r * std::sin(theta));
+    }
+
+    memcpy(noiseTable + NOISE_TABLE_SIZE, noiseTable, sizeof(float) * MAX_BLOCK_SAMPLES);
+
+    for (int k = 0; k < numLfpSources; k++)
+        lfpPhase[k] = 0.0;
+
+    eventCode = 0;
+}
+
+SimulatedHeadstageThread::~SimulatedHeadstageThread()
+{
+}
+
+GenericEditor* SimulatedHeadstageThread::createEditor(SourceNode* sn)
+{
+    return new SimulatedHeadstageEditor(sn, this, true);
+}
+
+bool SimulatedHeadstageThread::foundInputSource()
+{
+    return true;
+}
+
+int SimulatedHeadstageThread::getNumHeadstageOutputs()
+{
+    return numChannels;
+}
+
+int SimulatedHeadstageThread::getNumEventChannels()
+{
+    return NUM_EVENT_CHANNELS;
+}
+
+void SimulatedHeadstageThread::getEventChannelNames(StringArray& names)
+{
+    names.clear();
+    names.add("1 Hz");
+    names.add("10 Hz pulses");
+    names.add("Trials");
+    names.add("Unit 1 spikes");
+
+    for (int k = names.size(); k < NUM_EVENT_CHANNELS; k++)
+        names.add("TTL" + String(k + 1));
+}
+
+float SimulatedHeadstageThread::getSampleRate()
+{
+    return sampleRate;
+}
+
+float SimulatedHeadstageThread::getBitVolts(Channel*)
+{
+    return BIT_VOLTS;
+}
+
+void SimulatedHeadstageThread::setNumChannels(int n)
+{
+    if (isThreadRunning())
+        return;
+
+    numChannels = jlimit(1, 4096, n);
+    dataBuffer->resize(numChannels, DATA_BUFFER_SAMPLES);
+}
+
+void SimulatedHeadstageThread::setSampleRate(float rate)
+{
+    if (isThreadRunning() || rate <= 0)
+        return;
+
+    sampleRate = rate;
+}
+
+void SimulatedHeadstageThread::setRealTime(bool rt)
+{
+    realTime = rt;
+}
+
+bool SimulatedHeadstageThread::isRealTime() const
+{
+    return realTime;
+}
+
+int64 SimulatedHeadstageThread::drawInterval(float rate)
+{
+    const double interval = -std::log(1.0 - random.nextDouble()) / rate;
+
+    return jmax<int64>(1, int64(interval * sampleRate));
+}
+
+void SimulatedHeadstageThread::prepare()
+{
+    // the same settings always produce the same data
+    random.setSeed(RANDOM_SEED);
+
+    noiseOffsets.malloc(numChannels);
+    lfpWeights.malloc(numChannels * numLfpSources);
+
+    double spatialPhase[numLfpSources];
+
+    for (int k = 0; k < numLfpSources; k++)
+    {
+        spatialPhase[k] = 2.0 * double_Pi * random.nextDouble();
+        lfpPhase[k] = 0.0;
+    }
+
+    for (int ch = 0; ch < numChannels; ch++)
+    {
+        noiseOffsets[ch] = random.nextInt(NOISE_TABLE_SIZE);
+
+        // LFP amplitudes vary smoothly along the probe
+        const double x = double(ch) / numChannels;
+
+        for (int k = 0; k < numLfpSources; k++)
+            lfpWeights[ch * numLfpSources + k] = lfpAmplitudes[k]
+                                               * float(0.7 + 0.3 * std::sin(2.0 * double_Pi * x * (k + 1) + spatialPhase[k]));
+    }
+
+    // resample the spike waveforms to the current rate, with the baseline
+    // removed, the peak scaled to 1 and extracellular polarity
+    const int templateLength = jmax(8, roundToInt(SPIKE_DURATION * sampleRate));
+    templates.setSize(5, templateLength);
+
+    for (int w = 0; w < 5; w++)
+    {
+        const double baseline = SPIKE_WAVEFORMS[w][0];
+        double peak = 0.0;
+
+        for (int i = 0; i < N_WAVEFORM_SAMPLES; i++)
+            peak = jmax(peak, std::abs(SPIKE_WAVEFORMS[w][i] - baseline));
+
+        float* dest = templates.getWritePointer(w);
+
+        for (int j = 0; j < templateLength; j++)
+        {
+            const double pos = double(j) * (N_WAVEFORM_SAMPLES - 1) / (templateLength - 1);
+            const int i = jmin(int(pos), N_WAVEFORM_SAMPLES - 2);
+            const double frac = pos - i;
+            const double value = SPIKE_WAVEFORMS[w][i] * (1.0 - frac) + SPIKE_WAVEFORMS[w][i + 1] * frac;
+
+            dest[j] = float(-(value - baseline) / peak);
+        }
+    }
+
+    units.clearQuick();
+
+    for (int u = 0; u < jmax(1, numChannels / 4); u++)
+    {
+        Unit unit;
+        unit.channel = random.nextInt(numChannels);
+        unit.waveform = random.nextInt(5);
+        unit.amplitude = 50.0f + 200.0f * random.nextFloat();
+        unit.rate = 1.0f + 19.0f * random.nextFloat();
+        unit.nextSpike = drawInterval(unit.rate);
+
+        units.add(unit);
+    }
+
+    spikeBuffer.setSize(numChannels, MAX_BLOCK_SAMPLES + templateLength);
+    spikeBuffer.clear();
+
+    lfpSources.setSize(numLfpSources, MAX_BLOCK_SAMPLES);
+    block.setSize(numChannels, MAX_BLOCK_SAMPLES);
+    blockTimestamps.malloc(MAX_BLOCK_SAMPLES);
+    blockEventCodes.malloc(MAX_BLOCK_SAMPLES);
+
+    nextTrial = drawInterval(TRIAL_RATE);
+    trialEnd = 0;
+    syncEnd = 0;
+
+    numSamplesGenerated = 0;
+    timestamp = 0;
+}
+
+bool SimulatedHeadstageThread::startAcquisition()
+{
+    prepare();
+
+    dataBuffer->resize(numChannels, DATA_BUFFER_SAMPLES);
+    dataBuffer->clear();
+
+    startTicks = Time::getHighResolutionTicks();
+
+    startThread();
+
+    return true;
+}
+
+bool SimulatedHeadstageThread::stopAcquisition()
+{
+    if (isThreadRunning())
+        stopThread(500);
+
+    return true;
+}
+
+bool SimulatedHeadstageThread::updateBuffer()
+{
+    int numSamples;
+
+    if (realTime)
+    {
+        const double elapsed = double(Time::getHighResolutionTicks() - startTicks)
+                               / double(Time::getHighResolutionTicksPerSecond());
+        const int64 due = int64(elapsed * sampleRate);
+
+        numSamples = int(jmin<int64>(due - numSamplesGenerated, MAX_BLOCK_SAMPLES));
+    }
+    else
+    {
+        // keep the buffer full, but never overrun it
+        numSamples = jmin(MAX_BLOCK_SAMPLES, DATA_BUFFER_SAMPLES - 1 - dataBuffer->getNumSamples());
+    }
+
+    if (numSamples <= 0)
+    {
+        wait(1);
+        return true;
+    }
+
+    generate(numSamples);
+
+    return true;
+}
+
+void SimulatedHeadstageThread::generate(int numSamples)
+{
+    const int64 start = numSamplesGenerated;
+    const int64 samplesPerSecond = jmax<int64>(10, int64(sampleRate + 0.5f));
+    const int templateLength = templates.getNumSamples();
+
+    // shared LFP oscillations; gamma is strongest at the theta peak
+    float* theta = lfpSources.getWritePointer(0);
+    float* beta = lfpSources.getWritePointer(1);
+    float* gamma = lfpSources.getWritePointer(2);
+
+    double increment[numLfpSources];
+
+    for (int k = 0; k < numLfpSources; k++)
+        increment[k] = 2.0 * double_Pi * lfpFrequencies[k] / sampleRate;
+
+    for (int i = 0; i < numSamples; i++)
+    {
+        theta[i] = float(std::sin(lfpPhase[0]));
+        beta[i] = float(std::sin(lfpPhase[1]));
+        gamma[i] = float(std::sin(lfpPhase[2]) * 0.5 * (1.0 + std::cos(lfpPhase[0])));
+
+        for (int k = 0; k < numLfpSources; k++)
+        {
+            lfpPhase[k] += increment[k];
+
+            if (lfpPhase[k] > 2.0 * double_Pi)
+                lfpPhase[k] -= 2.0 * double_Pi;
+        }
+    }
+
+    // TTL patterns
+    for (int i = 0; i < numSamples; i++)
+    {
+        const int64 t = start + i;
+        uint64 code = 0;
+
+        if (t % samplesPerSecond < samplesPerSecond / 2)
+            code |= 1 << 0;
+
+        if (t % (samplesPerSecond / 10) < samplesPerSecond / 100)
+            code |= 1 << 1;
+
+        if (t >= nextTrial)
+        {
+            trialEnd = t + samplesPerSecond / 10;
+            nextTrial = trialEnd + drawInterval(TRIAL_RATE);
+        }
+
+        if (t < trialEnd)
+            code |= 1 << 2;
+
+        if (t < syncEnd)
+            code |= 1 << 3;
+
+        blockEventCodes[i] = code;
+        blockTimestamps[i] = t;
+    }
+
+    // spikes; those that run past the end of the block are finished in the next
+    for (int u = 0; u < units.size(); u++)
+    {
+        Unit& unit = units.getReference(u);
+
+        while (unit.nextSpike < start + numSamples)
+        {
+            const int offset = int(unit.nextSpike - start);
+
+            for (int d = -spikeSpread; d <= spikeSpread; d++)
+            {
+                const int ch = unit.channel + d;
+
+                if (ch >= 0 && ch < numChannels)
+                    spikeBuffer.addFrom(ch, offset, templates, unit.waveform, 0, templateLength,
+                                        unit.amplitude * spreadWeights[d + spikeSpread]);
+            }
+
+            if (u == 0)
+            {
+                for (int i = offset; i < jmin(numSamples, offset + templateLength); i++)
+                    blockEventCodes[i] |= 1 << 3;
+
+                syncEnd = unit.nextSpike + templateLength;
+            }
+
+            unit.nextSpike += drawInterval(unit.rate) + int64(REFRACTORY_PERIOD * sampleRate);
+        }
+    }
+
+    for (int ch = 0; ch < numChannels; ch++)
+    {
+        float* out = block.getWritePointer(ch);
+
+        FloatVectorOperations::copyWithMultiply(out, noiseTable + noiseOffsets[ch], NOISE_RMS, numSamples);
+        noiseOffsets[ch] = (noiseOffsets[ch] + numSamples) % NOISE_TABLE_SIZE;
+
+        for (int k = 0; k < numLfpSources; k++)
+            FloatVectorOperations::addWithMultiply(out, lfpSources.getReadPointer(k),
+                                                   lfpWeights[ch * numLfpSources + k], numSamples);
+
+        float* spikes = spikeBuffer.getWritePointer(ch);
+
+        FloatVectorOperations::add(out, spikes, numSamples);
+
+        memmove(spikes, spikes + numSamples, sizeof(float) * templateLength);
+        FloatVectorOperations::clear(spikes + templateLength, numSamples);
+    }
+
+    // samples that don't fit are dropped and counted by the buffer, and show
+    // up downstream as a timestamp gap, as they would with real hardware
+    dataBuffer->addBlockToBuffer(block, blockTimestamps, blockEventCodes, numSamples);
+
+    numSamplesGenerated += numSamples;
+    timestamp = numSamplesGenerated;
+}
@@ -0,0 +1,147 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2016 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef SIMULATEDHEADSTAGETHREAD_H_INCLUDED
+#define SIMULATEDHEADSTAGETHREAD_H_INCLUDED
+
+#include <DataThreadHeaders.h>
+
+/**
+
+  Generates synthetic headstage data, so that complete signal chains can be
+  run and load-tested without any acquisition hardware.
+
+  Each channel is the sum of:
+    - background noise, drawn from a precomputed table of Gaussian samples
+      that every channel reads at its own offset;
+    - LFP, a per-channel mix of a few shared oscillations (theta, beta, and
+      gamma whose amplitude follows the theta phase), so neighbouring
+      channels are correlated the way they are on a probe;
+    - spikes from units that fire as Poisson processes, using the templates
+      in SPIKE_WAVEFORMS and spreading to the channels next to their own.
+
+  The TTL lines carry fixed patterns: a 1 Hz square wave, 10 ms pulses at
+  10 Hz, randomly timed 100 ms "trials", and a copy of the firing of the
+  first unit.
+
+  Data is produced either paced to the wall clock, like real hardware, or
+  free-running, as fast as the signal chain takes it. The random generator
+  has a fixed seed, so every run produces the same data.
+
+  @see DataThread, SourceNode
+
+*/
+
+class SimulatedHeadstageThread : public DataThread
+{
+public:
+    SimulatedHeadstageThread(SourceNode* sn);
+    ~SimulatedHeadstageThread();
+
+    bool updateBuffer() override;
+
+    bool foundInputSource() override;
+
+    bool startAcquisition() override;
+    bool stopAcquisition() override;
+
+    int getNumHeadstageOutputs() override;
+    int getNumEventChannels() override;
+
+    float getSampleRate() override;
+    float getBitVolts(Channel* chan) override;
+
+    void getEventChannelNames(StringArray& names) override;
+
+    GenericEditor* createEditor(SourceNode* sn) override;
+
+    /** Sets the number of channels; only while not acquiring. */
+    void setNumChannels(int numChannels);
+
+    /** Sets the sample rate; only while not acquiring. */
+    void setSampleRate(float sampleRate);
+
+    /** Chooses between pacing to the wall clock and free-running. */
+    void setRealTime(bool realTime);
+    bool isRealTime() const;
+
+private:
+    struct Unit
+    {
+        int channel;
+        int waveform;
+        float amplitude;
+        float rate;
+        int64 nextSpike;
+    };
+
+    /** Builds the templates, units and channel weights for the current
+        settings. Not real-time safe. */
+    void prepare();
+
+    /** Writes the next numSamples samples into the block buffers. */
+    void generate(int numSamples);
+
+    /** Draws the time to the next event of a Poisson process, in samples. */
+    int64 drawInterval(float rate);
+
+    int numChannels;
+    float sampleRate;
+    bool realTime;
+
+    Random random;
+
+    /** Gaussian samples with unit variance, followed by a copy of the first
+        block so that every block can be read without wrapping. */
+    HeapBlock<float> noiseTable;
+    HeapBlock<int> noiseOffsets;
+
+    /** LFP weights: numLfpSources per channel. */
+    HeapBlock<float> lfpWeights;
+    AudioSampleBuffer lfpSources;
+    double lfpPhase[3];
+
+    /** Spike templates at the current sample rate, scaled to a peak of 1. */
+    AudioSampleBuffer templates;
+    Array<Unit> units;
+
+    /** Spikes still to be added; holds one block plus the tail of spikes
+        that run past its end. */
+    AudioSampleBuffer spikeBuffer;
+
+    int64 nextTrial;
+    int64 trialEnd;
+    int64 syncEnd;
+
+    /** One generated block, in the form the DataBuffer takes it. */
+    AudioSampleBuffer block;
+    HeapBlock<int64> blockTimestamps;
+    HeapBlock<uint64> blockEventCodes;
+
+    int64 startTicks;
+    int64 numSamplesGenerated;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SimulatedHeadstageThread);
+};
+
+#endif  // SIMULATEDHEADSTAGETHREAD_H_INCLUDED
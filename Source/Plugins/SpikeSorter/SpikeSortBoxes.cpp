@@ -591,6 +591,7 @@ void BoxUnit::updateWaveform(SpikeObject* so)
 /***********************************************/
 
 SpikeSortBoxes::SpikeSortBoxes(UniqueIDgenerator* uniqueIDgenerator_,PCAcomputingThread* pth, int numch, double SamplingRate, int WaveFormLength)
+    : activeUnits(nullptr), unitsInUse(nullptr)
 {
     uniqueIDgenerator = uniqueIDgenerator_;
     computingThread = pth;
@@ -619,11 +620,12 @@ SpikeSortBoxes::SpikeSortBoxes(UniqueIDgenerator* uniqueIDgenerator_,PCAcomputin
 
         spikeBuffer.add(so);
     }
+
+    publishUnits();
 }
 
 void SpikeSortBoxes::resizeWaveform(int numSamples)
 {
-    const ScopedLock myScopedLock(mut);
     //StartCriticalSection();
     waveformLength = numSamples;
     delete pc1;
@@ -647,6 +649,7 @@ void SpikeSortBoxes::resizeWaveform(int numSamples)
     {
         boxUnits[k].resizeWaveform(waveformLength);
     }
+    publishUnits();
     //EndCriticalSection();
 }
 
@@ -756,6 +759,7 @@ void SpikeSortBoxes::loadCustomParametersFromXml(XmlElement* electrodeNode)
             }
         }
     }
+    publishUnits();
 }
 
 void SpikeSortBoxes::saveCustomParametersToXml(XmlElement* electrodeNode)
@@ -839,6 +843,8 @@ SpikeSortBoxes::~SpikeSortBoxes()
     delete pc2;
     pc1 = nullptr;
     pc2 = nullptr;
+
+    delete activeUnits.exchange(nullptr);
 }
 
 void SpikeSortBoxes::setSelectedUnitAndBox(int unitID, int boxID)
@@ -928,9 +934,9 @@ void SpikeSortBoxes::RePCA()
 
 void SpikeSortBoxes::addPCAunit(PCAUnit unit)
 {
-    const ScopedLock myScopedLock(mut);
     //StartCriticalSection();
     pcaUnits.push_back(unit);
+    publishUnits();
     //EndCriticalSection();
 }
 
@@ -938,11 +944,11 @@ void SpikeSortBoxes::addPCAunit(PCAUnit unit)
 // returns the unit id
 int SpikeSortBoxes::addBoxUnit(int channel)
 {
-    const ScopedLock myScopedLock(mut);
     //StartCriticalSection();
     int unusedID = uniqueIDgenerator->generateUniqueID(); //generateUnitID();
     BoxUnit unit(unusedID, generateLocalID());
     boxUnits.push_back(unit);
+    publishUnits();
     setSelectedUnitAndBox(unusedID, 0);
     //EndCriticalSection();
     return unusedID;
@@ -960,11 +966,11 @@ void  SpikeSortBoxes::EndCriticalSection()
 */
 int SpikeSortBoxes::addBoxUnit(int channel, Box B)
 {
-    const ScopedLock myScopedLock(mut);
     //StartCriticalSection();
     int unusedID = uniqueIDgenerator->generateUniqueID(); //generateUnitID();
     BoxUnit unit(B, unusedID,generateLocalID());
     boxUnits.push_back(unit);
+    publishUnits();
     setSelectedUnitAndBox(unusedID, 0);
     //EndCriticalSection();
     return unusedID;
@@ -1038,7 +1044,6 @@ int SpikeSortBoxes::generateUnitID()
 
 void SpikeSortBoxes::generateNewIDs()
 {
-    const ScopedLock myScopedLock(mut);
     for (int k=0; k<boxUnits.size(); k++)
     {
         boxUnits[k].UnitID = generateUnitID();
@@ -1047,24 +1052,25 @@ void SpikeSortBoxes::generateNewIDs()
     {
         pcaUnits[k].UnitID = generateUnitID();
     }
+    publishUnits();
 }
 
 void SpikeSortBoxes::removeAllUnits()
 {
-    const ScopedLock myScopedLock(mut);
     boxUnits.clear();
     pcaUnits.clear();
+    publishUnits();
 }
 
 bool SpikeSortBoxes::removeUnit(int unitID)
 {
-    const ScopedLock myScopedLock(mut);
     //StartCriticalSection();
     for (int k=0; k<boxUnits.size(); k++)
     {
         if (boxUnits[k].getUnitID() == unitID)
         {
             boxUnits.erase(boxUnits.begin()+k);
+            publishUnits();
             //EndCriticalSection();
             return true;
         }
@@ -1075,6 +1081,7 @@ bool SpikeSortBoxes::removeUnit(int unitID)
         if (pcaUnits[k].getUnitID() == unitID)
         {
             pcaUnits.erase(pcaUnits.begin()+k);
+            publishUnits();
             //EndCriticalSection();
             return true;
         }
@@ -1087,7 +1094,6 @@ bool SpikeSortBoxes::removeUnit(int unitID)
 
 bool SpikeSortBoxes::addBoxToUnit(int channel, int unitID)
 {
-    const ScopedLock myScopedLock(mut);
 
     //StartCriticalSection();
 
@@ -1100,6 +1106,7 @@ bool SpikeSortBoxes::addBoxToUnit(int channel, int unitID)
             B.y -= 30;
             B.channel = channel;
             boxUnits[k].addBox(B);
+            publishUnits();
             setSelectedUnitAndBox(unitID, boxUnits[k].lstBoxes.size() - 1);
             // EndCriticalSection();
             return true;
@@ -1112,13 +1119,13 @@ bool SpikeSortBoxes::addBoxToUnit(int channel, int unitID)
 
 bool SpikeSortBoxes::addBoxToUnit(int channel, int unitID, Box B)
 {
-    const ScopedLock myScopedLock(mut);
     //StartCriticalSection();
     for (int k=0; k<boxUnits.size(); k++)
     {
         if (boxUnits[k].getUnitID() == unitID)
         {
             boxUnits[k].addBox(B);
+            publishUnits();
             // EndCriticalSection();
             return true;
         }
@@ -1130,7 +1137,6 @@ bool SpikeSortBoxes::addBoxToUnit(int channel, int unitID, Box B)
 std::vector<BoxUnit> SpikeSortBoxes::getBoxUnits()
 {
     //StartCriticalSection();
-    const ScopedLock myScopedLock(mut);
     std::vector<BoxUnit> unitsCopy = boxUnits;
     //EndCriticalSection();
     return unitsCopy;
@@ -1140,7 +1146,6 @@ std::vector<BoxUnit> SpikeSortBoxes::getBoxUnits()
 std::vector<PCAUnit> SpikeSortBoxes::getPCAUnits()
 {
     //StartCriticalSection();
-    const ScopedLock myScopedLock(mut);
     std::vector<PCAUnit> unitsCopy = pcaUnits;
     //EndCriticalSection();
     return unitsCopy;
@@ -1149,16 +1154,16 @@ std::vector<PCAUnit> SpikeSortBoxes::getPCAUnits()
 void SpikeSortBoxes::updatePCAUnits(std::vector<PCAUnit> _units)
 {
     //StartCriticalSection();
-    const ScopedLock myScopedLock(mut);
     pcaUnits = _units;
+    publishUnits();
     //EndCriticalSection();
 }
 
 void SpikeSortBoxes::updateBoxUnits(std::vector<BoxUnit> _units)
 {
-    const ScopedLock myScopedLock(mut);
     //StartCriticalSection();
     boxUnits = _units;
+    publishUnits();
     //EndCriticalSection();
 }
 
@@ -1168,7 +1173,31 @@ void SpikeSortBoxes::updateBoxUnits(std::vector<BoxUnit> _units)
 // tests whether a candidate spike belongs to one of the defined units
 bool SpikeSortBoxes::sortSpike(SpikeObject* so, bool PCAfirst)
 {
-    const ScopedLock myScopedLock(mut);
+    // Announce the copy we are about to use. If it was swapped in between,
+    // the message thread may already have retired it, so try again with the new one.
+    SortingUnits* units = activeUnits.load();
+
+    for (;;)
+    {
+        unitsInUse.store(units);
+
+        SortingUnits* latest = activeUnits.load();
+
+        if (latest == units)
+            break;
+
+        units = latest;
+    }
+
+    const bool sorted = units->sortSpike(so, PCAfirst);
+
+    unitsInUse.store(nullptr);
+
+    return sorted;
+}
+
+bool SpikeSortBoxes::SortingUnits::sortSpike(SpikeObject* so, bool PCAfirst)
+{
     if (PCAfirst)
     {
 
@@ -1230,16 +1259,41 @@ bool SpikeSortBoxes::sortSpike(SpikeObject* so, bool PCAfirst)
     return false;
 }
 
+void SpikeSortBoxes::publishUnits()
+{
+    SortingUnits* newUnits = new SortingUnits();
+    newUnits->boxUnits = boxUnits;
+    newUnits->pcaUnits = pcaUnits;
+
+    SortingUnits* oldUnits = activeUnits.exchange(newUnits);
+
+    if (oldUnits != nullptr)
+        retiredUnits.add(oldUnits);
+
+    releaseRetiredUnits();
+}
+
+void SpikeSortBoxes::releaseRetiredUnits()
+{
+    SortingUnits* inUse = unitsInUse.load();
+
+    for (int i = retiredUnits.size(); --i >= 0;)
+    {
+        if (retiredUnits[i] != inUse)
+            retiredUnits.remove(i);
+    }
+}
+
 
 bool  SpikeSortBoxes::removeBoxFromUnit(int unitID, int boxIndex)
 {
-    const ScopedLock myScopedLock(mut);
     //StartCriticalSection();
     for (int k=0; k<boxUnits.size(); k++)
     {
         if (boxUnits[k].getUnitID() == unitID)
         {
             bool s= boxUnits[k].deleteBox(boxIndex);
+            publishUnits();
             setSelectedUnitAndBox(-1,-1);
             //EndCriticalSection();
             return s;
@@ -1254,7 +1308,6 @@ bool  SpikeSortBoxes::removeBoxFromUnit(int unitID, int boxIndex)
 std::vector<Box> SpikeSortBoxes::getUnitBoxes(int unitID)
 {
     std::vector<Box> boxes;
-    const ScopedLock myScopedLock(mut);
     //StartCriticalSection();
     for (int k=0; k< boxUnits.size(); k++)
     {
@@ -1273,7 +1326,6 @@ std::vector<Box> SpikeSortBoxes::getUnitBoxes(int unitID)
 
 int SpikeSortBoxes::getNumBoxes(int unitID)
 {
-    const ScopedLock myScopedLock(mut);
     // StartCriticalSection();
     for (int k=0; k< boxUnits.size(); k++)
     {
@@ -29,6 +29,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <algorithm>    // std::sort
 #include <list>
 #include <queue>
+#include <atomic>
 
 class PCAcomputingThread;
 class UniqueIDgenerator;
@@ -268,14 +269,40 @@ public:
     void saveCustomParametersToXml(XmlElement* electrodeNode);
     void loadCustomParametersFromXml(XmlElement* electrodeNode);
 private:
+    /** Copy of the units that is used by sortSpike() on the audio thread. The
+        waveform statistics of the units are accumulated in this copy. */
+    struct SortingUnits
+    {
+        bool sortSpike(SpikeObject* so, bool PCAfirst);
+
+        std::vector<BoxUnit> boxUnits;
+        std::vector<PCAUnit> pcaUnits;
+    };
+
+    /** Copies the units into a new SortingUnits and hands it to the audio thread.
+        Has to be called after every change to boxUnits or pcaUnits. */
+    void publishUnits();
+
+    /** Deletes retired copies that the audio thread can no longer be using. */
+    void releaseRetiredUnits();
+
     //void  StartCriticalSection();
     //void  EndCriticalSection();
     UniqueIDgenerator* uniqueIDgenerator;
     int numChannels, waveformLength;
     int selectedUnit, selectedBox;
-    CriticalSection mut;
+
+    /** Message thread copy of the units, edited by the canvas. */
     std::vector<BoxUnit> boxUnits;
     std::vector<PCAUnit> pcaUnits;
+
+    /** The units are swapped with a single atomic exchange, so sorting a spike never
+        waits for the canvas. While sorting, the audio thread announces the copy it is
+        using in unitsInUse; copies replaced in the meantime are kept in retiredUnits
+        until it's safe to delete them. */
+    std::atomic<SortingUnits*> activeUnits;
+    std::atomic<SortingUnits*> unitsInUse;
+    OwnedArray<SortingUnits> retiredUnits;
     float* pc1, *pc2;
     float pc1min, pc2min, pc1max, pc2max;
     Array<SpikeObject> spikeBuffer;
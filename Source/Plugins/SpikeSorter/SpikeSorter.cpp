@@ -32,7 +32,8 @@ SpikeSorter::SpikeSorter()
     : GenericProcessor("Spike Sorter"),
       overflowBuffer(2,100), dataBuffer(nullptr),
       overflowBufferSize(100), currentElectrode(-1),
-      numPreSamples(8),numPostSamples(32)
+      numPreSamples(8),numPostSamples(32),
+      activeConfiguration(nullptr), configurationInUse(nullptr)
 {
     uniqueID = 0; // for electrode count
     uniqueSpikeID = 0;
@@ -40,12 +41,13 @@ SpikeSorter::SpikeSorter()
     ticksPerSec = (float) timer.getHighResolutionTicksPerSecond();
     electrodeTypes.clear();
     electrodeCounter.clear();
-    spikeBuffer = new uint8_t[MAX_SPIKE_BUFFER_LEN]; // MAX_SPIKE_BUFFER_LEN defined in SpikeObject.h
     channelBuffers=nullptr;
     PCAbeforeBoxes = true;
     autoDACassignment = false;
     syncThresholds = false;
     flipSignal = false;
+
+    publishConfiguration();
 }
 
 bool SpikeSorter::getFlipSignalState()
@@ -58,14 +60,12 @@ void SpikeSorter::setFlipSignalState(bool state)
 {
     flipSignal = state;
 
-    mut.enter();
     if (currentElectrode >= 0)
     {
         if (electrodes[currentElectrode]->spikePlot != nullptr)
             electrodes[currentElectrode]->spikePlot->setFlipSignal(state);
 
     }
-    mut.exit();
 
 }
 
@@ -110,6 +110,7 @@ void SpikeSorter::setNumPreSamples(int numSamples)
         electrodes[k]->resizeWaveform(numPreSamples,numPostSamples);
     }
 
+    publishConfiguration();
 }
 
 void SpikeSorter::setNumPostSamples(int numSamples)
@@ -119,6 +120,8 @@ void SpikeSorter::setNumPostSamples(int numSamples)
     {
         electrodes[k]->resizeWaveform(numPreSamples,numPostSamples);
     }
+
+    publishConfiguration();
 }
 
 
@@ -153,12 +156,11 @@ void SpikeSorter::increaseUniqueProbeID(String type)
 
 SpikeSorter::~SpikeSorter()
 {
-    delete spikeBuffer;
-    spikeBuffer = nullptr;
 
     if (channelBuffers != nullptr)
         delete channelBuffers;
 
+    delete activeConfiguration.exchange(nullptr);
 }
 
 
@@ -173,7 +175,6 @@ AudioProcessorEditor* SpikeSorter::createEditor()
 void SpikeSorter::updateSettings()
 {
 
-    mut.enter();
     int numChannels = getNumInputs();
     if (numChannels > 0)
         overflowBuffer.setSize(getNumInputs(), overflowBufferSize);
@@ -197,7 +198,6 @@ void SpikeSorter::updateSettings()
         eventChannels.add(ch);
     }
 
-    mut.exit();
 }
 
 
@@ -209,6 +209,7 @@ Electrode::~Electrode()
     delete channels;
     delete spikeSort;
     delete runningStats;
+    delete spikeRing;
 
 }
 
@@ -240,6 +241,7 @@ Electrode::Electrode(int ID, UniqueIDgenerator* uniqueIDgenerator_, PCAcomputing
         voltageScale[i] = 500;
     }
     spikePlot = nullptr;
+    spikeRing = new SpikeRing(SPIKE_DISPLAY_RING_SIZE);
 
     if (computingThread != nullptr)
         spikeSort = new SpikeSortBoxes(uniqueIDgenerator, computingThread, numChannels, samplingRate, pre+post);
@@ -264,23 +266,19 @@ void Electrode::resizeWaveform(int numPre, int numPost)
 void SpikeSorter::setElectrodeVoltageScale(int electrodeID, int index, float newvalue)
 {
     std::vector<float> values;
-    mut.enter();
     for (int k = 0; k < electrodes.size(); k++)
     {
         if (electrodes[k]->electrodeID == electrodeID)
         {
             electrodes[k]->voltageScale[index] = newvalue;
-            mut.exit();
             return;
         }
     }
-    mut.exit();
 }
 
 std::vector<float> SpikeSorter::getElectrodeVoltageScales(int electrodeID)
 {
     std::vector<float> values;
-    mut.enter();
     for (int k=0; k<electrodes.size(); k++)
     {
         if (electrodes[k]->electrodeID == electrodeID)
@@ -290,11 +288,9 @@ std::vector<float> SpikeSorter::getElectrodeVoltageScales(int electrodeID)
             {
                 values[i] = electrodes[k]->voltageScale[i];
             }
-            mut.exit();
             return values;
         }
     }
-    mut.exit();
     return values;
 }
 
@@ -403,18 +399,16 @@ void SpikeSorter::assignDACtoChannel(int dacOutput, int channel)
 
 void SpikeSorter::addElectrode(Electrode* newElectrode)
 {
-    mut.enter();
     resetElectrode(newElectrode);
     electrodes.add(newElectrode);
     // inform PSTH sink, if it exists, about this new electrode.
 //    updateSinks(newElectrode);
-    mut.exit();
+    publishConfiguration();
 }
 
 bool SpikeSorter::addElectrode(int nChans, String name, double Depth)
 {
 
-    mut.enter();
     int firstChan;
 
     if (electrodes.size() == 0)
@@ -429,7 +423,6 @@ bool SpikeSorter::addElectrode(int nChans, String name, double Depth)
 
     if (firstChan + nChans > getNumInputs())
     {
-        mut.exit();
         return false;
     }
 
@@ -457,7 +450,7 @@ bool SpikeSorter::addElectrode(int nChans, String name, double Depth)
     electrodes.add(newElectrode);
  //   updateSinks(newElectrode);
     setCurrentElectrodeIndex(electrodes.size()-1);
-    mut.exit();
+    publishConfiguration();
     return true;
 
 }
@@ -470,12 +463,10 @@ float SpikeSorter::getDefaultThreshold()
 StringArray SpikeSorter::getElectrodeNames()
 {
     StringArray names;
-    mut.enter();
     for (int i = 0; i < electrodes.size(); i++)
     {
         names.add(electrodes[i]->name);
     }
-    mut.exit();
     return names;
 }
 
@@ -486,12 +477,10 @@ void SpikeSorter::resetElectrode(Electrode* e)
 
 bool SpikeSorter::removeElectrode(int index)
 {
-    mut.enter();
     // std::cout << "Spike detector removing electrode" << std::endl;
 
     if (index > electrodes.size() || index < 0)
     {
-        mut.exit();
         return false;
     }
 
@@ -512,24 +501,21 @@ bool SpikeSorter::removeElectrode(int index)
     else
         currentElectrode = -1;
 
-    mut.exit();
+    publishConfiguration();
     return true;
 }
 
 void SpikeSorter::setElectrodeName(int index, String newName)
 {
-    mut.enter();
 	if ((electrodes.size() > 0) && (index > 0))
 	{
 		electrodes[index - 1]->name = newName;
 	//	updateSinks(electrodes[index - 1]->electrodeID, newName);
 	}
-    mut.exit();
 }
 
 void SpikeSorter::setChannel(int electrodeIndex, int channelNum, int newChannel)
 {
-    mut.enter();
     String log = "Setting electrode " + String(electrodeIndex) + " channel " + String(channelNum)+
                  " to " + String(newChannel);
     std::cout << log<< std::endl;
@@ -542,22 +528,18 @@ void SpikeSorter::setChannel(int electrodeIndex, int channelNum, int newChannel)
    // updateSinks(electrodes[electrodeIndex]->electrodeID, channelNum,newChannel);
 
     *(electrodes[electrodeIndex]->channels+channelNum) = newChannel;
-    mut.exit();
+    publishConfiguration();
 }
 
 int SpikeSorter::getNumChannels(int index)
 {
-    mut.enter();
     int i=electrodes[index]->numChannels;
-    mut.exit();
     return i;
 }
 
 int SpikeSorter::getChannel(int index, int i)
 {
-    mut.enter();
     int ii=*(electrodes[index]->channels+i);
-    mut.exit();
     return ii;
 }
 
@@ -578,16 +560,13 @@ void SpikeSorter::setChannelActive(int electrodeIndex, int subChannel, bool acti
 
 bool SpikeSorter::isChannelActive(int electrodeIndex, int i)
 {
-    mut.enter();
     bool b= *(electrodes[electrodeIndex]->isActive+i);
-    mut.exit();
     return b;
 }
 
 
 void SpikeSorter::setChannelThreshold(int electrodeNum, int channelNum, float thresh)
 {
-    mut.enter();
     currentElectrode = electrodeNum;
     currentChannelIndex = channelNum;
     electrodes[electrodeNum]->thresholds[channelNum] = thresh;
@@ -605,22 +584,18 @@ void SpikeSorter::setChannelThreshold(int electrodeNum, int channelNum, float th
         }
     }
 
-    mut.exit();
     setParameter(99, thresh);
 }
 
 double SpikeSorter::getChannelThreshold(int electrodeNum, int channelNum)
 {
-    mut.enter();
     double f= *(electrodes[electrodeNum]->thresholds+channelNum);
-    mut.exit();
     return f;
 }
 
 void SpikeSorter::setParameter(int parameterIndex, float newValue)
 {
     //editor->updateParameterButtons(parameterIndex);
-    mut.enter();
     if (parameterIndex == 99 && currentElectrode > -1)
     {
         *(electrodes[currentElectrode]->thresholds+currentChannelIndex) = newValue;
@@ -632,7 +607,7 @@ void SpikeSorter::setParameter(int parameterIndex, float newValue)
         else
             *(electrodes[currentElectrode]->isActive+currentChannelIndex) = true;
     }
-    mut.exit();
+    publishConfiguration();
 }
 
 
@@ -660,13 +635,11 @@ bool SpikeSorter::isReady()
 
 bool SpikeSorter::disable()
 {
-    mut.enter();
     for (int n = 0; n < electrodes.size(); n++)
     {
         resetElectrode(electrodes[n]);
     }
     //editor->disable();
-    mut.exit();
     return true;
 }
 
@@ -686,24 +659,20 @@ void SpikeSorter::addSpikeEvent(SpikeObject* s, MidiBuffer& eventBuffer, int pea
 
     s->eventType = SPIKE_EVENT_CODE;
 
-    int numBytes = packSpike(s,                        // SpikeObject
-                             spikeBuffer,              // uint8_t*
-                             MAX_SPIKE_BUFFER_LEN);    // int
-
-    if (numBytes > 0)
-        eventBuffer.addEvent(spikeBuffer, numBytes, peakIndex);
+    // downstream processors read the spike in place, without unpacking it
+    if (const SpikeRecord* record = spikePool.add(*s))
+        spikePool.addSpikeEvent(record, eventBuffer, peakIndex);
 
     //std::cout << "Adding spike" << std::endl;
 }
 
 void SpikeSorter::addWaveformToSpikeObject(SpikeObject* s,
                                            int& peakIndex,
-                                           int& electrodeNumber,
+                                           ElectrodeSettings* electrode,
                                            int& currentChannel)
 {
-    mut.enter();
-    int spikeLength = electrodes[electrodeNumber]->prePeakSamples +
-                      + electrodes[electrodeNumber]->postPeakSamples;
+    int spikeLength = electrode->prePeakSamples +
+                      + electrode->postPeakSamples;
 
     s->timestamp = getTimestamp(currentChannel) + peakIndex;
 
@@ -712,14 +681,14 @@ void SpikeSorter::addWaveformToSpikeObject(SpikeObject* s,
     s->timestamp_software = software_timestamp + int64(ticksPerSec*float(peakIndex)/samplesPerSec);
     s->nSamples = spikeLength;
 
-    int chan = *(electrodes[electrodeNumber]->channels+currentChannel);
+    int chan = electrode->channels[currentChannel];
 
     s->gain[currentChannel] = (1.0f / channels[chan]->bitVolts)*1000;
-    s->threshold[currentChannel] = (int) electrodes[electrodeNumber]->thresholds[currentChannel];
+    s->threshold[currentChannel] = (int) electrode->thresholds[currentChannel];
 
     // cycle through buffer
 
-    if (isChannelActive(electrodeNumber, currentChannel))
+    if (electrode->isActive[currentChannel])
     {
 
         for (int sample = 0; sample < spikeLength; sample++)
@@ -727,7 +696,7 @@ void SpikeSorter::addWaveformToSpikeObject(SpikeObject* s,
 
             // warning -- be careful of bitvolts conversion
             // do not flip signal (!).
-            float value = getNextSample(electrodes[electrodeNumber]->channels[currentChannel]);
+            float value = getNextSample(electrode->channels[currentChannel]);
             s->data[currentIndex] = uint16(jmin(65535,jmax(0, int(value / channels[chan]->bitVolts) + 32768)));
             // recovered data
             //float value2 = (s->data[currentIndex]-32768) /float(s->gain[currentChannel])*1000.0f;
@@ -756,14 +725,12 @@ void SpikeSorter::addWaveformToSpikeObject(SpikeObject* s,
 
 
     sampleIndex -= spikeLength; // reset sample index
-    mut.exit();
 
 }
 
 void SpikeSorter::startRecording()
 {
     // send status messages about which electrodes and units are available.
-    mut.enter();
     for (int k=0; k<electrodes.size(); k++)
     {
         String eventlog = "CurrentElectrodes "+String(electrodes[k]->electrodeID) + " "+ String(electrodes[k]->advancerID) + " "+String(electrodes[k]->depthOffsetMM) + " "+
@@ -788,7 +755,6 @@ void SpikeSorter::startRecording()
 
     }
 
-    mut.exit();
 }
 
 // int64 SpikeSorter::getExtrapolatedHardwareTimestamp(int64 softwareTS)
@@ -877,28 +843,49 @@ void SpikeSorter::process(AudioSampleBuffer& buffer,
 {
 
     //printf("Entering Spike Detector::process\n");
-    mut.enter();
+
+    // Announce the configuration we are about to use. If it was swapped in between,
+    // the message thread may already have retired it, so try again with the new one.
+    Configuration* config = activeConfiguration.load();
+
+    for (;;)
+    {
+        configurationInUse.store(config);
+
+        Configuration* latest = activeConfiguration.load();
+
+        if (latest == config)
+            break;
+
+        config = latest;
+    }
+
     uint16_t samplingFrequencyHz = getSampleRate();//buffer.getSamplingFrequency();
     // cycle through electrodes
+    ElectrodeSettings* settings;
     Electrode* electrode;
     dataBuffer = &buffer;
 
     checkForEvents(events); // find latest's packet timestamps
 
+    // the spikes sent in the previous block have been handled by now
+    spikePool.clear();
+
     //channelBuffers->update(buffer, hardware_timestamp,software_timestamp, nSamples);
 
-    for (int i = 0; i < electrodes.size(); i++)
+    for (int i = 0; i < config->electrodes.size(); i++)
     {
 
         //  std::cout << "ELECTRODE " << i << std::endl;
 
-        electrode = electrodes[i];
+        settings = config->electrodes.getUnchecked(i);
+        electrode = settings->electrode;
 
         // refresh buffer index for this electrode
         sampleIndex = electrode->lastBufferIndex - 1; // subtract 1 to account for
         // increment at start of getNextSample()
 
-        int nSamples = getNumSamples(*electrode->channels); // get the number of samples for this buffer
+        int nSamples = getNumSamples(*settings->channels); // get the number of samples for this buffer
 
         // cycle through samples
         while (samplesAvailable(nSamples))
@@ -907,23 +894,23 @@ void SpikeSorter::process(AudioSampleBuffer& buffer,
             sampleIndex++;
 
             // cycle through channels
-            for (int chan = 0; chan < electrode->numChannels; chan++)
+            for (int chan = 0; chan < settings->numChannels; chan++)
             {
 
                 // std::cout << "  channel " << chan << std::endl;
 
-                if (*(electrode->isActive+chan))
+                if (*(settings->isActive+chan))
                 {
                     //float v = getNextSample(currentChannel);
 
-                    int currentChannel = electrode->channels[chan];
+                    int currentChannel = settings->channels[chan];
                     float currentValue = getNextSample(currentChannel);
                     electrode->runningStats[chan].Push(currentValue);
 
-                    bool bSpikeDetectedPositive  = electrode->thresholds[chan] > 0 &&
-                                                   (currentValue > electrode->thresholds[chan]); // rising edge
-                    bool bSpikeDetectedNegative = electrode->thresholds[chan] < 0 &&
-                                                  (currentValue < electrode->thresholds[chan]); // falling edge
+                    bool bSpikeDetectedPositive  = settings->thresholds[chan] > 0 &&
+                                                   (currentValue > settings->thresholds[chan]); // rising edge
+                    bool bSpikeDetectedNegative = settings->thresholds[chan] < 0 &&
+                                                  (currentValue < settings->thresholds[chan]); // falling edge
 
                     if (bSpikeDetectedPositive || bSpikeDetectedNegative)
                     {
@@ -939,7 +926,7 @@ void SpikeSorter::process(AudioSampleBuffer& buffer,
                         {
                             // find localmaxima
                             while (getCurrentSample(currentChannel) < getNextSample(currentChannel) &&
-                                   sampleIndex < peakIndex + electrode->postPeakSamples)
+                                   sampleIndex < peakIndex + settings->postPeakSamples)
                             {
                                 sampleIndex++;
                             }
@@ -949,14 +936,14 @@ void SpikeSorter::process(AudioSampleBuffer& buffer,
                             // find local minimum
 
                             while (getCurrentSample(currentChannel) > getNextSample(currentChannel) &&
-                                   sampleIndex < peakIndex + electrode->postPeakSamples)
+                                   sampleIndex < peakIndex + settings->postPeakSamples)
                             {
                                 sampleIndex++;
                             }
                         }
 
                         peakIndex = sampleIndex;
-                        sampleIndex -= (electrode->prePeakSamples+1);
+                        sampleIndex -= (settings->prePeakSamples+1);
 
                         SpikeObject newSpike;
                         newSpike.sortedId = 0; // unsorted.
@@ -964,18 +951,18 @@ void SpikeSorter::process(AudioSampleBuffer& buffer,
                         newSpike.electrodeID = electrode->electrodeID;
                         newSpike.channel = chan;
                         newSpike.source = i;
-                        newSpike.nChannels = electrode->numChannels;
+                        newSpike.nChannels = settings->numChannels;
                         newSpike.samplingFrequencyHz = samplingFrequencyHz;
                         newSpike.color[0] = newSpike.color[1] = newSpike.color[2] = 127;
                         currentIndex = 0;
 
                         // package spikes;
-                        for (int channel = 0; channel < electrode->numChannels; channel++)
+                        for (int channel = 0; channel < settings->numChannels; channel++)
                         {
 
                             addWaveformToSpikeObject(&newSpike,
                                                      peakIndex,
-                                                     i,
+                                                     settings,
                                                      channel);
 
                             //std::cout << "adding waveform" << std::endl;
@@ -1000,26 +987,18 @@ void SpikeSorter::process(AudioSampleBuffer& buffer,
                         electrode->spikeSort->sortSpike(&newSpike, PCAbeforeBoxes);
 
 
-                        // transfer buffered spikes to spike plot
-                        if (electrode->spikePlot != nullptr)
+                        // hand the spike over to the canvas; if it falls behind,
+                        // the spike is counted as dropped instead of waiting for it
+                        if (settings->isDisplayed)
                         {
-                            if (electrode->spikeSort->isPCAfinished())
-                            {
-                                electrode->spikeSort->resetJobStatus();
-                                float p1min,p2min, p1max,  p2max;
-                                electrode->spikeSort->getPCArange(p1min,p2min, p1max,  p2max);
-                                electrode->spikePlot->setPCARange(p1min,p2min, p1max,  p2max);
-                            }
-
-
-                            electrode->spikePlot->processSpikeObject(newSpike);
+                            electrode->spikeRing->push(newSpike);
                         }
 
 
                         addSpikeEvent(&newSpike, events, peakIndex);
                         //prevSpike = newSpike;
                         // advance the sample index
-                        sampleIndex = peakIndex + electrode->postPeakSamples;
+                        sampleIndex = peakIndex + settings->postPeakSamples;
 
                         break; // quit spike "for" loop
                     } // end spike trigger
@@ -1033,17 +1012,17 @@ void SpikeSorter::process(AudioSampleBuffer& buffer,
         //float vv = getNextSample(currentChannel);
         electrode->lastBufferIndex = sampleIndex - nSamples; // should be negative
 
-        //jassert(electrode->lastBufferIndex < 0);
+        //jassert(settings->lastBufferIndex < 0);
 
         if (nSamples > overflowBufferSize)
         {
 
-            for (int j = 0; j < electrode->numChannels; j++)
+            for (int j = 0; j < settings->numChannels; j++)
             {
-                //std::cout << "Processing " << *electrode->channels+i << std::endl;
+                //std::cout << "Processing " << *settings->channels+i << std::endl;
 
-                overflowBuffer.copyFrom(*(electrode->channels+j), 0,
-                                        buffer, *(electrode->channels+j),
+                overflowBuffer.copyFrom(*(settings->channels+j), 0,
+                                        buffer, *(settings->channels+j),
                                         nSamples-overflowBufferSize,
                                         overflowBufferSize);
 
@@ -1059,11 +1038,55 @@ void SpikeSorter::process(AudioSampleBuffer& buffer,
 
     } // end cycle through electrodes
 
+    configurationInUse.store(nullptr);
 
-    mut.exit();
     //printf("Exitting Spike Detector::process\n");
 }
 
+SpikeSorter::ElectrodeSettings::ElectrodeSettings(Electrode* e)
+    : electrode(e),
+      numChannels(e->numChannels),
+      prePeakSamples(e->prePeakSamples), postPeakSamples(e->postPeakSamples),
+      isDisplayed(e->spikePlot != nullptr)
+{
+    channels.malloc(numChannels);
+    thresholds.malloc(numChannels);
+    isActive.malloc(numChannels);
+
+    for (int i = 0; i < numChannels; i++)
+    {
+        channels[i] = e->channels[i];
+        thresholds[i] = e->thresholds[i];
+        isActive[i] = e->isActive[i];
+    }
+}
+
+void SpikeSorter::publishConfiguration()
+{
+    Configuration* newConfiguration = new Configuration();
+
+    for (int i = 0; i < electrodes.size(); i++)
+        newConfiguration->electrodes.add(new ElectrodeSettings(electrodes[i]));
+
+    Configuration* oldConfiguration = activeConfiguration.exchange(newConfiguration);
+
+    if (oldConfiguration != nullptr)
+        retiredConfigurations.add(oldConfiguration);
+
+    releaseRetiredConfigurations();
+}
+
+void SpikeSorter::releaseRetiredConfigurations()
+{
+    Configuration* inUse = configurationInUse.load();
+
+    for (int i = retiredConfigurations.size(); --i >= 0;)
+    {
+        if (retiredConfigurations[i] != inUse)
+            retiredConfigurations.remove(i);
+    }
+}
+
 float SpikeSorter::getNextSample(int& chan)
 {
 
@@ -1375,37 +1398,31 @@ void SpikeSorter::loadCustomParametersFromXml()
 
 void SpikeSorter::removeSpikePlots()
 {
-    mut.enter();
     for (int i = 0; i < getNumElectrodes(); i++)
     {
         Electrode* ee = electrodes[i];
         ee->spikePlot = nullptr;
     }
-    mut.exit();
+    publishConfiguration();
 }
 
 int SpikeSorter::getNumElectrodes()
 {
-    mut.enter();
     int i= electrodes.size();
-    mut.exit();
     return i;
 
 }
 
 int SpikeSorter::getNumberOfChannelsForElectrode(int i)
 {
-    mut.enter();
     if (i > -1 && i < electrodes.size())
     {
         Electrode* ee = electrodes[i];
         int ii=ee->numChannels;
-        mut.exit();
         return ii;
     }
     else
     {
-        mut.exit();
         return 0;
     }
 }
@@ -1414,17 +1431,14 @@ int SpikeSorter::getNumberOfChannelsForElectrode(int i)
 
 String SpikeSorter::getNameForElectrode(int i)
 {
-    mut.enter();
     if (i > -1 && i < electrodes.size())
     {
         Electrode* ee = electrodes[i];
         String s= ee->name;
-        mut.exit();
         return s;
     }
     else
     {
-        mut.exit();
         return " ";
     }
 }
@@ -1432,10 +1446,9 @@ String SpikeSorter::getNameForElectrode(int i)
 
 void SpikeSorter::addSpikePlotForElectrode(SpikeHistogramPlot* sp, int i)
 {
-    mut.enter();
     Electrode* ee = electrodes[i];
     ee->spikePlot = sp;
-    mut.exit();
+    publishConfiguration();
 }
 
 int SpikeSorter::getCurrentElectrodeIndex()
@@ -1452,7 +1465,6 @@ Electrode* SpikeSorter::getElectrode(int i)
 std::vector<int> SpikeSorter::getElectrodeChannels(int ID)
 {
     std::vector<int> ch;
-    mut.enter();
     for (int k=0; k<electrodes.size(); k++)
     {
         if (electrodes[k]->electrodeID == ID)
@@ -1464,13 +1476,11 @@ std::vector<int> SpikeSorter::getElectrodeChannels(int ID)
                 ch[j] = electrodes[k]->channels[j];
             }
 
-            mut.exit();
             return ch;
         }
 
 
     }
-    mut.exit();
     return ch;
 }
 
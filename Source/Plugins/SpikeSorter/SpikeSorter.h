@@ -30,10 +30,13 @@
 #include "SpikeSortBoxes.h"
 #include <algorithm>    // std::sort
 #include <queue>
+#include <atomic>
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
 
+#define SPIKE_DISPLAY_RING_SIZE 128
+
 class SpikeSorterEditor;
 class SpikeHistogramPlot;
 class Trial;
@@ -173,6 +176,10 @@ public:
 
     RunningStat* runningStats;
     SpikeHistogramPlot* spikePlot;
+
+    /** Spikes waiting to be drawn. Filled by the audio thread while a plot
+        is attached, and emptied by the SpikeSorterCanvas. */
+    SpikeRing* spikeRing;
     SpikeSortBoxes* spikeSort;
     PCAcomputingThread* computingThread;
     UniqueIDgenerator* uniqueIDgenerator;
@@ -383,6 +390,39 @@ public:
 
 
 private:
+    /** Detection settings of one electrode, copied for the audio thread. The
+        electrode itself is only used for the state that process() owns: its
+        buffer index, running statistics, sorter and spike ring. */
+    struct ElectrodeSettings
+    {
+        ElectrodeSettings(Electrode* electrode);
+
+        Electrode* const electrode;
+        const int numChannels;
+        const int prePeakSamples, postPeakSamples;
+        const bool isDisplayed;
+
+        HeapBlock<int> channels;
+        HeapBlock<double> thresholds;
+        HeapBlock<bool> isActive;
+
+        JUCE_DECLARE_NON_COPYABLE(ElectrodeSettings);
+    };
+
+    /** Immutable copy of the electrode list that is used by process(). */
+    struct Configuration
+    {
+        OwnedArray<ElectrodeSettings> electrodes;
+    };
+
+    /** Builds a new Configuration from the electrodes and hands it to the audio thread.
+        Has to be called after every change to the electrode list or to the settings
+        that process() uses. */
+    void publishConfiguration();
+
+    /** Deletes retired configurations that the audio thread can no longer be using. */
+    void releaseRetiredConfigurations();
+
     UniqueIDgenerator uniqueIDgenerator;
     long uniqueSpikeID;
     SpikeObject prevSpike;
@@ -416,7 +456,8 @@ private:
 
 
     int numPreSamples,numPostSamples;
-    uint8_t* spikeBuffer;///[256];
+    /** Holds the sorted spikes sent in the current block. */
+    SpikePool spikePool;
     //int64 timestamp;
     int64 hardware_timestamp;
     int64 software_timestamp;
@@ -429,7 +470,6 @@ private:
     void addSpikeEvent(SpikeObject* s, MidiBuffer& eventBuffer, int peakIndex);
 
     void resetElectrode(Electrode*);
-    CriticalSection mut;
     bool autoDACassignment;
     bool syncThresholds;
  //   RHD2000Thread* getRhythmAccess();
@@ -439,11 +479,22 @@ private:
 
     void addWaveformToSpikeObject(SpikeObject* s,
                                   int& peakIndex,
-                                  int& electrodeNumber,
+                                  ElectrodeSettings* electrode,
                                   int& currentChannel);
 
 
+    /** Message thread copy of the electrodes. Removed electrodes are never deleted,
+        so configurations that still point to them stay valid. */
     Array<Electrode*> electrodes;
+
+    /** The configuration is swapped with a single atomic exchange, so the audio thread
+        never waits for the message thread. While processing, the audio thread announces
+        the configuration it is using in configurationInUse; configurations replaced
+        in the meantime are kept in retiredConfigurations until it's safe to delete them.
+    */
+    std::atomic<Configuration*> activeConfiguration;
+    std::atomic<Configuration*> configurationInUse;
+    OwnedArray<Configuration> retiredConfigurations;
     PCAcomputingThread computingThread;
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpikeSorter);
 
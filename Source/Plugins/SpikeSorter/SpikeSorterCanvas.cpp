@@ -167,6 +167,16 @@ void SpikeSorterCanvas::paint(Graphics& g)
 
     g.fillAll(Colours::darkgrey);
 
+    Electrode* e = processor->getActiveElectrode();
+
+    if (e != nullptr && e->spikeRing->getNumDropped() > 0)
+    {
+        g.setColour(Colours::lightgrey);
+        g.setFont(Font("Default", 12, Font::plain));
+        g.drawText("Not drawn: " + String(e->spikeRing->getNumDropped()) + " spikes",
+                   0, 330, 120, 20, Justification::left, false);
+    }
+
 }
 
 void SpikeSorterCanvas::refresh()
@@ -180,12 +190,32 @@ void SpikeSorterCanvas::refresh()
 
 void SpikeSorterCanvas::processSpikeEvents()
 {
+    Electrode* active = processor->getActiveElectrode();
 
+    if (active != nullptr && active->spikePlot != nullptr && active->spikeSort->isPCAfinished())
+    {
+        active->spikeSort->resetJobStatus();
+        float p1min,p2min, p1max,  p2max;
+        active->spikeSort->getPCArange(p1min,p2min, p1max,  p2max);
+        active->spikePlot->setPCARange(p1min,p2min, p1max,  p2max);
+    }
 
-    //Electrode* e = ((SpikeSorter*) processor)->getActiveElectrode();
+    // Transfer the spikes published by the audio thread to the plot. Every ring is
+    // emptied, so that spikes queued while another electrode was shown are never
+    // drawn late, but only the active electrode's spikes are drawn.
+    for (int i = 0; i < processor->getNumElectrodes(); i++)
+    {
+        Electrode* e = processor->getElectrode(i);
+        const bool draw = (e == active && e->spikePlot != nullptr);
+
+        while (const SpikeObject* s = e->spikeRing->peek())
+        {
+            if (draw)
+                e->spikePlot->processSpikeObject(*s);
 
-    //	e->spikeSort->lstLastSpikes
-    //    processor->setParameter(2, 0.0f); // request redraw
+            e->spikeRing->release();
+        }
+    }
 
 }
 
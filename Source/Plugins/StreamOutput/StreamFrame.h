@@ -0,0 +1,82 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2016 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/*
+  Wire format of the Stream Output processor.
+
+  Every frame is a two-part ZeroMQ message published on a PUB socket: the
+  topic ("continuous" or "spikes", so subscribers can filter with
+  ZMQ_SUBSCRIBE) followed by a StreamFrameHeader and its body. All values
+  are little-endian.
+
+  Continuous frames hold numSamples consecutive samples of numChannels
+  channels, starting at timestamp:
+
+      uint16  channel[numChannels]      0-based input channel of each row
+      float   scale[numChannels]        int16 frames only: microvolts per step
+      payload                           planar, one row of numSamples per channel,
+                                        float32 or int16, LZ4-compressed if
+                                        STREAM_FRAME_LZ4 is set
+
+  Spike frames hold numSamples spikes, each a uint16 length followed by the
+  packed spike (see packSpike() in SpikeObject.h); the payload can also be
+  LZ4-compressed.
+
+  sequence counts the frames of each topic; a gap means frames were dropped,
+  either by the GUI because the network could not keep up, or by ZeroMQ
+  because the subscriber could not.
+*/
+
+#ifndef STREAMFRAME_H_INCLUDED
+#define STREAMFRAME_H_INCLUDED
+
+#include <stdint.h>
+
+#define STREAM_FRAME_MAGIC      0x4653454fu   /* "OESF" */
+#define STREAM_FRAME_VERSION    1
+
+/* Flags */
+#define STREAM_FRAME_INT16      0x0001
+#define STREAM_FRAME_LZ4        0x0002
+
+/* Frame types */
+#define STREAM_FRAME_CONTINUOUS 0
+#define STREAM_FRAME_SPIKES     1
+
+typedef struct StreamFrameHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t flags;
+    uint16_t type;
+    uint16_t numChannels;
+    uint32_t sequence;
+    uint32_t numSamples;       /* samples per channel, or number of spikes */
+    uint32_t payloadBytes;     /* size of the payload as sent */
+    uint32_t rawBytes;         /* size of the payload before compression */
+    uint32_t reserved;
+    int64_t  timestamp;        /* timestamp of the first sample */
+    double   sampleRate;
+} StreamFrameHeader;
+
+#endif  /* STREAMFRAME_H_INCLUDED */
@@ -0,0 +1,867 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2016 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "StreamOutput.h"
+#include "StreamOutputEditor.h"
+#include <SpikeLib.h>
+
+#ifdef USE_LZ4
+#include <lz4.h>
+#endif
+
+#define CONTINUOUS_QUEUE_LENGTH 32
+#define SPIKE_QUEUE_LENGTH 64
+#define SPIKE_FRAME_BYTES 65536
+
+namespace
+{
+    const char* const topics[] = { "continuous", "spikes" };
+
+    size_t getCompressBound(size_t numBytes)
+    {
+#ifdef USE_LZ4
+        return size_t(LZ4_compressBound(int(numBytes)));
+#else
+        return numBytes;
+#endif
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////
+
+/** Subscribes to the stream from within the GUI and measures what arrives. */
+class StreamOutput::LoopbackSubscriber : public Thread
+{
+public:
+    LoopbackSubscriber(const std::shared_ptr<void>& context_, int port_, size_t maxMessageSize)
+        : Thread("Stream Output loopback"),
+          context(context_),
+          port(port_),
+          numFrames(0), numSpikeFrames(0), numLost(0),
+          numSamples(0), numBytes(0),
+          firstTicks(0), lastTicks(0)
+    {
+        decompressed.malloc(maxMessageSize);
+        decompressedSize = maxMessageSize;
+
+        for (int i = 0; i < 2; i++)
+            nextSequence[i] = 0;
+    }
+
+    ~LoopbackSubscriber()
+    {
+        stopThread(2000);
+    }
+
+    /** Starts receiving, and waits until the subscription is likely to have
+        reached the publisher (ZeroMQ drops messages sent before that). */
+    void connect()
+    {
+        startThread(6);
+        connected.wait(2000);
+        Thread::sleep(200);
+    }
+
+    /** Waits for the stream to go quiet, then prints what was received. */
+    void finish(int numFramesDropped, int64 numBytesSent, int64 numRawBytes, int numChannels, float sampleRate)
+    {
+        signalThreadShouldExit();
+        stopThread(5000);
+
+        const double seconds = Time::highResolutionTicksToSeconds(lastTicks - firstTicks);
+        const double required = double(numChannels) * sampleRate;
+
+        printf("Stream Output loopback: %d continuous and %d spike frames received, %d lost in transit, %d dropped by the sender\n",
+               numFrames, numSpikeFrames, numLost, numFramesDropped);
+
+        if (seconds > 0)
+        {
+            printf("  %.2f Msamples/s (%.1f MB/s on the wire, %.2f compression ratio) over %.2f s; "
+                   "%d channels at %.0f Hz need %.2f Msamples/s\n",
+                   double(numSamples) / seconds / 1.0e6,
+                   double(numBytes) / seconds / (1 << 20),
+                   numRawBytes > 0 ? double(numBytesSent) / double(numRawBytes) : 1.0,
+                   seconds, numChannels, sampleRate, required / 1.0e6);
+        }
+
+        fflush(stdout);
+    }
+
+private:
+    void run() override
+    {
+#ifdef ZEROMQ
+        std::unique_ptr<void, decltype(&closeZMQSocket)> socket(zmq_socket(context.get(), ZMQ_SUB), &closeZMQSocket);
+
+        if (!socket)
+        {
+            connected.signal();
+            return;
+        }
+
+        const String url = "tcp://127.0.0.1:" + String(port);
+        zmq_setsockopt(socket.get(), ZMQ_SUBSCRIBE, "", 0);
+        zmq_connect(socket.get(), url.toRawUTF8());
+
+        connected.signal();
+
+        zmq_msg_t message;
+        zmq_msg_init(&message);
+
+        zmq_pollitem_t item;
+        item.socket = socket.get();
+        item.fd = 0;
+        item.events = ZMQ_POLLIN;
+        item.revents = 0;
+
+        for (;;)
+        {
+            // once asked to stop, keep going until the stream has been quiet for a while
+            if (zmq_poll(&item, 1, threadShouldExit() ? 250 : 100) <= 0)
+            {
+                if (threadShouldExit())
+                    break;
+
+                continue;
+            }
+
+            // topic, then the frame itself
+            if (zmq_msg_recv(&message, socket.get(), 0) < 0
+                || zmq_msg_recv(&message, socket.get(), 0) < 0)
+                continue;
+
+            receivedFrame(static_cast<const char*>(zmq_msg_data(&message)), zmq_msg_size(&message));
+        }
+
+        zmq_msg_close(&message);
+#endif
+    }
+
+    void receivedFrame(const char* data, size_t size)
+    {
+        if (size < sizeof(StreamFrameHeader))
+            return;
+
+        const StreamFrameHeader* header = reinterpret_cast<const StreamFrameHeader*>(data);
+
+        if (header->magic != STREAM_FRAME_MAGIC || header->type > STREAM_FRAME_SPIKES)
+            return;
+
+        lastTicks = Time::getHighResolutionTicks();
+
+        if (firstTicks == 0)
+            firstTicks = lastTicks;
+
+        numLost += int(header->sequence - nextSequence[header->type]);
+        nextSequence[header->type] = header->sequence + 1;
+        numBytes += int64(size);
+
+#ifdef USE_LZ4
+        // decode the payload, as a real subscriber would
+        if ((header->flags & STREAM_FRAME_LZ4) != 0 && header->rawBytes <= decompressedSize)
+        {
+            const char* payload = data + size - header->payloadBytes;
+            LZ4_decompress_safe(payload, decompressed, int(header->payloadBytes), int(header->rawBytes));
+        }
+#endif
+
+        if (header->type == STREAM_FRAME_CONTINUOUS)
+        {
+            ++numFrames;
+            numSamples += int64(header->numSamples) * header->numChannels;
+        }
+        else
+        {
+            ++numSpikeFrames;
+        }
+    }
+
+    std::shared_ptr<void> context;
+    int port;
+
+    WaitableEvent connected;
+
+    HeapBlock<char> decompressed;
+    size_t decompressedSize;
+
+    uint32 nextSequence[2];
+    int numFrames;
+    int numSpikeFrames;
+    int numLost;
+    int64 numSamples;
+    int64 numBytes;
+    int64 firstTicks;
+    int64 lastTicks;
+};
+
+/////////////////////////////////////////////////////////////////////////
+
+StreamOutput::FrameQueue::FrameQueue()
+{
+}
+
+void StreamOutput::FrameQueue::allocate(int numFrames, int numSamples, int numBytes)
+{
+    fifo = new AbstractFifo(numFrames + 1);
+    frames.clear();
+
+    for (int i = 0; i < numFrames + 1; i++)
+    {
+        Frame* frame = new Frame();
+        frame->timestamp = 0;
+        frame->sequence = 0;
+        frame->numSamples = 0;
+        frame->numBytes = 0;
+
+        if (numSamples > 0)
+            frame->samples.malloc(numSamples);
+
+        if (numBytes > 0)
+            frame->bytes.malloc(numBytes);
+
+        frames.add(frame);
+    }
+}
+
+StreamOutput::Frame* StreamOutput::FrameQueue::getWriteFrame()
+{
+    int start1, size1, start2, size2;
+    fifo->prepareToWrite(1, start1, size1, start2, size2);
+
+    return size1 > 0 ? frames.getUnchecked(start1) : nullptr;
+}
+
+void StreamOutput::FrameQueue::finishedWrite()
+{
+    fifo->finishedWrite(1);
+}
+
+StreamOutput::Frame* StreamOutput::FrameQueue::getReadFrame()
+{
+    if (fifo == nullptr)
+        return nullptr;
+
+    int start1, size1, start2, size2;
+    fifo->prepareToRead(1, start1, size1, start2, size2);
+
+    return size1 > 0 ? frames.getUnchecked(start1) : nullptr;
+}
+
+void StreamOutput::FrameQueue::finishedRead()
+{
+    fifo->finishedRead(1);
+}
+
+/////////////////////////////////////////////////////////////////////////
+
+std::shared_ptr<void> StreamOutput::getZMQContext()
+{
+    // same arrangement as the EventBroadcaster: one context per library,
+    // created on first use
+#ifdef ZEROMQ
+    static const std::shared_ptr<void> ctx(zmq_ctx_new(), zmq_ctx_destroy);
+#else
+    static const std::shared_ptr<void> ctx;
+#endif
+    return ctx;
+}
+
+void StreamOutput::closeZMQSocket(void* socket)
+{
+#ifdef ZEROMQ
+    zmq_close(socket);
+#endif
+}
+
+StreamOutput::StreamOutput()
+    : GenericProcessor("Stream Output"),
+      Thread("Stream Output"),
+      zmqContext(getZMQContext()),
+      zmqSocket(nullptr, &closeZMQSocket),
+      listeningPort(0),
+      sampleFormat(FLOAT_FORMAT),
+      compression(false),
+      frameLength(10.0f),
+      loopback(false),
+      samplesPerFrame(0),
+      sampleRate(0),
+      currentFrame(nullptr),
+      currentSpikeFrame(nullptr),
+      nextTimestamp(-1),
+      messageCapacity(0),
+      continuousSequence(0),
+      spikeSequence(0)
+{
+    setListeningPort(5558);
+}
+
+StreamOutput::~StreamOutput()
+{
+    signalThreadShouldExit();
+    frameQueued.signal();
+    stopThread(2000);
+}
+
+AudioProcessorEditor* StreamOutput::createEditor()
+{
+    editor = new StreamOutputEditor(this, true);
+    return editor;
+}
+
+bool StreamOutput::isSink()
+{
+    return true;
+}
+
+int StreamOutput::getListeningPort() const
+{
+    return listeningPort;
+}
+
+void StreamOutput::setListeningPort(int port, bool forceRestart)
+{
+    if ((listeningPort != port) || forceRestart)
+    {
+#ifdef ZEROMQ
+        zmqSocket.reset(zmq_socket(zmqContext.get(), ZMQ_PUB));
+        if (!zmqSocket)
+        {
+            std::cout << "Failed to create socket: " << zmq_strerror(zmq_errno()) << std::endl;
+            return;
+        }
+
+        // a subscriber that can't keep up loses frames instead of queueing
+        // them without limit; unsent frames are discarded on close
+        const int highWaterMark = 2 * CONTINUOUS_QUEUE_LENGTH;
+        const int linger = 0;
+        zmq_setsockopt(zmqSocket.get(), ZMQ_SNDHWM, &highWaterMark, sizeof(highWaterMark));
+        zmq_setsockopt(zmqSocket.get(), ZMQ_LINGER, &linger, sizeof(linger));
+
+        String url = String("tcp://*:") + String(port);
+        if (0 != zmq_bind(zmqSocket.get(), url.toRawUTF8()))
+        {
+            std::cout << "Failed to open socket: " << zmq_strerror(zmq_errno()) << std::endl;
+            zmqSocket.reset();
+            return;
+        }
+#endif
+
+        listeningPort = port;
+    }
+}
+
+void StreamOutput::setChannelList(const String& list)
+{
+    channelList = list.trim();
+}
+
+String StreamOutput::getChannelList() const
+{
+    return channelList;
+}
+
+void StreamOutput::setSampleFormat(SampleFormat format)
+{
+    sampleFormat = format;
+}
+
+StreamOutput::SampleFormat StreamOutput::getSampleFormat() const
+{
+    return sampleFormat;
+}
+
+void StreamOutput::setCompression(bool compress)
+{
+    compression = compress && isCompressionAvailable();
+}
+
+bool StreamOutput::getCompression() const
+{
+    return compression;
+}
+
+bool StreamOutput::isCompressionAvailable()
+{
+#ifdef USE_LZ4
+    return true;
+#else
+    return false;
+#endif
+}
+
+void StreamOutput::setFrameLength(float milliseconds)
+{
+    frameLength = jlimit(1.0f, 1000.0f, milliseconds);
+}
+
+float StreamOutput::getFrameLength() const
+{
+    return frameLength;
+}
+
+void StreamOutput::setLoopback(bool loopback_)
+{
+    loopback = loopback_;
+}
+
+int StreamOutput::getNumFramesSent() const
+{
+    return numFramesSent.get();
+}
+
+int StreamOutput::getNumFramesDropped() const
+{
+    return numFramesDropped.get();
+}
+
+int64 StreamOutput::getNumBytesSent() const
+{
+    return numBytesSent.get();
+}
+
+double StreamOutput::getCompressionRatio() const
+{
+    const int64 raw = numRawBytes.get();
+
+    return raw > 0 ? double(numBytesSent.get()) / double(raw) : 1.0;
+}
+
+Array<int> StreamOutput::getSelectedChannels()
+{
+    Array<int> selected = Channel::parseChannelList(channelList, getNumInputs());
+
+    // channel numbers go out as uint16
+    selected.removeRange(65535, selected.size());
+
+    return selected;
+}
+
+bool StreamOutput::enable()
+{
+#ifdef ZEROMQ
+    if (!zmqSocket)
+    {
+        CoreServices::sendStatusMessage("Stream Output: could not open port " + String(listeningPort));
+        return false;
+    }
+
+    channelMap = getSelectedChannels();
+    sampleRate = getSampleRate();
+    samplesPerFrame = jmax(1, roundToInt(sampleRate * frameLength / 1000.0f));
+
+    const int numChannels = channelMap.size();
+
+    scales.malloc(jmax(1, numChannels));
+
+    for (int c = 0; c < numChannels; c++)
+    {
+        const float bitVolts = channels[channelMap[c]]->bitVolts;
+        scales[c] = bitVolts > 0 ? bitVolts : 1.0f;
+    }
+
+    // everything the audio and sender threads need is allocated up front
+    continuousFrames.allocate(CONTINUOUS_QUEUE_LENGTH, numChannels * samplesPerFrame, 0);
+    spikeFrames.allocate(SPIKE_QUEUE_LENGTH, 0, SPIKE_FRAME_BYTES);
+
+    const size_t maxRawBytes = jmax(size_t(numChannels) * samplesPerFrame * sizeof(float), size_t(SPIKE_FRAME_BYTES));
+
+    payload.malloc(maxRawBytes);
+    messageCapacity = sizeof(StreamFrameHeader)
+                      + size_t(numChannels) * (sizeof(uint16) + sizeof(float))
+                      + getCompressBound(maxRawBytes);
+    message.malloc(messageCapacity);
+
+    currentFrame = nullptr;
+    currentSpikeFrame = nullptr;
+    nextTimestamp = -1;
+    continuousSequence = 0;
+    spikeSequence = 0;
+
+    numFramesSent = 0;
+    numFramesDropped = 0;
+    numBytesSent = 0;
+    numRawBytes = 0;
+
+    if (loopback)
+    {
+        loopbackSubscriber = new LoopbackSubscriber(zmqContext, listeningPort, maxRawBytes);
+        loopbackSubscriber->connect();
+    }
+
+    startThread(7);
+
+    return true;
+#else
+    CoreServices::sendStatusMessage("Stream Output was built without ZeroMQ");
+    return false;
+#endif
+}
+
+bool StreamOutput::disable()
+{
+    if (isThreadRunning())
+    {
+        // the audio thread has stopped, so the partly filled frame can go too
+        if (currentFrame != nullptr && currentFrame->numSamples > 0)
+            publishContinuousFrame();
+
+        // the sender empties both queues before it exits
+        signalThreadShouldExit();
+        frameQueued.signal();
+        stopThread(5000);
+    }
+
+    if (loopbackSubscriber != nullptr)
+    {
+        loopbackSubscriber->finish(numFramesDropped.get(), numBytesSent.get(), numRawBytes.get(),
+                                   channelMap.size(), sampleRate);
+        loopbackSubscriber = nullptr;
+    }
+
+    return true;
+}
+
+void StreamOutput::process(AudioSampleBuffer& buffer, MidiBuffer& events)
+{
+    if (!isThreadRunning())
+        return;
+
+    if (channelMap.size() > 0)
+    {
+        // all streamed channels are expected to come from the same source
+        const int numSamples = getNumSamples(channelMap.getUnchecked(0));
+
+        if (numSamples > 0)
+            appendSamples(buffer, numSamples, getTimestamp(channelMap.getUnchecked(0)));
+    }
+
+    checkForEvents(events);
+
+    // spikes are sent once per block
+    if (currentSpikeFrame != nullptr)
+    {
+        spikeFrames.finishedWrite();
+        currentSpikeFrame = nullptr;
+        frameQueued.signal();
+    }
+}
+
+void StreamOutput::appendSamples(const AudioSampleBuffer& buffer, int numSamples, int64 timestamp)
+{
+    // every frame holds consecutive samples
+    if (currentFrame != nullptr && currentFrame->numSamples > 0 && timestamp != nextTimestamp)
+        publishContinuousFrame();
+
+    nextTimestamp = timestamp + numSamples;
+
+    int offset = 0;
+
+    while (offset < numSamples)
+    {
+        if (currentFrame == nullptr)
+        {
+            currentFrame = continuousFrames.getWriteFrame();
+
+            if (currentFrame == nullptr)
+            {
+                // the sender is behind: skip the rest of this block, leaving a
+                // gap in the sequence numbers for subscribers to see
+                ++numFramesDropped;
+                ++continuousSequence;
+                return;
+            }
+
+            currentFrame->timestamp = timestamp + offset;
+            currentFrame->sequence = continuousSequence++;
+            currentFrame->numSamples = 0;
+        }
+
+        const int count = jmin(numSamples - offset, samplesPerFrame - currentFrame->numSamples);
+
+        for (int c = 0; c < channelMap.size(); c++)
+        {
+            memcpy(currentFrame->samples + size_t(c) * samplesPerFrame + currentFrame->numSamples,
+                   buffer.getReadPointer(channelMap.getUnchecked(c), offset),
+                   count * sizeof(float));
+        }
+
+        currentFrame->numSamples += count;
+        offset += count;
+
+        if (currentFrame->numSamples == samplesPerFrame)
+            publishContinuousFrame();
+    }
+}
+
+void StreamOutput::publishContinuousFrame()
+{
+    continuousFrames.finishedWrite();
+    currentFrame = nullptr;
+    frameQueued.signal();
+}
+
+void StreamOutput::handleEvent(int eventType, MidiMessage& event, int samplePosition)
+{
+    if (eventType != SPIKE)
+        return;
+
+    // spikes detected in this process arrive as handles into their source's
+    // pool; subscribers get the packed spike
+    const SpikeRecord* record = SpikePool::getSpike(event);
+    const int size = record != nullptr ? getPackedSpikeSize(record->nChannels, record->nSamples)
+                                       : event.getRawDataSize();
+
+    if (currentSpikeFrame != nullptr && currentSpikeFrame->numBytes + 2 + size > SPIKE_FRAME_BYTES)
+    {
+        spikeFrames.finishedWrite();
+        currentSpikeFrame = nullptr;
+    }
+
+    if (currentSpikeFrame == nullptr)
+    {
+        currentSpikeFrame = spikeFrames.getWriteFrame();
+
+        if (currentSpikeFrame == nullptr || size + 2 > SPIKE_FRAME_BYTES)
+        {
+            currentSpikeFrame = nullptr;
+            ++numFramesDropped;
+            ++spikeSequence;
+            return;
+        }
+
+        currentSpikeFrame->timestamp = nextTimestamp;
+        currentSpikeFrame->sequence = spikeSequence++;
+        currentSpikeFrame->numSamples = 0;
+        currentSpikeFrame->numBytes = 0;
+    }
+
+    uint8* dest = currentSpikeFrame->bytes + currentSpikeFrame->numBytes;
+    const uint16 length = uint16(size);
+
+    memcpy(dest, &length, sizeof(length));
+
+    if (record != nullptr)
+        packSpike(record, dest + sizeof(length), size);
+    else
+        memcpy(dest + sizeof(length), event.getRawData(), size);
+
+    currentSpikeFrame->numBytes += sizeof(length) + size;
+    currentSpikeFrame->numSamples++;
+}
+
+void StreamOutput::run()
+{
+    for (;;)
+    {
+        frameQueued.wait(50);
+
+        bool sentFrame;
+
+        do
+        {
+            sentFrame = false;
+
+            // spike frames are small and latency-sensitive, so they go first
+            while (Frame* frame = spikeFrames.getReadFrame())
+            {
+                sendFrame(frame, STREAM_FRAME_SPIKES, frame->sequence);
+                spikeFrames.finishedRead();
+            }
+
+            if (Frame* frame = continuousFrames.getReadFrame())
+            {
+                sendFrame(frame, STREAM_FRAME_CONTINUOUS, frame->sequence);
+                continuousFrames.finishedRead();
+                sentFrame = true;
+            }
+        }
+        while (sentFrame);
+
+        if (threadShouldExit())
+            break;
+    }
+}
+
+void StreamOutput::sendFrame(Frame* frame, int type, uint32 sequence)
+{
+#ifdef ZEROMQ
+    StreamFrameHeader* header = reinterpret_cast<StreamFrameHeader*>(message.getData());
+    char* body = message + sizeof(StreamFrameHeader);
+
+    header->magic = STREAM_FRAME_MAGIC;
+    header->version = STREAM_FRAME_VERSION;
+    header->flags = 0;
+    header->type = uint16(type);
+    header->numChannels = 0;
+    header->sequence = sequence;
+    header->numSamples = uint32(frame->numSamples);
+    header->reserved = 0;
+    header->timestamp = frame->timestamp;
+    header->sampleRate = sampleRate;
+
+    // the payload is staged in a separate buffer only when it gets compressed
+    char* const staging = compression ? payload.getData() : nullptr;
+    const char* raw;
+    size_t rawBytes;
+
+    if (type == STREAM_FRAME_CONTINUOUS)
+    {
+        const int numChannels = channelMap.size();
+        const int numSamples = frame->numSamples;
+
+        header->numChannels = uint16(numChannels);
+
+        uint16* channelNumbers = reinterpret_cast<uint16*>(body);
+
+        for (int c = 0; c < numChannels; c++)
+            channelNumbers[c] = uint16(channelMap.getUnchecked(c));
+
+        body += numChannels * sizeof(uint16);
+
+        char* dest = staging != nullptr ? staging : body;
+
+        if (sampleFormat == INT16_FORMAT)
+        {
+            header->flags |= STREAM_FRAME_INT16;
+
+            memcpy(body, scales.getData(), numChannels * sizeof(float));
+            body += numChannels * sizeof(float);
+
+            if (staging == nullptr)
+                dest = body;
+
+            int16* out = reinterpret_cast<int16*>(dest);
+
+            for (int c = 0; c < numChannels; c++)
+            {
+                const float* in = frame->samples + size_t(c) * samplesPerFrame;
+                const float scale = 1.0f / scales[c];
+
+                for (int i = 0; i < numSamples; i++)
+                    *out++ = int16(jlimit(-32768, 32767, roundToInt(in[i] * scale)));
+            }
+
+            rawBytes = size_t(numChannels) * numSamples * sizeof(int16);
+        }
+        else
+        {
+            rawBytes = size_t(numChannels) * numSamples * sizeof(float);
+
+            if (numSamples == samplesPerFrame && staging != nullptr)
+            {
+                // already planar and contiguous; compress straight from the frame
+                dest = reinterpret_cast<char*>(frame->samples.getData());
+            }
+            else
+            {
+                for (int c = 0; c < numChannels; c++)
+                    memcpy(dest + size_t(c) * numSamples * sizeof(float),
+                           frame->samples + size_t(c) * samplesPerFrame,
+                           numSamples * sizeof(float));
+            }
+        }
+
+        raw = dest;
+    }
+    else
+    {
+        raw = reinterpret_cast<const char*>(frame->bytes.getData());
+        rawBytes = size_t(frame->numBytes);
+
+        if (staging == nullptr)
+            memcpy(body, raw, rawBytes);
+    }
+
+    header->rawBytes = uint32(rawBytes);
+    header->payloadBytes = uint32(rawBytes);
+
+    if (staging != nullptr)
+    {
+        bool compressed = false;
+
+#ifdef USE_LZ4
+        const size_t available = messageCapacity - size_t(body - message.getData());
+        const int numCompressed = LZ4_compress_default(raw, body, int(rawBytes), int(available));
+
+        if (numCompressed > 0 && size_t(numCompressed) < rawBytes)
+        {
+            header->flags |= STREAM_FRAME_LZ4;
+            header->payloadBytes = uint32(numCompressed);
+            compressed = true;
+        }
+#endif
+
+        if (!compressed)
+            memcpy(body, raw, rawBytes);
+    }
+
+    const size_t size = size_t(body - message.getData()) + header->payloadBytes;
+    const char* topic = topics[type];
+
+    // PUB sockets never block: frames for subscribers at their high-water
+    // mark are discarded by ZeroMQ
+    if (-1 == zmq_send(zmqSocket.get(), topic, strlen(topic), ZMQ_SNDMORE) ||
+        -1 == zmq_send(zmqSocket.get(), message.getData(), size, 0))
+    {
+        std::cout << "Failed to send frame: " << zmq_strerror(zmq_errno()) << std::endl;
+        ++numFramesDropped;
+        return;
+    }
+
+    ++numFramesSent;
+    numBytesSent += int64(header->payloadBytes);
+    numRawBytes += int64(rawBytes);
+#endif
+}
+
+void StreamOutput::saveCustomParametersToXml(XmlElement* parentElement)
+{
+    XmlElement* mainNode = parentElement->createNewChildElement("STREAMOUTPUT");
+    mainNode->setAttribute("port", listeningPort);
+    mainNode->setAttribute("channels", channelList);
+    mainNode->setAttribute("format", sampleFormat == INT16_FORMAT ? "int16" : "float32");
+    mainNode->setAttribute("lz4", compression);
+    mainNode->setAttribute("frameLength", frameLength);
+}
+
+void StreamOutput::loadCustomParametersFromXml()
+{
+    if (parametersAsXml)
+    {
+        forEachXmlChildElement(*parametersAsXml, mainNode)
+        {
+            if (mainNode->hasTagName("STREAMOUTPUT"))
+            {
+                setListeningPort(mainNode->getIntAttribute("port", listeningPort));
+                setChannelList(mainNode->getStringAttribute("channels"));
+                setSampleFormat(mainNode->getStringAttribute("format") == "int16" ? INT16_FORMAT : FLOAT_FORMAT);
+                setCompression(mainNode->getBoolAttribute("lz4", false));
+                setFrameLength(float(mainNode->getDoubleAttribute("frameLength", frameLength)));
+                setLoopback(mainNode->getBoolAttribute("loopback", false));
+            }
+        }
+    }
+
+    if (editor != nullptr)
+        static_cast<StreamOutputEditor*>(getEditor())->updateSettings();
+}
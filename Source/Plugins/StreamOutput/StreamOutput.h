@@ -0,0 +1,205 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2016 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef STREAMOUTPUT_H_INCLUDED
+#define STREAMOUTPUT_H_INCLUDED
+
+#include <ProcessorHeaders.h>
+#include "StreamFrame.h"
+
+#ifdef ZEROMQ
+
+#ifdef WIN32
+#include <zmq.h>
+#include <zmq_utils.h>
+#else
+#include <zmq.h>
+#endif
+
+#endif
+#include <memory>
+
+/**
+
+  Streams continuous data and spikes to any number of subscribers over
+  ZeroMQ (PUB socket, see StreamFrame.h for the wire format).
+
+  The audio thread only copies samples into preallocated frames, batching
+  several blocks into one frame; a sender thread converts them to int16 if
+  requested, compresses them with LZ4 if available and publishes them. If
+  the sender falls behind and every frame is in use, new data is dropped and
+  counted rather than ever making the audio thread wait.
+
+  With loopback enabled (used by the benchmark) a subscriber thread in the
+  same process receives the stream and reports the sustained throughput
+  when acquisition stops.
+
+  @see StreamOutputEditor, EventBroadcaster
+
+*/
+
+class StreamOutput : public GenericProcessor, private Thread
+{
+public:
+    enum SampleFormat
+    {
+        FLOAT_FORMAT = 0,
+        INT16_FORMAT = 1
+    };
+
+    StreamOutput();
+    ~StreamOutput();
+
+    AudioProcessorEditor* createEditor() override;
+
+    bool isSink() override;
+
+    bool enable() override;
+    bool disable() override;
+
+    void process(AudioSampleBuffer& buffer, MidiBuffer& events) override;
+    void handleEvent(int eventType, MidiMessage& event, int samplePosition = 0) override;
+
+    int getListeningPort() const;
+    void setListeningPort(int port, bool forceRestart = false);
+
+    /** Channels to stream, as 1-based numbers and ranges, e.g. "1-32,40".
+        An empty string streams every input channel. */
+    void setChannelList(const String& list);
+    String getChannelList() const;
+
+    void setSampleFormat(SampleFormat format);
+    SampleFormat getSampleFormat() const;
+
+    /** Compresses frames with LZ4, if the plugin was built with it. */
+    void setCompression(bool compress);
+    bool getCompression() const;
+    static bool isCompressionAvailable();
+
+    /** Length of the continuous frames, in milliseconds. */
+    void setFrameLength(float milliseconds);
+    float getFrameLength() const;
+
+    /** Receives the stream in-process and prints its throughput on disable(). */
+    void setLoopback(bool loopback);
+
+    int getNumFramesSent() const;
+    int getNumFramesDropped() const;
+    int64 getNumBytesSent() const;
+
+    /** Returns the mean ratio of sent to raw payload bytes. */
+    double getCompressionRatio() const;
+
+    void saveCustomParametersToXml(XmlElement* parentElement) override;
+    void loadCustomParametersFromXml() override;
+
+private:
+    /** A frame being filled by the audio thread or waiting to be sent. */
+    struct Frame
+    {
+        int64 timestamp;
+        uint32 sequence;
+        int numSamples;
+        int numBytes;
+        HeapBlock<float> samples;
+        HeapBlock<uint8> bytes;
+    };
+
+    /** Fixed set of frames handed from the audio thread to the sender thread. */
+    class FrameQueue
+    {
+    public:
+        FrameQueue();
+
+        void allocate(int numFrames, int numSamples, int numBytes);
+
+        /** Returns the frame being filled, or nullptr if all frames are queued.
+            Producer side only. */
+        Frame* getWriteFrame();
+        void finishedWrite();
+
+        /** Returns the oldest queued frame, or nullptr. Consumer side only. */
+        Frame* getReadFrame();
+        void finishedRead();
+
+    private:
+        ScopedPointer<AbstractFifo> fifo;
+        OwnedArray<Frame> frames;
+    };
+
+    class LoopbackSubscriber;
+
+    static std::shared_ptr<void> getZMQContext();
+    static void closeZMQSocket(void* socket);
+
+    void run() override;
+
+    Array<int> getSelectedChannels();
+
+    /** Appends samples to the current continuous frame, publishing it when full. */
+    void appendSamples(const AudioSampleBuffer& buffer, int numSamples, int64 timestamp);
+    void publishContinuousFrame();
+
+    void sendFrame(Frame* frame, int type, uint32 sequence);
+
+    const std::shared_ptr<void> zmqContext;
+    std::unique_ptr<void, decltype(&closeZMQSocket)> zmqSocket;
+    int listeningPort;
+
+    String channelList;
+    SampleFormat sampleFormat;
+    bool compression;
+    float frameLength;
+    bool loopback;
+
+    Array<int> channelMap;
+    HeapBlock<float> scales;
+    int samplesPerFrame;
+    float sampleRate;
+
+    FrameQueue continuousFrames;
+    FrameQueue spikeFrames;
+    Frame* currentFrame;
+    Frame* currentSpikeFrame;
+    int64 nextTimestamp;
+
+    /** Message buffers used by the sender thread. */
+    HeapBlock<char> message;
+    HeapBlock<char> payload;
+    size_t messageCapacity;
+
+    WaitableEvent frameQueued;
+    uint32 continuousSequence;
+    uint32 spikeSequence;
+
+    Atomic<int> numFramesSent;
+    Atomic<int> numFramesDropped;
+    Atomic<int64> numBytesSent;
+    Atomic<int64> numRawBytes;
+
+    ScopedPointer<LoopbackSubscriber> loopbackSubscriber;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StreamOutput);
+};
+
+#endif  // STREAMOUTPUT_H_INCLUDED
@@ -0,0 +1,215 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2016 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "StreamOutputEditor.h"
+#include "StreamOutput.h"
+
+StreamOutputMonitor::StreamOutputMonitor(StreamOutput* processor_)
+    : Label("Stream statistics", String::empty),
+      processor(processor_),
+      lastBytesSent(0),
+      lastTime(0)
+{
+    setFont(Font("Small Text", 11, Font::plain));
+    setColour(Label::textColourId, Colours::darkgrey);
+}
+
+void StreamOutputMonitor::start()
+{
+    lastBytesSent = 0;
+    lastTime = Time::getMillisecondCounter();
+    setText("Streaming", dontSendNotification);
+    startTimer(500);
+}
+
+void StreamOutputMonitor::stop()
+{
+    stopTimer();
+    timerCallback();
+}
+
+void StreamOutputMonitor::timerCallback()
+{
+    const int64 bytesSent = processor->getNumBytesSent();
+    const uint32 now = Time::getMillisecondCounter();
+    const double seconds = (now - lastTime) / 1000.0;
+
+    String text;
+    text << processor->getNumFramesSent() << " sent, " << processor->getNumFramesDropped() << " dropped";
+
+    if (isTimerRunning() && seconds > 0)
+        text << ", " << String(double(bytesSent - lastBytesSent) / seconds / (1 << 20), 1) << " MB/s";
+
+    setText(text, dontSendNotification);
+
+    lastBytesSent = bytesSent;
+    lastTime = now;
+}
+
+/////////////////////////////////////////////////////////////////////////
+
+StreamOutputEditor::StreamOutputEditor(GenericProcessor* parentNode, bool useDefaultParameterEditors)
+    : GenericEditor(parentNode, useDefaultParameterEditors)
+{
+    desiredWidth = 220;
+
+    processor = (StreamOutput*) parentNode;
+
+    portLabel = createStaticLabel("Port:", 5,28,40);
+    portValue = createEditableLabel("Port value", 45,30,60);
+
+    restartButton = new UtilityButton("Restart", Font("Small Text", 12, Font::plain));
+    restartButton->setRadius(3.0f);
+    restartButton->setBounds(115,30,60,18);
+    restartButton->addListener(this);
+    addAndMakeVisible(restartButton);
+
+    channelsLabel = createStaticLabel("Channels:", 5,53,60);
+    channelsValue = createEditableLabel("Channels value", 65,55,110);
+    channelsValue->setTooltip("Channels to stream, e.g. 1-32,40 (empty for all)");
+
+    formatSelector = new ComboBox("Format");
+    formatSelector->setBounds(10,80,75,20);
+    formatSelector->addItem("float32", StreamOutput::FLOAT_FORMAT + 1);
+    formatSelector->addItem("int16", StreamOutput::INT16_FORMAT + 1);
+    formatSelector->addListener(this);
+    addAndMakeVisible(formatSelector);
+
+    compressionButton = new UtilityButton("LZ4", Font("Small Text", 12, Font::plain));
+    compressionButton->setRadius(3.0f);
+    compressionButton->setBounds(90,80,35,20);
+    compressionButton->addListener(this);
+    compressionButton->setClickingTogglesState(true);
+    compressionButton->setEnabledState(StreamOutput::isCompressionAvailable());
+    compressionButton->setTooltip(StreamOutput::isCompressionAvailable()
+                                  ? "Compress frames with LZ4"
+                                  : "This build of the Stream Output has no LZ4 support");
+    addAndMakeVisible(compressionButton);
+
+    frameLengthValue = createEditableLabel("Frame length value", 130,81,35);
+    frameLengthValue->setTooltip("Length of each continuous frame");
+    frameLengthLabel = createStaticLabel("ms", 165,80,30);
+
+    monitor = new StreamOutputMonitor(processor);
+    monitor->setBounds(5,105,210,20);
+    addAndMakeVisible(monitor);
+
+    updateSettings();
+}
+
+Label* StreamOutputEditor::createEditableLabel(const String& name, int x, int y, int width)
+{
+    Label* label = new Label(name, String::empty);
+    label->setBounds(x,y,width,18);
+    label->setFont(Font("Default", 13, Font::plain));
+    label->setColour(Label::textColourId, Colours::white);
+    label->setColour(Label::backgroundColourId, Colours::grey);
+    label->setEditable(true);
+    label->addListener(this);
+    addAndMakeVisible(label);
+
+    return label;
+}
+
+Label* StreamOutputEditor::createStaticLabel(const String& text, int x, int y, int width)
+{
+    Label* label = new Label(text, text);
+    label->setBounds(x,y,width,20);
+    label->setFont(Font("Small Text", 12, Font::plain));
+    addAndMakeVisible(label);
+
+    return label;
+}
+
+void StreamOutputEditor::updateSettings()
+{
+    portValue->setText(String(processor->getListeningPort()), dontSendNotification);
+    channelsValue->setText(processor->getChannelList(), dontSendNotification);
+    formatSelector->setSelectedId(processor->getSampleFormat() + 1, dontSendNotification);
+    compressionButton->setToggleState(processor->getCompression(), dontSendNotification);
+    frameLengthValue->setText(String(processor->getFrameLength(), 0), dontSendNotification);
+}
+
+void StreamOutputEditor::buttonEvent(Button* button)
+{
+    if (button == restartButton)
+    {
+        processor->setListeningPort(processor->getListeningPort(), true);
+    }
+    else if (button == compressionButton)
+    {
+        processor->setCompression(compressionButton->getToggleState());
+    }
+}
+
+void StreamOutputEditor::labelTextChanged(Label* label)
+{
+    if (label == portValue)
+    {
+        processor->setListeningPort(label->getText().getIntValue());
+    }
+    else if (label == channelsValue)
+    {
+        processor->setChannelList(label->getText());
+    }
+    else if (label == frameLengthValue)
+    {
+        processor->setFrameLength(label->getText().getFloatValue());
+    }
+
+    updateSettings();
+}
+
+void StreamOutputEditor::comboBoxChanged(ComboBox* comboBox)
+{
+    if (comboBox == formatSelector)
+        processor->setSampleFormat(StreamOutput::SampleFormat(formatSelector->getSelectedId() - 1));
+}
+
+void StreamOutputEditor::startAcquisition()
+{
+    GenericEditor::startAcquisition();
+
+    portValue->setEditable(false);
+    channelsValue->setEditable(false);
+    frameLengthValue->setEditable(false);
+    restartButton->setEnabledState(false);
+    formatSelector->setEnabled(false);
+    compressionButton->setEnabledState(false);
+
+    monitor->start();
+}
+
+void StreamOutputEditor::stopAcquisition()
+{
+    GenericEditor::stopAcquisition();
+
+    portValue->setEditable(true);
+    channelsValue->setEditable(true);
+    frameLengthValue->setEditable(true);
+    restartButton->setEnabledState(true);
+    formatSelector->setEnabled(true);
+    compressionButton->setEnabledState(StreamOutput::isCompressionAvailable());
+
+    monitor->stop();
+}
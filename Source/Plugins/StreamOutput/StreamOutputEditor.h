@@ -0,0 +1,101 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2016 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef STREAMOUTPUTEDITOR_H_INCLUDED
+#define STREAMOUTPUTEDITOR_H_INCLUDED
+
+#include <EditorHeaders.h>
+
+class StreamOutput;
+
+/**
+
+  Shows how many frames the StreamOutput has sent and dropped, and the
+  data rate on the wire. Refreshes itself during acquisition.
+
+*/
+
+class StreamOutputMonitor : public Label, private Timer
+{
+public:
+    StreamOutputMonitor(StreamOutput* processor);
+
+    void start();
+    void stop();
+
+private:
+    void timerCallback() override;
+
+    StreamOutput* processor;
+    int64 lastBytesSent;
+    uint32 lastTime;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StreamOutputMonitor);
+};
+
+/**
+
+  User interface for the StreamOutput processor.
+
+  @see StreamOutput
+
+*/
+
+class StreamOutputEditor : public GenericEditor,
+                           public Label::Listener,
+                           public ComboBox::Listener
+{
+public:
+    StreamOutputEditor(GenericProcessor* parentNode, bool useDefaultParameterEditors);
+
+    void buttonEvent(Button* button) override;
+    void labelTextChanged(Label* label) override;
+    void comboBoxChanged(ComboBox* comboBox) override;
+
+    void startAcquisition() override;
+    void stopAcquisition() override;
+
+    /** Shows the processor's current settings, e.g. after loading them. */
+    void updateSettings();
+
+private:
+    Label* createEditableLabel(const String& name, int x, int y, int width);
+    Label* createStaticLabel(const String& text, int x, int y, int width);
+
+    StreamOutput* processor;
+
+    ScopedPointer<Label> portLabel;
+    ScopedPointer<Label> portValue;
+    ScopedPointer<UtilityButton> restartButton;
+    ScopedPointer<Label> channelsLabel;
+    ScopedPointer<Label> channelsValue;
+    ScopedPointer<ComboBox> formatSelector;
+    ScopedPointer<UtilityButton> compressionButton;
+    ScopedPointer<Label> frameLengthValue;
+    ScopedPointer<Label> frameLengthLabel;
+    ScopedPointer<StreamOutputMonitor> monitor;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StreamOutputEditor);
+};
+
+#endif  // STREAMOUTPUTEDITOR_H_INCLUDED
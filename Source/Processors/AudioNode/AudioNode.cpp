@@ -63,6 +63,9 @@ void AudioNode::resetConnections()
 
     channelPointers.clear();
 
+    const ScopedLock sl(getCallbackLock());
+    monitoredChannels.clear();
+
 }
 
 void AudioNode::updateBufferSize()
@@ -87,6 +90,11 @@ void AudioNode::setChannelStatus(Channel* chan, bool status)
 
     setChannel(chan); // add 2 to account for 2 output channels
 
+    if (currentChannel < 0)
+        return;
+
+    // every channel stays connected in the graph, so toggling the monitor only
+    // edits the list of channels that process() mixes
     enableCurrentChannel(status);
 
 }
@@ -105,16 +113,32 @@ void AudioNode::enableCurrentChannel(bool state)
 }
 
 
-void AudioNode::addInputChannel(GenericProcessor* sourceNode, int chan)
+int AudioNode::addInputChannel(GenericProcessor* sourceNode, int chan)
 {
 
 
-    int channelIndex = getNextChannel(false);
+    int channelIndex = getNextChannel(true);
 
     setPlayConfigDetails(channelIndex+1,0,44100.0,128);
 
     channelPointers.add(sourceNode->channels[chan]);
 
+    return channelIndex;
+
+}
+
+void AudioNode::updateMonitoredChannels()
+{
+    const ScopedLock sl(getCallbackLock());
+
+    monitoredChannels.clearQuick();
+    monitoredChannels.ensureStorageAllocated(channelPointers.size());
+
+    for (int i = 0; i < channelPointers.size(); i++)
+    {
+        if (channelPointers[i]->isMonitored)
+            monitoredChannels.add(i);
+    }
 }
 
 void AudioNode::setParameter(int parameterIndex, float newValue)
@@ -138,11 +162,17 @@ void AudioNode::setParameter(int parameterIndex, float newValue)
 
         channelPointers[currentChannel]->isMonitored = true;
 
+        const ScopedLock sl(getCallbackLock());
+        monitoredChannels.addIfNotAlreadyThere(currentChannel);
+
     }
     else if (parameterIndex == -100)
     {
 
         channelPointers[currentChannel]->isMonitored = false;
+
+        const ScopedLock sl(getCallbackLock());
+        monitoredChannels.removeFirstMatchingValue(currentChannel);
     }
 
 }
@@ -193,7 +223,10 @@ void AudioNode::recreateBuffers()
 
     }
 
-    tempBuffer->setSize(getNumInputs(), 4096);
+    // one channel per connected input, rather than one per possible input
+    tempBuffer->setSize(jmax(1, channelPointers.size()), 4096);
+
+    updateMonitoredChannels();
 }
 
 bool AudioNode::enable()
@@ -238,17 +271,21 @@ void AudioNode::process(AudioSampleBuffer& buffer,
         AudioSampleBuffer* overflowBuffer;
         AudioSampleBuffer* backupBuffer;
 
-        if (channelPointers.size() > 0) // we have some channels
-        {
+        const ScopedLock sl(getCallbackLock());
 
-            tempBuffer->clear();
+        if (monitoredChannels.size() > 0) // we have some channels
+        {
 
-            for (int i = 0; i < buffer.getNumChannels()-2; i++) // cycle through them all
+            for (int m = 0; m < monitoredChannels.size(); m++) // only the monitored ones are connected
             {
 
-                if (channelPointers[i]->isMonitored)
+                const int i = monitoredChannels.getUnchecked(m);
+
+                if (i < buffer.getNumChannels()-2)
                 {
 
+                    tempBuffer->clear(i, 0, jmin(numSamplesExpected[i], tempBuffer->getNumSamples()));
+
                     //std::cout << "Processing channel " << i << std::endl;
 
                     if (!bufferSwap[i])
@@ -445,7 +482,7 @@ void AudioNode::process(AudioSampleBuffer& buffer,
                     //                 valuesNeeded,        // number of samples
                     //                 1.0);      // gain to apply to source
 
-                } // if channelPointers[i]->isMonitored
+                } // if i < buffer.getNumChannels()-2
             } // end cycling through channels
 
             // Simple implementation of a "noise gate" on audio output
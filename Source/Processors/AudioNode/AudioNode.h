@@ -41,10 +41,11 @@ class AudioEditor;
   The default processor for sending output to the audio monitor.
 
   The ProcessorGraph has two default nodes: the AudioNode and the RecordNode.
-  Every channel of every processor (that's not a sink or a utility) is automatically
-  connected to both of these nodes. The AudioNode is used to filter out channels to be
-  sent to the audio output device, which can be selected by the user through the AudioEditor
-  (located in the ControlPanel).
+  Every channel of every processor (that's not a sink or a utility) is given an input
+  on both of these nodes, but only the channels that are being monitored are actually
+  connected to the AudioNode; toggling a channel's monitor adds or removes that single
+  connection. The AudioNode mixes the monitored channels into the audio output device,
+  which can be selected by the user through the AudioEditor (located in the ControlPanel).
 
   Since the AudioNode exists no matter what, it doesn't appear in the ProcessorList.
   Instead, it's created by the ProcessorGraph at startup.
@@ -110,8 +111,10 @@ public:
     /** Resets the connections prior to a new round of data acquisition. */
     void enableCurrentChannel(bool);
 
-    /** Establishes a connection between a channel of a GenericProcessor and the AudioNode. */
-    void addInputChannel(GenericProcessor* source, int chan);
+    /** Reserves an AudioNode input for a channel of a GenericProcessor and returns
+        its index. The ProcessorGraph connects every channel; only the monitored
+        ones are mixed in process(). */
+    int addInputChannel(GenericProcessor* source, int chan);
 
     /** A pointer to the AudioNode's editor. */
     ScopedPointer<AudioEditor> audioEditor;
@@ -124,9 +127,18 @@ public:
 
 	bool enable();
 
+    /** The output channels are filled at the audio device's block size. */
+    bool processesWholeBuffer()
+    {
+        return true;
+    }
+
 private:
 	void recreateBuffers();
 
+    /** Rebuilds the list of monitored channels from their isMonitored flags. */
+    void updateMonitoredChannels();
+
     Array<int> leftChan;
     Array<int> rightChan;
     float volume;
@@ -135,6 +147,9 @@ private:
     /** An array of pointers to the channels that feed into the AudioNode. */
     Array<Channel*> channelPointers;
 
+    /** Indices into channelPointers of the monitored channels; guarded by the callback lock. */
+    Array<int> monitoredChannels;
+
     OwnedArray<AudioSampleBuffer> bufferA;
     OwnedArray<AudioSampleBuffer> bufferB;
 
@@ -143,7 +143,11 @@ void AudioResamplingNode::process(AudioSampleBuffer& buffer,
                                   MidiBuffer& midiMessages)
 {
 
-    int nSamps = buffer.getNumSamples(); // WRONG!!!!
+    int nSamps = getNumSamples(0);
+
+    if (nSamps <= 0)
+        return;
+
     int valuesNeeded;
 
     if (destBufferIsTempBuffer)
@@ -154,7 +158,7 @@ void AudioResamplingNode::process(AudioSampleBuffer& buffer,
     else
     {
         ratio = sourceBufferSampleRate / destBufferSampleRate;
-        valuesNeeded = (int) buffer.getNumSamples() / ratio;
+        valuesNeeded = (int) nSamps / ratio;
         //std::cout << std::endl;
         //std::cout << "Ratio: " << ratio << std::endl;
         //std::cout << "Values needed: " << valuesNeeded << std::endl;
@@ -179,7 +183,7 @@ void AudioResamplingNode::process(AudioSampleBuffer& buffer,
     // initialize variables
     tempBuffer->clear();
     int sourceBufferPos = 0;
-    int sourceBufferSize = buffer.getNumSamples();
+    int sourceBufferSize = nSamps;
     float subSampleOffset = 0.0;
     int nextPos = (sourceBufferPos + 1) % sourceBufferSize;
 
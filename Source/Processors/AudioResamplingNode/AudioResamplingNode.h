@@ -62,6 +62,12 @@ public:
     void process(AudioSampleBuffer& buffer, MidiBuffer& midiMessages);
     void setParameter(int parameterIndex, float newValue);
 
+    /** The output has a different number of samples than the input. */
+    bool processesWholeBuffer()
+    {
+        return true;
+    }
+
     AudioSampleBuffer* getContinuousBuffer()
     {
         return destBuffer;
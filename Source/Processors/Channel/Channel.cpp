@@ -154,6 +154,38 @@ bool Channel::getRecordState()
 	return isRecording;
 }
 
+Array<int> Channel::parseChannelList(const String& list, int numChannels)
+{
+    Array<int> selected;
+
+    if (list.isEmpty())
+    {
+        for (int i = 0; i < numChannels; i++)
+            selected.add(i);
+
+        return selected;
+    }
+
+    StringArray ranges;
+    ranges.addTokens(list, ",", String::empty);
+
+    for (int i = 0; i < ranges.size(); i++)
+    {
+        const String range = ranges[i].trim();
+
+        int first = range.upToFirstOccurrenceOf("-", false, false).getIntValue();
+        int last = range.contains("-") ? range.fromFirstOccurrenceOf("-", false, false).getIntValue() : first;
+
+        first = jmax(first, 1);
+        last = jmin(last, numChannels);
+
+        for (int chan = first; chan <= last; chan++)
+            selected.add(chan - 1);
+    }
+
+    return selected;
+}
+
 ChannelExtraData::ChannelExtraData(void* ptr, int size)
 	: dataPtr(ptr), dataSize(size)
 {
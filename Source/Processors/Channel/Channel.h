@@ -102,6 +102,11 @@ public:
     /** Restores the default settings for a given channel. */
     void reset();
 
+    /** Parses a list of channel numbers and ranges, such as "1-8,12", into
+        zero-based channel indices below numChannels. An empty list selects
+        every channel. */
+    static Array<int> parseChannelList(const String& list, int numChannels);
+
     //--------------PUBLIC MEMBERS ---------------- //
 
     /** Channel index within the source processor */
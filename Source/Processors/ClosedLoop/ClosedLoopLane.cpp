@@ -0,0 +1,176 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2016 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "ClosedLoopLane.h"
+
+ClosedLoopLane::ClosedLoopLane(int capacity)
+    : Thread("Closed-loop lane"), fifo(capacity + 1)
+{
+    triggers.calloc(capacity + 1);
+}
+
+ClosedLoopLane::~ClosedLoopLane()
+{
+    triggerAvailable.signal();
+    stopThread(1000);
+}
+
+void ClosedLoopLane::addListener(Listener* listener)
+{
+    {
+        const ScopedLock sl(listenerLock);
+
+        // nothing is published while there are no listeners
+        if (listeners.size() == 0)
+            fifo.reset();
+
+        listeners.addIfNotAlreadyThere(listener);
+        numListeners = listeners.size();
+    }
+
+    if (!isThreadRunning())
+        startThread(10);
+}
+
+void ClosedLoopLane::removeListener(Listener* listener)
+{
+    bool stop;
+
+    {
+        const ScopedLock sl(listenerLock);
+
+        listeners.removeFirstMatchingValue(listener);
+        numListeners = listeners.size();
+        stop = (listeners.size() == 0);
+    }
+
+    if (stop)
+    {
+        signalThreadShouldExit();
+        triggerAvailable.signal();
+        stopThread(1000);
+    }
+}
+
+bool ClosedLoopLane::hasListeners() const
+{
+    return numListeners.get() > 0;
+}
+
+bool ClosedLoopLane::publish(int sourceNodeId, int eventType, int channel, int state, int64 timestamp)
+{
+    if (numListeners.get() == 0)
+        return false;
+
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    if (size1 == 0)
+    {
+        ++numDropped;
+        return false;
+    }
+
+    ClosedLoopTrigger& trigger = triggers[start1];
+    trigger.sourceNodeId = sourceNodeId;
+    trigger.eventType = eventType;
+    trigger.channel = channel;
+    trigger.state = state;
+    trigger.timestamp = timestamp;
+    trigger.publishTicks = Time::getHighResolutionTicks();
+
+    fifo.finishedWrite(1);
+
+    // wakes the lane thread; only takes the event's own short-lived lock
+    triggerAvailable.signal();
+
+    return true;
+}
+
+void ClosedLoopLane::run()
+{
+    while (!threadShouldExit())
+    {
+        triggerAvailable.wait(100);
+        dispatchTriggers();
+    }
+}
+
+void ClosedLoopLane::dispatchTriggers()
+{
+    const ScopedLock sl(listenerLock);
+
+    while (fifo.getNumReady() > 0)
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(1, start1, size1, start2, size2);
+
+        const ClosedLoopTrigger trigger = triggers[start1];
+        fifo.finishedRead(1);
+
+        for (int i = 0; i < listeners.size(); i++)
+            listeners.getUnchecked(i)->closedLoopTriggerReceived(trigger);
+
+        const int64 ticks = Time::getHighResolutionTicks() - trigger.publishTicks;
+
+        totalDispatchTicks += ticks;
+
+        if (ticks > maxDispatchTicks.get())
+            maxDispatchTicks = ticks;
+
+        ++numDispatched;
+    }
+}
+
+int ClosedLoopLane::getNumDropped() const
+{
+    return numDropped.get();
+}
+
+int ClosedLoopLane::getNumDispatched() const
+{
+    return numDispatched.get();
+}
+
+double ClosedLoopLane::getMeanDispatchLatency() const
+{
+    const int n = numDispatched.get();
+
+    if (n == 0)
+        return 0;
+
+    return Time::highResolutionTicksToSeconds(totalDispatchTicks.get()) * 1.0e6 / n;
+}
+
+double ClosedLoopLane::getMaxDispatchLatency() const
+{
+    return Time::highResolutionTicksToSeconds(maxDispatchTicks.get()) * 1.0e6;
+}
+
+void ClosedLoopLane::resetStatistics()
+{
+    numDropped = 0;
+    numDispatched = 0;
+    totalDispatchTicks = 0;
+    maxDispatchTicks = 0;
+}
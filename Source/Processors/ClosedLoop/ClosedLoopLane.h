@@ -0,0 +1,142 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2016 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef CLOSEDLOOPLANE_H_INCLUDED
+#define CLOSEDLOOPLANE_H_INCLUDED
+
+#include "../../../JuceLibraryCode/JuceHeader.h"
+#include "../PluginManager/OpenEphysPlugin.h"
+
+/** A trigger published by a detector on the closed-loop lane. */
+struct ClosedLoopTrigger
+{
+    /** Node id of the processor that published the trigger. */
+    int sourceNodeId;
+
+    /** Event type (e.g. GenericProcessor::TTL). */
+    int eventType;
+
+    /** Event channel, as it would appear in the event buffer. */
+    int channel;
+
+    /** Event id, i.e. 1 for a rising and 0 for a falling TTL. */
+    int state;
+
+    /** Sample timestamp of the detection. */
+    int64 timestamp;
+
+    /** Time::getHighResolutionTicks() when the trigger was published. */
+    int64 publishTicks;
+};
+
+/**
+
+  Low-latency path from detectors to output devices.
+
+  Events added to the event buffer only reach an output processor once every
+  processor upstream of it has finished the current block. Detectors can
+  additionally publish their triggers here from within process(): they are
+  copied into a lock-free ring and picked up immediately by a high-priority
+  thread, which hands them to every registered Listener (usually an output
+  processor, which fires its device straight away).
+
+  The ring has a single producer: triggers must only be published from the
+  audio thread (or from one other thread while acquisition is stopped). If the
+  lane thread falls behind, new triggers are dropped and counted.
+
+  The lane thread only runs while at least one listener is registered, and
+  publish() returns immediately while there are none.
+
+  @see ClosedLoopTrigger, CoreServices::getClosedLoopLane
+
+*/
+
+class PLUGIN_API ClosedLoopLane : private Thread
+{
+public:
+    ClosedLoopLane(int capacity = 256);
+    ~ClosedLoopLane();
+
+    class PLUGIN_API Listener
+    {
+    public:
+        virtual ~Listener() {}
+
+        /** Called on the lane thread for every published trigger. Should
+            return quickly, as it delays all subsequent triggers. */
+        virtual void closedLoopTriggerReceived(const ClosedLoopTrigger& trigger) = 0;
+    };
+
+    /** Adds a listener and starts the lane thread if needed. Typically called
+        from a processor's enable() method. */
+    void addListener(Listener* listener);
+
+    /** Removes a listener, stopping the lane thread after the last one. Once
+        this returns the listener is no longer called. */
+    void removeListener(Listener* listener);
+
+    /** Queues a trigger for the listeners. Never blocks on the lane thread.
+        Returns false if there are no listeners or the ring is full. */
+    bool publish(int sourceNodeId, int eventType, int channel, int state, int64 timestamp);
+
+    /** Returns true if at least one listener is registered. */
+    bool hasListeners() const;
+
+    /** Returns the number of triggers dropped because the ring was full. */
+    int getNumDropped() const;
+
+    /** Returns the number of triggers handed to the listeners so far. */
+    int getNumDispatched() const;
+
+    /** Returns the mean / maximum time, in microseconds, from publish() to the
+        last listener returning. */
+    double getMeanDispatchLatency() const;
+    double getMaxDispatchLatency() const;
+
+    /** Clears the drop counter and the latency statistics. */
+    void resetStatistics();
+
+private:
+    void run();
+
+    /** Hands every queued trigger to the listeners. */
+    void dispatchTriggers();
+
+    AbstractFifo fifo;
+    HeapBlock<ClosedLoopTrigger> triggers;
+
+    WaitableEvent triggerAvailable;
+
+    CriticalSection listenerLock;
+    Array<Listener*> listeners;
+    Atomic<int> numListeners;
+
+    Atomic<int> numDropped;
+    Atomic<int> numDispatched;
+    Atomic<int64> totalDispatchTicks;
+    Atomic<int64> maxDispatchTicks;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ClosedLoopLane);
+};
+
+#endif  // CLOSEDLOOPLANE_H_INCLUDED
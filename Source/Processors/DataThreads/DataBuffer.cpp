@@ -24,7 +24,8 @@
 #include "DataBuffer.h"
 
 DataBuffer::DataBuffer(int chans, int size)
-    : abstractFifo(size), buffer(chans, size), numChans(chans)
+    : abstractFifo(size), buffer(chans, size), numChans(chans),
+      numOverrunSamples(0), numUnderruns(0)
 {
     timestampBuffer.malloc(size);
     eventCodeBuffer.malloc(size);
@@ -55,6 +56,13 @@ void DataBuffer::addToBuffer(float* data, int64* timestamps, uint64* eventCodes,
     int startIndex1, blockSize1, startIndex2, blockSize2;
     abstractFifo.prepareToWrite(numItems, startIndex1, blockSize1, startIndex2, blockSize2);
 
+    // the reader has fallen behind; drop the sample rather than overwrite unread data
+    if (blockSize1 < 1)
+    {
+        numOverrunSamples += numItems;
+        return;
+    }
+
     for (int chan = 0; chan < numChans; chan++)
     {
 
@@ -70,13 +78,49 @@ void DataBuffer::addToBuffer(float* data, int64* timestamps, uint64* eventCodes,
     abstractFifo.finishedWrite(numItems);
 }
 
+int DataBuffer::addBlockToBuffer(const AudioSampleBuffer& data, const int64* timestamps, const uint64* eventCodes, int numItems)
+{
+    int startIndex1, blockSize1, startIndex2, blockSize2;
+    abstractFifo.prepareToWrite(numItems, startIndex1, blockSize1, startIndex2, blockSize2);
+
+    const int numChannels = jmin(numChans, data.getNumChannels());
+
+    for (int chan = 0; chan < numChannels; chan++)
+    {
+        if (blockSize1 > 0)
+            buffer.copyFrom(chan, startIndex1, data, chan, 0, blockSize1);
+
+        if (blockSize2 > 0)
+            buffer.copyFrom(chan, startIndex2, data, chan, blockSize1, blockSize2);
+    }
+
+    if (blockSize1 > 0)
+    {
+        memcpy(timestampBuffer + startIndex1, timestamps, sizeof(int64) * blockSize1);
+        memcpy(eventCodeBuffer + startIndex1, eventCodes, sizeof(uint64) * blockSize1);
+    }
+
+    if (blockSize2 > 0)
+    {
+        memcpy(timestampBuffer + startIndex2, timestamps + blockSize1, sizeof(int64) * blockSize2);
+        memcpy(eventCodeBuffer + startIndex2, eventCodes + blockSize1, sizeof(uint64) * blockSize2);
+    }
+
+    abstractFifo.finishedWrite(blockSize1 + blockSize2);
+
+    if (blockSize1 + blockSize2 < numItems)
+        numOverrunSamples += numItems - blockSize1 - blockSize2;
+
+    return blockSize1 + blockSize2;
+}
+
 int DataBuffer::getNumSamples()
 {
     return abstractFifo.getNumReady();
 }
 
 
-int DataBuffer::readAllFromBuffer(AudioSampleBuffer& data, uint64* timestamp, uint64* eventCodes, int maxSize)
+int DataBuffer::readAllFromBuffer(AudioSampleBuffer& data, int64* timestamps, uint64* eventCodes, int maxSize)
 {
     // check to see if the maximum size is smaller than the total number of available ints
 
@@ -88,6 +132,12 @@ int DataBuffer::readAllFromBuffer(AudioSampleBuffer& data, uint64* timestamp, ui
     //int numItems = (maxSize < abstractFifo.getNumReady()) ?
     //               maxSize : abstractFifo.getNumReady();
 
+    if (numItems < 1)
+    {
+        ++numUnderruns;
+        return 0;
+    }
+
     int startIndex1, blockSize1, startIndex2, blockSize2;
     abstractFifo.prepareToRead(numItems, startIndex1, blockSize1, startIndex2, blockSize2);
 
@@ -104,13 +154,9 @@ int DataBuffer::readAllFromBuffer(AudioSampleBuffer& data, uint64* timestamp, ui
                           blockSize1); // numSamples
         }
 
-        memcpy(timestamp, timestampBuffer+startIndex1, 8);
+        memcpy(timestamps, timestampBuffer+startIndex1, blockSize1*8);
         memcpy(eventCodes, eventCodeBuffer+startIndex1, blockSize1*8);
     }
-    else
-    {
-        memcpy(timestamp, timestampBuffer+startIndex2, 8);
-    }
 
     if (blockSize2 > 0)
     {
@@ -124,6 +170,7 @@ int DataBuffer::readAllFromBuffer(AudioSampleBuffer& data, uint64* timestamp, ui
                           startIndex2,     // sourceStartSample
                           blockSize2); // numSamples
         }
+        memcpy(timestamps + blockSize1, timestampBuffer+startIndex2, blockSize2*8);
         memcpy(eventCodes + blockSize1, eventCodeBuffer+startIndex2, blockSize2*8);
     }
 
@@ -131,4 +178,20 @@ int DataBuffer::readAllFromBuffer(AudioSampleBuffer& data, uint64* timestamp, ui
 
     return numItems;
 
-}
\ No newline at end of file
+}
+
+int64 DataBuffer::getNumOverrunSamples() const
+{
+    return numOverrunSamples.get();
+}
+
+int64 DataBuffer::getNumUnderruns() const
+{
+    return numUnderruns.get();
+}
+
+void DataBuffer::resetCounters()
+{
+    numOverrunSamples = 0;
+    numUnderruns = 0;
+}
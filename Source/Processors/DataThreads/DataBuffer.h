@@ -48,11 +48,26 @@ public:
     /** Add an array of floats to the buffer.*/
     void addToBuffer(float* data, int64* ts, uint64* eventCodes, int numItems);
 
+    /** Adds numItems samples of every channel from a non-interleaved buffer,
+        with one timestamp and event code per sample. Returns the number of
+        samples that fit.*/
+    int addBlockToBuffer(const AudioSampleBuffer& data, const int64* timestamps, const uint64* eventCodes, int numItems);
+
     /** Returns the number of samples currently available in the buffer.*/
     int getNumSamples();
 
-    /** Copies as many samples as possible from the DataBuffer to an AudioSampleBuffer.*/
-    int readAllFromBuffer(AudioSampleBuffer& data, uint64* ts, uint64* eventCodes, int maxSize);
+    /** Copies as many samples as possible from the DataBuffer to an AudioSampleBuffer,
+        along with the timestamp and event code of every sample.*/
+    int readAllFromBuffer(AudioSampleBuffer& data, int64* timestamps, uint64* eventCodes, int maxSize);
+
+    /** Returns the number of samples that were dropped because the buffer was full.*/
+    int64 getNumOverrunSamples() const;
+
+    /** Returns the number of reads that found the buffer empty.*/
+    int64 getNumUnderruns() const;
+
+    /** Sets the overrun and underrun counters back to zero.*/
+    void resetCounters();
 
     /** Resizes the data buffer */
     void resize(int chans, int size);
@@ -66,6 +81,9 @@ private:
 
     int numChans;
 
+    Atomic<int64> numOverrunSamples;
+    Atomic<int64> numUnderruns;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DataBuffer);
 
 };
@@ -559,7 +559,7 @@ RHD2000Editor::RHD2000Editor(GenericProcessor* parentNode,
     : VisualizerEditor(parentNode, useDefaultParameterEditors), board(board_)
 {
     canvas = nullptr;
-    desiredWidth = 340;
+    desiredWidth = 400;
     tabText = "FPGA";
     measureWhenRecording = false;
     saveImpedances = false;
@@ -637,6 +637,10 @@ RHD2000Editor::RHD2000Editor(GenericProcessor* parentNode,
     addAndMakeVisible(clockInterface);
     clockInterface->setBounds(179, 82, 70, 50);
 
+    usbStatsInterface = new USBStatsInterface(board, this);
+    addAndMakeVisible(usbStatsInterface);
+    usbStatsInterface->setBounds(335, 25, 60, 60);
+
     adcButton = new UtilityButton("ADC 1-8", Font("Small Text", 13, Font::plain));
     adcButton->setRadius(3.0f);
     adcButton->setBounds(179,108,70,18);
@@ -887,6 +891,8 @@ void RHD2000Editor::startAcquisition()
 
     channelSelector->startAcquisition();
 
+    usbStatsInterface->startAcquisition();
+
     rescanButton->setEnabledState(false);
     adcButton->setEnabledState(false);
     dspoffsetButton-> setEnabledState(false);
@@ -901,6 +907,8 @@ void RHD2000Editor::stopAcquisition()
 
     channelSelector->stopAcquisition();
 
+    usbStatsInterface->stopAcquisition();
+
     rescanButton->setEnabledState(true);
     adcButton->setEnabledState(true);
     dspoffsetButton-> setEnabledState(true);
@@ -1492,6 +1500,48 @@ void ClockDivideInterface::paint(Graphics& g)
     g.drawText("Ratio: ", 0, 10, 200, 20, Justification::left, false);
 }
 
+// USB Statistics --------------------------------------------------------------------
+
+USBStatsInterface::USBStatsInterface(RHD2000Thread* board_,
+                                     RHD2000Editor* editor_) :
+    name("USB"), board(board_), editor(editor_),
+    fifoFill(0.0f), lastBlocksPerRead(0), meanBlocksPerRead(0.0f)
+{
+}
+
+void USBStatsInterface::startAcquisition()
+{
+    startTimer(250);
+}
+
+void USBStatsInterface::stopAcquisition()
+{
+    stopTimer();
+    timerCallback();
+}
+
+void USBStatsInterface::timerCallback()
+{
+    fifoFill = board->getFifoFill();
+    lastBlocksPerRead = board->getLastBlocksPerRead();
+    meanBlocksPerRead = board->getMeanBlocksPerRead();
+
+    repaint();
+}
+
+void USBStatsInterface::paint(Graphics& g)
+{
+
+    g.setColour(Colours::darkgrey);
+    g.setFont(Font("Small Text",10,Font::plain));
+    g.drawText(name, 0, 0, 200, 15, Justification::left, false);
+
+    g.setFont(Font("Small Text",9,Font::plain));
+    g.drawText("FIFO: " + String(fifoFill * 100.0f, 1) + "%", 0, 15, 200, 12, Justification::left, false);
+    g.drawText("Read: " + String(lastBlocksPerRead) + "/" + String(board->getMaxBlocksPerRead()), 0, 27, 200, 12, Justification::left, false);
+    g.drawText("Avg: " + String(meanBlocksPerRead, 1), 0, 39, 200, 12, Justification::left, false);
+}
+
 // DSP Options --------------------------------------------------------------------
 
 DSPInterface::DSPInterface(RHD2000Thread* board_,
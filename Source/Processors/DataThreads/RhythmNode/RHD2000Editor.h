@@ -36,6 +36,7 @@ class BandwidthInterface;
 class DSPInterface;
 class AudioInterface;
 class ClockDivideInterface;
+class USBStatsInterface;
 class RHD2000Thread;
 
 class UtilityButton;
@@ -201,6 +202,7 @@ private:
 
     ScopedPointer<AudioInterface> audioInterface;
     ScopedPointer<ClockDivideInterface> clockInterface;
+    ScopedPointer<USBStatsInterface> usbStatsInterface;
 
     ScopedPointer<UtilityButton> rescanButton,dacTTLButton;
     ScopedPointer<UtilityButton> adcButton;
@@ -396,5 +398,36 @@ private:
     ScopedPointer<Label> divideRatioSelection;
     int actualDivideRatio;
 
+};
+
+/**
+
+  Shows how full the board's FIFO is and how many USB data blocks each
+  read takes, while acquisition is running.
+
+*/
+class USBStatsInterface : public Component,
+    public Timer
+{
+public:
+    USBStatsInterface(RHD2000Thread*, RHD2000Editor*);
+
+    void paint(Graphics& g);
+    void timerCallback();
+
+    void startAcquisition();
+    void stopAcquisition();
+
+private:
+
+    String name;
+
+    RHD2000Thread * board;
+    RHD2000Editor * editor;
+
+    float fifoFill;
+    int lastBlocksPerRead;
+    float meanBlocksPerRead;
+
 };
 #endif  // __RHD2000EDITOR_H_2AD3C591__
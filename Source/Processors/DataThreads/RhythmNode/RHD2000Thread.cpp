@@ -90,11 +90,14 @@ RHD2000Thread::RHD2000Thread(SourceNode* sn) : DataThread(sn),
     desiredLowerBandwidth(1.0f),
     boardSampleRate(30000.0f),
     savedSampleRateIndex(16),
+    nextRawBuffer(0), haveFreeRawBuffer(false), maxUsbBlocksToRead(16),
     cableLengthPortA(0.914f), cableLengthPortB(0.914f), cableLengthPortC(0.914f), cableLengthPortD(0.914f), // default is 3 feet (0.914 m),
     audioOutputL(-1), audioOutputR(-1) ,numberingScheme(1),
 	newScan(true), ledsEnabled(true)
 {
 	impedanceThread = new RHDImpedanceMeasure(this);
+	decodeThread = new RHDDecodeThread(this);
+	rawBuffers[0].size = rawBuffers[1].size = 0;
 	memset(auxBuffer, 0, sizeof(auxBuffer));
 	memset(auxSamples, 0, sizeof(auxSamples));
 
@@ -1175,7 +1178,7 @@ void RHD2000Thread::setSampleRate(int sampleRateIndex, bool isTemporary)
         savedSampleRateIndex = sampleRateIndex;
     }
 
-    int numUsbBlocksToRead = 0; // placeholder - make this change the number of blocks that are read in RHD2000Thread::updateBuffer()
+    int numUsbBlocksToRead = 0; // the most blocks RHD2000Thread::updateBuffer() takes in one read
 
     Rhd2000EvalBoard::AmplifierSampleRate sampleRate; // just for local use
 
@@ -1272,6 +1275,7 @@ void RHD2000Thread::setSampleRate(int sampleRateIndex, bool isTemporary)
             boardSampleRate = 10000.0f;
     }
 
+    maxUsbBlocksToRead = numUsbBlocksToRead;
 
     // Select per-channel amplifier sampling rate.
     evalBoard->setSampleRate(sampleRate);
@@ -1433,6 +1437,34 @@ bool RHD2000Thread::startAcquisition()
     blockSize = dataBlock->calculateDataBlockSizeInWords(evalBoard->getNumEnabledDataStreams(), evalBoard->isUSB3());
 	std::cout << "Expecting blocksize of " << blockSize << " for " << evalBoard->getNumEnabledDataStreams() << " streams" << std::endl;
 	//evalBoard->printFIFOmetrics();
+
+    // each raw buffer holds the largest read allowed at this sample rate
+    const int samplesPerBlock = Rhd2000DataBlock::getSamplesPerDataBlock(evalBoard->isUSB3());
+    const unsigned int rawBufferSize = 2 * Rhd2000DataBlock::calculateDataBlockSizeInWords(
+        evalBoard->getNumEnabledDataStreams(), evalBoard->isUSB3(), samplesPerBlock * maxUsbBlocksToRead);
+
+    for (int i = 0; i < 2; i++)
+    {
+        if (rawBuffers[i].size < rawBufferSize)
+        {
+            rawBuffers[i].data.malloc(rawBufferSize);
+            rawBuffers[i].size = rawBufferSize;
+        }
+
+        rawBuffers[i].numSamples = 0;
+        rawBufferFilled[i].reset();
+        rawBufferFree[i].signal();
+    }
+
+    nextRawBuffer = 0;
+    haveFreeRawBuffer = false;
+
+    lastFifoWords = 0;
+    lastBlocksPerRead = 0;
+    numUsbReads = 0;
+    numUsbBlocksRead = 0;
+
+    decodeThread->startThread(10);
     startThread();
 
 
@@ -1462,6 +1494,12 @@ bool RHD2000Thread::stopAcquisition()
         std::cout << "Thread failed to exit, continuing anyway..." << std::endl;
     }
 
+    // whatever is still waiting to be decoded is flushed with the FIFO below
+    decodeThread->stopThread(500);
+
+    if (numUsbReads.get() > 0)
+        std::cout << "Average USB read: " << getMeanBlocksPerRead() << " blocks." << std::endl;
+
     if (deviceFound)
     {
         evalBoard->setContinuousRunMode(false);
@@ -1492,202 +1530,267 @@ bool RHD2000Thread::stopAcquisition()
     return true;
 }
 
-bool RHD2000Thread::updateBuffer()
+void RHD2000Thread::decodeRawData(unsigned char* bufferPtr, int nSamps)
 {
-	//int chOffset;
-	unsigned char* bufferPtr;
-    //cout << "Number of 16-bit words in FIFO: " << evalBoard->numWordsInFifo() << endl;
-    //cout << "Block size: " << blockSize << endl;
-   
-	//std::cout << "Current number of words: " <<  evalBoard->numWordsInFifo() << " for " << blockSize << std::endl;
-    if (evalBoard->isUSB3() || evalBoard->numWordsInFifo() >= blockSize)
-    {
-		bool return_code;
+	int index = 0;
+	int auxIndex, chanIndex;
+	int numStreams = enabledStreams.size();
 
-		return_code = evalBoard->readRawDataBlock(&bufferPtr);
+	//evalBoard->printFIFOmetrics();
+    for (int samp = 0; samp < nSamps; samp++)
+    {
+        int channel = -1;
 
-		int index = 0;
-		int auxIndex, chanIndex;
-		int numStreams = enabledStreams.size();
-		int nSamps = Rhd2000DataBlock::getSamplesPerDataBlock(evalBoard->isUSB3());
-		
-		//evalBoard->printFIFOmetrics();
-        for (int samp = 0; samp < nSamps; samp++)
-        {
-            int channel = -1;
+		if (!Rhd2000DataBlock::checkUsbHeader(bufferPtr, index))
+		{
+			cerr << "Error in Rhd2000EvalBoard::readDataBlock: Incorrect header." << endl;
+			break;
+		}
 
-			if (!Rhd2000DataBlock::checkUsbHeader(bufferPtr, index))
+		index += 8;
+		timestamp = Rhd2000DataBlock::convertUsbTimeStamp(bufferPtr,index);
+		index += 4;
+		auxIndex = index;
+		//skip the aux channels
+		index += numStreams * 6;
+		// do the neural data channels first
+		for (int dataStream = 0; dataStream < numStreams; dataStream++)
+		{
+			int nChans = numChannelsPerDataStream[dataStream];
+			chanIndex = index + 2*dataStream;
+			if ((chipId[dataStream] == CHIP_ID_RHD2132) && (nChans == 16)) //RHD2132 16ch. headstage
 			{
-				cerr << "Error in Rhd2000EvalBoard::readDataBlock: Incorrect header." << endl;
-				break;
+				chanIndex += 2 * RHD2132_16CH_OFFSET*numStreams;
 			}
-
-			index += 8;
-			timestamp = Rhd2000DataBlock::convertUsbTimeStamp(bufferPtr,index);
-			index += 4;
-			auxIndex = index;
-			//skip the aux channels
-			index += numStreams * 6;
-			// do the neural data channels first
-			for (int dataStream = 0; dataStream < numStreams; dataStream++)
+			for (int chan = 0; chan < nChans; chan++)
 			{
-				int nChans = numChannelsPerDataStream[dataStream];
-				chanIndex = index + 2*dataStream;
-				if ((chipId[dataStream] == CHIP_ID_RHD2132) && (nChans == 16)) //RHD2132 16ch. headstage
+				channel++;
+				thisSample[channel] = float(*(uint16*)(bufferPtr + chanIndex) - 32768)*0.195f;
+				chanIndex += 2*numStreams;
+			}
+		}
+		index += 64 * numStreams;
+		//now we can do the aux channels
+		auxIndex += 2*numStreams;
+		for (int dataStream = 0; dataStream < numStreams; dataStream++)
+		{
+			if (chipId[dataStream] != CHIP_ID_RHD2164_B)
+			{
+				int auxNum = (samp+3) % 4;
+				if (auxNum < 3)
 				{
-					chanIndex += 2 * RHD2132_16CH_OFFSET*numStreams;
+					auxSamples[dataStream][auxNum] = float(*(uint16*)(bufferPtr + auxIndex) - 32768)*0.0000374;
 				}
-				for (int chan = 0; chan < nChans; chan++)
+				for (int chan = 0; chan < 3; chan++)
 				{
 					channel++;
-					thisSample[channel] = float(*(uint16*)(bufferPtr + chanIndex) - 32768)*0.195f;
-					chanIndex += 2*numStreams;
-				}
-			}
-			index += 64 * numStreams;
-			//now we can do the aux channels
-			auxIndex += 2*numStreams;
-			for (int dataStream = 0; dataStream < numStreams; dataStream++)
-			{
-				if (chipId[dataStream] != CHIP_ID_RHD2164_B)
-				{
-					int auxNum = (samp+3) % 4;
-					if (auxNum < 3)
+					if (auxNum == 3)
 					{
-						auxSamples[dataStream][auxNum] = float(*(uint16*)(bufferPtr + auxIndex) - 32768)*0.0000374;
-					}
-					for (int chan = 0; chan < 3; chan++)
-					{
-						channel++;
-						if (auxNum == 3)
-						{
-							auxBuffer[channel] = auxSamples[dataStream][chan];
-						}
-						thisSample[channel] = auxBuffer[channel];
+						auxBuffer[channel] = auxSamples[dataStream][chan];
 					}
+					thisSample[channel] = auxBuffer[channel];
 				}
-				auxIndex += 2;
-
 			}
-			index += 2 * numStreams;
-			if (acquireAdcChannels)
-			{
-				for (int adcChan = 0; adcChan < 8; ++adcChan)
-				{
+			auxIndex += 2;
 
-					channel++;
-					// ADC waveform units = volts
-					thisSample[channel] =
-						//0.000050354 * float(dataBlock->boardAdcData[adcChan][samp]);
-						0.00015258789 * float(*(uint16*)(bufferPtr + index)) - 5 - 0.4096; // account for +/-5V input range and DC offset
-					index += 2;
-				}
-			}
-			else
+		}
+		index += 2 * numStreams;
+		if (acquireAdcChannels)
+		{
+			for (int adcChan = 0; adcChan < 8; ++adcChan)
 			{
-				index += 16;
+
+				channel++;
+				// ADC waveform units = volts
+				thisSample[channel] =
+					//0.000050354 * float(dataBlock->boardAdcData[adcChan][samp]);
+					0.00015258789 * float(*(uint16*)(bufferPtr + index)) - 5 - 0.4096; // account for +/-5V input range and DC offset
+				index += 2;
 			}
-			eventCode = *(uint16*)(bufferPtr + index);
-			index += 4;
-			dataBuffer->addToBuffer(thisSample, &timestamp, &eventCode, 1);
+		}
+		else
+		{
+			index += 16;
+		}
+		eventCode = *(uint16*)(bufferPtr + index);
+		index += 4;
+		dataBuffer->addToBuffer(thisSample, &timestamp, &eventCode, 1);
 #if 0
-            // do the neural data channels first
-            for (int dataStream = 0; dataStream < enabledStreams.size(); dataStream++)
+        // do the neural data channels first
+        for (int dataStream = 0; dataStream < enabledStreams.size(); dataStream++)
+        {
+			if ((chipId[dataStream] == CHIP_ID_RHD2132) && (numChannelsPerDataStream[dataStream] == 16)) //RHD2132 16ch. headstage
+				chOffset = RHD2132_16CH_OFFSET;
+			else
+				chOffset = 0;
+            for (int chan = 0; chan < numChannelsPerDataStream[dataStream]; chan++)
             {
-				if ((chipId[dataStream] == CHIP_ID_RHD2132) && (numChannelsPerDataStream[dataStream] == 16)) //RHD2132 16ch. headstage
-					chOffset = RHD2132_16CH_OFFSET;
-				else
-					chOffset = 0;
-                for (int chan = 0; chan < numChannelsPerDataStream[dataStream]; chan++)
-                {
 
-                    //  std::cout << "reading sample stream " << streamNumber << " chan " << chan << " sample "<< samp << std::endl;
+                //  std::cout << "reading sample stream " << streamNumber << " chan " << chan << " sample "<< samp << std::endl;
 
-                    channel++;
+                channel++;
 
-                    int value = dataBlock->amplifierData[dataStream][chan+chOffset][samp];
+                int value = dataBlock->amplifierData[dataStream][chan+chOffset][samp];
 
-                    thisSample[channel] = float(value-32768)*0.195f;
-                }
+                thisSample[channel] = float(value-32768)*0.195f;
+            }
 
 
-            }
+        }
 
 
-            // then do the Intan AUX channels
-            for (int dataStream = 0; dataStream < enabledStreams.size(); dataStream++)
+        // then do the Intan AUX channels
+        for (int dataStream = 0; dataStream < enabledStreams.size(); dataStream++)
+        {
+            if (chipId[dataStream] != CHIP_ID_RHD2164_B) //Channel B of 2164 shouldn't be copied
             {
-                if (chipId[dataStream] != CHIP_ID_RHD2164_B) //Channel B of 2164 shouldn't be copied
+                if (samp % 4 == 1)   // every 4th sample should have auxiliary input data
                 {
-                    if (samp % 4 == 1)   // every 4th sample should have auxiliary input data
-                    {
 
-                        // std::cout << "reading sample stream " << streamNumber << " aux ADCs " << std::endl;
+                    // std::cout << "reading sample stream " << streamNumber << " aux ADCs " << std::endl;
 
-                        channel++;
-						thisSample[channel] = 0.0000374 *
-							float(dataBlock->auxiliaryData[dataStream][1][samp + 0] - 32768);
-                        // constant offset keeps the values visible in the LFP Viewer
+                    channel++;
+					thisSample[channel] = 0.0000374 *
+						float(dataBlock->auxiliaryData[dataStream][1][samp + 0] - 32768);
+                    // constant offset keeps the values visible in the LFP Viewer
 
-                        auxBuffer[channel] = thisSample[channel];
+                    auxBuffer[channel] = thisSample[channel];
 
-                        channel++;
-						thisSample[channel] = 0.0000374 *
-							float(dataBlock->auxiliaryData[dataStream][1][samp + 1] - 32768);
-                        // constant offset keeps the values visible in the LFP Viewer
+                    channel++;
+					thisSample[channel] = 0.0000374 *
+						float(dataBlock->auxiliaryData[dataStream][1][samp + 1] - 32768);
+                    // constant offset keeps the values visible in the LFP Viewer
 
-                        auxBuffer[channel] = thisSample[channel];
+                    auxBuffer[channel] = thisSample[channel];
 
 
-                        channel++;
-						thisSample[channel] = 0.0000374 *
-							float(dataBlock->auxiliaryData[dataStream][1][samp + 2] - 32768);
-                        // constant offset keeps the values visible in the LFP Viewer
+                    channel++;
+					thisSample[channel] = 0.0000374 *
+						float(dataBlock->auxiliaryData[dataStream][1][samp + 2] - 32768);
+                    // constant offset keeps the values visible in the LFP Viewer
 
-                        auxBuffer[channel] = thisSample[channel];
+                    auxBuffer[channel] = thisSample[channel];
 
-                    }
-                    else    // repeat last values from buffer
-                    {
+                }
+                else    // repeat last values from buffer
+                {
 
-                        //std::cout << "reading sample stream " << streamNumber << " aux ADCs " << std::endl;
+                    //std::cout << "reading sample stream " << streamNumber << " aux ADCs " << std::endl;
 
-                        channel++;
-                        thisSample[channel] = auxBuffer[channel];
-                        channel++;
-                        thisSample[channel] = auxBuffer[channel];
-                        channel++;
-                        thisSample[channel] = auxBuffer[channel];
-                    }
+                    channel++;
+                    thisSample[channel] = auxBuffer[channel];
+                    channel++;
+                    thisSample[channel] = auxBuffer[channel];
+                    channel++;
+                    thisSample[channel] = auxBuffer[channel];
                 }
-
             }
 
-            // finally, loop through acquisition board ADC channels if necessary
-            if (acquireAdcChannels)
+        }
+
+        // finally, loop through acquisition board ADC channels if necessary
+        if (acquireAdcChannels)
+        {
+            for (int adcChan = 0; adcChan < 8; ++adcChan)
             {
-                for (int adcChan = 0; adcChan < 8; ++adcChan)
-                {
 
-                    channel++;
-                    // ADC waveform units = volts
-                    thisSample[channel] =
-                        //0.000050354 * float(dataBlock->boardAdcData[adcChan][samp]);
-                        0.00015258789 * float(dataBlock->boardAdcData[adcChan][samp]) - 5 - 0.4096; // account for +/-5V input range and DC offset
-                }
+                channel++;
+                // ADC waveform units = volts
+                thisSample[channel] =
+                    //0.000050354 * float(dataBlock->boardAdcData[adcChan][samp]);
+                    0.00015258789 * float(dataBlock->boardAdcData[adcChan][samp]) - 5 - 0.4096; // account for +/-5V input range and DC offset
             }
-            // std::cout << channel << std::endl;
+        }
+        // std::cout << channel << std::endl;
 
-            timestamp = dataBlock->timeStamp[samp];
-            //timestamp = timestamp;
-            eventCode = dataBlock->ttlIn[samp];
-            dataBuffer->addToBuffer(thisSample, &timestamp, &eventCode, 1);
+        timestamp = dataBlock->timeStamp[samp];
+        //timestamp = timestamp;
+        eventCode = dataBlock->ttlIn[samp];
+        dataBuffer->addToBuffer(thisSample, &timestamp, &eventCode, 1);
 #endif
+    }
+}
+
+float RHD2000Thread::getFifoFill() const
+{
+    return float(lastFifoWords.get()) / float(Rhd2000EvalBoard::fifoCapacityInWords());
+}
+
+int RHD2000Thread::getLastBlocksPerRead() const
+{
+    return lastBlocksPerRead.get();
+}
+
+int RHD2000Thread::getMaxBlocksPerRead() const
+{
+    return maxUsbBlocksToRead;
+}
+
+float RHD2000Thread::getMeanBlocksPerRead() const
+{
+    const int64 numReads = numUsbReads.get();
+
+    return numReads > 0 ? float(numUsbBlocksRead.get()) / float(numReads) : 0.0f;
+}
+
+bool RHD2000Thread::updateBuffer()
+{
+    // take the raw buffer the decoding thread is done with; it may still be
+    // busy with the other one
+    if (!haveFreeRawBuffer)
+    {
+        if (!rawBufferFree[nextRawBuffer].wait(100))
+            return true;
+
+        haveFreeRawBuffer = true;
+    }
+
+    const bool usb3 = evalBoard->isUSB3();
+    const int samplesPerBlock = Rhd2000DataBlock::getSamplesPerDataBlock(usb3);
+    const unsigned int wordsInFifo = evalBoard->numWordsInFifo();
+
+    // read everything the FIFO holds, up to the limit for this sample rate: small
+    // reads while keeping up keep latency low, larger ones catch up under load
+    int numBlocks = jmin(int(wordsInFifo / blockSize), maxUsbBlocksToRead);
+
+    lastFifoWords = int(wordsInFifo);
+
+    if (numBlocks < 1)
+    {
+        if (usb3)
+        {
+            numBlocks = 1; // block pipe reads wait for the data to arrive
+        }
+        else
+        {
+            // rather than polling the FIFO, wait for part of a block to arrive
+            wait(jmax(1, int(500.0 * samplesPerBlock / boardSampleRate)));
         }
+    }
+
+    if (numBlocks > 0)
+    {
+        RawBuffer& raw = rawBuffers[nextRawBuffer];
+        raw.numSamples = numBlocks * samplesPerBlock;
 
+        // as before, a failed transfer doesn't stop acquisition; the batch is
+        // skipped and the buffer is used for the next one
+        if (!evalBoard->readRawData(raw.data, raw.size, raw.numSamples))
+        {
+            std::cout << "RHD2000Thread: USB read of " << numBlocks << " blocks failed." << std::endl;
+        }
+        else
+        {
+            lastBlocksPerRead = numBlocks;
+            ++numUsbReads;
+            numUsbBlocksRead += numBlocks;
+
+            haveFreeRawBuffer = false;
+            rawBufferFilled[nextRawBuffer].signal();
+            nextRawBuffer ^= 1;
+        }
     }
 
-	
     if (dacOutputShouldChange)
     {
 		std::cout << "DAC" << std::endl;
@@ -1922,6 +2025,27 @@ bool RHDHeadstage::isPlugged()
 /***********************************/
 /* Below is code for impedance measurements */
 
+RHDDecodeThread::RHDDecodeThread(RHD2000Thread* b) : Thread("RHD2000 decoder"), board(b)
+{
+}
+
+void RHDDecodeThread::run()
+{
+	int index = 0;
+
+	while (!threadShouldExit())
+	{
+		if (!board->rawBufferFilled[index].wait(100))
+			continue;
+
+		RHD2000Thread::RawBuffer& raw = board->rawBuffers[index];
+		board->decodeRawData(raw.data, raw.numSamples);
+
+		board->rawBufferFree[index].signal();
+		index ^= 1;
+	}
+}
+
 RHDImpedanceMeasure::RHDImpedanceMeasure(RHD2000Thread* b) : Thread(""), data(nullptr), board(b)
 {
 	// to perform electrode impedance measurements at very low frequencies.
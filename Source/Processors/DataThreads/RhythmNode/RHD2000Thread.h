@@ -47,6 +47,7 @@
 class SourceNode;
 class RHDHeadstage;
 class RHDImpedanceMeasure;
+class RHDDecodeThread;
 
 struct ImpedanceData
 {
@@ -68,6 +69,7 @@ struct ImpedanceData
 class RHD2000Thread : public DataThread, public Timer
 {
 	friend class RHDImpedanceMeasure;
+	friend class RHDDecodeThread;
 public:
     RHD2000Thread(SourceNode* sn);
     ~RHD2000Thread();
@@ -134,6 +136,17 @@ public:
 
 	static DataThread* createDataThread(SourceNode* sn);
 
+    /** Returns how full the board's FIFO was at the last read, from 0 to 1.*/
+    float getFifoFill() const;
+
+    /** Returns the number of USB data blocks taken in the last read, and the
+        most one read may take at the current sample rate.*/
+    int getLastBlocksPerRead() const;
+    int getMaxBlocksPerRead() const;
+
+    /** Returns the average number of USB data blocks per read since acquisition started.*/
+    float getMeanBlocksPerRead() const;
+
 private:
 
     bool enableHeadstage(int hsNum, bool enabled, int nStr = 1, int strChans = 32);
@@ -191,8 +204,36 @@ private:
 
     int deviceId(Rhd2000DataBlock* dataBlock, int stream, int& register59Value);
 
+    /** Reads as many data blocks as the FIFO holds, up to maxUsbBlocksToRead,
+        into whichever raw buffer the decoding thread isn't using.*/
     bool updateBuffer();
 
+    /** Turns raw USB data into samples for the DataBuffer. Runs on the decoding thread.*/
+    void decodeRawData(unsigned char* bufferPtr, int nSamps);
+
+    /** Raw USB transfers alternate between two buffers, so that one is decoded
+        while the next is being read.*/
+    struct RawBuffer
+    {
+        HeapBlock<unsigned char> data;
+        unsigned int size;
+        int numSamples;
+    };
+
+    RawBuffer rawBuffers[2];
+    WaitableEvent rawBufferFilled[2];
+    WaitableEvent rawBufferFree[2];
+    int nextRawBuffer;
+    bool haveFreeRawBuffer;
+    ScopedPointer<RHDDecodeThread> decodeThread;
+
+    int maxUsbBlocksToRead;
+
+    Atomic<int> lastFifoWords;
+    Atomic<int> lastBlocksPerRead;
+    Atomic<int64> numUsbReads;
+    Atomic<int64> numUsbBlocksRead;
+
     double cableLengthPortA, cableLengthPortB, cableLengthPortC, cableLengthPortD;
 
     int audioOutputL, audioOutputR;
@@ -240,6 +281,26 @@ private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RHDHeadstage);
 };
 
+/**
+
+  Decodes the raw USB transfers that the RHD2000Thread reads, so that the
+  next transfer can be read while the last one is decoded.
+
+  @see RHD2000Thread
+
+*/
+
+class RHDDecodeThread : public Thread
+{
+public:
+	RHDDecodeThread(RHD2000Thread* b);
+	void run();
+private:
+	RHD2000Thread* board;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RHDDecodeThread);
+};
+
 class RHDImpedanceMeasure : public Thread
 {
 public:
@@ -1449,35 +1449,47 @@ bool Rhd2000EvalBoard::readDataBlock(Rhd2000DataBlock *dataBlock, int nSamples)
 }
 
 bool Rhd2000EvalBoard::readRawDataBlock(unsigned char** bufferPtr, int nSamples)
+{
+	if (!readRawData(usbBuffer, USB_BUFFER_SIZE, nSamples))
+	{
+		*bufferPtr = nullptr;
+		return false;
+	}
+
+	*bufferPtr = usbBuffer;
+	return true;
+}
+
+// Reads nSamples samples of raw USB data into a caller-supplied buffer of bufferSize bytes, so that
+// the caller can decode one transfer while the next is being read.  The caller must make sure the
+// FIFO holds enough data (USB 2) and that nSamples is a whole number of data blocks.
+bool Rhd2000EvalBoard::readRawData(unsigned char* buffer, unsigned int bufferSize, int nSamples)
 {
 	unsigned int numBytesToRead;
 	long res;
 
 	numBytesToRead = 2 * Rhd2000DataBlock::calculateDataBlockSizeInWords(numDataStreams, usb3, nSamples);
 
-	if (numBytesToRead > USB_BUFFER_SIZE) {
-		cerr << "Error in Rhd2000EvalBoard::readDataBlock: USB buffer size exceeded.  " <<
-			"Increase value of USB_BUFFER_SIZE." << endl;
-		*bufferPtr = nullptr;
+	if (numBytesToRead > bufferSize) {
+		cerr << "Error in Rhd2000EvalBoard::readRawData: buffer size exceeded." << endl;
 		return false;
 	}
 
 	if (usb3)
 	{
 		//std::cout << "usb3 read : " << numBytesToRead << " in " << USB3_BLOCK_SIZE << " blocks" << std::endl;
-		res = dev->ReadFromBlockPipeOut(PipeOutData, USB3_BLOCK_SIZE, numBytesToRead, usbBuffer);
+		res = dev->ReadFromBlockPipeOut(PipeOutData, USB3_BLOCK_SIZE, numBytesToRead, buffer);
 
 	}
 	else
 	{
 		//std::cout << "usb2 read: " << numBytesToRead << std::endl;
-		res = dev->ReadFromPipeOut(PipeOutData, numBytesToRead, usbBuffer);
+		res = dev->ReadFromPipeOut(PipeOutData, numBytesToRead, buffer);
 	}
 	if (res == ok_Timeout)
 	{
 		cerr << "CRITICAL: Timeout on pipe read. Check block and buffer sizes." << endl;
 	}
-	*bufferPtr = usbBuffer;
 	return true;
 }
 
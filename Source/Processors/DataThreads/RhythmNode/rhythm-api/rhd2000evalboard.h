@@ -170,6 +170,7 @@ public:
 	bool isUSB3();
 	void printFIFOmetrics();
 	bool readRawDataBlock(unsigned char** bufferPtr, int nSamples = -1);
+	bool readRawData(unsigned char* buffer, unsigned int bufferSize, int nSamples);
 
 private:
     okCFrontPanel *dev;
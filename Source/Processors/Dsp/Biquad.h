@@ -96,6 +96,19 @@ public:
         return m_b2*m_a0;
     }
 
+    // Move the coefficients a fraction t of the way towards those
+    // of target. Lets a smoothed filter slide between two designs
+    // without having to redesign the filter for every sample.
+    void interpolateTowards(const BiquadBase& target, double t)
+    {
+        m_a0 += (target.m_a0 - m_a0) * t;
+        m_a1 += (target.m_a1 - m_a1) * t;
+        m_a2 += (target.m_a2 - m_a2) * t;
+        m_b0 += (target.m_b0 - m_b0) * t;
+        m_b1 += (target.m_b1 - m_b1) * t;
+        m_b2 += (target.m_b2 - m_b2) * t;
+    }
+
     // Process a block of samples in the given form
     template <class StateType, typename Sample>
     void process(int numSamples, Sample* dest, StateType& state) const
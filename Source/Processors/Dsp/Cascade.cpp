@@ -115,5 +115,20 @@ void Cascade::setLayout(const LayoutBase& proto)
                std::abs(response(proto.getNormalW() / (2 * doublePi))));
 }
 
+void Cascade::interpolateTowards(const Cascade& target, double t)
+{
+    if (m_numStages != target.m_numStages)
+    {
+        m_numStages = target.m_numStages;
+        assert(m_numStages <= m_maxStages);
+        t = 1;
+    }
+
+    Biquad* stage = m_stageArray;
+    const Biquad* targetStage = target.m_stageArray;
+    for (int i = m_numStages; --i >= 0; ++stage, ++targetStage)
+        stage->interpolateTowards(*targetStage, t);
+}
+
 }
 
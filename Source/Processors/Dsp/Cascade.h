@@ -117,6 +117,11 @@ public:
 
     std::vector<PoleZeroPair> getPoleZeros() const;
 
+    // Move every stage a fraction t of the way towards the matching
+    // stage of target. If the number of stages differs the target
+    // coefficients are copied as-is.
+    void interpolateTowards(const Cascade& target, double t);
+
     // Process a block of samples in the given form
     template <class StateType, typename Sample>
     void process(int numSamples, Sample* dest, StateType& state) const
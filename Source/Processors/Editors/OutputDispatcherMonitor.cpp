@@ -0,0 +1,72 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2016 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "OutputDispatcherMonitor.h"
+#include "../Serial/OutputDispatcher.h"
+
+OutputDispatcherMonitor::OutputDispatcherMonitor(OutputDispatcher* dispatcher_)
+    : dispatcher(dispatcher_), queueDepth(0), maxQueueDepth(0),
+      meanLatency(0), maxLatency(0), numDropped(0)
+{
+    setTooltip("Output queue depth (maximum) and time from queueing a command to the device sending it, mean (maximum)");
+    startTimer(250);
+}
+
+OutputDispatcherMonitor::~OutputDispatcherMonitor()
+{
+}
+
+void OutputDispatcherMonitor::timerCallback()
+{
+    const int newQueueDepth = dispatcher->getQueueDepth();
+    const int newMaxQueueDepth = dispatcher->getMaxQueueDepth();
+    const int newMeanLatency = roundToInt(dispatcher->getMeanSendLatency());
+    const int newMaxLatency = roundToInt(dispatcher->getMaxSendLatency());
+    const int newNumDropped = dispatcher->getNumDropped();
+
+    if (newQueueDepth != queueDepth || newMaxQueueDepth != maxQueueDepth
+        || newMeanLatency != meanLatency || newMaxLatency != maxLatency
+        || newNumDropped != numDropped)
+    {
+        queueDepth = newQueueDepth;
+        maxQueueDepth = newMaxQueueDepth;
+        meanLatency = newMeanLatency;
+        maxLatency = newMaxLatency;
+        numDropped = newNumDropped;
+
+        repaint();
+    }
+}
+
+void OutputDispatcherMonitor::paint(Graphics& g)
+{
+    const int lineHeight = getHeight() / 2;
+
+    g.setFont(Font("Small Text", 9, Font::plain));
+    g.setColour(numDropped > 0 ? Colours::darkred : Colours::darkgrey);
+
+    g.drawText("q " + String(queueDepth) + " (" + String(maxQueueDepth) + ")",
+               0, 0, getWidth(), lineHeight, Justification::left, false);
+    g.drawText(String(meanLatency) + " (" + String(maxLatency) + ") us",
+               0, lineHeight, getWidth(), lineHeight, Justification::left, false);
+}
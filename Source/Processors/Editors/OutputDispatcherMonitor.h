@@ -1,57 +1,65 @@
-/*
-    ------------------------------------------------------------------
-
-    This file is part of the Open Ephys GUI
-    Copyright (C) 2014 Open Ephys
-
-    ------------------------------------------------------------------
-
-    This program is free software: you can redistribute it and/or modify
-    it under the terms of the GNU General Public License as published by
-    the Free Software Foundation, either version 3 of the License, or
-    (at your option) any later version.
-
-    This program is distributed in the hope that it will be useful,
-    but WITHOUT ANY WARRANTY; without even the implied warranty of
-    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-    GNU General Public License for more details.
-
-    You should have received a copy of the GNU General Public License
-    along with this program.  If not, see <http://www.gnu.org/licenses/>.
-
-*/
-
-#ifndef __RESAMPLINGNODEEDITOR_H_B7FD956A__
-#define __RESAMPLINGNODEEDITOR_H_B7FD956A__
-
-
-#include "../../../JuceLibraryCode/JuceHeader.h"
-#include "../Editors/GenericEditor.h"
-
-/**
-
-  User interface for the ResamplingNode processor.
-
-  @see ResamplingNode
-
-*/
-
-class ResamplingNodeEditor : public GenericEditor
-{
-public:
-    ResamplingNodeEditor(GenericProcessor* parentNode, bool useDefaultParameterEditors);
-    virtual ~ResamplingNodeEditor();
-
-    // void startAcquisition();
-    //void stopAcquisition();
-
-private:
-
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ResamplingNodeEditor);
-
-};
-
-
-
-
-#endif  // __RESAMPLINGNODEEDITOR_H_B7FD956A__
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2016 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef OUTPUTDISPATCHERMONITOR_H_INCLUDED
+#define OUTPUTDISPATCHERMONITOR_H_INCLUDED
+
+#include "../../../JuceLibraryCode/JuceHeader.h"
+#include "../PluginManager/OpenEphysPlugin.h"
+
+class OutputDispatcher;
+
+/**
+
+  Small readout of an OutputDispatcher's queue depth and send latency, for
+  the editors of output processors. Refreshes itself a few times per second.
+
+  @see OutputDispatcher
+
+*/
+
+class PLUGIN_API OutputDispatcherMonitor : public Component,
+    public SettableTooltipClient,
+    private Timer
+{
+public:
+    OutputDispatcherMonitor(OutputDispatcher* dispatcher);
+    ~OutputDispatcherMonitor();
+
+    void paint(Graphics& g);
+
+private:
+    void timerCallback();
+
+    OutputDispatcher* dispatcher;
+
+    int queueDepth;
+    int maxQueueDepth;
+    int meanLatency;
+    int maxLatency;
+    int numDropped;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OutputDispatcherMonitor);
+};
+
+#endif  // OUTPUTDISPATCHERMONITOR_H_INCLUDED
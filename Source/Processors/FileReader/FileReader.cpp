@@ -44,10 +44,9 @@ FileReader::FileReader()
     const int numFileSources = AccessClass::getPluginManager()->getNumFileSources();
     for (int i = 0; i < numFileSources; ++i)
     {
-        Plugin::FileSourceInfo info = AccessClass::getPluginManager()->getFileSourceInfo (i);
-
+        // from the metadata, so the libraries are only loaded when a file is opened
         StringArray extensions;
-        extensions.addTokens (info.extensions, ";", "\"");
+        extensions.addTokens (AccessClass::getPluginManager()->getFileSourceExtensions (i), ";", "\"");
 
         const int numExtensions = extensions.size();
         for (int j = 0; j < numExtensions; ++j)
@@ -154,6 +153,13 @@ bool FileReader::setFile (String fullpath)
     {
         const int index = supportedExtensions[ext] - 1;
         Plugin::FileSourceInfo sourceInfo = AccessClass::getPluginManager()->getFileSourceInfo (index);
+
+        if (sourceInfo.creator == nullptr)
+        {
+            CoreServices::sendStatusMessage ("Could not load the plugin for this file type");
+            return false;
+        }
+
         input = sourceInfo.creator();
     }
     else
@@ -262,10 +268,7 @@ void FileReader::process (AudioSampleBuffer& buffer, MidiBuffer& events)
         samplesRead += samplesToRead;
     }
 
-    for (int i = 0; i < currentNumChannels; ++i)
-    {
-        input->processChannelData (readBuffer, buffer.getWritePointer (i, 0), i, samplesNeeded);
-    }
+    input->processData (readBuffer, buffer.getArrayOfWritePointers(), currentNumChannels, samplesNeeded);
 
     timestamp += samplesNeeded;
     setNumSamples (events, samplesNeeded);
@@ -104,6 +104,13 @@ RecordedChannelInfo FileSource::getChannelInfo (int channel) const
 }
 
 
+void FileSource::processData (int16* inBuffer, float* const* outBuffers, int numChannels, int64 numSamples)
+{
+    for (int i = 0; i < numChannels; ++i)
+        processChannelData (inBuffer, outBuffers[i], i, numSamples);
+}
+
+
 void FileSource::setActiveRecord (int index)
 {
     activeRecord = index;
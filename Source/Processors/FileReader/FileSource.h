@@ -26,6 +26,7 @@
 
 #include "../../../JuceLibraryCode/JuceHeader.h"
 #include "../PluginManager/OpenEphysPlugin.h"
+#include "../RecordNode/SampleConversion.h"
 
 
 struct RecordedChannelInfo
@@ -65,6 +66,13 @@ public:
 
     virtual int readData (int16* buffer, int nSamples) = 0;
     virtual void processChannelData (int16* inBuffer, float* outBuffer, int channel, int64 numSamples) = 0;
+
+    /** Converts a block read with readData into float channels. The default
+        implementation calls processChannelData for each channel; sources that
+        store interleaved int16 can convert all channels in one pass instead
+        (see SampleConversion::deinterleaveInt16ToFloat).
+    */
+    virtual void processData (int16* inBuffer, float* const* outBuffers, int numChannels, int64 numSamples);
     virtual void seekTo (int64 sample) = 0;
 
 	virtual bool isReady();
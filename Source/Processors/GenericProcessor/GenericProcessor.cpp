@@ -27,10 +27,16 @@
 
 #include <exception>
 
+/** Written past the valid samples of each channel in debug builds, to catch
+    processors that touch them. */
+#define INVALID_SAMPLE_MARKER -1.0e30f
+
 GenericProcessor::GenericProcessor(const String& name_) :
     sourceNode(0), destNode(0), isEnabled(true), wasConnected(false),
     nextAvailableChannel(0), saveOrder(-1), loadOrder(-1), currentChannel(-1),
     editor(0), parametersAsXml(nullptr), sendSampleCount(true), name(name_),
+    channelNumSamplesSize(0), numChannelNumSamples(0), numValidSamples(0), validSamplesBuffer(1, 0),
+    reportedInvalidSampleWrite(false),
     paramsWereLoaded(false), needsToSendTimestampMessage(false), timestampSet(false)
 {
     settings.numInputs = settings.numOutputs = settings.sampleRate = 0;
@@ -453,6 +459,13 @@ void GenericProcessor::update()
 
     updateSettings(); // allow processors to change custom settings
 
+    // sample counts are cached per channel on the audio thread, so size the
+    // cache here rather than there
+    channelNumSamplesSize = jmax(1, channels.size());
+    channelNumSamples.calloc(channelNumSamplesSize);
+    numChannelNumSamples = 0;
+    reportedInvalidSampleWrite = false;
+
     // required for the ProcessorGraph to know the
     // details of this processor:
     setPlayConfigDetails(getNumInputs(),  // numIns
@@ -522,6 +535,10 @@ void GenericProcessor::disableEditor()
 /** Used to get the number of samples in a given buffer, for a given channel. */
 int GenericProcessor::getNumSamples(int channelNum)
 {
+    // looked up once per block by processBlock()
+    if (channelNum >= 0 && channelNum < numChannelNumSamples)
+        return channelNumSamples[channelNum];
+
     int sourceNodeId, nSamples;
 
     if (channelNum >= 0 && channelNum < channels.size())
@@ -546,6 +563,87 @@ int GenericProcessor::getNumSamples(int channelNum)
 }
 
 
+int GenericProcessor::getNumValidSamples() const
+{
+    return numValidSamples;
+}
+
+void GenericProcessor::updateValidSamples(int blockSize)
+{
+    const int numChannels = channels.size();
+
+    if (numChannels == 0 || numChannels > channelNumSamplesSize)
+    {
+        numChannelNumSamples = 0;
+        numValidSamples = blockSize;
+        return;
+    }
+
+    // most processors see one or two sources, so remember the last lookup
+    int lastSourceNodeId = -1;
+    int lastNumSamples = 0;
+    int maxNumSamples = 0;
+
+    for (int i = 0; i < numChannels; i++)
+    {
+        const int sourceNodeId = channels.getUnchecked(i)->sourceNodeId;
+
+        if (sourceNodeId != lastSourceNodeId)
+        {
+            std::map<uint8, int>::const_iterator it = numSamples.find(uint8(sourceNodeId));
+            lastNumSamples = (it != numSamples.end()) ? jlimit(0, blockSize, it->second) : 0;
+            lastSourceNodeId = sourceNodeId;
+        }
+
+        channelNumSamples[i] = lastNumSamples;
+        maxNumSamples = jmax(maxNumSamples, lastNumSamples);
+    }
+
+    numChannelNumSamples = numChannels;
+    numValidSamples = maxNumSamples;
+}
+
+void GenericProcessor::fillInvalidSamples(AudioSampleBuffer& buffer)
+{
+    // only channels the processor owns; inputs of sinks may be shared
+    const int numChannels = jmin(numChannelNumSamples, buffer.getNumChannels(), getNumOutputChannels());
+
+    for (int i = 0; i < numChannels; i++)
+    {
+        const int numInvalid = buffer.getNumSamples() - channelNumSamples[i];
+
+        if (numInvalid > 0)
+            FloatVectorOperations::fill(buffer.getWritePointer(i, channelNumSamples[i]),
+                                        INVALID_SAMPLE_MARKER, numInvalid);
+    }
+}
+
+void GenericProcessor::checkInvalidSamples(AudioSampleBuffer& buffer)
+{
+    if (reportedInvalidSampleWrite)
+        return;
+
+    const int numChannels = jmin(numChannelNumSamples, buffer.getNumChannels(), getNumOutputChannels());
+
+    for (int i = 0; i < numChannels; i++)
+    {
+        const float* data = buffer.getReadPointer(i);
+
+        for (int n = channelNumSamples[i]; n < buffer.getNumSamples(); n++)
+        {
+            if (data[n] != INVALID_SAMPLE_MARKER)
+            {
+                std::cout << getName() << " (" << nodeId << ") wrote past the " << channelNumSamples[i]
+                          << " valid samples of channel " << i << std::endl;
+
+                reportedInvalidSampleWrite = true;
+                jassertfalse;
+                return;
+            }
+        }
+    }
+}
+
 /** Used to get the number of samples in a given buffer, for a given source node. */
 void GenericProcessor::setNumSamples(MidiBuffer& events, int sampleIndex)
 {
@@ -623,17 +721,17 @@ void GenericProcessor::setTimestamp(MidiBuffer& events, int64 timestamp)
 
     if (needsToSendTimestampMessage)
     {
-        String eventString = "Processor: " + String(getNodeId()) + " start time: " + String(timestamp) + "@" + String(getSampleRate()) + "Hz";
-
-        CharPointer_UTF8 data = eventString.toUTF8();
+        char eventString[96];
+        int length = snprintf(eventString, sizeof(eventString), "Processor: %d start time: %lld@%gHz",
+                              getNodeId(), (long long) timestamp, double(getSampleRate()));
 
         addEvent(events,
                  MESSAGE,
                  0,
                  0,
                  0,
-                 data.sizeInBytes(), //It doesn't hurt to send the end-string null and can help avoid issues
-                 (uint8*)data.getAddress(),
+                 length + 1, //It doesn't hurt to send the end-string null and can help avoid issues
+                 (uint8*) eventString,
                  true);
 
         needsToSendTimestampMessage = false;
@@ -769,8 +867,8 @@ void GenericProcessor::addEvent(MidiBuffer& eventBuffer,
     if (!isTimestamp && !timestampSet && !isSource() && !generatesTimestamps())
         setTimestamp(eventBuffer, getTimestamp(0));
 
-	HeapBlock<uint8> data(static_cast<const size_t>(6 + numBytes));
-    //uint8* data = new uint8[6+numBytes];
+    // numBytes is a uint8, so the whole event always fits on the stack
+    uint8 data[6 + 255];
 
     data[0] = type;    // event type
     data[1] = nodeId;  // processor ID automatically added
@@ -809,7 +907,29 @@ void GenericProcessor::processBlock(AudioSampleBuffer& buffer, MidiBuffer& event
 
     timestampSet = false;
 
-    process(buffer, eventBuffer);
+    updateValidSamples(buffer.getNumSamples());
+
+    if (processesWholeBuffer() || numChannelNumSamples == 0)
+    {
+        process(buffer, eventBuffer);
+        return;
+    }
+
+    // the graph allocates blocks at the audio device's size, but a source
+    // rarely fills them; only hand over the samples that hold data
+    validSamplesBuffer.setDataToReferTo(buffer.getArrayOfWritePointers(),
+                                        buffer.getNumChannels(),
+                                        numValidSamples);
+
+#if JUCE_DEBUG
+    fillInvalidSamples(buffer);
+#endif
+
+    process(validSamplesBuffer, eventBuffer);
+
+#if JUCE_DEBUG
+    checkInvalidSamples(buffer);
+#endif
 
 }
 
@@ -1208,6 +1328,11 @@ bool GenericProcessor::isSink()
     return false;
 }
 
+bool GenericProcessor::processesWholeBuffer()
+{
+    return isSource();
+}
+
 bool GenericProcessor::isSplitter()
 {
     return false;
@@ -29,7 +29,7 @@ enum ChannelType {HEADSTAGE_CHANNEL = 0, AUX_CHANNEL = 1, ADC_CHANNEL = 2, EVENT
                  };
 
 //defines which events are writable to files
-#define isWritableEvent(ev) (((int)(ev) == GenericProcessor::TTL) || ((int)(ev) == GenericProcessor::MESSAGE) || ((int)(ev) == GenericProcessor::BINARY_MSG))
+#define isWritableEvent(ev) (((int)(ev) == GenericProcessor::TTL) || ((int)(ev) == GenericProcessor::MESSAGE) || ((int)(ev) == GenericProcessor::BINARY_MSG) || ((int)(ev) == GenericProcessor::TIMESTAMP_GAP))
 
 #include "../../../JuceLibraryCode/JuceHeader.h"
 #include "../Editors/GenericEditor.h"
@@ -287,6 +287,12 @@ public:
     /** Returns true if a processor is a sink, false otherwise.*/
     virtual bool isSink();
 
+    /** Returns true if process() should get the whole block the graph allocated
+        (at the audio device's block size) rather than just its valid samples.
+        True for sources, which decide how many samples to produce; processors
+        that change the number of samples should return true as well.*/
+    virtual bool processesWholeBuffer();
+
     /** Returns true if a processor is a splitter, false otherwise.*/
     virtual bool isSplitter();
 
@@ -375,7 +381,8 @@ public:
         TTL = 3,
         SPIKE = 4,
         MESSAGE = 5,
-        BINARY_MSG = 6
+        BINARY_MSG = 6,
+        TIMESTAMP_GAP = 7
     };
 
     /** Variable used to orchestrate saving the ProcessorGraph. */
@@ -479,6 +486,28 @@ public:
     /** Used to get the number of samples in a given buffer, for a given channel. */
     int getNumSamples(int channelNumber);
 
+    /** Returns the largest number of valid samples across this processor's
+        channels in the current block. Unless processesWholeBuffer() is true, the
+        buffer handed to process() is exactly this long; channels whose source
+        delivered fewer samples still need to check getNumSamples(). */
+    int getNumValidSamples() const;
+
+    /** Calls function(channel, samples, numSamples) for every channel of the buffer
+        handed to process(), with only the samples of that channel that hold data.
+        Processors that work on each channel on its own should use this instead of
+        looping up to buffer.getNumSamples(). */
+    template <typename Function>
+    void forEachValidRange(AudioSampleBuffer& buffer, Function function)
+    {
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        {
+            const int numSamples = jmin(getNumSamples(channel), buffer.getNumSamples());
+
+            if (numSamples > 0)
+                function(channel, buffer.getWritePointer(channel), numSamples);
+        }
+    }
+
     /** Used to get the number of samples in a given buffer, for a given source node. */
     void setNumSamples(MidiBuffer&, int numSamples);
 
@@ -507,6 +536,25 @@ private:
     /** Extracts sample counts and timestamps from the MidiBuffer. */
     int processEventBuffer(MidiBuffer&);
 
+    /** Looks up the number of valid samples of every channel once per block. */
+    void updateValidSamples(int blockSize);
+
+    /** In debug builds, fills the samples past each channel's valid range with
+        a marker before process() and complains if process() changed them. */
+    void fillInvalidSamples(AudioSampleBuffer& buffer);
+    void checkInvalidSamples(AudioSampleBuffer& buffer);
+
+    /** Valid samples per channel for the current block, and their maximum. */
+    HeapBlock<int> channelNumSamples;
+    int channelNumSamplesSize;
+    int numChannelNumSamples;
+    int numValidSamples;
+
+    /** The part of the graph's buffer handed to process(). */
+    AudioSampleBuffer validSamplesBuffer;
+
+    bool reportedInvalidSampleWrite;
+
     /** For getInputChannelName() and getOutputChannelName() */
     static const String unusedNameString;
 
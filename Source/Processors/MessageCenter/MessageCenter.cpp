@@ -29,9 +29,10 @@
 //---------------------------------------------------------------------
 
 MessageCenter::MessageCenter() :
-    GenericProcessor("Message Center"), newEventAvailable(false), isRecording(false), sourceNodeId(0), 
-	timestampSource(nullptr), lastTime(0), softTimestamp(0)
+    GenericProcessor("Message Center"), messageFifo(17), isRecording(false), sourceNodeId(0), 
+	timestampSource(nullptr), lastTime(0), softTimestamp(0), needsToSendTimestampMessage(false)
 {
+    messageSlots.calloc(messageFifo.getTotalSize());
 
     setPlayConfigDetails(0, // number of inputs
                          0, // number of outputs
@@ -61,8 +62,7 @@ void MessageCenter::setParameter(int parameterIndex, float newValue)
 {
     if (isRecording)
     {
-        newEventAvailable = true;
-        messageCenterEditor->messageReceived(true);
+        messageCenterEditor->messageReceived(queueMessage(messageCenterEditor->getLabelString()));
     }
     else
     {
@@ -112,6 +112,24 @@ int MessageCenter::getSourceNodeId()
     return sourceNodeId;
 }
 
+bool MessageCenter::queueMessage(const String& text)
+{
+    int start1, size1, start2, size2;
+    messageFifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    if (size1 == 0)
+        return false;
+
+    MessageSlot& slot = messageSlots[start1];
+
+    // the terminating null is sent too, as before; longer text is truncated
+    slot.length = int(text.copyToUTF8((CharPointer_UTF8::CharType*) slot.data, sizeof(slot.data)));
+
+    messageFifo.finishedWrite(1);
+
+    return true;
+}
+
 int64 MessageCenter::getTimestamp(bool softwareTime)
 {
     if (!softwareTime && sourceNodeId > 0)
@@ -120,45 +138,51 @@ int64 MessageCenter::getTimestamp(bool softwareTime)
         return (softTimestamp);
 }
 
+int64 MessageCenter::getSoftwareTimestampForTicks(int64 ticks)
+{
+    return ticks - lastTime;
+}
+
 void MessageCenter::process(AudioSampleBuffer& buffer, MidiBuffer& eventBuffer)
 {
 	softTimestamp = Time::getHighResolutionTicks() - lastTime;
     setTimestamp(eventBuffer,getTimestamp());
     if (needsToSendTimestampMessage)
     {
-        String eventString = "Software time: " + String(getTimestamp(true)) + "@" + String(Time::getHighResolutionTicksPerSecond()) + "Hz";
-        CharPointer_UTF8 data = eventString.toUTF8();
+        char eventString[64];
+        int length = snprintf(eventString, sizeof(eventString), "Software time: %lld@%lldHz",
+                              (long long) getTimestamp(true), (long long) Time::getHighResolutionTicksPerSecond());
 
         addEvent(eventBuffer,
                  MESSAGE,
                  0,
                  0,
                  0,
-                 data.sizeInBytes(), //It doesn't hurt to send the end-string null and can help avoid issues
-                 (uint8*)data.getAddress());
+                 length + 1, //It doesn't hurt to send the end-string null and can help avoid issues
+                 (uint8*) eventString);
 
         needsToSendTimestampMessage = false;
     }
 
-    if (newEventAvailable)
-    {
-        //int numBytes = 0;
-
-        String eventString = messageCenterEditor->getLabelString();
+    // send the messages queued by the editor, straight from their slots
+    int start1, size1, start2, size2;
+    messageFifo.prepareToRead(messageFifo.getNumReady(), start1, size1, start2, size2);
 
-        CharPointer_UTF8 data = eventString.toUTF8();
+    for (int i = 0; i < size1 + size2; i++)
+    {
+        MessageSlot& slot = messageSlots[i < size1 ? start1 + i : start2 + i - size1];
 
         addEvent(eventBuffer,
                  MESSAGE,
                  0,
                  0,
                  0,
-                 data.sizeInBytes(), //It doesn't hurt to send the end-string null and can help avoid issues
-                 (uint8*) data.getAddress());
-
-        newEventAvailable = false;
+                 slot.length,
+                 slot.data);
     }
 
+    messageFifo.finishedRead(size1 + size2);
+
 
 }
 
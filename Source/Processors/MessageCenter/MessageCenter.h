@@ -82,9 +82,26 @@ public:
     void removeSourceProcessor(GenericProcessor* p);
 
     int64 getTimestamp(bool softwareTime = false);
+
+    /** Converts a Time::getHighResolutionTicks() value to the software timestamp
+    clock, which counts ticks since the start of acquisition. */
+    int64 getSoftwareTimestampForTicks(int64 ticks);
 private:
 
-    bool newEventAvailable;
+    /** A message typed by the user, waiting to be sent by the audio thread. */
+    struct MessageSlot
+    {
+        int length;
+        uint8 data[255];
+    };
+
+    /** Hands the text over to the audio thread. Returns false if every slot is in use. */
+    bool queueMessage(const String& text);
+
+    /** Queues up to 16 messages; an AbstractFifo holds one item less than its size. */
+    AbstractFifo messageFifo;
+    HeapBlock<MessageSlot> messageSlots;
+
     bool isRecording;
     int sourceNodeId;
     GenericProcessor* timestampSource;
@@ -175,6 +175,11 @@ int64 MessageCenterEditor::getTimestamp(bool softwareTimestamp)
     return messageCenter->getTimestamp(softwareTimestamp);
 }
 
+int64 MessageCenterEditor::getSoftwareTimestampForTicks(int64 ticks)
+{
+    return messageCenter->getSoftwareTimestampForTicks(ticks);
+}
+
 void MessageCenterEditor::actionListenerCallback(const String& message)
 {
 
@@ -74,6 +74,8 @@ public:
 
     int64 getTimestamp(bool softwareTimestamp = false);
 
+    int64 getSoftwareTimestampForTicks(int64 ticks);
+
 private:
 
     void buttonClicked(Button* button);
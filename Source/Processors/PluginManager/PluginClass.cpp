@@ -48,29 +48,11 @@ void PluginClass::setPluginData(Plugin::PluginType type, int index)
 	switch (type)
 	{
 	case Plugin::ProcessorPlugin:
-	{
-		Plugin::ProcessorInfo i = pm->getProcessorInfo(index);
-		name = i.name;
-	}
-	break;
 	case Plugin::RecordEnginePlugin:
-	{
-		Plugin::RecordEngineInfo i = pm->getRecordEngineInfo(index);
-		name = i.name;
-	}
-	break;
 	case Plugin::DatathreadPlugin:
-	{
-		Plugin::DataThreadInfo i = pm->getDataThreadInfo(index);
-		name = i.name;
-	}
-	break;
 	case Plugin::FileSourcePlugin:
-	{
-		Plugin::FileSourceInfo i = pm->getFileSourceInfo(index);
-		name = i.name;
-	}
-	break;
+		name = pm->getPluginName(type, index);
+		break;
 	case Plugin::NotAPlugin:
 	{
 		String pName;
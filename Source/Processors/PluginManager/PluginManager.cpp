@@ -70,7 +70,88 @@ static void errorMsg(const char *file, int line, const char *msg) {
 #define ERROR_MSG(msg) errorMsg(__FILE__, __LINE__, msg)
 
 
-PluginManager::PluginManager()
+// Opens a library and finds its two entry points; closes it again on failure
+static bool openLibrary(const String& pluginLoc, decltype(LoadedLibInfo::handle)& handle,
+                        LibraryInfoFunction& infoFunction, PluginInfoFunction& piFunction)
+{
+	/*
+	Load in the selected processor. This takes the
+	dynamic object (.so) and copies it into RAM
+	Dynamic linker requires a C-style string, so we
+	we have to convert first.
+	*/
+	const char* processorLocCString = static_cast<const char*>(pluginLoc.toUTF8());
+
+#ifdef WIN32
+	handle = LoadLibrary(processorLocCString);
+#elif defined(__APPLE__)
+    CFURLRef bundleURL = CFURLCreateFromFileSystemRepresentation(kCFAllocatorDefault,
+                                                                 reinterpret_cast<const UInt8 *>(processorLocCString),
+                                                                 strlen(processorLocCString),
+                                                                 true);
+    assert(bundleURL);
+    handle = CFBundleCreate(kCFAllocatorDefault, bundleURL);
+    CFRelease(bundleURL);
+#else
+	// Clear errors
+	dlerror();
+
+	/*
+	Changing this to resolve all variables immediately upon loading.
+	This will provide for quicker testing of the custom
+	processor stability and to ensure that it doesn't crash due
+	to memory mishaps.
+	*/
+	handle = dlopen(processorLocCString,RTLD_GLOBAL|RTLD_NOW);
+#endif
+
+	if (!handle) {
+		ERROR_MSG("Failed to load plugin DLL");
+		closeHandle(handle);
+		return false;
+	}
+
+	infoFunction = 0;
+#ifdef WIN32
+	infoFunction = (LibraryInfoFunction)GetProcAddress(handle, "getLibInfo");
+#elif defined(__APPLE__)
+    infoFunction = (LibraryInfoFunction)CFBundleGetFunctionPointerForName(handle, CFSTR("getLibInfo"));
+#else
+    dlerror();
+	infoFunction = (LibraryInfoFunction)(dlsym(handle, "getLibInfo"));
+#endif
+
+	if (!infoFunction)
+	{
+		ERROR_MSG("Failed to load function 'getLibInfo'");
+		closeHandle(handle);
+		handle = 0;
+		return false;
+	}
+
+	piFunction = 0;
+#ifdef WIN32
+	piFunction = (PluginInfoFunction)GetProcAddress(handle, "getPluginInfo");
+#elif defined(__APPLE__)
+    piFunction = (PluginInfoFunction)CFBundleGetFunctionPointerForName(handle, CFSTR("getPluginInfo"));
+#else
+    dlerror();
+	piFunction = (PluginInfoFunction)(dlsym(handle, "getPluginInfo"));
+#endif
+
+	if (!piFunction)
+	{
+        ERROR_MSG("Failed to load function 'getPluginInfo'");
+		closeHandle(handle);
+		handle = 0;
+		return false;
+	}
+
+	return true;
+}
+
+
+PluginManager::PluginManager() : cacheChanged(false)
 {
 }
 
@@ -90,6 +171,8 @@ void PluginManager::loadAllPlugins()
 	paths.add(File::getSpecialLocation(File::currentApplicationFile).getParentDirectory().getChildFile("plugins"));
 #endif
 
+    readCache();
+
     for (auto &pluginPath : paths) {
         if (!pluginPath.isDirectory()) {
             std::cout << "Plugin path not found: " << pluginPath.getFullPathName() << std::endl;
@@ -97,6 +180,8 @@ void PluginManager::loadAllPlugins()
             loadPlugins(pluginPath);
         }
     }
+
+    writeCache();
 }
 
 void PluginManager::loadPlugins(const File &pluginPath) {
@@ -118,6 +203,26 @@ void PluginManager::loadPlugins(const File &pluginPath) {
 
 	for (int i = 0; i < foundDLLs.size(); i++)
 	{
+		const XmlElement* cached = nullptr;
+
+		if (pluginCache != nullptr)
+		{
+			forEachXmlChildElementWithTagName(*pluginCache, libXml, "LIBRARY")
+			{
+				if (libXml->getStringAttribute("path") == foundDLLs[i].getFullPathName())
+				{
+					cached = libXml;
+					break;
+				}
+			}
+		}
+
+		if (addCachedLibrary(foundDLLs[i], cached))
+		{
+			std::cout << "Found Plugin: " << foundDLLs[i].getFileNameWithoutExtension() << " (cached)" << std::endl;
+			continue;
+		}
+
 		std::cout << "Loading Plugin: " << foundDLLs[i].getFileNameWithoutExtension() << "... " << std::flush;
 		int res = loadPlugin(foundDLLs[i].getFullPathName());
 		if (res < 0)
@@ -140,61 +245,13 @@ void PluginManager::loadPlugins(const File &pluginPath) {
  */
 
 int PluginManager::loadPlugin(const String& pluginLoc) {
-	/*
-	Load in the selected processor. This takes the
-	dynamic object (.so) and copies it into RAM
-	Dynamic linker requires a C-style string, so we
-	we have to convert first.
-	*/
-	const char* processorLocCString = static_cast<const char*>(pluginLoc.toUTF8());
 
-#ifdef WIN32
-	HINSTANCE handle;
-	handle = LoadLibrary(processorLocCString);
-#elif defined(__APPLE__)
-    CFURLRef bundleURL = CFURLCreateFromFileSystemRepresentation(kCFAllocatorDefault,
-                                                                 reinterpret_cast<const UInt8 *>(processorLocCString),
-                                                                 strlen(processorLocCString),
-                                                                 true);
-    assert(bundleURL);
-    CFBundleRef handle = CFBundleCreate(kCFAllocatorDefault, bundleURL);
-    CFRelease(bundleURL);
-#else
-	// Clear errors
-	dlerror();
+	decltype(LoadedLibInfo::handle) handle = 0;
+	LibraryInfoFunction infoFunction;
+	PluginInfoFunction piFunction;
 
-	/*
-	Changing this to resolve all variables immediately upon loading.
-	This will provide for quicker testing of the custom
-	processor stability and to ensure that it doesn't crash due
-	to memory mishaps.
-	*/
-	void *handle = 0;
-	handle = dlopen(processorLocCString,RTLD_GLOBAL|RTLD_NOW);
-#endif
-
-	if (!handle) {
-		ERROR_MSG("Failed to load plugin DLL");
-		closeHandle(handle);
+	if (!openLibrary(pluginLoc, handle, infoFunction, piFunction))
 		return -1;
-	}
-
-	LibraryInfoFunction infoFunction = 0;
-#ifdef WIN32
-	infoFunction = (LibraryInfoFunction)GetProcAddress(handle, "getLibInfo");
-#elif defined(__APPLE__)
-    infoFunction = (LibraryInfoFunction)CFBundleGetFunctionPointerForName(handle, CFSTR("getLibInfo"));
-#else
-    dlerror();
-	infoFunction = (LibraryInfoFunction)(dlsym(handle, "getLibInfo"));
-#endif
-
-	if (!infoFunction)
-	{
-		ERROR_MSG("Failed to load function 'getLibInfo'");
-		closeHandle(handle);
-		return -1;
-	}
 
 	Plugin::LibraryInfo libInfo;
 	infoFunction(&libInfo);
@@ -206,85 +263,338 @@ int PluginManager::loadPlugin(const String& pluginLoc) {
 		return -1;
 	}
 
-	PluginInfoFunction piFunction = 0;
-#ifdef WIN32
-	piFunction = (PluginInfoFunction)GetProcAddress(handle, "getPluginInfo");
-#elif defined(__APPLE__)
-    piFunction = (PluginInfoFunction)CFBundleGetFunctionPointerForName(handle, CFSTR("getPluginInfo"));
-#else
-    dlerror();
-	piFunction = (PluginInfoFunction)(dlsym(handle, "getPluginInfo"));
-#endif
-
-	if (!piFunction)
-	{
-        ERROR_MSG("Failed to load function 'getPluginInfo'");
-		closeHandle(handle);
-		return -1;
-	}
+	const File libFile(pluginLoc);
 
-	LoadedLibInfo lib;
+	LoadedLibInfo& lib = *libArray.add(new LoadedLibInfo());
 	lib.apiVersion = libInfo.apiVersion;
-	lib.name = libInfo.name;
+	lib.nameString = libInfo.name;
+	lib.name = lib.nameString.toRawUTF8();
 	lib.libVersion = libInfo.libVersion;
 	lib.numPlugins = libInfo.numPlugins;
 	lib.handle = handle;
+	lib.path = pluginLoc;
+	lib.fileSize = libFile.getSize();
+	lib.modificationTime = libFile.getLastModificationTime().toMilliseconds();
+	lib.loaded = true;
+
+	const int libIndex = libArray.size() - 1;
 
-	libArray.add(lib);
+	// remember the metadata for next time
+	XmlElement* libXml = new XmlElement("LIBRARY");
+	libXml->setAttribute("path", lib.path);
+	libXml->setAttribute("size", String(lib.fileSize));
+	libXml->setAttribute("modified", String(lib.modificationTime));
+	libXml->setAttribute("name", lib.nameString);
+	libXml->setAttribute("version", lib.libVersion);
 
 	Plugin::PluginInfo pInfo;
 	for (int i = 0; i < lib.numPlugins; i++)
 	{
 		if (piFunction(i, &pInfo)) //if somehow there are less plugins than stated, stop adding
 			break;
+
+		addPluginInfo(libIndex, i, pInfo);
+
+		XmlElement* pluginXml = libXml->createNewChildElement("PLUGIN");
+		pluginXml->setAttribute("index", i);
+		pluginXml->setAttribute("type", int(pInfo.type));
+
 		switch (pInfo.type)
 		{
 		case Plugin::ProcessorPlugin:
-		{
-			LoadedPluginInfo<Plugin::ProcessorInfo> info;
-			info.creator = pInfo.processor.creator;
-			info.name = pInfo.processor.name;
-			info.type = pInfo.processor.type;
-			info.libIndex = libArray.size()-1;
-			processorPlugins.add(info);
+			pluginXml->setAttribute("name", pInfo.processor.name);
+			pluginXml->setAttribute("processorType", int(pInfo.processor.type));
 			break;
-		}
 		case Plugin::RecordEnginePlugin:
-		{
-			LoadedPluginInfo<Plugin::RecordEngineInfo> info;
-			info.creator = pInfo.recordEngine.creator;
-			info.name = pInfo.recordEngine.name;
-			info.libIndex = libArray.size();
-			recordEnginePlugins.add(info);
+			pluginXml->setAttribute("name", pInfo.recordEngine.name);
 			break;
-		}
 		case Plugin::DatathreadPlugin:
-		{
-			LoadedPluginInfo<Plugin::DataThreadInfo> info;
-			info.creator = pInfo.dataThread.creator;
-			info.name = pInfo.dataThread.name;
-			info.libIndex = libArray.size();
-			dataThreadPlugins.add(info);
+			pluginXml->setAttribute("name", pInfo.dataThread.name);
 			break;
-		}
 		case Plugin::FileSourcePlugin:
+			pluginXml->setAttribute("name", pInfo.fileSource.name);
+			pluginXml->setAttribute("extensions", pInfo.fileSource.extensions);
+			break;
+		default:
+			break;
+		}
+	}
+
+	if (pluginCache == nullptr)
+		pluginCache = new XmlElement("PLUGINCACHE");
+
+	forEachXmlChildElementWithTagName(*pluginCache, oldXml, "LIBRARY")
+	{
+		if (oldXml->getStringAttribute("path") == lib.path)
 		{
-			LoadedPluginInfo<Plugin::FileSourceInfo> info;
-			info.creator = pInfo.fileSource.creator;
-			info.name = pInfo.fileSource.name;
-			info.extensions = pInfo.fileSource.extensions;
-			info.libIndex = libArray.size();
-			fileSourcePlugins.add(info);
+			pluginCache->removeChildElement(oldXml, true);
 			break;
 		}
+	}
+
+	pluginCache->addChildElement(libXml);
+	cacheChanged = true;
+
+	return lib.numPlugins;
+}
+
+bool PluginManager::addCachedLibrary(const File& file, const XmlElement* libXml)
+{
+	if (libXml == nullptr
+		|| libXml->getStringAttribute("size") != String(file.getSize())
+		|| libXml->getStringAttribute("modified") != String(file.getLastModificationTime().toMilliseconds()))
+		return false;
+
+	LoadedLibInfo& lib = *libArray.add(new LoadedLibInfo());
+	lib.apiVersion = PLUGIN_API_VER;
+	lib.nameString = libXml->getStringAttribute("name");
+	lib.name = lib.nameString.toRawUTF8();
+	lib.libVersion = libXml->getIntAttribute("version");
+	lib.numPlugins = libXml->getNumChildElements();
+	lib.handle = 0;
+	lib.path = file.getFullPathName();
+	lib.fileSize = file.getSize();
+	lib.modificationTime = file.getLastModificationTime().toMilliseconds();
+	lib.loaded = false;
+
+	const int libIndex = libArray.size() - 1;
+
+	// the strings are copied by addPluginInfo
+	Plugin::PluginInfo pInfo;
+	forEachXmlChildElementWithTagName(*libXml, pluginXml, "PLUGIN")
+	{
+		const String name = pluginXml->getStringAttribute("name");
+		const String extensions = pluginXml->getStringAttribute("extensions");
+
+		pInfo.type = (Plugin::PluginType) pluginXml->getIntAttribute("type", Plugin::NotAPlugin);
+
+		switch (pInfo.type)
+		{
+		case Plugin::ProcessorPlugin:
+			pInfo.processor.name = name.toRawUTF8();
+			pInfo.processor.creator = nullptr;
+			pInfo.processor.type = (Plugin::ProcessorType) pluginXml->getIntAttribute("processorType", Plugin::InvalidProcessor);
+			break;
+		case Plugin::RecordEnginePlugin:
+			pInfo.recordEngine.name = name.toRawUTF8();
+			pInfo.recordEngine.creator = nullptr;
+			break;
+		case Plugin::DatathreadPlugin:
+			pInfo.dataThread.name = name.toRawUTF8();
+			pInfo.dataThread.creator = nullptr;
+			break;
+		case Plugin::FileSourcePlugin:
+			pInfo.fileSource.name = name.toRawUTF8();
+			pInfo.fileSource.creator = nullptr;
+			pInfo.fileSource.extensions = extensions.toRawUTF8();
+			break;
 		default:
+			break;
+		}
+
+		addPluginInfo(libIndex, pluginXml->getIntAttribute("index"), pInfo);
+	}
+
+	return true;
+}
+
+void PluginManager::addPluginInfo(int libIndex, int pluginIndex, const Plugin::PluginInfo& pInfo)
+{
+	switch (pInfo.type)
+	{
+	case Plugin::ProcessorPlugin:
+	{
+		LoadedPluginInfo<Plugin::ProcessorInfo>& info = *processorPlugins.add(new LoadedPluginInfo<Plugin::ProcessorInfo>());
+		info.creator = pInfo.processor.creator;
+		info.nameString = pInfo.processor.name;
+		info.name = info.nameString.toRawUTF8();
+		info.type = pInfo.processor.type;
+		info.libIndex = libIndex;
+		info.pluginIndex = pluginIndex;
+		break;
+	}
+	case Plugin::RecordEnginePlugin:
+	{
+		LoadedPluginInfo<Plugin::RecordEngineInfo>& info = *recordEnginePlugins.add(new LoadedPluginInfo<Plugin::RecordEngineInfo>());
+		info.creator = pInfo.recordEngine.creator;
+		info.nameString = pInfo.recordEngine.name;
+		info.name = info.nameString.toRawUTF8();
+		info.libIndex = libIndex;
+		info.pluginIndex = pluginIndex;
+		break;
+	}
+	case Plugin::DatathreadPlugin:
+	{
+		LoadedPluginInfo<Plugin::DataThreadInfo>& info = *dataThreadPlugins.add(new LoadedPluginInfo<Plugin::DataThreadInfo>());
+		info.creator = pInfo.dataThread.creator;
+		info.nameString = pInfo.dataThread.name;
+		info.name = info.nameString.toRawUTF8();
+		info.libIndex = libIndex;
+		info.pluginIndex = pluginIndex;
+		break;
+	}
+	case Plugin::FileSourcePlugin:
+	{
+		LoadedPluginInfo<Plugin::FileSourceInfo>& info = *fileSourcePlugins.add(new LoadedPluginInfo<Plugin::FileSourceInfo>());
+		info.creator = pInfo.fileSource.creator;
+		info.nameString = pInfo.fileSource.name;
+		info.name = info.nameString.toRawUTF8();
+		info.extensionsString = pInfo.fileSource.extensions;
+		info.extensions = info.extensionsString.toRawUTF8();
+		info.libIndex = libIndex;
+		info.pluginIndex = pluginIndex;
+		break;
+	}
+	default:
+	{
+		std::cerr << libArray[libIndex]->path << " invalid plugin type: " << pInfo.type << std::endl;
+		break;
+	}
+	}
+}
+
+template<class T>
+static LoadedPluginInfo<T>* findLoadedPlugin(OwnedArray<LoadedPluginInfo<T>>& pluginArray, int libIndex, int pluginIndex)
+{
+	for (int i = 0; i < pluginArray.size(); i++)
+	{
+		if (pluginArray[i]->libIndex == libIndex && pluginArray[i]->pluginIndex == pluginIndex)
+			return pluginArray[i];
+	}
+	return nullptr;
+}
+
+bool PluginManager::loadLibrary(int libIndex)
+{
+	if (libIndex < 0 || libIndex >= libArray.size())
+		return false;
+
+	LoadedLibInfo& lib = *libArray[libIndex];
+
+	// only try once
+	if (lib.loaded)
+		return lib.handle != 0;
+
+	lib.loaded = true;
+
+	std::cout << "Loading Plugin: " << lib.nameString << "... " << std::flush;
+
+	decltype(LoadedLibInfo::handle) handle = 0;
+	LibraryInfoFunction infoFunction;
+	PluginInfoFunction piFunction;
+
+	if (!openLibrary(lib.path, handle, infoFunction, piFunction))
+	{
+		std::cout << " DLL Load FAILED" << std::endl;
+		return false;
+	}
+
+	Plugin::LibraryInfo libInfo;
+	infoFunction(&libInfo);
+
+	if (libInfo.apiVersion != PLUGIN_API_VER)
+	{
+		std::cerr << lib.path << " invalid version" << std::endl;
+		closeHandle(handle);
+		return false;
+	}
+
+	lib.handle = handle;
+
+	Plugin::PluginInfo pInfo;
+	for (int i = 0; i < libInfo.numPlugins; i++)
+	{
+		if (piFunction(i, &pInfo))
+			break;
+
+		switch (pInfo.type)
 		{
-			std::cerr << pluginLoc << " invalid plugin type: " << pInfo.type << std::endl;
+		case Plugin::ProcessorPlugin:
+			if (LoadedPluginInfo<Plugin::ProcessorInfo>* info = findLoadedPlugin(processorPlugins, libIndex, i))
+				info->creator = pInfo.processor.creator;
+			break;
+		case Plugin::RecordEnginePlugin:
+			if (LoadedPluginInfo<Plugin::RecordEngineInfo>* info = findLoadedPlugin(recordEnginePlugins, libIndex, i))
+				info->creator = pInfo.recordEngine.creator;
+			break;
+		case Plugin::DatathreadPlugin:
+			if (LoadedPluginInfo<Plugin::DataThreadInfo>* info = findLoadedPlugin(dataThreadPlugins, libIndex, i))
+				info->creator = pInfo.dataThread.creator;
+			break;
+		case Plugin::FileSourcePlugin:
+			if (LoadedPluginInfo<Plugin::FileSourceInfo>* info = findLoadedPlugin(fileSourcePlugins, libIndex, i))
+				info->creator = pInfo.fileSource.creator;
+			break;
+		default:
 			break;
 		}
+	}
+
+	std::cout << "Loaded with " << libInfo.numPlugins << " plugins" << std::endl;
+
+	return true;
+}
+
+File PluginManager::getCacheFile() const
+{
+	// in the user's data folder, one per install as each install has its own plugins
+#if defined(__APPLE__)
+	const File dir = File::getSpecialLocation(File::userApplicationDataDirectory).getChildFile("Application Support/open-ephys");
+#elif defined(WIN32)
+	const File dir = File::getSpecialLocation(File::userApplicationDataDirectory).getChildFile("open-ephys");
+#else
+	const File dir = File::getSpecialLocation(File::userApplicationDataDirectory).getChildFile(".open-ephys");
+#endif
+	const String installPath = File::getSpecialLocation(File::currentExecutableFile).getParentDirectory().getFullPathName();
+
+	return dir.getChildFile("pluginCache-" + String::toHexString(installPath.hashCode64()) + ".xml");
+}
+
+void PluginManager::readCache()
+{
+	pluginCache = XmlDocument::parse(getCacheFile());
+
+	if (pluginCache != nullptr
+		&& (!pluginCache->hasTagName("PLUGINCACHE") || pluginCache->getIntAttribute("apiVersion") != PLUGIN_API_VER))
+		pluginCache = nullptr;
+
+	cacheChanged = false;
+}
+
+void PluginManager::writeCache()
+{
+	if (pluginCache == nullptr)
+		return;
+
+	// forget libraries that are gone
+	for (int i = pluginCache->getNumChildElements(); --i >= 0;)
+	{
+		XmlElement* libXml = pluginCache->getChildElement(i);
+		bool found = false;
+
+		for (int j = 0; j < libArray.size() && !found; j++)
+			found = libArray[j]->path == libXml->getStringAttribute("path");
+
+		if (!found)
+		{
+			pluginCache->removeChildElement(libXml, true);
+			cacheChanged = true;
 		}
 	}
-	return lib.numPlugins;
+
+	if (!cacheChanged)
+		return;
+
+	pluginCache->setAttribute("apiVersion", PLUGIN_API_VER);
+
+	const File cacheFile = getCacheFile();
+	cacheFile.getParentDirectory().createDirectory();
+
+	// without write access we just go without the cache
+	if (!pluginCache->writeToFile(cacheFile, String::empty))
+		std::cout << "Could not write plugin cache to " << cacheFile.getFullPathName() << std::endl;
+
+	cacheChanged = false;
 }
 
 int PluginManager::getNumProcessors() const
@@ -307,60 +617,72 @@ int PluginManager::getNumFileSources() const
 	return fileSourcePlugins.size();
 }
 
-Plugin::ProcessorInfo PluginManager::getProcessorInfo(int index) const
+Plugin::ProcessorInfo PluginManager::getProcessorInfo(int index)
 {
-	if (index < processorPlugins.size())
-		return processorPlugins[index];
+	if (index >= 0 && index < processorPlugins.size())
+	{
+		loadLibrary(processorPlugins[index]->libIndex);
+		return *processorPlugins[index];
+	}
 	else
 		return getEmptyProcessorInfo();
 }
 
-Plugin::DataThreadInfo PluginManager::getDataThreadInfo(int index) const
+Plugin::DataThreadInfo PluginManager::getDataThreadInfo(int index)
 {
-	if (index < dataThreadPlugins.size())
-		return dataThreadPlugins[index];
+	if (index >= 0 && index < dataThreadPlugins.size())
+	{
+		loadLibrary(dataThreadPlugins[index]->libIndex);
+		return *dataThreadPlugins[index];
+	}
 	else
 		return getEmptyDatathreadInfo();
 }
 
-Plugin::RecordEngineInfo PluginManager::getRecordEngineInfo(int index) const
+Plugin::RecordEngineInfo PluginManager::getRecordEngineInfo(int index)
 {
-	if (index < recordEnginePlugins.size())
-		return recordEnginePlugins[index];
+	if (index >= 0 && index < recordEnginePlugins.size())
+	{
+		loadLibrary(recordEnginePlugins[index]->libIndex);
+		return *recordEnginePlugins[index];
+	}
 	else 
 		return getEmptyRecordengineInfo();
 }
 
-Plugin::FileSourceInfo PluginManager::getFileSourceInfo(int index) const
+Plugin::FileSourceInfo PluginManager::getFileSourceInfo(int index)
 {
-	if (index < fileSourcePlugins.size())
-		return fileSourcePlugins[index];
+	if (index >= 0 && index < fileSourcePlugins.size())
+	{
+		loadLibrary(fileSourcePlugins[index]->libIndex);
+		return *fileSourcePlugins[index];
+	}
 	else
 		return getEmptyFileSourceInfo();
 }
 
-Plugin::ProcessorInfo PluginManager::getProcessorInfo(String name, String libName) const
+Plugin::ProcessorInfo PluginManager::getProcessorInfo(String name, String libName)
 {
 	Plugin::ProcessorInfo i = getEmptyProcessorInfo();
 	findPlugin<Plugin::ProcessorInfo>(name, libName, processorPlugins, i);
 	return i;
 }
 
-Plugin::DataThreadInfo PluginManager::getDataThreadInfo(String name, String libName) const
+Plugin::DataThreadInfo PluginManager::getDataThreadInfo(String name, String libName)
 {
 	Plugin::DataThreadInfo i = getEmptyDatathreadInfo();
 	findPlugin<Plugin::DataThreadInfo>(name, libName, dataThreadPlugins, i);
 	return i;
 }
 
-Plugin::RecordEngineInfo PluginManager::getRecordEngineInfo(String name, String libName) const
+Plugin::RecordEngineInfo PluginManager::getRecordEngineInfo(String name, String libName)
 {
 	Plugin::RecordEngineInfo i = getEmptyRecordengineInfo();
 	findPlugin<Plugin::RecordEngineInfo>(name, libName, recordEnginePlugins, i);
 	return i;
 }
 
-Plugin::FileSourceInfo PluginManager::getFileSourceInfo(String name, String libName) const
+Plugin::FileSourceInfo PluginManager::getFileSourceInfo(String name, String libName)
 {
 	Plugin::FileSourceInfo i = getEmptyFileSourceInfo();
 	findPlugin<Plugin::FileSourceInfo>(name, libName, fileSourcePlugins, i);
@@ -372,7 +694,7 @@ String PluginManager::getLibraryName(int index) const
 	if (index < 0 || index >= libArray.size())
 		return String::empty;
 	else
-		return libArray[index].name;
+		return libArray[index]->name;
 }
 
 int PluginManager::getLibraryVersion(int index) const
@@ -380,7 +702,7 @@ int PluginManager::getLibraryVersion(int index) const
 	if (index < 0 || index >= libArray.size())
 		return -1;
 	else
-		return libArray[index].libVersion;
+		return libArray[index]->libVersion;
 }
 
 int PluginManager::getLibraryIndexFromPlugin(Plugin::PluginType type, int index)
@@ -388,18 +710,48 @@ int PluginManager::getLibraryIndexFromPlugin(Plugin::PluginType type, int index)
 	switch (type)
 	{
 	case Plugin::ProcessorPlugin:
-		return processorPlugins[index].libIndex;
+		return processorPlugins[index]->libIndex;
 	case Plugin::RecordEnginePlugin:
-		return recordEnginePlugins[index].libIndex;
+		return recordEnginePlugins[index]->libIndex;
 	case Plugin::DatathreadPlugin:
-		return dataThreadPlugins[index].libIndex;
+		return dataThreadPlugins[index]->libIndex;
 	case Plugin::FileSourcePlugin:
-		return fileSourcePlugins[index].libIndex;
+		return fileSourcePlugins[index]->libIndex;
 	default:
 		return -1;
 	}
 }
 
+String PluginManager::getPluginName(Plugin::PluginType type, int index) const
+{
+	switch (type)
+	{
+	case Plugin::ProcessorPlugin:
+		return processorPlugins[index]->nameString;
+	case Plugin::RecordEnginePlugin:
+		return recordEnginePlugins[index]->nameString;
+	case Plugin::DatathreadPlugin:
+		return dataThreadPlugins[index]->nameString;
+	case Plugin::FileSourcePlugin:
+		return fileSourcePlugins[index]->nameString;
+	default:
+		return String::empty;
+	}
+}
+
+Plugin::ProcessorType PluginManager::getProcessorType(int index) const
+{
+	if (index < 0 || index >= processorPlugins.size())
+		return Plugin::InvalidProcessor;
+	else
+		return processorPlugins[index]->type;
+}
+
+String PluginManager::getFileSourceExtensions(int index) const
+{
+	return fileSourcePlugins[index]->extensionsString;
+}
+
 Plugin::ProcessorInfo PluginManager::getEmptyProcessorInfo()
 {
 	Plugin::ProcessorInfo i;
@@ -434,15 +786,16 @@ Plugin::FileSourceInfo PluginManager::getEmptyFileSourceInfo()
 }
 
 template<class T>
-bool PluginManager::findPlugin(String name, String libName, const Array<LoadedPluginInfo<T>>& pluginArray, T& pluginInfo) const
+bool PluginManager::findPlugin(String name, String libName, const OwnedArray<LoadedPluginInfo<T>>& pluginArray, T& pluginInfo)
 {
 	for (int i = 0; i < pluginArray.size(); i++)
 	{
-		if (String(pluginArray[i].name) == name)
+		if (String(pluginArray[i]->name) == name)
 		{
-			if ((libName.isEmpty()) || (libName == String(libArray[pluginArray[i].libIndex].name)))
+			if ((libName.isEmpty()) || (libName == String(libArray[pluginArray[i]->libIndex]->name)))
 			{
-				pluginInfo = pluginArray[i];
+				loadLibrary(pluginArray[i]->libIndex);
+				pluginInfo = *pluginArray[i];
 				return true;
 			}
 		}
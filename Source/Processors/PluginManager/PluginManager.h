@@ -46,17 +46,50 @@ struct LoadedLibInfo : public Plugin::LibraryInfo
 #else
 	void* handle;
 #endif
+	/** Library file and the size and modification time it had when its
+	metadata was read, which tell whether the cached metadata still holds */
+	String path;
+	int64 fileSize;
+	int64 modificationTime;
+
+	/** Holds the name, which must outlive the library being unloaded */
+	String nameString;
+
+	/** Whether loading the library has been attempted */
+	bool loaded;
 };
 
 template<class T>
 struct LoadedPluginInfo : public T
 {
 	int libIndex;
+
+	/** Index of the plugin within its library */
+	int pluginIndex;
+
+	/** Hold the strings of the info structure, which must be valid before
+	the library is loaded */
+	String nameString;
+	String extensionsString;
 };
 
 
 class GenericProcessor;
 
+/**
+
+  Finds the plugin libraries and keeps track of the plugins they contain.
+
+  Libraries are only loaded when a plugin from them is first used: the names,
+  types and file extensions of their plugins come from a metadata cache
+  (pluginCache.xml), which is keyed by each library's path, size and
+  modification time and is rebuilt for any library that changed. The info
+  structures returned by the get...Info methods load the library if needed
+  and have a null creator if it can't be loaded; the name getters never load
+  anything.
+
+*/
+
 class PluginManager {
 
 public:
@@ -71,27 +104,51 @@ public:
 	int getNumDataThreads() const;
 	int getNumRecordEngines() const;
 	int getNumFileSources() const;
-	Plugin::ProcessorInfo getProcessorInfo(int index) const;
-	Plugin::ProcessorInfo getProcessorInfo(String name, String libName = String::empty) const;
-	Plugin::DataThreadInfo getDataThreadInfo(int index) const;
-	Plugin::DataThreadInfo getDataThreadInfo(String name, String libName = String::empty) const;
-	Plugin::RecordEngineInfo getRecordEngineInfo(int index) const;
-	Plugin::RecordEngineInfo getRecordEngineInfo(String name, String libName = String::empty) const;
-	Plugin::FileSourceInfo getFileSourceInfo(int index) const;
-	Plugin::FileSourceInfo getFileSourceInfo(String name, String libName = String::empty) const;
+	Plugin::ProcessorInfo getProcessorInfo(int index);
+	Plugin::ProcessorInfo getProcessorInfo(String name, String libName = String::empty);
+	Plugin::DataThreadInfo getDataThreadInfo(int index);
+	Plugin::DataThreadInfo getDataThreadInfo(String name, String libName = String::empty);
+	Plugin::RecordEngineInfo getRecordEngineInfo(int index);
+	Plugin::RecordEngineInfo getRecordEngineInfo(String name, String libName = String::empty);
+	Plugin::FileSourceInfo getFileSourceInfo(int index);
+	Plugin::FileSourceInfo getFileSourceInfo(String name, String libName = String::empty);
 	String getLibraryName(int index) const;
 	int getLibraryVersion(int index) const;
 	int getLibraryIndexFromPlugin(Plugin::PluginType type, int index);
 
+	/** Return plugin metadata without loading the library */
+	String getPluginName(Plugin::PluginType type, int index) const;
+	Plugin::ProcessorType getProcessorType(int index) const;
+	String getFileSourceExtensions(int index) const;
+
 private:
-	Array<LoadedLibInfo> libArray;
-	Array<LoadedPluginInfo<Plugin::ProcessorInfo>> processorPlugins;
-	Array<LoadedPluginInfo<Plugin::DataThreadInfo>> dataThreadPlugins;
-	Array<LoadedPluginInfo<Plugin::RecordEngineInfo>> recordEnginePlugins;
-	Array<LoadedPluginInfo<Plugin::FileSourceInfo>> fileSourcePlugins;
+	/** Held by pointer, as the name pointers of the infos point into their own String members */
+	OwnedArray<LoadedLibInfo> libArray;
+	OwnedArray<LoadedPluginInfo<Plugin::ProcessorInfo>> processorPlugins;
+	OwnedArray<LoadedPluginInfo<Plugin::DataThreadInfo>> dataThreadPlugins;
+	OwnedArray<LoadedPluginInfo<Plugin::RecordEngineInfo>> recordEnginePlugins;
+	OwnedArray<LoadedPluginInfo<Plugin::FileSourceInfo>> fileSourcePlugins;
+
+	/** Metadata of the libraries found last time, by path */
+	ScopedPointer<XmlElement> pluginCache;
+	bool cacheChanged;
+
+	File getCacheFile() const;
+	void readCache();
+	void writeCache();
+
+	/** Registers a library whose metadata was cached, without loading it */
+	bool addCachedLibrary(const File& file, const XmlElement* libXml);
+
+	/** Adds a plugin of the library libIndex to the right plugin array */
+	void addPluginInfo(int libIndex, int pluginIndex, const Plugin::PluginInfo& pInfo);
+
+	/** Loads a library registered from the cache, filling in the creators of
+	its plugins. Returns false if it couldn't be loaded */
+	bool loadLibrary(int libIndex);
 
 	template<class T>
-	bool findPlugin(String name, String libName, const Array<LoadedPluginInfo<T>>& pluginArray, T& pluginInfo) const;
+	bool findPlugin(String name, String libName, const OwnedArray<LoadedPluginInfo<T>>& pluginArray, T& pluginInfo);
 
 	/* Making the info structures have a constructor complicates the DLL interface. 
 	It's easier to just add some static methods to create empty structures for when the calls fail*/
@@ -22,6 +22,8 @@
 */
 
 #include <stdio.h>
+#include <map>
+#include <set>
 
 #include "ProcessorGraph.h"
 #include "../GenericProcessor/GenericProcessor.h"
@@ -29,6 +31,7 @@
 #include "../AudioNode/AudioNode.h"
 #include "../RecordNode/RecordNode.h"
 #include "../MessageCenter/MessageCenter.h"
+#include "../ClosedLoop/ClosedLoopLane.h"
 #include "../Merger/Merger.h"
 #include "../Splitter/Splitter.h"
 #include "../../UI/UIComponent.h"
@@ -39,6 +42,8 @@
 ProcessorGraph::ProcessorGraph() : currentNodeId(100)
 {
 
+    closedLoopLane = new ClosedLoopLane();
+
     // The ProcessorGraph will always have 0 inputs (all content is generated within graph)
     // but it will have N outputs, where N is the number of channels for the audio monitor
     setPlayConfigDetails(0, // number of inputs
@@ -212,9 +217,11 @@ Array<GenericProcessor*> ProcessorGraph::getListOfProcessors()
 
 }
 
-void ProcessorGraph::clearConnections()
+void ProcessorGraph::resetConnections()
 {
 
+    newConnectionBundles.clearQuick();
+
     for (int i = 0; i < getNumNodes(); i++)
     {
         Node* node = getNode(i);
@@ -222,15 +229,8 @@ void ProcessorGraph::clearConnections()
 
         if (nodeId != OUTPUT_NODE_ID)
         {
-
-            if (nodeId != RECORD_NODE_ID && nodeId != AUDIO_NODE_ID)
-            {
-                disconnectNode(node->nodeId);
-            }
-
             GenericProcessor* p = (GenericProcessor*) node->getProcessor();
             p->resetConnections();
-
         }
     }
 
@@ -238,19 +238,151 @@ void ProcessorGraph::clearConnections()
     for (int n = 0; n < 2; n++)
     {
 
-        addConnection(AUDIO_NODE_ID, n,
-                      OUTPUT_NODE_ID, n);
+        addBundledConnection(AUDIO_NODE_ID, n,
+                             OUTPUT_NODE_ID, n);
 
     }
 
-    addConnection(MESSAGE_CENTER_ID, midiChannelIndex,
-                  RECORD_NODE_ID, midiChannelIndex);
+    addBundledConnection(MESSAGE_CENTER_ID, midiChannelIndex,
+                         RECORD_NODE_ID, midiChannelIndex);
+}
+
+void ProcessorGraph::addBundledConnection(uint32 sourceNodeId, int sourceChannel,
+                                          uint32 destNodeId, int destChannel)
+{
+    // the graph would refuse these anyway
+    if (sourceChannel < 0 || destChannel < 0)
+        return;
+
+    if (newConnectionBundles.size() > 0)
+    {
+        ConnectionBundle& last = newConnectionBundles.getReference(newConnectionBundles.size() - 1);
+
+        if (last.sourceNodeId == sourceNodeId && last.destNodeId == destNodeId
+            && last.sourceChannel + last.numChannels == sourceChannel
+            && last.destChannel + last.numChannels == destChannel
+            && sourceChannel != midiChannelIndex)
+        {
+            last.numChannels++;
+            return;
+        }
+    }
+
+    ConnectionBundle bundle;
+    bundle.sourceNodeId = sourceNodeId;
+    bundle.sourceChannel = sourceChannel;
+    bundle.destNodeId = destNodeId;
+    bundle.destChannel = destChannel;
+    bundle.numChannels = 1;
+    bundle.complete = true;
+
+    newConnectionBundles.add(bundle);
+}
+
+namespace
+{
+    // source node and channel, dest node and channel
+    typedef std::pair<std::pair<uint32, int>, std::pair<uint32, int> > ConnectionKey;
+
+    ConnectionKey makeConnectionKey(uint32 sourceNodeId, int sourceChannel, uint32 destNodeId, int destChannel)
+    {
+        return ConnectionKey(std::make_pair(sourceNodeId, sourceChannel),
+                             std::make_pair(destNodeId, destChannel));
+    }
+}
+
+void ProcessorGraph::applyConnectionBundles()
+{
+    // bundles are matched by where they start; a bundle that only grew or
+    // shrank keeps the connections it had
+    std::map<ConnectionKey, const ConnectionBundle*> oldBundles, newBundles;
+
+    for (int i = 0; i < connectionBundles.size(); i++)
+    {
+        const ConnectionBundle& b = connectionBundles.getReference(i);
+        oldBundles[makeConnectionKey(b.sourceNodeId, b.sourceChannel, b.destNodeId, b.destChannel)] = &b;
+    }
+
+    for (int i = 0; i < newConnectionBundles.size(); i++)
+    {
+        const ConnectionBundle& b = newConnectionBundles.getReference(i);
+        newBundles[makeConnectionKey(b.sourceNodeId, b.sourceChannel, b.destNodeId, b.destChannel)] = &b;
+    }
+
+    // 1. remove the connections that are no longer wanted, in a single pass
+    std::set<ConnectionKey> unwanted;
+
+    for (int i = 0; i < connectionBundles.size(); i++)
+    {
+        const ConnectionBundle& b = connectionBundles.getReference(i);
+        std::map<ConnectionKey, const ConnectionBundle*>::const_iterator match =
+            newBundles.find(makeConnectionKey(b.sourceNodeId, b.sourceChannel, b.destNodeId, b.destChannel));
+
+        const int numKept = (match != newBundles.end() && b.complete) ? jmin(b.numChannels, match->second->numChannels) : 0;
+
+        for (int n = numKept; n < b.numChannels; n++)
+            unwanted.insert(makeConnectionKey(b.sourceNodeId, b.sourceChannel + n, b.destNodeId, b.destChannel + n));
+    }
+
+    int numRemoved = 0;
+
+    if (! unwanted.empty())
+    {
+        for (int i = getNumConnections(); --i >= 0;)
+        {
+            const Connection* c = getConnection(i);
+
+            if (unwanted.count(makeConnectionKey(c->sourceNodeId, c->sourceChannelIndex,
+                                                 c->destNodeId, c->destChannelIndex)) > 0)
+            {
+                removeConnection(i);
+                numRemoved++;
+            }
+        }
+    }
+
+    // 2. add the ones that are new
+    int numAdded = 0;
+
+    for (int i = 0; i < newConnectionBundles.size(); i++)
+    {
+        ConnectionBundle& b = newConnectionBundles.getReference(i);
+        std::map<ConnectionKey, const ConnectionBundle*>::const_iterator match =
+            oldBundles.find(makeConnectionKey(b.sourceNodeId, b.sourceChannel, b.destNodeId, b.destChannel));
+
+        const int numExisting = (match != oldBundles.end() && match->second->complete) ? jmin(b.numChannels, match->second->numChannels) : 0;
+
+        for (int n = numExisting; n < b.numChannels; n++)
+        {
+            if (addConnection(b.sourceNodeId, b.sourceChannel + n, b.destNodeId, b.destChannel + n))
+                numAdded++;
+            else
+                b.complete = false;
+        }
+    }
+
+    connectionBundles.swapWith(newConnectionBundles);
+    newConnectionBundles.clearQuick();
+
+    std::cout << "Connections: " << connectionBundles.size() << " bundles, "
+              << numAdded << " added, " << numRemoved << " removed." << std::endl;
+}
+
+void ProcessorGraph::forgetConnectionBundles(uint32 nodeId)
+{
+    for (int i = connectionBundles.size(); --i >= 0;)
+    {
+        const ConnectionBundle& b = connectionBundles.getReference(i);
+
+        if (b.sourceNodeId == nodeId || b.destNodeId == nodeId)
+            connectionBundles.remove(i);
+    }
 }
 
 
 void ProcessorGraph::updateConnections(Array<SignalChainTabButton*, CriticalSection> tabs)
 {
-    clearConnections(); // clear processor graph
+    resetConnections(); // work out the connections from scratch, then apply the difference
 
     std::cout << "Updating connections:" << std::endl;
     std::cout << std::endl;
@@ -371,6 +503,8 @@ void ProcessorGraph::updateConnections(Array<SignalChainTabButton*, CriticalSect
         } // end while source != 0
     } // end "tabs" for loop
 
+    applyConnectionBundles();
+
 } // end method
 
 void ProcessorGraph::connectProcessors(GenericProcessor* source, GenericProcessor* dest)
@@ -402,20 +536,20 @@ void ProcessorGraph::connectProcessors(GenericProcessor* source, GenericProcesso
         {
             //std::cout << chan << " ";
 
-            addConnection(source->getNodeId(),         // sourceNodeID
-                          chan,                        // sourceNodeChannelIndex
-                          dest->getNodeId(),           // destNodeID
-                          dest->getNextChannel(true)); // destNodeChannelIndex
+            addBundledConnection(source->getNodeId(),         // sourceNodeID
+                                 chan,                        // sourceNodeChannelIndex
+                                 dest->getNodeId(),           // destNodeID
+                                 dest->getNextChannel(true)); // destNodeChannelIndex
         }
     }
 
     // 2. connect event channel
     if (connectEvents)
     {
-        addConnection(source->getNodeId(),    // sourceNodeID
-                      midiChannelIndex,       // sourceNodeChannelIndex
-                      dest->getNodeId(),      // destNodeID
-                      midiChannelIndex);      // destNodeChannelIndex
+        addBundledConnection(source->getNodeId(),    // sourceNodeID
+                             midiChannelIndex,       // sourceNodeChannelIndex
+                             dest->getNodeId(),      // destNodeID
+                             midiChannelIndex);      // destNodeChannelIndex
     }
 
 }
@@ -431,37 +565,43 @@ void ProcessorGraph::connectProcessorToAudioAndRecordNodes(GenericProcessor* sou
     for (int chan = 0; chan < source->getNumOutputs(); chan++)
     {
 
-        getAudioNode()->addInputChannel(source, chan);
+        int audioNodeChannel = getAudioNode()->addInputChannel(source, chan);
 
-        // THIS IS A HACK TO MAKE SURE AUDIO NODE KNOWS WHAT THE SAMPLE RATE SHOULD BE
-        // IT CAN CAUSE PROBLEMS IF THE SAMPLE RATE VARIES ACROSS PROCESSORS
+        // the audio node resamples each channel from its own Channel::sampleRate,
+        // so sources at different rates (e.g. after a Resampler) can be mixed;
+        // this is only the node's nominal rate
         getAudioNode()->settings.sampleRate = source->getSampleRate();
 
-        addConnection(source->getNodeId(),                   // sourceNodeID
-                      chan,                                  // sourceNodeChannelIndex
-                      AUDIO_NODE_ID,                         // destNodeID
-                      getAudioNode()->getNextChannel(true)); // destNodeChannelIndex
+        // every channel is connected, so that switching a monitor on or off
+        // during acquisition doesn't change the graph; the audio node only
+        // mixes the monitored ones
+        addBundledConnection(source->getNodeId(),  // sourceNodeID
+                             chan,                 // sourceNodeChannelIndex
+                             AUDIO_NODE_ID,        // destNodeID
+                             audioNodeChannel);    // destNodeChannelIndex
 
+        // neither node has outputs, so the graph hands them the source's
+        // buffers directly instead of copying each channel
         getRecordNode()->addInputChannel(source, chan);
 
-        addConnection(source->getNodeId(),                    // sourceNodeID
-                      chan,                                   // sourceNodeChannelIndex
-                      RECORD_NODE_ID,                         // destNodeID
-                      getRecordNode()->getNextChannel(true)); // destNodeChannelIndex
+        addBundledConnection(source->getNodeId(),                    // sourceNodeID
+                             chan,                                   // sourceNodeChannelIndex
+                             RECORD_NODE_ID,                         // destNodeID
+                             getRecordNode()->getNextChannel(true)); // destNodeChannelIndex
 
     }
 
     // connect event channel
-    addConnection(source->getNodeId(),    // sourceNodeID
-                  midiChannelIndex,       // sourceNodeChannelIndex
-                  RECORD_NODE_ID,         // destNodeID
-                  midiChannelIndex);      // destNodeChannelIndex
+    addBundledConnection(source->getNodeId(),    // sourceNodeID
+                         midiChannelIndex,       // sourceNodeChannelIndex
+                         RECORD_NODE_ID,         // destNodeID
+                         midiChannelIndex);      // destNodeChannelIndex
 
     // connect event channel
-    addConnection(source->getNodeId(),    // sourceNodeID
-                  midiChannelIndex,       // sourceNodeChannelIndex
-                  AUDIO_NODE_ID,          // destNodeID
-                  midiChannelIndex);      // destNodeChannelIndex
+    addBundledConnection(source->getNodeId(),    // sourceNodeID
+                         midiChannelIndex,       // sourceNodeChannelIndex
+                         AUDIO_NODE_ID,          // destNodeID
+                         midiChannelIndex);      // destNodeChannelIndex
 
 
     getRecordNode()->addInputChannel(source, midiChannelIndex);
@@ -536,6 +676,7 @@ void ProcessorGraph::removeProcessor(GenericProcessor* processor)
 
     disconnectNode(nodeId);
     removeNode(nodeId);
+    forgetConnectionBundles(nodeId);
 
     if (getMessageCenter()->getSourceNodeId() == nodeId)
     {
@@ -701,3 +842,8 @@ MessageCenter* ProcessorGraph::getMessageCenter()
     return (MessageCenter*) node->getProcessor();
 
 }
+
+ClosedLoopLane* ProcessorGraph::getClosedLoopLane()
+{
+    return closedLoopLane;
+}
@@ -32,6 +32,7 @@ class GenericProcessor;
 class RecordNode;
 class AudioNode;
 class MessageCenter;
+class ClosedLoopLane;
 class SignalChainTabButton;
 
 /**
@@ -70,6 +71,7 @@ public:
     RecordNode* getRecordNode();
     AudioNode* getAudioNode();
     MessageCenter* getMessageCenter();
+    ClosedLoopLane* getClosedLoopLane();
 
     void updateConnections(Array<SignalChainTabButton*, CriticalSection>);
 
@@ -90,6 +92,8 @@ public:
 private:
     int currentNodeId;
 
+    ScopedPointer<ClosedLoopLane> closedLoopLane;
+
     enum nodeIds
     {
         RECORD_NODE_ID = 900,
@@ -98,7 +102,45 @@ private:
         MESSAGE_CENTER_ID = 904
     };
 
-    void clearConnections();
+    /** A run of connections from consecutive channels of one node to
+        consecutive channels of another, such as all the continuous outputs of
+        a processor; an event connection is a bundle of one on midiChannelIndex.
+        The graph itself needs a connection per channel, so updateConnections
+        works out the bundles, compares them with the previous ones and only
+        adds or removes the connections that changed. */
+    struct ConnectionBundle
+    {
+        uint32 sourceNodeId;
+        int sourceChannel;
+        uint32 destNodeId;
+        int destChannel;
+        int numChannels;
+
+        /** False if the graph refused some of its connections. */
+        bool complete;
+    };
+
+    /** The bundles whose connections are in the graph. */
+    Array<ConnectionBundle> connectionBundles;
+
+    /** The bundles collected by the updateConnections in progress. */
+    Array<ConnectionBundle> newConnectionBundles;
+
+    /** Resets the channel assignments of all processors before their
+        connections are worked out again. */
+    void resetConnections();
+
+    /** Adds a connection to the bundles being collected, extending the last
+        bundle when the channels follow on from it. */
+    void addBundledConnection(uint32 sourceNodeId, int sourceChannel,
+                              uint32 destNodeId, int destChannel);
+
+    /** Brings the graph's connections in line with the collected bundles. */
+    void applyConnectionBundles();
+
+    /** Drops the bundles to or from a node that's being removed (the graph
+        removes its connections itself). */
+    void forgetConnectionBundles(uint32 nodeId);
 
     void connectProcessors(GenericProcessor* source, GenericProcessor* dest);
     void connectProcessorToAudioAndRecordNodes(GenericProcessor* source);
@@ -128,15 +128,14 @@ namespace ProcessorManager
 			break;
 		case PluginProcessor:
 			{
-				Plugin::ProcessorInfo info = AccessClass::getPluginManager()->getProcessorInfo(index);
-				name = info.name;
-				type = info.type;
+				// from the metadata, without loading the library
+				name = AccessClass::getPluginManager()->getPluginName(Plugin::ProcessorPlugin, index);
+				type = AccessClass::getPluginManager()->getProcessorType(index);
 			}
 			break;
 		case DataThreadProcessor:
 		{
-			Plugin::DataThreadInfo info = AccessClass::getPluginManager()->getDataThreadInfo(index);
-			name = info.name;
+			name = AccessClass::getPluginManager()->getPluginName(Plugin::DatathreadPlugin, index);
 			type = SourceProcessor;
 			break;
 		}
@@ -157,6 +156,8 @@ namespace ProcessorManager
 		case PluginProcessor:
 			{
 				Plugin::ProcessorInfo info = AccessClass::getPluginManager()->getProcessorInfo(index);
+				if (info.creator == nullptr)
+					return nullptr;
 				GenericProcessor* proc = info.creator();
 				proc->setPluginData(Plugin::ProcessorPlugin, index);
 				return proc;
@@ -165,6 +166,8 @@ namespace ProcessorManager
 		case DataThreadProcessor:
 		{
 			Plugin::DataThreadInfo info = AccessClass::getPluginManager()->getDataThreadInfo(index);
+			if (info.creator == nullptr)
+				return nullptr;
 			GenericProcessor* proc = new SourceNode(info.name, info.creator);
 			proc->setPluginData(Plugin::DatathreadPlugin, index);
 			return proc;
@@ -190,12 +193,14 @@ namespace ProcessorManager
 			{
 				for (int i = 0; i < pm->getNumProcessors(); i++)
 				{
-					Plugin::ProcessorInfo info = pm->getProcessorInfo(i);
-					if (procName.equalsIgnoreCase(info.name))
+					if (procName.equalsIgnoreCase(pm->getPluginName(Plugin::ProcessorPlugin, i)))
 					{
 						int libIndex = pm->getLibraryIndexFromPlugin(Plugin::ProcessorPlugin, i);
 						if (libName.equalsIgnoreCase(pm->getLibraryName(libIndex)) && libVersion == pm->getLibraryVersion(libIndex))
 						{
+							Plugin::ProcessorInfo info = pm->getProcessorInfo(i);
+							if (info.creator == nullptr)
+								break;
 							proc = info.creator();
 							proc->setPluginData(Plugin::ProcessorPlugin, i);
 							return proc;
@@ -207,12 +212,14 @@ namespace ProcessorManager
 			{
 				for (int i = 0; i < pm->getNumDataThreads(); i++)
 				{
-					Plugin::DataThreadInfo info = pm->getDataThreadInfo(i);
-					if (procName.equalsIgnoreCase(info.name))
+					if (procName.equalsIgnoreCase(pm->getPluginName(Plugin::DatathreadPlugin, i)))
 					{
 						int libIndex = pm->getLibraryIndexFromPlugin(Plugin::DatathreadPlugin, i);
 						if (libName.equalsIgnoreCase(pm->getLibraryName(libIndex)) && libVersion == pm->getLibraryVersion(libIndex))
 						{
+							Plugin::DataThreadInfo info = pm->getDataThreadInfo(i);
+							if (info.creator == nullptr)
+								break;
 							proc = new SourceNode(info.name, info.creator);
 							proc->setPluginData(Plugin::DatathreadPlugin, i);
 							return proc;
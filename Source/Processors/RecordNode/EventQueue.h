@@ -25,46 +25,40 @@
 #define EVENTQUEUE_H_INCLUDED
 
 #include "../../../JuceLibraryCode/JuceHeader.h"
-#include <vector>
 
-struct SpikeObject;
+/** Largest raw event: 6 header bytes plus up to 255 bytes of data. */
+#define EVENT_MAX_BYTES (6 + 255)
 
-template <class MsgContainer>
-class AsyncEventMessage :
-	public ReferenceCountedObject
-{
-public:
-	AsyncEventMessage(const MsgContainer& m, int64 t, int extra) : 
-		ReferenceCountedObject(),
-		m_data(m),
-		m_timestamp(t),
-		m_extra(extra)
-	{}
-
-	~AsyncEventMessage() {};
+/**
+	Fixed-capacity, lock-free queue of events for one producer (the RecordNode,
+	on the audio thread) and one consumer (the RecordThread).
 
-	const MsgContainer& getData() const { return m_data;  }
-	const int64& getTimestamp() const { return m_timestamp; }
-	const int& getExtra() const { return m_extra;  }
+	Every slot holds a whole raw event inline and all slots are allocated when
+	the queue is created, so adding an event only copies its bytes. The consumer
+	reads a batch of events in place between startRead() and stopRead(), which
+	releases the whole batch at once.
 
-private:
-	const MsgContainer m_data;
-	const int64 m_timestamp;
-	const int m_extra;
-
-};
+	If the consumer falls behind, new events are dropped and counted instead of
+	overwriting the ones being read.
 
-template <class EventClass>
+	@see RecordNode, RecordThread, MessageQueue
+*/
 class EventQueue
 {
 public:
-	typedef AsyncEventMessage<EventClass> EventContainer;
-	typedef ReferenceCountedObjectPtr<EventContainer> EventClassPtr;
+	struct Event
+	{
+		int64 timestamp;
+		int eventType;
+		int numBytes;
+		uint8 data[EVENT_MAX_BYTES];
+	};
 
 	EventQueue(int size) :
 		m_fifo(size)
 	{
-		m_data.resize(size);
+		m_data.calloc(size);
+		m_readStart1 = m_readSize1 = m_readStart2 = m_readSize2 = 0;
 	}
 
 	~EventQueue()
@@ -75,67 +69,85 @@ public:
 		return m_fifo.getNumReady();
 	}
 
+	/** Empties the queue and clears the drop counter. Only call this while
+		neither the producer nor the consumer are using the queue. */
 	void reset()
 	{
-		m_data.clear();
-		m_data.resize(m_fifo.getTotalSize());
+		m_fifo.reset();
+		m_readSize1 = m_readSize2 = 0;
+		m_numDropped = 0;
 	}
 
 	void resize(int size)
 	{
-		m_data.clear();
 		m_fifo.setTotalSize(size);
-		m_data.resize(size);
+		m_data.calloc(size);
+		reset();
 	}
 
-	void addEvent(const EventClass& ev, int64 t, int extra = 0)
+	/** Copies an event into the queue. Producer side only. */
+	void addEvent(const MidiMessage& ev, int64 t, int eventType = 0)
 	{
 		int pos1, size1, pos2, size2;
 		size1 = 0;
 		m_fifo.prepareToWrite(1, pos1, size1, pos2, size2);
 
 		/* This means there is a buffer overrun. Instead of overwritting the existing data and risking a collision of both threads
-			we just skip the incoming samples. TODO: use this to notify of the overrun and act consequently   */
+			we just skip the incoming event and count it */
 		if (size1 > 0)
 		{
-			m_data[pos1] = new EventContainer(ev, t, extra);
+			Event& slot = m_data[pos1];
+			slot.timestamp = t;
+			slot.eventType = eventType;
+			slot.numBytes = jmin(ev.getRawDataSize(), EVENT_MAX_BYTES);
+			memcpy(slot.data, ev.getRawData(), slot.numBytes);
 			m_fifo.finishedWrite(1);
 		}
+		else
+		{
+			++m_numDropped;
+		}
 	}
 
-	int getEvents(std::vector<EventClassPtr>& vec, int max)
+	/** Makes up to max events (all of them if max <= 0) available through
+		getEvent() and returns how many there are. Consumer side only. */
+	int startRead(int max)
 	{
-		int pos1, size1, pos2, size2;
 		int numAvailable = m_fifo.getNumReady();
 		int numToRead = ((max < numAvailable) && (max > 0)) ? max : numAvailable;
-		m_fifo.prepareToRead(numToRead, pos1, size1, pos2, size2);
-		vec.resize(numToRead);
-		for (int i = 0; i < size1; ++i)
-		{
-			vec[i] = m_data[pos1 + i];
-		}
-		if (size2 > 0)
-		{
-			for (int i = 0; i < size2; ++i)
-			{
-				vec[size1 + i] = m_data[pos2 + i];
-			}
-		}
-		m_fifo.finishedRead(numToRead);
-		return numToRead;
+		m_fifo.prepareToRead(numToRead, m_readStart1, m_readSize1, m_readStart2, m_readSize2);
+		return m_readSize1 + m_readSize2;
+	}
+
+	/** Returns one of the events made available by startRead(), in place. */
+	const Event& getEvent(int index) const
+	{
+		return index < m_readSize1 ? m_data[m_readStart1 + index] : m_data[m_readStart2 + index - m_readSize1];
+	}
+
+	/** Releases every event made available by startRead(). */
+	void stopRead()
+	{
+		m_fifo.finishedRead(m_readSize1 + m_readSize2);
+		m_readSize1 = m_readSize2 = 0;
+	}
+
+	/** Returns the number of events dropped because the queue was full. */
+	int getNumDropped() const
+	{
+		return m_numDropped.get();
 	}
 
 private:
-	std::vector<EventClassPtr> m_data;
 	AbstractFifo m_fifo;
+	HeapBlock<Event> m_data;
+	Atomic<int> m_numDropped;
+
+	int m_readStart1, m_readSize1, m_readStart2, m_readSize2;
 
 	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EventQueue);
 };
 
-typedef EventQueue<MidiMessage> EventMsgQueue;
-typedef EventQueue<SpikeObject> SpikeMsgQueue;
-typedef ReferenceCountedObjectPtr<AsyncEventMessage<MidiMessage>> EventMessagePtr;
-typedef ReferenceCountedObjectPtr<AsyncEventMessage<SpikeObject>> SpikeMessagePtr;
+typedef EventQueue EventMsgQueue;
 
 #endif  // EVENTQUEUE_H_INCLUDED
-
@@ -0,0 +1,234 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2016 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef MESSAGEQUEUE_H_INCLUDED
+#define MESSAGEQUEUE_H_INCLUDED
+
+#include "../../../JuceLibraryCode/JuceHeader.h"
+
+/** Largest raw MESSAGE event: 6 header bytes plus up to 255 bytes of text. */
+#define MESSAGE_EVENT_MAX_BYTES (6 + 255)
+
+/**
+
+  Fixed-capacity, lock-free queue of MESSAGE events for one producer (the
+  RecordNode, on the audio thread) and one consumer (the RecordThread).
+
+  Every slot holds a whole raw event inline, so queueing a message never
+  allocates. Messages that keep coming back (e.g. the same command sent by a
+  script on every trial) are interned the second time they are seen: their
+  bytes are stored once in a fixed table and later copies only store an index
+  into it. Interned messages stay valid until reset(), which is called between
+  recordings.
+
+  If the consumer falls behind, new messages are dropped and counted.
+
+  @see RecordNode, RecordThread, SpikeRing
+
+*/
+
+class MessageQueue
+{
+public:
+    MessageQueue(int capacity, int maxInterned)
+        : fifo(capacity + 1),
+          maxInterned(maxInterned)
+    {
+        slots.calloc(capacity + 1);
+        interned.calloc(maxInterned);
+
+        tableSize = nextPowerOfTwo(maxInterned * 2);
+        table.malloc(tableSize);
+        seen.malloc(tableSize);
+
+        reset();
+    }
+
+    /** Queues a raw MESSAGE event. Returns false, and counts the message as
+        dropped, if the queue is full. Producer side only. */
+    bool push(const uint8* data, int numBytes, int64 timestamp)
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite(1, start1, size1, start2, size2);
+
+        if (size1 == 0)
+        {
+            ++numDropped;
+            return false;
+        }
+
+        numBytes = jmin(numBytes, MESSAGE_EVENT_MAX_BYTES);
+
+        Slot& slot = slots[start1];
+        slot.timestamp = timestamp;
+        slot.internedIndex = intern(data, numBytes);
+        slot.numBytes = numBytes;
+
+        if (slot.internedIndex < 0)
+            memcpy(slot.data, data, numBytes);
+
+        fifo.finishedWrite(1);
+
+        return true;
+    }
+
+    /** Returns the raw bytes of the oldest message, or nullptr if the queue
+        is empty. The data remains valid until release() is called. Consumer
+        side only. */
+    const uint8* peek(int& numBytes, int64& timestamp)
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(1, start1, size1, start2, size2);
+
+        if (size1 == 0)
+            return nullptr;
+
+        const Slot& slot = slots[start1];
+        numBytes = slot.numBytes;
+        timestamp = slot.timestamp;
+
+        return slot.internedIndex < 0 ? slot.data : interned[slot.internedIndex].data;
+    }
+
+    /** Removes the message returned by peek(). Consumer side only. */
+    void release()
+    {
+        fifo.finishedRead(1);
+    }
+
+    int getNumReady() const
+    {
+        return fifo.getNumReady();
+    }
+
+    /** Returns the number of messages dropped because the queue was full. */
+    int getNumDropped() const
+    {
+        return numDropped.get();
+    }
+
+    /** Returns the number of distinct messages that have been interned. */
+    int getNumInterned() const
+    {
+        return numInterned;
+    }
+
+    /** Empties the queue and forgets every interned message. Only call this
+        while neither the producer nor the consumer are using the queue. */
+    void reset()
+    {
+        fifo.reset();
+        numDropped = 0;
+        numInterned = 0;
+
+        for (int i = 0; i < tableSize; i++)
+        {
+            table[i] = -1;
+            seen[i] = 0;
+        }
+    }
+
+private:
+    struct Slot
+    {
+        int64 timestamp;
+        int numBytes;
+        int internedIndex;
+        uint8 data[MESSAGE_EVENT_MAX_BYTES];
+    };
+
+    struct InternedMessage
+    {
+        uint32 hash;
+        int numBytes;
+        uint8 data[MESSAGE_EVENT_MAX_BYTES];
+    };
+
+    static uint32 hashBytes(const uint8* data, int numBytes)
+    {
+        uint32 hash = 2166136261u; // FNV-1a
+
+        for (int i = 0; i < numBytes; i++)
+            hash = (hash ^ data[i]) * 16777619u;
+
+        return hash != 0 ? hash : 1;
+    }
+
+    /** Returns the index of an interned copy of the message, interning it if
+        it has been seen before, or -1 if it should be copied into its slot. */
+    int intern(const uint8* data, int numBytes)
+    {
+        const uint32 hash = hashBytes(data, numBytes);
+        const int mask = tableSize - 1;
+        int bucket = int(hash) & mask;
+
+        // open addressing; the table is never more than half full
+        while (table[bucket] >= 0)
+        {
+            const InternedMessage& entry = interned[table[bucket]];
+
+            if (entry.hash == hash
+                && entry.numBytes == numBytes
+                && memcmp(entry.data, data, numBytes) == 0)
+            {
+                return table[bucket];
+            }
+
+            bucket = (bucket + 1) & mask;
+        }
+
+        // only intern messages the second time they turn up, so that
+        // one-off messages (e.g. ones carrying a time) don't fill the table
+        uint32& lastSeen = seen[int(hash) & mask];
+
+        if (lastSeen != hash || numInterned == maxInterned)
+        {
+            lastSeen = hash;
+            return -1;
+        }
+
+        InternedMessage& entry = interned[numInterned];
+        entry.hash = hash;
+        entry.numBytes = numBytes;
+        memcpy(entry.data, data, numBytes);
+
+        table[bucket] = numInterned;
+
+        return numInterned++;
+    }
+
+    AbstractFifo fifo;
+    HeapBlock<Slot> slots;
+    Atomic<int> numDropped;
+
+    HeapBlock<InternedMessage> interned;
+    HeapBlock<int> table;
+    HeapBlock<uint32> seen;
+    const int maxInterned;
+    int tableSize;
+    int numInterned;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MessageQueue);
+};
+
+#endif  // MESSAGEQUEUE_H_INCLUDED
@@ -34,8 +34,9 @@ OriginalRecording::OriginalRecording() : separateFiles(false),
 
     recordMarker = new char[10];*/
 	continuousDataIntegerBuffer.malloc(10000);
-	continuousDataFloatBuffer.malloc(10000);
 	recordMarker.malloc(10);
+	spikeBufferSize = MAX_SPIKE_BUFFER_LEN;
+	spikeBuffer.malloc(spikeBufferSize);
 
     for (int i = 0; i < 9; i++)
     {
@@ -384,24 +385,30 @@ String OriginalRecording::generateSpikeHeader(SpikeRecordInfo* elec)
 
 void OriginalRecording::writeEvent(int eventType, const MidiMessage& event, int64 timestamp)
 {
-    if (isWritableEvent(eventType))
-		writeTTLEvent(event, timestamp);
+	writeRawEvent(eventType, event.getRawData(), event.getRawDataSize(), timestamp);
+}
+
+void OriginalRecording::writeRawEvent(int eventType, const uint8* data, int numBytes, int64 timestamp)
+{
+    if (isWritableEvent(eventType) && numBytes >= 4)
+		writeTTLEvent(data, timestamp);
     if (eventType == GenericProcessor::MESSAGE)
-		writeMessage(event, timestamp);
+		writeMessage(data, numBytes, timestamp);
 }
 
-void OriginalRecording::writeMessage(const MidiMessage& event, int64 timestamp)
+void OriginalRecording::writeMessage(const uint8* data, int numBytes, int64 timestamp)
 {
-    if (messageFile == nullptr)
+    if (messageFile == nullptr || numBytes < 6)
         return;
 
-    int msgLength = event.getRawDataSize() - 6;
-    const char* dataptr = (const char*)event.getRawData() + 6;
+    int msgLength = numBytes - 6;
+    const char* dataptr = (const char*)data + 6;
 
-    String timestampText(timestamp);
+    char timestampText[24];
+    int timestampLength = snprintf(timestampText, sizeof(timestampText), "%lld", (long long) timestamp);
 
     diskWriteLock.enter();
-    fwrite(timestampText.toUTF8(),1,timestampText.length(),messageFile);
+    fwrite(timestampText,1,timestampLength,messageFile);
     fwrite(" ",1,1,messageFile);
     fwrite(dataptr,1,msgLength,messageFile);
     fwrite("\n",1,1,messageFile);
@@ -409,7 +416,7 @@ void OriginalRecording::writeMessage(const MidiMessage& event, int64 timestamp)
 
 }
 
-void OriginalRecording::writeTTLEvent(const MidiMessage& event, int64 timestamp)
+void OriginalRecording::writeTTLEvent(const uint8* dataptr, int64 timestamp)
 {
     // find file and write samples to disk
     // std::cout << "Received event!" << std::endl;
@@ -417,8 +424,6 @@ void OriginalRecording::writeTTLEvent(const MidiMessage& event, int64 timestamp)
     if (eventFile == nullptr)
         return;
 
-    const uint8* dataptr = event.getRawData();
-
     //With the new external recording thread, this field has no sense.
 	int16 samplePos = 0;
 
@@ -504,13 +509,8 @@ void OriginalRecording::writeContinuousBuffer(const float* data, int nSamples, i
         return;
 
     // scale the data back into the range of int16
-    float scaleFactor =  float(0x7fff) * getChannel(channel)->bitVolts;
-
-    for (int n = 0; n < nSamples; n++)
-    {
-        *(continuousDataFloatBuffer+n) = *(data+n) / scaleFactor;
-    }
-    AudioDataConverters::convertFloatToInt16BE(continuousDataFloatBuffer, continuousDataIntegerBuffer, nSamples);
+    addClippedSamples(writeChannel, SampleConversion::floatToInt16BE(data, continuousDataIntegerBuffer,
+                                                                     1.0f / getChannel(channel)->bitVolts, nSamples));
 
     if (blockIndex[channel] == 0)
     {
@@ -630,19 +630,21 @@ void OriginalRecording::closeFiles()
 //     this->timestamp = timestamp;
 // }
 
-void OriginalRecording::writeSpike(int electrodeIndex, const SpikeObject& spike, int64 timestamp)
+void OriginalRecording::writeSpike(int electrodeIndex, const SpikeRecord& spike, int64 timestamp)
 {
-    uint8_t spikeBuffer[MAX_SPIKE_BUFFER_LEN];
-
     if (spikeFileArray[electrodeIndex] == nullptr)
         return;
 
-    packSpike(&spike, spikeBuffer, MAX_SPIKE_BUFFER_LEN);
+    int totalBytes = getPackedSpikeSize(spike.nChannels, spike.nSamples);
+
+    // spikes from large electrode groups may not fit the usual buffer
+    if (totalBytes > spikeBufferSize)
+    {
+        spikeBufferSize = totalBytes;
+        spikeBuffer.malloc(spikeBufferSize);
+    }
 
-    int totalBytes = spike.nSamples * spike.nChannels * 2 + // account for samples
-                     spike.nChannels * 4 +            // acount for gain
-                     spike.nChannels * 2 +            // account for thresholds
-                     SPIKE_METADATA_SIZE;             // 42, from SpikeObject.h
+    packSpike(&spike, spikeBuffer, spikeBufferSize);
 
 
     diskWriteLock.enter();
@@ -50,10 +50,12 @@ public:
 	void closeFiles() override;
 	void writeData(int writeChannel, int realChannel, const float* buffer, int size) override;
 	void writeEvent(int eventType, const MidiMessage& event, int64 timestamp) override;
+	void writeRawEvent(int eventType, const uint8* data, int numBytes, int64 timestamp) override;
+	void writeMessage(const uint8* data, int numBytes, int64 timestamp) override;
 	void addChannel(int index, const Channel* chan) override;
 	void resetChannels() override;
 	void addSpikeElectrode(int index, const SpikeRecordInfo* elec) override;
-	void writeSpike(int electrodeIndex, const SpikeObject& spike, int64 timestamp) override;
+	void writeSpike(int electrodeIndex, const SpikeRecord& spike, int64 timestamp) override;
 
     static RecordEngineManager* getEngineManager();
 
@@ -69,8 +71,7 @@ private:
     String generateSpikeHeader(SpikeRecordInfo* elec);
 
     void openMessageFile(File rootFolder);
-    void writeTTLEvent(const MidiMessage& event, int64 timestamp);
-    void writeMessage(const MidiMessage& event, int64 timestamp);
+    void writeTTLEvent(const uint8* data, int64 timestamp);
 
     void writeXml();
 
@@ -89,16 +90,14 @@ private:
 	HeapBlock<int16> continuousDataIntegerBuffer;
     //int16* continuousDataIntegerBuffer;
 
-    /** Holds data that has been converted from float to int16 before
-        saving.
-    */
-	HeapBlock<float> continuousDataFloatBuffer;
-    //float* continuousDataFloatBuffer;
-
     /** Used to indicate the end of each record */
 	HeapBlock<char> recordMarker;
     //char* recordMarker;
 
+    /** Holds a packed spike before it is written. */
+	HeapBlock<uint8> spikeBuffer;
+	int spikeBufferSize;
+
     AudioSampleBuffer zeroBuffer;
 
     FILE* eventFile;
@@ -48,6 +48,34 @@ void RecordEngine::startChannelBlock(bool lastBlock) {}
 
 void RecordEngine::endChannelBlock(bool lastBlock) {}
 
+void RecordEngine::writeRawEvent(int eventType, const uint8* data, int numBytes, int64 timestamp)
+{
+    writeEvent(eventType, MidiMessage(data, numBytes), timestamp);
+}
+
+void RecordEngine::writeMessage(const uint8* data, int numBytes, int64 timestamp)
+{
+    writeEvent(GenericProcessor::MESSAGE, MidiMessage(data, numBytes), timestamp);
+}
+
+void RecordEngine::writeTimestampGap(int sourceNodeId, int64 numMissing, int64 timestamp)
+{
+    // laid out like a MESSAGE event: 6 header bytes, then the text
+    uint8 data[6 + 64];
+
+    data[0] = GenericProcessor::MESSAGE;
+    data[1] = uint8(sourceNodeId);
+    data[2] = 0;
+    data[3] = 0;
+    data[4] = 0;
+    data[5] = uint8(sourceNodeId);
+
+    int textLength = snprintf((char*)data + 6, 64, "Timestamp gap: %lld samples missing from node %d",
+                              (long long) numMissing, sourceNodeId);
+
+    writeMessage(data, 6 + jmin(textLength, 63), timestamp);
+}
+
 Channel* RecordEngine::getChannel(int index) const
 {
     return AccessClass::getProcessorGraph()->getRecordNode()->getDataChannel(index);
@@ -74,6 +102,8 @@ void RecordEngine::updateTimestamps(const Array<int64>& ts, int channel)
 void RecordEngine::setChannelMapping(const Array<int>& chans)
 {
 	channelMap = chans;
+	clippedSamples.clearQuick();
+	clippedSamples.insertMultiple(0, 0, chans.size());
 }
 
 int64 RecordEngine::getTimestamp(int channel) const
@@ -91,6 +121,27 @@ int RecordEngine::getNumRecordedChannels() const
 	return channelMap.size();
 }
 
+void RecordEngine::addClippedSamples(int channel, int numClipped)
+{
+	if (numClipped > 0 && channel < clippedSamples.size())
+		clippedSamples.getReference(channel) += numClipped;
+}
+
+int64 RecordEngine::getNumClippedSamples(int channel) const
+{
+	return clippedSamples[channel];
+}
+
+void RecordEngine::reportClippedSamples() const
+{
+	for (int i = 0; i < clippedSamples.size(); i++)
+	{
+		if (clippedSamples[i] > 0)
+			std::cout << getEngineID() << ": " << clippedSamples[i] << " samples of channel "
+			          << getChannel(getRealChannel(i))->name << " were out of range and clipped" << std::endl;
+	}
+}
+
 void RecordEngine::registerSpikeSource(GenericProcessor* processor) {}
 
 void RecordEngine::startAcquisition() {}
@@ -28,6 +28,7 @@
 #include "../Channel/Channel.h"
 #include "../GenericProcessor/GenericProcessor.h"
 #include "../Visualization/SpikeObject.h"
+#include "SampleConversion.h"
 
 #include <map>
 
@@ -77,7 +78,7 @@ public:
 		2-startChannelBlock*
 		3-writeData* (per channel. Can be called more than once to account for the circular buffer wrap)
 		4-endChannelBlock*
-		4-writeEvent* (if needed)
+		4-writeRawEvent*, writeMessage* (if needed)
 		5-writeSpike* (if needed)
     When recording stops:
     	closeFiles*
@@ -116,6 +117,25 @@ public:
     */
     virtual void writeEvent(int eventType, const MidiMessage& event, int64 timestamp) = 0;
 
+    /** Write a single event to disk, straight from its raw bytes in the record queue.
+    	The default implementation wraps them in a MidiMessage, which allocates for
+    	anything longer than 4 bytes, and calls writeEvent; engines that override it
+    	avoid that copy.
+    */
+    virtual void writeRawEvent(int eventType, const uint8* data, int numBytes, int64 timestamp);
+
+    /** Write a MESSAGE event to disk. The raw event (6 header bytes followed by
+    	the text) is passed straight from the record queue. The default implementation
+    	wraps it in a MidiMessage and calls writeEvent; engines that override it avoid
+    	that copy.
+    */
+    virtual void writeMessage(const uint8* data, int numBytes, int64 timestamp);
+
+    /** Write a marker for numMissing samples that the source sourceNodeId skipped
+    	just before timestamp. The default implementation writes it as a message.
+    */
+    virtual void writeTimestampGap(int sourceNodeId, int64 numMissing, int64 timestamp);
+
     /** Called when acquisition starts once for each processor that might record continuous data
     */
     virtual void registerProcessor(const GenericProcessor* processor);
@@ -135,7 +155,7 @@ public:
 
     /** Write a spike to disk
     */
-    virtual void writeSpike(int electrodeIndex, const SpikeObject& spike, int64 timestamp) = 0;
+    virtual void writeSpike(int electrodeIndex, const SpikeRecord& spike, int64 timestamp) = 0;
 
     /** Called when a new acquisition starts, to clean all channel data
     	before registering the processors
@@ -151,6 +171,15 @@ public:
 	*/
 	void setChannelMapping(const Array<int>& channels);
 
+	/** Returns the number of samples of a recorded channel that didn't fit in
+		the file format and were saturated, since the channel mapping was last set
+	*/
+	int64 getNumClippedSamples(int channel) const;
+
+	/** Prints the recorded channels that clipped. Called after closeFiles
+	*/
+	void reportClippedSamples() const;
+
     /** Called after all channels and spike groups have been registered,
     	just before acquisition starts
     */
@@ -195,9 +224,15 @@ protected:
 	*/
 	int getNumRecordedChannels() const;
 
+	/** Adds to the clipping count of a recorded channel, e.g. the value
+		returned by the SampleConversion functions
+	*/
+	void addClippedSamples(int channel, int numClipped);
+
 private:
 	Array<int64> timestamps;
 	Array<int> channelMap;
+	Array<int64> clippedSamples;
     RecordEngineManager* manager;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RecordEngine);
@@ -61,8 +61,10 @@ RecordNode::RecordNode()
 	m_recordThread = new RecordThread(engineArray);
 	m_dataQueue = new DataQueue(WRITE_BLOCK_LENGTH, DATA_BUFFER_NBLOCKS);
 	m_eventQueue = new EventMsgQueue(EVENT_BUFFER_NEVENTS);
-	m_spikeQueue = new SpikeMsgQueue(SPIKE_BUFFER_NSPIKES);
-	m_recordThread->setQueuePointers(m_dataQueue, m_eventQueue, m_spikeQueue);
+	m_messageQueue = new MessageQueue(MESSAGE_BUFFER_NMESSAGES, MESSAGE_BUFFER_NINTERNED);
+	m_spikeQueue = new SpikeRecordRing(SPIKE_BUFFER_BYTES);
+	m_spikeScratch.calloc(SpikeRecord::getSize(MAX_NUMBER_OF_SPIKE_CHANNELS, MAX_NUMBER_OF_SPIKE_CHANNEL_SAMPLES));
+	m_recordThread->setQueuePointers(m_dataQueue, m_eventQueue, m_messageQueue, m_spikeQueue);
 }
 
 
@@ -118,6 +120,12 @@ void RecordNode::filenameComponentChanged(FilenameComponent* fnc)
 
 }
 
+void RecordNode::setDataDirectory(const File& directory)
+{
+    dataDirectory = directory;
+    newDirectoryNeeded = true;
+}
+
 
 void RecordNode::getChannelNamesAndRecordingStatus(StringArray& names, Array<bool>& recording)
 {
@@ -299,7 +307,8 @@ void RecordNode::setParameter(int parameterIndex, float newValue)
         if (settingsNeeded)
         {
             String settingsFileName = rootFolder.getFullPathName() + File::separator + "settings" + ((experimentNumber > 1) ? "_" + String(experimentNumber) : String::empty) + ".xml";
-            AccessClass::getEditorViewport()->saveState(File(settingsFileName));
+            // written in the background, so that the recording doesn't wait for it
+            AccessClass::getEditorViewport()->saveState(File(settingsFileName), true);
             settingsNeeded = false;
         }
 
@@ -320,6 +329,7 @@ void RecordNode::setParameter(int parameterIndex, float newValue)
 		m_recordThread->setChannelMap(channelMap);
 		m_dataQueue->setChannels(numRecordedChannels);
 		m_eventQueue->reset();
+		m_messageQueue->reset();
 		m_spikeQueue->reset();
 		m_recordThread->setFirstBlockFlag(false);
 
@@ -360,6 +370,15 @@ void RecordNode::setParameter(int parameterIndex, float newValue)
 				}
 			}
 
+			if (m_spikeQueue->getNumDropped() > 0)
+				std::cerr << "RecordNode dropped " << m_spikeQueue->getNumDropped() << " spikes" << std::endl;
+
+			if (m_eventQueue->getNumDropped() > 0)
+				std::cerr << "RecordNode dropped " << m_eventQueue->getNumDropped() << " events" << std::endl;
+
+			if (m_messageQueue->getNumDropped() > 0)
+				std::cerr << "RecordNode dropped " << m_messageQueue->getNumDropped() << " messages" << std::endl;
+
         }
     }
     else if (parameterIndex == 2)
@@ -435,7 +454,12 @@ void RecordNode::handleEvent(int eventType, MidiMessage& event, int samplePositi
             {
 				uint8 sourceNodeId = event.getNoteNumber();
 				int64 timestamp = timestamps[sourceNodeId] + samplePosition;
-				m_eventQueue->addEvent(event, timestamp, eventType);
+
+				// messages go through their own queue so their text is never copied onto the heap
+				if (eventType == MESSAGE)
+					m_messageQueue->push(event.getRawData(), event.getRawDataSize(), timestamp);
+				else
+					m_eventQueue->addEvent(event, timestamp, eventType);
             }
         }
     }
@@ -501,14 +525,31 @@ int RecordNode::addSpikeElectrode(SpikeRecordInfo* elec)
     return spikeElectrodeIndex++;
 }
 
+void RecordNode::writeSpike(const SpikeRecord& spike, int electrodeIndex)
+{
+	if (isRecording)
+	{
+		m_spikeQueue->push(spike, electrodeIndex);
+	}
+}
+
 void RecordNode::writeSpike(SpikeObject& spike, int electrodeIndex)
 {
 	if (isRecording)
 	{
-		m_spikeQueue->addEvent(spike, spike.timestamp, electrodeIndex);
+		SpikeRecord* record = reinterpret_cast<SpikeRecord*>(m_spikeScratch.getData());
+		record->nChannels = spike.nChannels;
+		record->nSamples = spike.nSamples;
+		record->copyFrom(spike);
+		m_spikeQueue->push(*record, electrodeIndex);
 	}
 }
 
+int RecordNode::getNumDroppedSpikes() const
+{
+	return m_spikeQueue->getNumDropped();
+}
+
 SpikeRecordInfo* RecordNode::getSpikeElectrode(int index)
 {
     return spikeElectrodePointers[index];
@@ -32,14 +32,19 @@
 #include "../GenericProcessor/GenericProcessor.h"
 #include "../Channel/Channel.h"
 #include "EventQueue.h"
+#include "MessageQueue.h"
+#include "../Visualization/SpikeRing.h"
 
 #define WRITE_BLOCK_LENGTH 1024
 #define DATA_BUFFER_NBLOCKS 300
 #define EVENT_BUFFER_NEVENTS 512
-#define SPIKE_BUFFER_NSPIKES 512
+#define SPIKE_BUFFER_BYTES (1 << 20)
+#define MESSAGE_BUFFER_NMESSAGES 256
+#define MESSAGE_BUFFER_NINTERNED 256
 
 struct SpikeRecordInfo;
 struct SpikeObject;
+struct SpikeRecord;
 class RecordEngine;
 class RecordThread;
 class DataQueue;
@@ -94,6 +99,12 @@ public:
     bool enable();
     bool disable();
 
+    /** Each channel is written with its own source's sample count. */
+    bool processesWholeBuffer()
+    {
+        return true;
+    }
+
     /** returns channel names and whether we record them */
     void getChannelNamesAndRecordingStatus(StringArray& names, Array<bool>& recording);
 
@@ -134,6 +145,11 @@ public:
         return rootFolder;
     }
 
+    /** Sets the directory in which new recording folders are created, for
+        when there is no FilenameComponent driving the RecordNode.
+    */
+    void setDataDirectory(const File& directory);
+
     /** Adds a Record Engine to use
     */
     void registerRecordEngine(RecordEngine* engine);
@@ -152,10 +168,18 @@ public:
     */
     int addSpikeElectrode(SpikeRecordInfo* elec);
 
-    /** Called by a spike recording source to write a spike to file
+    /** Called by a spike recording source to write a spike to file.
+    The spike is copied into a preallocated ring that is emptied by the
+    record thread, so this never blocks or allocates.
     */
+    void writeSpike(const SpikeRecord& spike, int electrodeIndex);
     void writeSpike(SpikeObject& spike, int electrodeIndex);
 
+    /** Returns the number of spikes dropped in the current or last recording
+    because the record thread fell behind.
+    */
+    int getNumDroppedSpikes() const;
+
     SpikeRecordInfo* getSpikeElectrode(int index);
 
     /** Signals when to create a new data directory when recording starts.*/
@@ -221,7 +245,11 @@ private:
 	ScopedPointer<RecordThread> m_recordThread;
 	ScopedPointer<DataQueue> m_dataQueue;
 	ScopedPointer<EventMsgQueue> m_eventQueue;
-	ScopedPointer<SpikeMsgQueue> m_spikeQueue;
+	ScopedPointer<MessageQueue> m_messageQueue;
+	ScopedPointer<SpikeRecordRing> m_spikeQueue;
+
+	/** Holds a SpikeObject converted to a SpikeRecord by writeSpike(). */
+	HeapBlock<uint8> m_spikeScratch;
 	
 	Array<int> m_recordedChannelMap;
 
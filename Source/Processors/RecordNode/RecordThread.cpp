@@ -58,10 +58,11 @@ void RecordThread::setChannelMap(const Array<int>& channels)
 	m_numChannels = channels.size();
 }
 
-void RecordThread::setQueuePointers(DataQueue* data, EventMsgQueue* events, SpikeMsgQueue* spikes)
+void RecordThread::setQueuePointers(DataQueue* data, EventMsgQueue* events, MessageQueue* messages, SpikeRecordRing* spikes)
 {
 	m_dataQueue = data;
 	m_eventQueue = events;
+	m_messageQueue = messages;
 	m_spikeQueue = spikes;
 }
 
@@ -105,6 +106,7 @@ void RecordThread::run()
 		std::cout << "Closing files" << std::endl;
 		//5-Close files
 		EVERY_ENGINE->closeFiles();
+		EVERY_ENGINE->reportClippedSamples();
 	}
 	m_cleanExit = true;
 	m_receivedFirstBlock = false;
@@ -133,18 +135,40 @@ void RecordThread::writeData(const AudioSampleBuffer& dataBuffer, int maxSamples
 	m_dataQueue->stopRead();
 	EVERY_ENGINE->endChannelBlock(lastBlock);
 
-	std::vector<EventMessagePtr> events;
-	int nEvents = m_eventQueue->getEvents(events, maxEvents);
+	// events are read in place and released as a batch
+	int nEvents = m_eventQueue->startRead(maxEvents);
 	for (int ev = 0; ev < nEvents; ++ev)
 	{
-		EVERY_ENGINE->writeEvent(events[ev]->getExtra(), events[ev]->getData(), events[ev]->getTimestamp());
+		const EventQueue::Event& event = m_eventQueue->getEvent(ev);
+		if (event.eventType == GenericProcessor::TIMESTAMP_GAP)
+		{
+			// the source's node id, then the number of missing samples after the header
+			int64 numMissing;
+			memcpy(&numMissing, event.data + 6, sizeof(int64));
+			EVERY_ENGINE->writeTimestampGap(event.data[1], numMissing, event.timestamp);
+		}
+		else
+			EVERY_ENGINE->writeRawEvent(event.eventType, event.data, event.numBytes, event.timestamp);
+	}
+	m_eventQueue->stopRead();
+
+	// messages are written straight from their queue slots, like spikes
+	const uint8* message;
+	int messageSize;
+	int64 messageTimestamp;
+	for (int msg = 0; (msg < maxEvents || maxEvents <= 0) && (message = m_messageQueue->peek(messageSize, messageTimestamp)) != nullptr; ++msg)
+	{
+		EVERY_ENGINE->writeMessage(message, messageSize, messageTimestamp);
+		m_messageQueue->release();
 	}
 
-	std::vector<SpikeMessagePtr> spikes;
-	int nSpikes = m_spikeQueue->getEvents(spikes, maxSpikes);
-	for (int sp = 0; sp < nSpikes; ++sp)
+	// spikes are written straight from the ring slots and released one by one
+	int electrodeIndex;
+	const SpikeRecord* spike;
+	for (int sp = 0; (sp < maxSpikes || maxSpikes <= 0) && (spike = m_spikeQueue->peek(&electrodeIndex)) != nullptr; ++sp)
 	{
-		EVERY_ENGINE->writeSpike(spikes[sp]->getExtra(), spikes[sp]->getData(), spikes[sp]->getTimestamp());
+		EVERY_ENGINE->writeSpike(electrodeIndex, *spike, spike->timestamp);
+		m_spikeQueue->release();
 	}
 }
 
@@ -154,5 +178,6 @@ void RecordThread::forceCloseFiles()
 		return;
 
 	EVERY_ENGINE->closeFiles();
+	EVERY_ENGINE->reportClippedSamples();
 	m_cleanExit = true;
 }
\ No newline at end of file
@@ -26,7 +26,9 @@
 
 #include "../../../JuceLibraryCode/JuceHeader.h"
 #include "EventQueue.h"
+#include "MessageQueue.h"
 #include "DataQueue.h"
+#include "../Visualization/SpikeRing.h"
 #include <atomic>
 
 #define BLOCK_MAX_WRITE_SAMPLES 4096
@@ -44,7 +46,7 @@ public:
 	~RecordThread();
 	void setFileComponents(File rootFolder, int experimentNumber, int recordingNumber);
 	void setChannelMap(const Array<int>& channels);
-	void setQueuePointers(DataQueue* data, EventMsgQueue* events, SpikeMsgQueue* spikes);
+	void setQueuePointers(DataQueue* data, EventMsgQueue* events, MessageQueue* messages, SpikeRecordRing* spikes);
 
 	void run() override;
 
@@ -59,7 +61,8 @@ private:
 	
 	DataQueue* m_dataQueue;
 	EventMsgQueue* m_eventQueue;
-	SpikeMsgQueue *m_spikeQueue;
+	MessageQueue* m_messageQueue;
+	SpikeRecordRing* m_spikeQueue;
 
 	std::atomic<bool> m_receivedFirstBlock;
 	std::atomic<bool> m_cleanExit;
@@ -0,0 +1,206 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2016 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "SampleConversion.h"
+
+// same conditions as JUCE's own vector operations
+#if JUCE_INTEL && ! (JUCE_MINGW && ! defined (__SSE2__))
+ #define SAMPLE_CONVERSION_SSE 1
+ #include <emmintrin.h>
+#else
+ #define SAMPLE_CONVERSION_SSE 0
+#endif
+
+// frames of interleaved input split up per pass, so that they stay in the
+// cache while every channel is read out of them
+#define DEINTERLEAVE_BLOCK_FRAMES 256
+
+namespace
+{
+    // anything at or above the upper limit rounds past 32767, anything below
+    // the lower one rounds past -32768
+    const float upperLimit = 32767.5f;
+    const float lowerLimit = -32768.5f;
+
+    inline int16 swapIf(bool swap, int16 value)
+    {
+        return swap ? int16(ByteOrder::swap(uint16(value))) : value;
+    }
+
+    // NaNs count as clipped and come out as 32767, as in the vector code
+    inline int16 convertSample(float value, int& numClipped)
+    {
+        if (! (value < upperLimit))
+        {
+            numClipped++;
+            return 32767;
+        }
+
+        if (value < lowerLimit)
+        {
+            numClipped++;
+            return -32768;
+        }
+
+        return int16(jlimit(-32768, 32767, roundToInt(value)));
+    }
+
+   #if SAMPLE_CONVERSION_SSE
+    const int bitCount[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+
+    inline __m128i convertFour(__m128 value, int& numClipped)
+    {
+        const __m128 clipped = _mm_or_ps(_mm_cmpnlt_ps(value, _mm_set1_ps(upperLimit)),
+                                         _mm_cmplt_ps(value, _mm_set1_ps(lowerLimit)));
+        numClipped += bitCount[_mm_movemask_ps(clipped)];
+
+        // clamp before converting, since out-of-range floats don't convert to
+        // a saturated int32; minps passes its second argument for NaNs
+        value = _mm_min_ps(value, _mm_set1_ps(32767.0f));
+        value = _mm_max_ps(value, _mm_set1_ps(-32768.0f));
+
+        // rounds to nearest, like roundToInt
+        return _mm_cvtps_epi32(value);
+    }
+   #endif
+
+    int convertToInt16(const float* src, int16* dest, float scale, int numSamples, bool swap)
+    {
+        int numClipped = 0;
+        int i = 0;
+
+       #if SAMPLE_CONVERSION_SSE
+        const __m128 scaleVector = _mm_set1_ps(scale);
+
+        for (; i + 8 <= numSamples; i += 8)
+        {
+            const __m128i low = convertFour(_mm_mul_ps(_mm_loadu_ps(src + i), scaleVector), numClipped);
+            const __m128i high = convertFour(_mm_mul_ps(_mm_loadu_ps(src + i + 4), scaleVector), numClipped);
+
+            __m128i packed = _mm_packs_epi32(low, high);
+
+            if (swap)
+                packed = _mm_or_si128(_mm_slli_epi16(packed, 8), _mm_srli_epi16(packed, 8));
+
+            _mm_storeu_si128((__m128i*) (dest + i), packed);
+        }
+       #endif
+
+        for (; i < numSamples; i++)
+            dest[i] = swapIf(swap, convertSample(src[i] * scale, numClipped));
+
+        return numClipped;
+    }
+}
+
+int SampleConversion::floatToInt16(const float* src, int16* dest, float scale, int numSamples)
+{
+    return convertToInt16(src, dest, scale, numSamples, false);
+}
+
+int SampleConversion::floatToInt16BE(const float* src, int16* dest, float scale, int numSamples)
+{
+   #if JUCE_LITTLE_ENDIAN
+    return convertToInt16(src, dest, scale, numSamples, true);
+   #else
+    return convertToInt16(src, dest, scale, numSamples, false);
+   #endif
+}
+
+int SampleConversion::floatToInt16LE(const float* src, int16* dest, float scale, int numSamples)
+{
+   #if JUCE_LITTLE_ENDIAN
+    return convertToInt16(src, dest, scale, numSamples, false);
+   #else
+    return convertToInt16(src, dest, scale, numSamples, true);
+   #endif
+}
+
+void SampleConversion::int16ToFloat(const int16* src, int stride, float* dest, float scale, int numSamples)
+{
+    int i = 0;
+
+   #if SAMPLE_CONVERSION_SSE
+    if (stride == 1)
+    {
+        const __m128 scaleVector = _mm_set1_ps(scale);
+
+        for (; i + 8 <= numSamples; i += 8)
+        {
+            const __m128i samples = _mm_loadu_si128((const __m128i*) (src + i));
+
+            // sign-extend each half to int32
+            const __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+            const __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+
+            _mm_storeu_ps(dest + i, _mm_mul_ps(_mm_cvtepi32_ps(low), scaleVector));
+            _mm_storeu_ps(dest + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), scaleVector));
+        }
+    }
+   #endif
+
+    for (; i < numSamples; i++)
+        dest[i] = float(src[size_t(i) * stride]) * scale;
+}
+
+void SampleConversion::deinterleaveInt16ToFloat(const int16* src, float* const* dest, const float* scales,
+                                                 int numChannels, int numSamples)
+{
+    if (numChannels == 1)
+    {
+        int16ToFloat(src, 1, dest[0], scales[0], numSamples);
+        return;
+    }
+
+    for (int start = 0; start < numSamples; start += DEINTERLEAVE_BLOCK_FRAMES)
+    {
+        const int numFrames = jmin(DEINTERLEAVE_BLOCK_FRAMES, numSamples - start);
+        const int16* block = src + size_t(start) * numChannels;
+
+        for (int chan = 0; chan < numChannels; chan++)
+        {
+            const int16* in = block + chan;
+            float* out = dest[chan] + start;
+            const float scale = scales[chan];
+
+            for (int i = 0; i < numFrames; i++)
+                out[i] = float(in[i * numChannels]) * scale;
+        }
+    }
+}
+
+void SampleConversion::swapByteOrder(int16* data, int numSamples)
+{
+    int i = 0;
+
+   #if SAMPLE_CONVERSION_SSE
+    for (; i + 8 <= numSamples; i += 8)
+    {
+        const __m128i samples = _mm_loadu_si128((const __m128i*) (data + i));
+        _mm_storeu_si128((__m128i*) (data + i), _mm_or_si128(_mm_slli_epi16(samples, 8), _mm_srli_epi16(samples, 8)));
+    }
+   #endif
+
+    for (; i < numSamples; i++)
+        data[i] = int16(ByteOrder::swap(uint16(data[i])));
+}
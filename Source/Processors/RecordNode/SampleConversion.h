@@ -0,0 +1,73 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2016 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef SAMPLECONVERSION_H_INCLUDED
+#define SAMPLECONVERSION_H_INCLUDED
+
+#include "../../../JuceLibraryCode/JuceHeader.h"
+#include "../PluginManager/OpenEphysPlugin.h"
+
+/**
+
+  Conversions between the GUI's float samples (in the units of the channel)
+  and the int16 samples that file formats store, shared by the record engines
+  and the file sources.
+
+  Each kernel does its work in a single pass over the data, using SSE2 on
+  Intel processors and plain loops elsewhere; the results are the same either
+  way. Float to int16 conversions round to the nearest integer and saturate
+  at the limits of int16, and report how many samples had to be saturated so
+  that the caller can keep clipping statistics.
+
+  @see RecordEngine, FileSource
+
+*/
+
+namespace SampleConversion
+{
+/** Writes round(src[i] * scale) to dest, saturated to the range of int16,
+    in the byte order of the machine. Returns the number of samples that
+    were out of range. */
+PLUGIN_API int floatToInt16(const float* src, int16* dest, float scale, int numSamples);
+
+/** Like floatToInt16, but the samples are written big-endian. */
+PLUGIN_API int floatToInt16BE(const float* src, int16* dest, float scale, int numSamples);
+
+/** Like floatToInt16, but the samples are written little-endian. */
+PLUGIN_API int floatToInt16LE(const float* src, int16* dest, float scale, int numSamples);
+
+/** Writes src[i * stride] * scale to dest. Reads one channel out of
+    interleaved data when stride is the number of channels. */
+PLUGIN_API void int16ToFloat(const int16* src, int stride, float* dest, float scale, int numSamples);
+
+/** Splits numSamples frames of interleaved data into numChannels float
+    channels in one pass, multiplying each channel by its own scale (e.g. its
+    bitVolts). */
+PLUGIN_API void deinterleaveInt16ToFloat(const int16* src, float* const* dest, const float* scales,
+                                         int numChannels, int numSamples);
+
+/** Reverses the byte order of each sample, in place. */
+PLUGIN_API void swapByteOrder(int16* data, int numSamples);
+}
+
+#endif  // SAMPLECONVERSION_H_INCLUDED
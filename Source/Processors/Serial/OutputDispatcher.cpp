@@ -0,0 +1,265 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2016 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "OutputDispatcher.h"
+
+#define OUTPUT_LOG_SIZE 64
+
+OutputDispatcher::OutputDispatcher(const String& name, Device* device_, int capacity)
+    : Thread(name + " output"), device(device_), dequeuePosition(0), logPosition(0)
+{
+    const int size = nextPowerOfTwo(jmax(2, capacity));
+
+    mask = uint32(size - 1);
+    cells.calloc(size);
+
+    for (int i = 0; i < size; i++)
+        cells[i].sequence = uint32(i);
+
+    log.ensureStorageAllocated(OUTPUT_LOG_SIZE);
+
+    startThread(8);
+}
+
+OutputDispatcher::~OutputDispatcher()
+{
+    signalThreadShouldExit();
+    commandQueued.signal();
+    stopThread(2000);
+}
+
+bool OutputDispatcher::queueCommand(int target, int value, bool coalesce)
+{
+    uint32 position = enqueuePosition.get();
+    Cell* cell;
+
+    for (;;)
+    {
+        cell = cells + (position & mask);
+
+        const int diff = int(cell->sequence.get() - position);
+
+        if (diff == 0)
+        {
+            // the cell is free; claim it unless another producer got there first
+            if (enqueuePosition.compareAndSetBool(position + 1, position))
+                break;
+        }
+        else if (diff < 0)
+        {
+            // the dispatcher hasn't caught up with this cell yet
+            ++numDropped;
+            return false;
+        }
+
+        position = enqueuePosition.get();
+    }
+
+    // counted before the command becomes visible to the dispatcher
+    const int depth = ++queueDepth;
+
+    if (depth > maxQueueDepth.get())
+        maxQueueDepth = depth;
+
+    cell->command.target = target;
+    cell->command.value = value;
+    cell->command.coalesce = coalesce;
+    cell->command.queuedTicks = Time::getHighResolutionTicks();
+    cell->sequence = position + 1;
+
+    commandQueued.signal();
+
+    return true;
+}
+
+bool OutputDispatcher::dequeue(OutputCommand& command)
+{
+    Cell* cell = cells + (dequeuePosition & mask);
+
+    if (int(cell->sequence.get() - (dequeuePosition + 1)) < 0)
+        return false;
+
+    command = cell->command;
+    cell->sequence = dequeuePosition + mask + 1;
+    ++dequeuePosition;
+
+    return true;
+}
+
+void OutputDispatcher::run()
+{
+    OutputCommand command;
+
+    while (!threadShouldExit())
+    {
+        commandQueued.wait(100);
+
+        if (deviceStateInvalid.compareAndSetBool(0, 1))
+            lastValues.clear();
+
+        while (!threadShouldExit() && dequeue(command))
+        {
+            send(command);
+
+            if (--queueDepth == 0)
+                queueEmptied.signal();
+        }
+    }
+}
+
+void OutputDispatcher::send(const OutputCommand& command)
+{
+    if (command.coalesce
+        && lastValues.contains(command.target)
+        && lastValues[command.target] == command.value)
+    {
+        ++numCoalesced;
+        return;
+    }
+
+    OutputLogEntry entry;
+    entry.command = command;
+    entry.sentTicks = Time::getHighResolutionTicks();
+    entry.succeeded = device->sendOutputCommand(command);
+    entry.ackTicks = Time::getHighResolutionTicks();
+
+    if (entry.succeeded)
+    {
+        lastValues.set(command.target, command.value);
+
+        const int64 latency = entry.ackTicks - command.queuedTicks;
+
+        totalLatencyTicks += latency;
+
+        if (latency > maxLatencyTicks.get())
+            maxLatencyTicks = latency;
+
+        ++numSent;
+    }
+    else
+    {
+        // the device may be in any state now
+        lastValues.remove(command.target);
+        ++numFailed;
+    }
+
+    const ScopedLock sl(logLock);
+
+    if (log.size() < OUTPUT_LOG_SIZE)
+    {
+        log.add(entry);
+    }
+    else
+    {
+        log.set(logPosition, entry);
+        logPosition = (logPosition + 1) % OUTPUT_LOG_SIZE;
+    }
+}
+
+bool OutputDispatcher::waitUntilSent(int timeoutMs)
+{
+    const uint32 deadline = Time::getMillisecondCounter() + uint32(timeoutMs);
+
+    while (queueDepth.get() > 0)
+    {
+        const int remaining = int(deadline - Time::getMillisecondCounter());
+
+        if (remaining <= 0)
+            return false;
+
+        queueEmptied.wait(remaining);
+    }
+
+    return true;
+}
+
+void OutputDispatcher::resetDeviceState()
+{
+    deviceStateInvalid = 1;
+}
+
+int OutputDispatcher::getQueueDepth() const
+{
+    return queueDepth.get();
+}
+
+int OutputDispatcher::getMaxQueueDepth() const
+{
+    return maxQueueDepth.get();
+}
+
+int OutputDispatcher::getNumSent() const
+{
+    return numSent.get();
+}
+
+int OutputDispatcher::getNumCoalesced() const
+{
+    return numCoalesced.get();
+}
+
+int OutputDispatcher::getNumFailed() const
+{
+    return numFailed.get();
+}
+
+int OutputDispatcher::getNumDropped() const
+{
+    return numDropped.get();
+}
+
+double OutputDispatcher::getMeanSendLatency() const
+{
+    const int n = numSent.get();
+
+    if (n == 0)
+        return 0;
+
+    return Time::highResolutionTicksToSeconds(totalLatencyTicks.get()) * 1.0e6 / n;
+}
+
+double OutputDispatcher::getMaxSendLatency() const
+{
+    return Time::highResolutionTicksToSeconds(maxLatencyTicks.get()) * 1.0e6;
+}
+
+void OutputDispatcher::resetStatistics()
+{
+    maxQueueDepth = queueDepth.get();
+    numSent = 0;
+    numCoalesced = 0;
+    numFailed = 0;
+    numDropped = 0;
+    totalLatencyTicks = 0;
+    maxLatencyTicks = 0;
+}
+
+void OutputDispatcher::getRecentLog(Array<OutputLogEntry>& entries)
+{
+    const ScopedLock sl(logLock);
+
+    entries.clearQuick();
+
+    for (int i = 0; i < log.size(); i++)
+        entries.add(log[(logPosition + i) % log.size()]);
+}
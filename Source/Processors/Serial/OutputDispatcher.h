@@ -0,0 +1,175 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2016 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef OUTPUTDISPATCHER_H_INCLUDED
+#define OUTPUTDISPATCHER_H_INCLUDED
+
+#include "../../../JuceLibraryCode/JuceHeader.h"
+#include "../PluginManager/OpenEphysPlugin.h"
+
+/** A command for an output device, e.g. "set pin 13 high" or "trigger channel 2". */
+struct OutputCommand
+{
+    /** Pin, channel or any other device-specific target. */
+    int target;
+
+    /** New state of the target, or any other device-specific value. */
+    int value;
+
+    /** If true, the command is skipped when the last command sent to the same
+        target had the same value (i.e. it is a redundant state change). */
+    bool coalesce;
+
+    /** Time::getHighResolutionTicks() when the command was queued. */
+    int64 queuedTicks;
+};
+
+/** Timing of one command handed to the device. */
+struct OutputLogEntry
+{
+    OutputCommand command;
+
+    /** Time::getHighResolutionTicks() before and after the device sent the command. */
+    int64 sentTicks;
+    int64 ackTicks;
+
+    bool succeeded;
+};
+
+/**
+
+  Sends commands to a (usually serial) output device on its own thread.
+
+  Output processors queue commands from the audio thread, or any other
+  thread, instead of talking to the device directly, so a slow or wedged
+  port never holds up the signal chain. Queueing is lock-free; the
+  dispatcher thread hands the commands to the Device in order, skipping
+  redundant state changes, and keeps statistics and a log of the most
+  recent sends.
+
+  If the device falls behind and the queue fills up, new commands are
+  dropped and counted.
+
+  @see OutputCommand, ArduinoOutput, PulsePalOutput
+
+*/
+
+class PLUGIN_API OutputDispatcher : private Thread
+{
+public:
+
+    class PLUGIN_API Device
+    {
+    public:
+        virtual ~Device() {}
+
+        /** Sends one command to the hardware. Called on the dispatcher
+            thread; returns false if the device reported an error. */
+        virtual bool sendOutputCommand(const OutputCommand& command) = 0;
+    };
+
+    /** Starts a dispatcher thread for the device. The capacity is rounded up
+        to a power of two. */
+    OutputDispatcher(const String& name, Device* device, int capacity = 256);
+
+    /** Stops the thread; commands that are still queued are discarded. */
+    ~OutputDispatcher();
+
+    /** Queues a command. Never blocks; can be called from any thread.
+        Returns false if the queue was full. */
+    bool queueCommand(int target, int value, bool coalesce = true);
+
+    /** Waits until every queued command has been sent, or the timeout expires.
+        Returns true if the queue is empty. */
+    bool waitUntilSent(int timeoutMs);
+
+    /** Forgets the last value sent to each target, e.g. after the device was
+        reconnected, so that the next state change is sent whatever it is. */
+    void resetDeviceState();
+
+    /** Returns the number of commands waiting to be sent. */
+    int getQueueDepth() const;
+    int getMaxQueueDepth() const;
+
+    int getNumSent() const;
+    int getNumCoalesced() const;
+    int getNumFailed() const;
+    int getNumDropped() const;
+
+    /** Returns the mean / maximum time, in microseconds, from queueing a
+        command to the device having sent it. */
+    double getMeanSendLatency() const;
+    double getMaxSendLatency() const;
+
+    void resetStatistics();
+
+    /** Copies the most recent sends, oldest first. */
+    void getRecentLog(Array<OutputLogEntry>& entries);
+
+private:
+    void run();
+
+    /** Removes the oldest command from the queue. Dispatcher thread only. */
+    bool dequeue(OutputCommand& command);
+
+    void send(const OutputCommand& command);
+
+    Device* device;
+
+    /** Bounded multi-producer, single-consumer queue. Each cell's sequence
+        tells producers and the consumer whose turn it is. */
+    struct Cell
+    {
+        Atomic<uint32> sequence;
+        OutputCommand command;
+    };
+
+    HeapBlock<Cell> cells;
+    uint32 mask;
+    Atomic<uint32> enqueuePosition;
+    uint32 dequeuePosition;
+
+    WaitableEvent commandQueued;
+    WaitableEvent queueEmptied;
+
+    /** Last value sent to each target; dispatcher thread only. */
+    HashMap<int, int> lastValues;
+    Atomic<int> deviceStateInvalid;
+
+    Atomic<int> queueDepth;
+    Atomic<int> maxQueueDepth;
+    Atomic<int> numSent;
+    Atomic<int> numCoalesced;
+    Atomic<int> numFailed;
+    Atomic<int> numDropped;
+    Atomic<int64> totalLatencyTicks;
+    Atomic<int64> maxLatencyTicks;
+
+    CriticalSection logLock;
+    Array<OutputLogEntry> log;
+    int logPosition;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OutputDispatcher);
+};
+
+#endif  // OUTPUTDISPATCHER_H_INCLUDED
@@ -20,6 +20,10 @@
 #include <algorithm>
 #include <stdio.h>
 
+#if defined( TARGET_OSX ) || defined( TARGET_LINUX )
+#include <poll.h>
+#endif
+
 //---------------------------------------------
 #ifdef TARGET_WIN32
 //---------------------------------------------
@@ -764,3 +768,45 @@ int ofSerial::available()
 
     return numBytes;
 }
+
+//----------------------------------------------------------------
+bool ofSerial::waitForData(int timeoutMs)
+{
+
+    if (!bInited)
+    {
+        return false;
+    }
+
+    //---------------------------------------------
+#if defined( TARGET_OSX ) || defined( TARGET_LINUX )
+    struct pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+
+    if (poll(&pfd, 1, timeoutMs) <= 0)
+        return false;
+
+    // a hang-up or error is reported as ready too, so that the next read
+    // fails instead of the caller waiting forever on a dead port
+    return (pfd.revents & (POLLIN | POLLHUP | POLLERR | POLLNVAL)) != 0;
+#endif
+    //---------------------------------------------
+
+    //---------------------------------------------
+#ifdef TARGET_WIN32
+    // overlapped I/O isn't enabled on the port, so check the input queue
+    // every millisecond instead of waiting on a comm event
+    for (int i = 0; i <= timeoutMs; i++)
+    {
+        if (available() > 0)
+            return true;
+
+        Sleep(1);
+    }
+
+    return false;
+#endif
+    //---------------------------------------------
+}
@@ -101,6 +101,10 @@ public:
     void            flush(bool flushIn = true, bool flushOut = true);
     int             available();
 
+    // waits up to timeoutMs for incoming data; returns true if there is some,
+    // or if the port has been closed or has failed (readBytes() then fails)
+    bool            waitForData(int timeoutMs);
+
     void            drain();
 
 
@@ -28,6 +28,9 @@
 #include "../../AccessClass.h"
 #include "../PluginManager/OpenEphysPlugin.h"
 
+// most samples taken from the data thread in one block
+#define MAX_SOURCE_SAMPLES 10000
+
 SourceNode::SourceNode(const String& name_, DataThreadCreator dt)
     : GenericProcessor(name_),
       sourceCheckInterval(2000), wasDisabled(true), dataThread(nullptr),
@@ -62,8 +65,16 @@ SourceNode::SourceNode(const String& name_, DataThreadCreator dt)
     startTimer(sourceCheckInterval);
 
     timestamp = 0;
+    expectedTimestamp = 0;
+    hasTimestamp = false;
+    numTimestampGaps = 0;
+    numMissingSamples = 0;
+    numBackwardJumps = 0;
+    numSamplesJumpedBack = 0;
+
     //eventCodeBuffer = new uint64[10000]; //10000 samples per buffer max?
-	eventCodeBuffer.malloc(10000);
+	timestampBuffer.malloc(MAX_SOURCE_SAMPLES);
+	eventCodeBuffer.malloc(MAX_SOURCE_SAMPLES);
 
 
 }
@@ -283,6 +294,15 @@ bool SourceNode::enable()
 
     stopTimer();
 
+    hasTimestamp = false;
+    numTimestampGaps = 0;
+    numMissingSamples = 0;
+    numBackwardJumps = 0;
+    numSamplesJumpedBack = 0;
+
+    if (inputBuffer != nullptr)
+        inputBuffer->resetCounters();
+
     if (dataThread != 0)
     {
         dataThread->startAcquisition();
@@ -303,6 +323,18 @@ bool SourceNode::disable()
     if (dataThread != 0)
         dataThread->stopAcquisition();
 
+    if (getNumTimestampGaps() > 0)
+        std::cout << "Source node: " << getNumTimestampGaps() << " timestamp gaps, "
+                  << getNumMissingSamples() << " samples missing." << std::endl;
+
+    if (getNumBackwardJumps() > 0)
+        std::cout << "Source node: " << getNumBackwardJumps() << " backward timestamp jumps, "
+                  << getNumSamplesJumpedBack() << " samples jumped back." << std::endl;
+
+    if (inputBuffer != nullptr && inputBuffer->getNumOverrunSamples() > 0)
+        std::cout << "Source node: " << inputBuffer->getNumOverrunSamples()
+                  << " samples dropped because the buffer was full." << std::endl;
+
     startTimer(2000); // timer to check for connected source
 
     wasDisabled = true;
@@ -334,15 +366,21 @@ void SourceNode::process(AudioSampleBuffer& buffer,
 
     //std::cout << "SOURCE NODE" << std::endl;
 
-    // clear the input buffers
+    // clear the events; samples past nSamples are never read downstream,
+    // so there's no need to clear the rest of the block
     events.clear();
-    buffer.clear();
 
-    int nSamples = inputBuffer->readAllFromBuffer(buffer, &timestamp, eventCodeBuffer, buffer.getNumSamples());
+    int nSamples = inputBuffer->readAllFromBuffer(buffer, timestampBuffer, eventCodeBuffer,
+                                                  jmin(buffer.getNumSamples(), MAX_SOURCE_SAMPLES));
+
+    // an empty block carries the timestamp the next sample should have
+    timestamp = (nSamples > 0) ? timestampBuffer[0] : expectedTimestamp;
 
     setNumSamples(events, nSamples);
     setTimestamp(events, timestamp);
 
+    checkForTimestampGaps(events, nSamples);
+
     //std::cout << *buffer.getReadPointer(0) << std::endl;
 
     //std::cout << "Source node timestamp: " << timestamp << std::endl;
@@ -414,6 +452,62 @@ void SourceNode::process(AudioSampleBuffer& buffer,
 
 
 
+void SourceNode::checkForTimestampGaps(MidiBuffer& events, int nSamples)
+{
+    for (int i = 0; i < nSamples; i++)
+    {
+        if (hasTimestamp && timestampBuffer[i] != expectedTimestamp)
+        {
+            // the count is negative if the timestamps went backwards; the
+            // event is stamped with this node's id, like its timestamps
+            int64 numMissing = timestampBuffer[i] - expectedTimestamp;
+
+            addEvent(events,         // MidiBuffer
+                     TIMESTAMP_GAP,  // eventType
+                     i,              // sampleNum
+                     0,              // eventID
+                     0,              // eventChannel
+                     sizeof(int64),
+                     (uint8*)(&numMissing),
+                     true);
+
+            if (numMissing > 0)
+            {
+                ++numTimestampGaps;
+                numMissingSamples += numMissing;
+            }
+            else
+            {
+                ++numBackwardJumps;
+                numSamplesJumpedBack -= numMissing;
+            }
+        }
+
+        expectedTimestamp = timestampBuffer[i] + 1;
+        hasTimestamp = true;
+    }
+}
+
+int SourceNode::getNumTimestampGaps() const
+{
+    return numTimestampGaps.get();
+}
+
+int64 SourceNode::getNumMissingSamples() const
+{
+    return numMissingSamples.get();
+}
+
+int SourceNode::getNumBackwardJumps() const
+{
+    return numBackwardJumps.get();
+}
+
+int64 SourceNode::getNumSamplesJumpedBack() const
+{
+    return numSamplesJumpedBack.get();
+}
+
 void SourceNode::saveCustomParametersToXml(XmlElement* parentElement)
 {
 
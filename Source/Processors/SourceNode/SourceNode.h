@@ -104,6 +104,20 @@ public:
 
     bool tryEnablingEditor();
 
+    /** Returns the number of forward gaps found in the data thread's
+        timestamps since acquisition started. */
+    int getNumTimestampGaps() const;
+
+    /** Returns the number of samples skipped by those gaps. */
+    int64 getNumMissingSamples() const;
+
+    /** Returns the number of times the data thread's timestamps went
+        backwards since acquisition started. */
+    int getNumBackwardJumps() const;
+
+    /** Returns the total number of samples those jumps went back by. */
+    int64 getNumSamplesJumpedBack() const;
+
 private:
 
     int numEventChannels;
@@ -117,12 +131,29 @@ private:
     ScopedPointer<DataThread> dataThread;
     DataBuffer* inputBuffer;
 
-    uint64 timestamp;
+    int64 timestamp;
     //uint64* eventCodeBuffer;
     //int* eventChannelState;
+	HeapBlock<int64> timestampBuffer;
 	HeapBlock<uint64> eventCodeBuffer;
 	HeapBlock<int> eventChannelState;
 
+    /** Adds a TIMESTAMP_GAP event wherever a sample's timestamp doesn't follow
+        on from the one before it, within the block or across blocks. The event
+        sits on the first sample after the gap and carries the number of
+        missing samples as an int64. */
+    void checkForTimestampGaps(MidiBuffer& events, int nSamples);
+
+    int64 expectedTimestamp;
+    bool hasTimestamp;
+
+    /** Written by the audio thread and read by the message thread, like the
+        DataBuffer's counters. */
+    Atomic<int> numTimestampGaps;
+    Atomic<int64> numMissingSamples;
+    Atomic<int> numBackwardJumps;
+    Atomic<int64> numSamplesJumpedBack;
+
     int ttlState;
 
     void updateSettings();
@@ -111,6 +111,16 @@ bool unpackSpike(SpikeObject* s, const uint8_t* buffer, int bufferSize)
     //if (!isBufferValid(buffer, bufferSize))
     //  return false;
 
+    // spikes detected in this process are passed by handle
+    if (const SpikeRecord* record = SpikePool::getSpike(buffer, bufferSize))
+    {
+        record->copyTo(*s);
+        return true;
+    }
+
+    if (bufferSize < SPIKE_METADATA_SIZE)
+        return false;
+
     int idx = 0;
 
     memcpy(&(s->eventType), buffer+idx, 1);
@@ -30,12 +30,12 @@
 #include <math.h>
 
 #include "../Channel/Channel.h"
+#include "SpikeRecord.h"
 
-#define SPIKE_METADATA_SIZE 42
 #define MAX_NUMBER_OF_SPIKE_CHANNELS 4
 #define MAX_NUMBER_OF_SPIKE_CHANNEL_SAMPLES 80
 #define CHECK_BUFFER_VALIDITY true
-#define SPIKE_EVENT_CODE 4;
+#define SPIKE_EVENT_CODE 4
 #define MAX_SPIKE_BUFFER_LEN 512 // max length of spike buffer in bytes
                                  // the true max calculated from the spike values below is actually 507
 
@@ -107,7 +107,8 @@ PLUGIN_API int microSecondsToSpikeTimeBin(SpikeObject *s, float t, int ch = 0);
 /** Simple method for serializing a SpikeObject into a string of bytes, returns true is the packaged spike buffer is valid */
 PLUGIN_API int packSpike(const SpikeObject* s, uint8_t* buffer, int bufferLength);
 
-/** Simple method for deserializing a string of bytes into a Spike object, returns true is the provided spike buffer is valid */
+/** Simple method for deserializing a string of bytes into a Spike object, returns true is the provided spike buffer is valid.
+    Also accepts the SPIKE events that refer to a SpikeRecord, keeping as many channels and samples as fit. */
 PLUGIN_API bool unpackSpike(SpikeObject* s, const uint8_t* buffer, int bufferLength);
 
 /** Checks the validity of the buffer, this should be run before unpacking the buffer */
@@ -0,0 +1,261 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2016 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "SpikeRecord.h"
+#include "SpikeObject.h"
+
+namespace
+{
+    // pools are looked up by the id stored in their SPIKE events; id 0 is never used
+    SpikePool* registeredPools[256] = { nullptr };
+    CriticalSection registryLock;
+
+    size_t alignRecordSize(size_t size)
+    {
+        return (size + 7) & ~size_t(7);
+    }
+}
+
+//---------------------------------------------------------------------
+
+size_t SpikeRecord::getSize(int nChannels, int nSamples)
+{
+    return alignRecordSize(sizeof(SpikeRecord)
+                           + size_t(nChannels) * (sizeof(float) + sizeof(uint16))
+                           + size_t(nChannels) * size_t(nSamples) * sizeof(uint16));
+}
+
+bool SpikeRecord::copyTo(SpikeObject& s) const
+{
+    const int numChannels = jmin(int(nChannels), MAX_NUMBER_OF_SPIKE_CHANNELS);
+    const int numSamples = jmin(int(nSamples), MAX_NUMBER_OF_SPIKE_CHANNEL_SAMPLES);
+
+    s.eventType = eventType;
+    s.timestamp = timestamp;
+    s.timestamp_software = timestamp_software;
+    s.source = source;
+    s.nChannels = uint16(numChannels);
+    s.nSamples = uint16(numSamples);
+    s.sortedId = sortedId;
+    s.electrodeID = electrodeID;
+    s.channel = channel;
+    s.color[0] = color[0];
+    s.color[1] = color[1];
+    s.color[2] = color[2];
+    s.pcProj[0] = pcProj[0];
+    s.pcProj[1] = pcProj[1];
+    s.samplingFrequencyHz = samplingFrequencyHz;
+
+    for (int chan = 0; chan < numChannels; chan++)
+    {
+        s.gain[chan] = getGains()[chan];
+        s.threshold[chan] = getThresholds()[chan];
+        memcpy(s.data + chan * numSamples, getChannelData(chan), numSamples * sizeof(uint16));
+    }
+
+    return numChannels == nChannels && numSamples == nSamples;
+}
+
+void SpikeRecord::copyFrom(const SpikeObject& s)
+{
+    jassert(nChannels == s.nChannels && nSamples == s.nSamples);
+
+    eventType = s.eventType;
+    timestamp = s.timestamp;
+    timestamp_software = s.timestamp_software;
+    source = s.source;
+    sortedId = s.sortedId;
+    electrodeID = s.electrodeID;
+    channel = s.channel;
+    color[0] = s.color[0];
+    color[1] = s.color[1];
+    color[2] = s.color[2];
+    pcProj[0] = s.pcProj[0];
+    pcProj[1] = s.pcProj[1];
+    samplingFrequencyHz = s.samplingFrequencyHz;
+
+    memcpy(getGains(), s.gain, nChannels * sizeof(float));
+    memcpy(getThresholds(), s.threshold, nChannels * sizeof(uint16));
+    memcpy(getData(), s.data, size_t(nChannels) * nSamples * sizeof(uint16));
+}
+
+void SpikeRecord::copyFrom(const SpikeRecord& other)
+{
+    jassert(nChannels == other.nChannels && nSamples == other.nSamples);
+
+    memcpy(this, &other, other.getSize());
+}
+
+//---------------------------------------------------------------------
+
+SpikePool::SpikePool(int numBytes)
+    : capacity(int(alignRecordSize(numBytes))),
+      used(0),
+      generation(0),
+      poolId(0)
+{
+    arena.calloc(capacity);
+
+    const ScopedLock sl(registryLock);
+
+    for (int i = 1; i < numElementsInArray(registeredPools); i++)
+    {
+        if (registeredPools[i] == nullptr)
+        {
+            registeredPools[i] = this;
+            poolId = uint8(i);
+            break;
+        }
+    }
+
+    if (poolId == 0)
+        std::cerr << "SpikePool: too many spike sources, spikes will not be sent" << std::endl;
+}
+
+SpikePool::~SpikePool()
+{
+    const ScopedLock sl(registryLock);
+
+    if (poolId != 0)
+        registeredPools[poolId] = nullptr;
+}
+
+void SpikePool::clear()
+{
+    used = 0;
+    generation++;
+}
+
+SpikeRecord* SpikePool::allocate(int nChannels, int nSamples)
+{
+    const size_t size = SpikeRecord::getSize(nChannels, nSamples);
+
+    if (poolId == 0 || used + size > size_t(capacity))
+    {
+        ++numDropped;
+        return nullptr;
+    }
+
+    SpikeRecord* record = reinterpret_cast<SpikeRecord*>(arena + used);
+    used += int(size);
+
+    record->nChannels = uint16(nChannels);
+    record->nSamples = uint16(nSamples);
+
+    return record;
+}
+
+SpikeRecord* SpikePool::add(const SpikeObject& spike)
+{
+    SpikeRecord* record = allocate(spike.nChannels, spike.nSamples);
+
+    if (record != nullptr)
+        record->copyFrom(spike);
+
+    return record;
+}
+
+void SpikePool::addSpikeEvent(const SpikeRecord* spike, MidiBuffer& events, int samplePosition)
+{
+    const uint32 offset = uint32(reinterpret_cast<const uint8*>(spike) - arena.getData());
+
+    uint8 handle[SPIKE_HANDLE_SIZE];
+    handle[0] = SPIKE_EVENT_CODE;
+    handle[1] = poolId;
+    memcpy(handle + 2, &generation, 2);
+    memcpy(handle + 4, &offset, 4);
+
+    // 8 bytes is small enough for a MidiMessage to hold without allocating
+    events.addEvent(handle, SPIKE_HANDLE_SIZE, samplePosition);
+}
+
+const SpikeRecord* SpikePool::getSpike(const uint8* eventData, int numBytes)
+{
+    if (numBytes != SPIKE_HANDLE_SIZE || eventData[0] != SPIKE_EVENT_CODE)
+        return nullptr;
+
+    const SpikePool* pool = registeredPools[eventData[1]];
+
+    if (pool == nullptr)
+        return nullptr;
+
+    uint16 generation;
+    uint32 offset;
+    memcpy(&generation, eventData + 2, 2);
+    memcpy(&offset, eventData + 4, 4);
+
+    if (generation != pool->generation || offset >= uint32(pool->used))
+        return nullptr;
+
+    return reinterpret_cast<const SpikeRecord*>(pool->arena + offset);
+}
+
+const SpikeRecord* SpikePool::getSpike(const MidiMessage& event)
+{
+    return getSpike(event.getRawData(), event.getRawDataSize());
+}
+
+int SpikePool::getNumDropped() const
+{
+    return numDropped.get();
+}
+
+//---------------------------------------------------------------------
+
+int getPackedSpikeSize(int nChannels, int nSamples)
+{
+    return SPIKE_METADATA_SIZE + nChannels * nSamples * 2 + nChannels * 4 + nChannels * 2;
+}
+
+int packSpike(const SpikeRecord* s, uint8_t* buffer, int bufferLength)
+{
+    const int numBytes = getPackedSpikeSize(s->nChannels, s->nSamples);
+
+    if (numBytes > bufferLength)
+        return 0;
+
+    int idx = 0;
+
+    buffer[idx++] = s->eventType;
+    memcpy(buffer + idx, &s->timestamp, 8);           idx += 8;
+    memcpy(buffer + idx, &s->timestamp_software, 8);  idx += 8;
+    memcpy(buffer + idx, &s->source, 2);              idx += 2;
+    memcpy(buffer + idx, &s->nChannels, 2);           idx += 2;
+    memcpy(buffer + idx, &s->nSamples, 2);            idx += 2;
+    memcpy(buffer + idx, &s->sortedId, 2);            idx += 2;
+    memcpy(buffer + idx, &s->electrodeID, 2);         idx += 2;
+    memcpy(buffer + idx, &s->channel, 2);             idx += 2;
+    memcpy(buffer + idx, s->color, 3);                idx += 3;
+    memcpy(buffer + idx, s->pcProj, 8);               idx += 8;
+    memcpy(buffer + idx, &s->samplingFrequencyHz, 2); idx += 2;
+
+    jassert(idx == SPIKE_METADATA_SIZE);
+
+    // gains and thresholds follow the samples, as in the SpikeObject layout
+    const int numSampleBytes = s->nChannels * s->nSamples * 2;
+    memcpy(buffer + idx, s->getData(), numSampleBytes);            idx += numSampleBytes;
+    memcpy(buffer + idx, s->getGains(), s->nChannels * 4);          idx += s->nChannels * 4;
+    memcpy(buffer + idx, s->getThresholds(), s->nChannels * 2);     idx += s->nChannels * 2;
+
+    return idx;
+}
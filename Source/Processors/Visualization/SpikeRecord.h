@@ -0,0 +1,154 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2016 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef SPIKERECORD_H_INCLUDED
+#define SPIKERECORD_H_INCLUDED
+
+#include "../../../JuceLibraryCode/JuceHeader.h"
+#include "../PluginManager/OpenEphysPlugin.h"
+
+struct SpikeObject;
+
+/** Size of the SPIKE event that refers to a SpikeRecord in a SpikePool. */
+#define SPIKE_HANDLE_SIZE 8
+
+/** Size of the fields that precede the samples in a packed spike (see packSpike()). */
+#define SPIKE_METADATA_SIZE 42
+
+/**
+
+  Compact, variable-length spike: the same fields as a SpikeObject, followed
+  in memory by nChannels gains, nChannels thresholds and nChannels * nSamples
+  samples (one row of nSamples per channel), with no fixed limit on either.
+
+  Records live in a SpikePool owned by the processor that detected them and
+  are passed down the signal chain by handle, so they are never packed or
+  copied on the way. Only the packed form (packSpike()) leaves the process,
+  to disk or the network.
+
+  @see SpikePool, SpikeObject
+
+*/
+
+struct PLUGIN_API SpikeRecord
+{
+    int64       timestamp;
+    int64       timestamp_software;
+    uint16      source;      // index of the electrode in the source's electrode array
+    uint16      nChannels;
+    uint16      nSamples;
+    uint16      sortedId;    // sorted unit ID (or 0 if unsorted)
+    uint16      electrodeID;
+    uint16      channel;     // channel in which the threshold crossing was detected
+    uint16      samplingFrequencyHz;
+    uint8       color[3];
+    uint8       eventType;
+    float       pcProj[2];
+
+    /** Returns the number of bytes needed for a record of the given shape. */
+    static size_t getSize(int nChannels, int nSamples);
+    size_t getSize() const { return getSize(nChannels, nSamples); }
+
+    float* getGains()                       { return reinterpret_cast<float*>(this + 1); }
+    const float* getGains() const           { return reinterpret_cast<const float*>(this + 1); }
+    uint16* getThresholds()                 { return reinterpret_cast<uint16*>(getGains() + nChannels); }
+    const uint16* getThresholds() const     { return reinterpret_cast<const uint16*>(getGains() + nChannels); }
+    uint16* getData()                       { return getThresholds() + nChannels; }
+    const uint16* getData() const           { return getThresholds() + nChannels; }
+
+    /** Returns the samples of one channel. */
+    const uint16* getChannelData(int chan) const { return getData() + chan * nSamples; }
+
+    /** Copies the record into a SpikeObject, keeping only as many channels and
+        samples as fit. Returns false if anything had to be left out. */
+    bool copyTo(SpikeObject& spike) const;
+
+    /** Copies the fields and samples of a SpikeObject. The record must have
+        been allocated with the SpikeObject's shape. */
+    void copyFrom(const SpikeObject& spike);
+
+    /** Copies the fields and samples of another record of the same shape. */
+    void copyFrom(const SpikeRecord& other);
+};
+
+/**
+
+  Preallocated arena of SpikeRecords for one spike source.
+
+  The source clears the pool at the start of every process() call, fills in
+  new records and adds an 8-byte SPIKE event referring to each one. Processors
+  further down the chain run in the same audio callback, so they can read the
+  record in place (getSpike()) without unpacking it; anything they want to keep
+  beyond that callback must be copied, as the next clear() reuses the memory.
+
+  If the pool runs out of space the spike is dropped and counted.
+
+  @see SpikeRecord
+
+*/
+
+class PLUGIN_API SpikePool
+{
+public:
+    explicit SpikePool(int numBytes = 1 << 20);
+    ~SpikePool();
+
+    /** Forgets every record; events that refer to them become invalid. */
+    void clear();
+
+    /** Returns a new record of the given shape with its count fields set, or
+        nullptr (counting a dropped spike) if the pool is full. */
+    SpikeRecord* allocate(int nChannels, int nSamples);
+
+    /** Allocates a record holding a copy of a SpikeObject. */
+    SpikeRecord* add(const SpikeObject& spike);
+
+    /** Adds a SPIKE event referring to a record of this pool. */
+    void addSpikeEvent(const SpikeRecord* spike, MidiBuffer& events, int samplePosition);
+
+    /** Returns the record a SPIKE event refers to, or nullptr if the event is
+        not a handle (e.g. a packed spike) or its pool has been cleared since. */
+    static const SpikeRecord* getSpike(const uint8* eventData, int numBytes);
+    static const SpikeRecord* getSpike(const MidiMessage& event);
+
+    int getNumDropped() const;
+
+private:
+    HeapBlock<uint8> arena;
+    const int capacity;
+    int used;
+    uint16 generation;
+    uint8 poolId;
+    Atomic<int> numDropped;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpikePool);
+};
+
+/** Serializes a SpikeRecord in the same layout as packSpike(const SpikeObject*, ...).
+    Returns the number of bytes written, or 0 if the buffer is too small. */
+PLUGIN_API int packSpike(const SpikeRecord* s, uint8_t* buffer, int bufferLength);
+
+/** Returns the size of a packed spike with the given shape. */
+PLUGIN_API int getPackedSpikeSize(int nChannels, int nSamples);
+
+#endif  // SPIKERECORD_H_INCLUDED
@@ -0,0 +1,275 @@
+/*
+    ------------------------------------------------------------------
+
+    This file is part of the Open Ephys GUI
+    Copyright (C) 2016 Open Ephys
+
+    ------------------------------------------------------------------
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef SPIKERING_H_INCLUDED
+#define SPIKERING_H_INCLUDED
+
+#include "SpikeObject.h"
+
+/**
+
+  Fixed-capacity, lock-free queue of SpikeObjects for one producer and one consumer.
+
+  All slots are allocated when the ring is created, so pushing a spike from the
+  audio thread only copies it into a free slot. If the consumer falls behind, new
+  spikes are dropped (never the ones being read) and counted, so neither side ever
+  has to wait for the other.
+
+  Each spike can carry an extra integer, e.g. the electrode index it belongs to.
+
+  @see SpikeObject, RecordNode, AbstractFifo
+
+*/
+
+class SpikeRing
+{
+public:
+    explicit SpikeRing(int capacity)
+        : fifo(capacity + 1)
+    {
+        slots.calloc(capacity + 1);
+        extras.calloc(capacity + 1);
+    }
+
+    /** Copies a spike into the ring. Returns false, and counts the spike as
+        dropped, if the ring is full. Producer side only. */
+    bool push(const SpikeObject& spike, int extra = 0)
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite(1, start1, size1, start2, size2);
+
+        if (size1 == 0)
+        {
+            ++numDropped;
+            return false;
+        }
+
+        slots[start1] = spike;
+        extras[start1] = extra;
+        fifo.finishedWrite(1);
+
+        return true;
+    }
+
+    /** Returns the oldest spike without removing it, or nullptr if the ring is
+        empty. The spike remains valid until release() is called. Consumer side only. */
+    const SpikeObject* peek(int* extra = nullptr)
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(1, start1, size1, start2, size2);
+
+        if (size1 == 0)
+            return nullptr;
+
+        if (extra != nullptr)
+            *extra = extras[start1];
+
+        return slots + start1;
+    }
+
+    /** Removes the spike returned by peek(). Consumer side only. */
+    void release()
+    {
+        fifo.finishedRead(1);
+    }
+
+    /** Copies the oldest spike out of the ring. Consumer side only. */
+    bool pop(SpikeObject& spike, int* extra = nullptr)
+    {
+        const SpikeObject* oldest = peek(extra);
+
+        if (oldest == nullptr)
+            return false;
+
+        spike = *oldest;
+        release();
+
+        return true;
+    }
+
+    int getNumReady() const
+    {
+        return fifo.getNumReady();
+    }
+
+    int getCapacity() const
+    {
+        return fifo.getTotalSize() - 1;
+    }
+
+    /** Returns the number of spikes dropped because the ring was full. */
+    int getNumDropped() const
+    {
+        return numDropped.get();
+    }
+
+    /** Empties the ring and clears the drop counter. Only call this while
+        neither the producer nor the consumer are using the ring. */
+    void reset()
+    {
+        fifo.reset();
+        numDropped = 0;
+    }
+
+private:
+    AbstractFifo fifo;
+    HeapBlock<SpikeObject> slots;
+    HeapBlock<int> extras;
+    Atomic<int> numDropped;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpikeRing);
+};
+
+/**
+
+  Lock-free queue of SpikeRecords for one producer and one consumer.
+
+  Unlike SpikeRing, the storage is a single block of bytes and every spike
+  only takes as much of it as its channels and samples need, so a ring of a
+  given size holds many more tetrode spikes, and spikes from large
+  silicon-probe groups fit too. Each record is stored contiguously; if one
+  would wrap around the end of the block the rest of the block is skipped.
+
+  If the consumer falls behind, new spikes are dropped and counted.
+
+  @see SpikeRecord, RecordNode
+
+*/
+
+class SpikeRecordRing
+{
+public:
+    explicit SpikeRecordRing(int numBytes)
+        : fifo((numBytes + 7) & ~7)
+    {
+        storage.calloc(fifo.getTotalSize());
+        lastEntrySize = 0;
+    }
+
+    /** Copies a spike into the ring. Returns false, and counts the spike as
+        dropped, if there is not enough room. Producer side only. */
+    bool push(const SpikeRecord& spike, int extra = 0)
+    {
+        const int entrySize = int(sizeof(EntryHeader) + spike.getSize());
+
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite(entrySize, start1, size1, start2, size2);
+
+        int padding = 0;
+
+        if (size1 < entrySize)
+        {
+            // the free space wraps: skip to the start of the block, if the
+            // record fits there
+            padding = size1;
+            fifo.prepareToWrite(padding + entrySize, start1, size1, start2, size2);
+
+            if (size1 != padding || size2 != entrySize)
+            {
+                ++numDropped;
+                return false;
+            }
+
+            reinterpret_cast<EntryHeader*>(storage + start1)->size = PADDING;
+            start1 = 0;
+        }
+
+        EntryHeader* header = reinterpret_cast<EntryHeader*>(storage + start1);
+        header->size = entrySize;
+        header->extra = extra;
+        memcpy(header + 1, &spike, spike.getSize());
+
+        fifo.finishedWrite(padding + entrySize);
+
+        return true;
+    }
+
+    /** Returns the oldest spike without removing it, or nullptr if the ring is
+        empty. The spike remains valid until release() is called. Consumer side only. */
+    const SpikeRecord* peek(int* extra = nullptr)
+    {
+        for (;;)
+        {
+            int start1, size1, start2, size2;
+            fifo.prepareToRead(sizeof(EntryHeader), start1, size1, start2, size2);
+
+            if (size1 < int(sizeof(EntryHeader)))
+                return nullptr;
+
+            const EntryHeader* header = reinterpret_cast<const EntryHeader*>(storage + start1);
+
+            if (header->size == PADDING)
+            {
+                fifo.finishedRead(fifo.getTotalSize() - start1);
+                continue;
+            }
+
+            if (extra != nullptr)
+                *extra = header->extra;
+
+            lastEntrySize = header->size;
+
+            return reinterpret_cast<const SpikeRecord*>(header + 1);
+        }
+    }
+
+    /** Removes the spike returned by peek(). Consumer side only. */
+    void release()
+    {
+        fifo.finishedRead(lastEntrySize);
+        lastEntrySize = 0;
+    }
+
+    /** Returns the number of spikes dropped because the ring was full. */
+    int getNumDropped() const
+    {
+        return numDropped.get();
+    }
+
+    /** Empties the ring and clears the drop counter. Only call this while
+        neither the producer nor the consumer are using the ring. */
+    void reset()
+    {
+        fifo.reset();
+        numDropped = 0;
+        lastEntrySize = 0;
+    }
+
+private:
+    struct EntryHeader
+    {
+        int32 size;
+        int32 extra;
+    };
+
+    enum { PADDING = -1 };
+
+    AbstractFifo fifo;
+    HeapBlock<uint8> storage;
+    int lastEntrySize;
+    Atomic<int> numDropped;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpikeRecordRing);
+};
+
+#endif  // SPIKERING_H_INCLUDED
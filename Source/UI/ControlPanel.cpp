@@ -540,6 +540,8 @@ void ControlPanel::updateRecordEngineList()
 	{
 		Plugin::RecordEngineInfo info;
 		info = AccessClass::getPluginManager()->getRecordEngineInfo(i);
+		if (info.creator == nullptr)
+			continue;
 		recordSelector->addItem(info.name, id++);
 		recordEngines.add(info.creator());
 	}
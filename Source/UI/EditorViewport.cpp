@@ -28,11 +28,87 @@
 #include "EditorViewportButtons.h"
 #include "../AccessClass.h"
 
+/**
+
+  Writes settings files on a thread of its own, in the order they were
+  handed over. Files that are still waiting when the writer is deleted are
+  written before the destructor returns.
+
+*/
+
+class SettingsWriter : public Thread
+{
+public:
+    SettingsWriter() : Thread("Settings Writer")
+    {
+        startThread();
+    }
+
+    ~SettingsWriter()
+    {
+        signalThreadShouldExit();
+        notify();
+        waitForThreadToExit(-1);
+    }
+
+    /** Takes ownership of the xml. */
+    void write(const File& file, XmlElement* xml)
+    {
+        {
+            const ScopedLock sl(lock);
+            pending.add(new PendingFile(file, xml));
+        }
+
+        notify();
+    }
+
+    void run() override
+    {
+        for (;;)
+        {
+            ScopedPointer<PendingFile> next;
+
+            {
+                const ScopedLock sl(lock);
+
+                if (pending.size() > 0)
+                    next = pending.removeAndReturn(0);
+            }
+
+            if (next == nullptr)
+            {
+                if (threadShouldExit())
+                    return;
+
+                wait(-1);
+                continue;
+            }
+
+            if (! next->xml->writeToFile(next->file, String::empty))
+                std::cout << "Couldn't write " << next->file.getFullPathName() << std::endl;
+        }
+    }
+
+private:
+    struct PendingFile
+    {
+        PendingFile(const File& f, XmlElement* x) : file(f), xml(x) {}
+
+        File file;
+        ScopedPointer<XmlElement> xml;
+    };
+
+    OwnedArray<PendingFile> pending;
+    CriticalSection lock;
+
+    JUCE_DECLARE_NON_COPYABLE(SettingsWriter);
+};
+
 EditorViewport::EditorViewport()
     : leftmostEditor(0),
       message("Drag-and-drop some rows from the top-left box onto this component!"),
       somethingIsBeingDraggedOver(false), shiftDown(false), canEdit(true),
-      lastEditorClicked(0), selectionIndex(0), borderSize(6), tabSize(30),
+      lastEditorClicked(0), selectionIndex(0), loadingState(false), borderSize(6), tabSize(30),
       tabButtonSize(15), insertionPoint(0), componentWantsToMove(false),
       indexOfMovingComponent(-1), currentTab(-1)
 {
@@ -53,6 +129,8 @@ EditorViewport::EditorViewport()
     signalChainManager = new SignalChainManager(this, editorArray,
                                                 signalChainArray);
 
+    settingsWriter = new SettingsWriter();
+
     upButton = new SignalChainScrollButton(UP);
     downButton = new SignalChainScrollButton(DOWN);
     leftButton = new EditorScrollButton(LEFT);
@@ -258,14 +336,18 @@ void EditorViewport::itemDropped(const SourceDetails& dragSourceDetails)
 
             lastEditor = activeEditor;
 
-            signalChainManager->updateVisibleEditors(activeEditor, indexOfMovingComponent, insertionPoint, ADD);
+            signalChainManager->updateVisibleEditors(activeEditor, indexOfMovingComponent, insertionPoint,
+                                                     loadingState ? LOAD : ADD);
 
-            for (int i = 0; i < editorArray.size(); i++)
+            if (! loadingState)
             {
-                if (editorArray[i] == activeEditor)
-                    editorArray[i]->select();
-                else
-                    editorArray[i]->deselect();
+                for (int i = 0; i < editorArray.size(); i++)
+                {
+                    if (editorArray[i] == activeEditor)
+                        editorArray[i]->select();
+                    else
+                        editorArray[i]->deselect();
+                }
             }
 
             // Instructions below were enclosed into the if block by Michael Borisov
@@ -273,13 +355,16 @@ void EditorViewport::itemDropped(const SourceDetails& dragSourceDetails)
 
             insertionPoint = -1; // make sure all editors are left-justified
             indexOfMovingComponent = -1;
-            refreshEditors();
+
+            if (! loadingState)
+                refreshEditors();
 
             somethingIsBeingDraggedOver = false;
 
             AccessClass::getGraphViewer()->addNode(activeEditor);
 
-            repaint();
+            if (! loadingState)
+                repaint();
 
             currentId++;
         }
@@ -319,7 +404,7 @@ void EditorViewport::makeEditorVisible(GenericEditor* editor, bool highlight, bo
     if (!updateSettings)
         signalChainManager->updateVisibleEditors(editor, 0, 0, ACTIVATE);
     else
-        signalChainManager->updateVisibleEditors(editor, 0, 0, UPDATE);
+        signalChainManager->updateVisibleEditors(editor, 0, 0, UPDATE_DOWNSTREAM);
 
     refreshEditors();
 
@@ -1223,7 +1308,7 @@ XmlElement* EditorViewport::switchNodeXml(GenericProcessor* processor)
 
 }
 
-const String EditorViewport::saveState(File fileToUse)
+const String EditorViewport::saveState(File fileToUse, bool writeInBackground)
 {
 
     String error;
@@ -1395,6 +1480,13 @@ const String EditorViewport::saveState(File fileToUse)
     AccessClass::getMessageCenter()->saveStateToXml(xml);
     AccessClass::getUIComponent()->saveStateToXml(xml);  // save the UI settings
 
+    if (writeInBackground)
+    {
+        // formatting and writing the file is left to the writer thread
+        settingsWriter->write(currentFile, xml);
+        return "Saving configuration as " + currentFile.getFileName();
+    }
+
     if (! xml->writeToFile(currentFile, String::empty))
         error = "Couldn't write to file ";
     else
@@ -1505,6 +1597,10 @@ const String EditorViewport::loadState(File fileToLoad)
 	}
     clearSignalChain();
 
+    // each new processor only updates itself and what comes after it, and
+    // the editors are laid out once everything is in place
+    loadingState = true;
+
     String description;// = " ";
     int loadOrder = 0;
 
@@ -1565,8 +1661,6 @@ const String EditorViewport::loadState(File fileToLoad)
                         splitPoints.add(p);
                     }
 
-                    signalChainManager->updateVisibleEditors(editorArray[0], 0, 0, UPDATE);
-
                 }
                 else if (processor->hasTagName("SWITCH"))
                 {
@@ -1600,8 +1694,6 @@ const String EditorViewport::loadState(File fileToLoad)
                         }
                     }
 
-                    signalChainManager->updateVisibleEditors(editorArray[0], 0, 0, UPDATE);
-
                 }
 
             }
@@ -1615,6 +1707,8 @@ const String EditorViewport::loadState(File fileToLoad)
 
     }
 
+    loadingState = false;
+
     for (int i = 0; i < editorArray.size(); i++)
     {
         // deselect everything initially
@@ -1628,13 +1722,12 @@ const String EditorViewport::loadState(File fileToLoad)
     AccessClass::getMessageCenter()->loadStateFromXml(xml);
     AccessClass::getUIComponent()->loadStateFromXml(xml);  // save the UI settings
 
+    // a single update of every chain, now that all the parameters are in
     if (editorArray.size() > 0)
         signalChainManager->updateVisibleEditors(editorArray[0], 0, 0, UPDATE);
 
     refreshEditors();
 
-    AccessClass::getProcessorGraph()->restoreParameters();
-
 
     String error = "Opened ";
     error += currentFile.getFileName();
@@ -37,6 +37,7 @@
 class GenericEditor;
 class SignalChainTabButton;
 class SignalChainManager;
+class SettingsWriter;
 class EditorScrollButton;
 class SignalChainScrollButton;
 class ControlPanel;
@@ -146,8 +147,10 @@ public:
         return signalChainArray;
     }
 
-    /** Save the current configuration as an XML file. */
-    const String saveState(File filename);
+    /** Save the current configuration as an XML file. If writeInBackground is true,
+    the settings are collected right away but the file is written by a background
+    thread, so the caller doesn't have to wait for the disk. */
+    const String saveState(File filename, bool writeInBackground = false);
 
     /** Load a saved configuration from an XML file. */
     const String loadState(File filename);
@@ -190,6 +193,14 @@ private:
 
     SignalChainManager* signalChainManager;
 
+    /** Writes the files for saveState(file, true). */
+    ScopedPointer<SettingsWriter> settingsWriter;
+
+    /** True while loadState() is adding processors; settings are then only
+    updated downstream of each new processor, and the editors are laid out
+    once at the end. */
+    bool loadingState;
+
     Font font;
     Image sourceDropImage;
 
@@ -201,7 +212,7 @@ private:
 
     int currentTab;
 
-    enum actions {ADD, MOVE, REMOVE, ACTIVATE, UPDATE};
+    enum actions {ADD, MOVE, REMOVE, ACTIVATE, UPDATE, UPDATE_DOWNSTREAM, LOAD};
     enum directions1 {LEFT, RIGHT};
     enum directions2 {UP, DOWN};
 
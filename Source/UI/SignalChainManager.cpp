@@ -163,10 +163,10 @@ void SignalChainManager::updateVisibleEditors(GenericEditor* activeEditor,
 
 {
 
-    enum actions {ADD, MOVE, REMOVE, ACTIVATE, UPDATE};
+    enum actions {ADD, MOVE, REMOVE, ACTIVATE, UPDATE, UPDATE_DOWNSTREAM, LOAD};
 
     // Step 1: update the editor array
-    if (action == ADD)
+    if (action == ADD || action == LOAD)
     {
         //std::cout << "    Adding editor." << std::endl;
         editorArray.insert(insertionPoint, activeEditor);
@@ -292,7 +292,7 @@ void SignalChainManager::updateVisibleEditors(GenericEditor* activeEditor,
     }
 
     // Step 2: update connections
-    if (action != ACTIVATE && action != UPDATE && editorArray.size() > 0)
+    if (action != ACTIVATE && action != UPDATE && action != UPDATE_DOWNSTREAM && editorArray.size() > 0)
     {
 
         // std::cout << "Updating connections." << std::endl;
@@ -316,7 +316,7 @@ void SignalChainManager::updateVisibleEditors(GenericEditor* activeEditor,
     }
 
     // Step 3: check for new tabs
-    if (action != ACTIVATE && action != UPDATE)
+    if (action != ACTIVATE && action != UPDATE && action != UPDATE_DOWNSTREAM)
     {
 
         //  std::cout << "Checking for new tabs." << std::endl;
@@ -381,7 +381,7 @@ void SignalChainManager::updateVisibleEditors(GenericEditor* activeEditor,
             //   std::cout << "Source: " << source->getName() << std::endl;
 
             // need to switch the splitter somehow
-            if (action == ACTIVATE || action == UPDATE)
+            if (action == ACTIVATE || action == UPDATE || action == UPDATE_DOWNSTREAM)
             {
                 if (source->isSplitter())
                 {
@@ -504,49 +504,55 @@ void SignalChainManager::updateVisibleEditors(GenericEditor* activeEditor,
         }
     }
 
-    // Step 7: update all settings
-    if (action != ACTIVATE)
+    // Step 7: update settings
+    if (action == UPDATE_DOWNSTREAM || action == LOAD)
+    {
+        // only the processors after the one that changed can be affected;
+        // while loading, the whole chain is updated once at the end
+        updateProcessorSettings(activeEditor->getProcessor());
+    }
+    else if (action != ACTIVATE)
     {
 
         // std::cout << "Updating settings." << std::endl;
 
-        Array<GenericProcessor*> splitters;
-
         for (int n = 0; n < signalChainArray.size(); n++)
         {
             // iterate through signal chains
 
             GenericEditor* source = signalChainArray[n]->getEditor();
-            GenericProcessor* p = source->getProcessor();
 
-            //  p->update();
+            updateProcessorSettings(source->getProcessor());
+        }
+    }
 
-            //  GenericProcessor* dest = p->getDestNode();
 
-            while (p != 0)
-            {
-                // iterate through processors
-                p->update();
+    // std::cout << "Finished adding new editor." << std::endl << std::endl << std::endl;
 
-                if (p->isSplitter())
-                {
-                    splitters.add(p);
-                }
+}
 
-                p = p->getDestNode();
+void SignalChainManager::updateProcessorSettings(GenericProcessor* p)
+{
+    Array<GenericProcessor*> splitters;
 
-                if (p == 0 && splitters.size() > 0)
-                {
-                    splitters.getFirst()->switchIO(); // switch the signal chain
-                    p = splitters[0]->getDestNode();
-                    splitters.getFirst()->switchIO(); // switch it back
-                    splitters.remove(0);
-                }
-            }
-        }
-    }
+    while (p != 0)
+    {
+        // iterate through processors
+        p->update();
 
+        if (p->isSplitter())
+        {
+            splitters.add(p);
+        }
 
-    // std::cout << "Finished adding new editor." << std::endl << std::endl << std::endl;
+        p = p->getDestNode();
 
+        if (p == 0 && splitters.size() > 0)
+        {
+            splitters.getFirst()->switchIO(); // switch the signal chain
+            p = splitters[0]->getDestNode();
+            splitters.getFirst()->switchIO(); // switch it back
+            splitters.remove(0);
+        }
+    }
 }
@@ -84,6 +84,10 @@ private:
     /** Updates the visibility of SignalChainTabButtons.*/
     void refreshTabs();
 
+    /** Updates the settings of a processor and of everything downstream of it,
+    following both paths of any splitter along the way.*/
+    void updateProcessorSettings(GenericProcessor* processor);
+
     /** The index of the top tab (used for scrolling purposes).*/
     int topTab;
 